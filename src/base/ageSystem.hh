@@ -0,0 +1,53 @@
+// Copyright (C) 2004-2012 Jed Brown, Ed Bueler and Constantine Khroulev
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef __ageSystem_hh
+#define __ageSystem_hh
+
+#include "columnSystem.hh"
+
+class IceModelVec3;
+
+//! Tridiagonal linear system for vertical column of age (pure advection) problem.
+class ageSystemCtx : public columnSystemCtx {
+
+public:
+  ageSystemCtx(PetscInt my_Mz, string my_prefix);
+  PetscErrorCode initAllColumns();
+
+  PetscErrorCode solveThisColumn(PetscScalar **x, PetscErrorCode &pivoterrorindex);  
+
+public:
+  // constants which should be set before calling initForAllColumns()
+  PetscScalar  dx,
+               dy,
+               dtAge,
+               dzEQ;
+  bool         semi_lagrangian; //!< use semi-Lagrangian horizontal advection
+  // pointers which should be set before calling initForAllColumns()
+  PetscScalar  *u,
+               *v,
+               *w;
+  IceModelVec3 *tau3;
+
+protected: // used internally
+  PetscScalar nuEQ;
+  bool        initAllDone;
+};
+
+#endif  // __ageSystem_hh
@@ -33,8 +33,8 @@ PetscErrorCode PISMConstantYieldStress::init(PISMVars &/*vars*/) {
     ierr = PISMOptionsIsSet("-i", "PISM input file", i_set); CHKERRQ(ierr);
     ierr = PISMOptionsIsSet("-boot_file", "PISM bootstrapping file",
                             bootstrap); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-tauc", "set basal yield stress to a constant (units of Pa)",
-                           constant_tauc, tauc_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-tauc", "set basal yield stress to a constant (units of Pa)",
+                                     constant_tauc, tauc_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -111,10 +111,10 @@ PetscErrorCode PISMConstantYieldStress::regrid() {
 
   ierr = PetscOptionsBegin(grid.com, "", "PISMMohrCoulombYieldStress regridding options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-regrid_file", "regridding file name",
-                             regrid_file, regrid_file_set); CHKERRQ(ierr);
-    ierr = PISMOptionsStringArray("-regrid_vars", "comma-separated list of regridding variables",
-                                  "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-regrid_file", "regridding file name",
+                                       regrid_file, regrid_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsStringArray(grid.com, "-regrid_vars", "comma-separated list of regridding variables",
+                                            "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
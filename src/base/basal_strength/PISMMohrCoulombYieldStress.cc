@@ -130,8 +130,8 @@ PetscErrorCode PISMMohrCoulombYieldStress::init(PISMVars &vars)
                             tauc_to_phi_set); CHKERRQ(ierr);
     bool scaleSet = false;
     double slidescale = 0.0;
-    ierr = PISMOptionsReal("-sliding_scale",
-                           "Divides pseudo-plastic tauc (yield stress) by given factor;"
+    ierr = PISMOptionsReal(grid.com, "-sliding_scale",
+                                     "Divides pseudo-plastic tauc (yield stress) by given factor;"
                            " this would increase sliding by given factor in absence of membrane stresses",
                            slidescale, scaleSet); CHKERRQ(ierr);
     if (scaleSet) { // only modify config if option set; otherwise leave alone
@@ -199,8 +199,8 @@ PetscErrorCode PISMMohrCoulombYieldStress::init(PISMVars &vars)
   if (tauc_to_phi_set) {
     string tauc_to_phi_file;
     bool flag;
-    ierr = PISMOptionsString("-tauc_to_phi", "Specifies the file tauc will be read from",
-                             tauc_to_phi_file, flag, true); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-tauc_to_phi", "Specifies the file tauc will be read from",
+                                       tauc_to_phi_file, flag, true); CHKERRQ(ierr);
 
     if (tauc_to_phi_file.empty() == false) {
       // "-tauc_to_phi filename.nc" is given
@@ -254,10 +254,10 @@ PetscErrorCode PISMMohrCoulombYieldStress::regrid() {
 
   ierr = PetscOptionsBegin(grid.com, "", "PISMMohrCoulombYieldStress regridding options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-regrid_file", "regridding file name",
-                             regrid_file, regrid_file_set); CHKERRQ(ierr);
-    ierr = PISMOptionsStringArray("-regrid_vars", "comma-separated list of regridding variables",
-                                  "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-regrid_file", "regridding file name",
+                                       regrid_file, regrid_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsStringArray(grid.com, "-regrid_vars", "comma-separated list of regridding variables",
+                                            "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -465,8 +465,8 @@ PetscErrorCode PISMMohrCoulombYieldStress::topg_to_phi() {
   inarray[3] = 1000.0;
 
   // read the comma-separated list of four values
-  ierr = PISMOptionsRealArray("-topg_to_phi", "phi_min, phi_max, topg_min, topg_max",
-                              inarray, topg_to_phi_set); CHKERRQ(ierr);
+  ierr = PISMOptionsRealArray(grid.com, "-topg_to_phi", "phi_min, phi_max, topg_min, topg_max",
+                                        inarray, topg_to_phi_set); CHKERRQ(ierr);
 
   if (topg_to_phi_set == false) {
     SETERRQ(grid.com, 1, "HOW DID I GET HERE? ... ending...\n");
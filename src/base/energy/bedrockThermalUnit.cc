@@ -22,6 +22,7 @@
 #include "LocalInterpCtx.hh"
 #include "IceGrid.hh"
 #include "pism_options.hh"
+#include "pism_threads.hh"
 
 bool IceModelVec3BTU::good_init() {
   return ((n_levels >= 2) && (Lbz > 0.0) && (v != PETSC_NULL));
@@ -161,10 +162,10 @@ PetscErrorCode PISMBedThermalUnit::init(PISMVars &vars) {
 
   ierr = PetscOptionsBegin(grid.com, "", "PISMBedThermalUnit options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-i", "PISM input file name",
-                             input_file, i_set); CHKERRQ(ierr);
-    ierr = PISMOptionsInt("-Mbz", "number of levels in bedrock thermal layer", Mbz, Mbz_set); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-Lbz", "depth (thickness) of bedrock thermal layer", Lbz, Lbz_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-i", "PISM input file name",
+                                       input_file, i_set); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(grid.com, "-Mbz", "number of levels in bedrock thermal layer", Mbz, Mbz_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-Lbz", "depth (thickness) of bedrock thermal layer", Lbz, Lbz_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -227,6 +228,37 @@ PetscErrorCode PISMBedThermalUnit::init(PISMVars &vars) {
 }
 
 
+//! \brief Save the bedrock temperature in memory (see IceModel::run()).
+/*!
+ * Sets \c result to PETSC_NULL if there is no bedrock thermal layer. The
+ * caller is responsible for destroying \c result.
+ */
+PetscErrorCode PISMBedThermalUnit::save_state(Vec &result) {
+  PetscErrorCode ierr;
+
+  result = PETSC_NULL;
+
+  if (temp.was_created()) {
+    ierr = temp.save_state(result); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Restore the bedrock temperature saved by save_state() and restart
+//! the clock, as init() does.
+PetscErrorCode PISMBedThermalUnit::restore_state(Vec saved) {
+  PetscErrorCode ierr;
+
+  t = dt = GSL_NAN;
+
+  if (temp.was_created() && saved != PETSC_NULL) {
+    ierr = temp.restore_state(saved); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
 void PISMBedThermalUnit::add_vars_to_output(string /*keyword*/, map<string,NCSpatialVariable> &result) {
   if (temp.was_created()) {
     result[temp.string_attr("short_name")] = temp.get_metadata();
@@ -355,28 +387,46 @@ PetscErrorCode PISMBedThermalUnit::update(PetscReal my_t, PetscReal my_dt) {
 
   const PetscReal bed_R  = bed_D * my_dt / (dzb * dzb);
 
-  PetscScalar *Tbold;
-  vector<PetscScalar> Tbnew(Mbz);
+  vector<PetscErrorCode> thread_error(pism_max_threads(), 0);
 
   ierr = temp.begin_access(); CHKERRQ(ierr);
   ierr = ghf->begin_access(); CHKERRQ(ierr);
   ierr = bedtoptemp->begin_access(); CHKERRQ(ierr);
-  for (PetscInt   i = grid.xs; i < grid.xs+grid.xm; ++i) {
-    for (PetscInt j = grid.ys; j < grid.ys+grid.ym; ++j) {
 
-      ierr = temp.getInternalColumn(i,j,&Tbold); CHKERRQ(ierr); // Tbold actually points into temp memory
-      Tbold[k0] = (*bedtoptemp)(i,j);  // sets Dirichlet explicit-in-time b.c. at top of bedrock column
+  // Columns are independent, so they can be updated by different threads.
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr)
+#endif
+  {
+    PetscScalar *Tbold;
+    vector<PetscScalar> Tbnew(Mbz);
+    PetscErrorCode &error = thread_error[pism_thread_id()];
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp for
+#endif
+    for (PetscInt   i = grid.xs; i < grid.xs+grid.xm; ++i) {
+      for (PetscInt j = grid.ys; j < grid.ys+grid.ym; ++j) {
+
+        ierr = temp.getInternalColumn(i,j,&Tbold); PISM_THREAD_CHKERRQ(ierr, error); // Tbold actually points into temp memory
+        Tbold[k0] = (*bedtoptemp)(i,j);  // sets Dirichlet explicit-in-time b.c. at top of bedrock column
 
-      const PetscReal Tbold_negone = Tbold[1] + 2 * (*ghf)(i,j) * dzb / bed_k;
-      Tbnew[0] = Tbold[0] + bed_R * (Tbold_negone - 2 * Tbold[0] + Tbold[1]);
-      for (PetscInt k = 1; k < k0; k++) { // working upward from base
-        Tbnew[k] = Tbold[k] + bed_R * (Tbold[k-1] - 2 * Tbold[k] + Tbold[k+1]);
-      }
-      Tbnew[k0] = (*bedtoptemp)(i,j);
+        const PetscReal Tbold_negone = Tbold[1] + 2 * (*ghf)(i,j) * dzb / bed_k;
+        Tbnew[0] = Tbold[0] + bed_R * (Tbold_negone - 2 * Tbold[0] + Tbold[1]);
+        for (PetscInt k = 1; k < k0; k++) { // working upward from base
+          Tbnew[k] = Tbold[k] + bed_R * (Tbold[k-1] - 2 * Tbold[k] + Tbold[k+1]);
+        }
+        Tbnew[k0] = (*bedtoptemp)(i,j);
 
-      ierr = temp.setInternalColumn(i,j,&Tbnew[0]); CHKERRQ(ierr); // copy from Tbnew into temp memory
+        ierr = temp.setInternalColumn(i,j,&Tbnew[0]); PISM_THREAD_CHKERRQ(ierr, error); // copy from Tbnew into temp memory
+      }
     }
+  } // end of the parallel region
+
+  for (unsigned int t = 0; t < thread_error.size(); ++t) {
+    CHKERRQ(thread_error[t]);
   }
+
   ierr = bedtoptemp->end_access(); CHKERRQ(ierr);
   ierr = ghf->end_access(); CHKERRQ(ierr);
   ierr = temp.end_access(); CHKERRQ(ierr);
@@ -435,10 +485,10 @@ PetscErrorCode PISMBedThermalUnit::regrid() {
 
   ierr = PetscOptionsBegin(grid.com, "", "PISMBedThermalUnit regridding options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-regrid_file", "regridding file name",
-                             regrid_file, regrid_file_set); CHKERRQ(ierr);
-    ierr = PISMOptionsStringArray("-regrid_vars", "comma-separated list of regridding variables",
-                                  "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-regrid_file", "regridding file name",
+                                       regrid_file, regrid_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsStringArray(grid.com, "-regrid_vars", "comma-separated list of regridding variables",
+                                            "", regrid_vars, regrid_vars_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -116,6 +116,9 @@ public:
   virtual PetscErrorCode update(PetscReal my_t, PetscReal my_dt);
 
   virtual PetscErrorCode get_upward_geothermal_flux(IceModelVec2S &result);
+
+  virtual PetscErrorCode save_state(Vec &result);
+  virtual PetscErrorCode restore_state(Vec saved);
 protected:
   virtual PetscErrorCode allocate(int Mbz, double Lbz);
 
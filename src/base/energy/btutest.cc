@@ -169,10 +169,10 @@ int main(int argc, char *argv[]) {
     string outname="unnamed_btutest.nc";
     ierr = PetscOptionsBegin(grid.com, "", "BTU_TEST options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString("-o", "Output file name", outname, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsReal("-dt", "Time-step, in years", dt_years, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsInt("-Mz", "number of vertical layers in ice", grid.Mz, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsReal("-Lz", "height of ice/atmosphere boxr", grid.Lz, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-o", "Output file name", outname, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(grid.com, "-dt", "Time-step, in years", dt_years, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(grid.com, "-Mz", "number of vertical layers in ice", grid.Mz, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(grid.com, "-Lz", "height of ice/atmosphere boxr", grid.Lz, flag); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -41,6 +41,8 @@ enthSystemCtx::enthSystemCtx(const NCConfigVariable &config,
   ice_c   = config.get("ice_specific_heat_capacity");
   ice_k   = config.get("ice_thermal_conductivity");
 
+  semi_lagrangian = config.get_flag("semi_lagrangian_advection");
+
   ice_K   = ice_k / ice_c;
   ice_K0  = ice_K * config.get("enthalpy_temperate_conductivity_ratio");
 
@@ -241,13 +243,9 @@ PetscErrorCode enthSystemCtx::setBasalHeatFlux(PetscScalar hf) {
   // zero vertical velocity contribution
   b = Enth[0] + Rminus * X;   // = rhs[0]
   if (!ismarginal) {
-    planeStar<PetscScalar> ss;
-    ierr = Enth3->getPlaneStar_fine(i,j,0,&ss); CHKERRQ(ierr);
-    const PetscScalar UpEnthu = (u[0] < 0) ? u[0] * (ss.e -  ss.ij) / dx :
-                                             u[0] * (ss.ij  - ss.w) / dx;
-    const PetscScalar UpEnthv = (v[0] < 0) ? v[0] * (ss.n -  ss.ij) / dy :
-                                             v[0] * (ss.ij  - ss.s) / dy;
-    b += dtTemp * ((Sigma[0] / ice_rho) - UpEnthu - UpEnthv);  // = rhs[0]
+    PetscScalar advection;
+    ierr = horizontal_advection(0, advection); CHKERRQ(ierr);
+    b += dtTemp * (Sigma[0] / ice_rho) + advection;  // = rhs[0]
   }
   return 0;
 }
@@ -281,6 +279,36 @@ PetscErrorCode enthSystemCtx::assemble_R() {
 }
 
 
+//! \brief Compute the change in enthalpy at the fine level \c k over one time
+//! step due to horizontal advection.
+/*!
+Uses explicit first-order upwinding (subject to the CFL condition) or, if
+\c semi_lagrangian_advection is set, a semi-Lagrangian step: the new value is
+the old enthalpy at the departure point \f$(x - u \Delta t, y - v \Delta t)\f$,
+computed using bilinear interpolation (see
+IceModelVec3::getValDeparture_fine()).
+ */
+PetscErrorCode enthSystemCtx::horizontal_advection(PetscInt k, PetscScalar &result) {
+  PetscErrorCode ierr;
+  planeStar<PetscScalar> ss;
+  ierr = Enth3->getPlaneStar_fine(i,j,k,&ss); CHKERRQ(ierr);
+
+  if (semi_lagrangian) {
+    result = Enth3->getValDeparture_fine(i, j, k,
+                                         u[k] * dtTemp / dx,
+                                         v[k] * dtTemp / dy) - ss.ij;
+    return 0;
+  }
+
+  const PetscScalar UpEnthu = (u[k] < 0) ? u[k] * (ss.e -  ss.ij) / dx :
+                                           u[k] * (ss.ij  - ss.w) / dx;
+  const PetscScalar UpEnthv = (v[k] < 0) ? v[k] * (ss.n -  ss.ij) / dy :
+                                           v[k] * (ss.ij  - ss.s) / dy;
+  result = - dtTemp * (UpEnthu + UpEnthv);
+  return 0;
+}
+
+
 /*! \brief Solve the tridiagonal system, in a single column, which determines
 the new values of the ice enthalpy. */
 PetscErrorCode enthSystemCtx::solveThisColumn(PetscScalar **x, PetscErrorCode &pivoterrorindex) {
@@ -317,13 +345,9 @@ PetscErrorCode enthSystemCtx::solveThisColumn(PetscScalar **x, PetscErrorCode &p
     }
     rhs[k] = Enth[k];
     if (!ismarginal) {
-      planeStar<PetscScalar> ss;
-      ierr = Enth3->getPlaneStar_fine(i,j,k,&ss); CHKERRQ(ierr);
-      const PetscScalar UpEnthu = (u[k] < 0) ? u[k] * (ss.e -  ss.ij) / dx :
-                                               u[k] * (ss.ij  - ss.w) / dx;
-      const PetscScalar UpEnthv = (v[k] < 0) ? v[k] * (ss.n -  ss.ij) / dy :
-                                               v[k] * (ss.ij  - ss.s) / dy;
-      rhs[k] += dtTemp * ((Sigma[k] / ice_rho) - UpEnthu - UpEnthv);
+      PetscScalar advection;
+      ierr = horizontal_advection(k, advection); CHKERRQ(ierr);
+      rhs[k] += dtTemp * (Sigma[k] / ice_rho) + advection;
     }
   }
 
@@ -77,7 +77,10 @@ protected:
   vector<PetscScalar> R; // value of k \Delta t / (\rho c \Delta x^2) in
                          // column, using current values of enthalpy
 
+  bool         semi_lagrangian;
+
   virtual PetscErrorCode assemble_R();
+  PetscErrorCode horizontal_advection(PetscInt k, PetscScalar &result);
   PetscErrorCode checkReadyToSolve();
 };
 
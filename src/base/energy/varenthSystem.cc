@@ -65,19 +65,23 @@ In this implementation the conductivity \f$k=k(T)\f$ and the specific heat capac
 depends on the temperature.  We get the temperature from the enthalpy.
  */
 PetscErrorCode varenthSystemCtx::assemble_R() {
-  PetscErrorCode ierr;
-
   const PetscScalar Rfactor = dtTemp / (PetscSqr(dzEQ) * ice_rho);
 
+  if ((int)z.size() != Mz) {
+    z.resize(Mz);
+    T.resize(Mz);
+    for (PetscInt k = 0; k < Mz; ++k)
+      z[k] = k * dzEQ;
+  }
+
+  // temperatures in the whole column (one EnthalpyConverter call); the return
+  // code is not checked because only temperatures of cold ice are used below
+  EC->getAbsTempColumn(Enth, ice_thickness, &z[0], ks + 1, &T[0]); // FIXME: issue #15
+
   for (PetscInt k = 0; k <= ks; k++) {
     if (Enth[k] < Enth_s[k]) {
       // cold case
-      const PetscScalar depth = ice_thickness - k * dzEQ;
-      PetscScalar T;
-      ierr = EC->getAbsTemp(Enth[k], EC->getPressureFromDepth(depth), // FIXME: issue #15
-                            T); CHKERRQ(ierr);
-
-      R[k] = ((k_depends_on_T ? k_from_T(T) : ice_k) / EC->c_from_T(T)) * Rfactor;
+      R[k] = ((k_depends_on_T ? k_from_T(T[k]) : ice_k) / EC->c_from_T(T[k])) * Rfactor;
     } else {
       // temperate case
       R[k] = iceRtemp;
@@ -46,6 +46,8 @@ protected:
   EnthalpyConverter *EC;  // conductivity has known dependence on T, not enthalpy
   PetscReal ice_thickness;
   bool k_depends_on_T;
+  vector<PetscScalar> z, T;     // levels of the equally-spaced grid and
+                                // temperatures in the current column
 };
 
 #endif   //  ifndef __varenthSystem_hh
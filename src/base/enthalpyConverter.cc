@@ -35,16 +35,20 @@ EnthalpyConverter::EnthalpyConverter(const NCConfigVariable &config) {
   T_0   = config.get("enthalpy_converter_reference_temperature");// K  
 
   do_cold_ice_methods  = config.get_flag("do_cold_ice_methods");
+  inline_pointwise     = true;
+
+  com = config.get_comm();
 }
 
 
-//! Simple view of state of EnthalpyConverter.  viewer==NULL sends to stdout.
+//! Simple view of state of EnthalpyConverter.  viewer==NULL sends to stdout
+//! (on the communicator of the config database used to create it).
 PetscErrorCode EnthalpyConverter::viewConstants(PetscViewer viewer) const {
   PetscErrorCode ierr;
 
   PetscBool iascii;
   if (!viewer) {
-    ierr = PetscViewerASCIIGetStdout(PETSC_COMM_WORLD,&viewer); CHKERRQ(ierr);
+    ierr = PetscViewerASCIIGetStdout(com,&viewer); CHKERRQ(ierr);
   }
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii); CHKERRQ(ierr);
   if (!iascii) { SETERRQ(PETSC_COMM_SELF, 1,"Only ASCII viewer for EnthalpyConverter\n"); }
@@ -78,22 +82,6 @@ PetscErrorCode EnthalpyConverter::viewConstants(PetscViewer viewer) const {
 }
 
 
-//! Get pressure in ice from depth below surface using the hydrostatic assumption.
-/*! If \f$d\f$ is the depth then
-     \f[ p = p_{\text{air}}  + \rho_i g d. \f]
-Frequently \f$d\f$ is computed from the thickess minus a level in the ice, 
-something like "H[i][j] - z[k]".  The input depth to this routine is allowed to
-be negative, representing a position above the surface of the ice.
- */ 
-double EnthalpyConverter::getPressureFromDepth(double depth) const {
-  if (depth <= 0.0) { // at or above surface of ice
-    return p_air;
-  } else {
-    return p_air + rho_i * g * depth;
-  }
-}
-
-
 //! Get melting temperature from pressure p.
 /*!
      \f[ T_m(p) = T_{melting} - \beta p. \f]
@@ -322,3 +310,94 @@ PetscErrorCode EnthalpyConverter::getEnthAtWaterFraction(
   return 0;
 }
 
+
+//! Get absolute ice temperatures (K) at levels z[0], ..., z[n-1] of an ice column.
+/*!
+Uses the hydrostatic pressure (see getPressureFromDepth()) and computes
+\f$T(E,p)\f$ as in getAbsTemp(), without making virtual calls for each level.
+
+Returns 1 if the enthalpy at any of these levels equals or exceeds that of
+liquid water.  The temperature at such a level is set to \f$T_m(p)\f$.
+ */
+PetscErrorCode EnthalpyConverter::getAbsTempColumn(const double *E, double thickness,
+                                                   const double *z, int n, double *T) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      T_m = T_melting - beta * p,
+      E_s = c_i * (T_m - T_0);
+
+    if (E[k] < E_s) {
+      T[k] = (E[k] / c_i) + T_0;
+    } else {
+      T[k] = T_m;
+      if (E[k] >= E_s + L)
+        result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Get pressure-adjusted ice temperatures (K) at levels z[0], ..., z[n-1] of an ice column.
+/*!
+See getPATemp() and getAbsTempColumn().
+ */
+PetscErrorCode EnthalpyConverter::getPATempColumn(const double *E, double thickness,
+                                                  const double *z, int n, double *T_pa) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      T_m = T_melting - beta * p,
+      E_s = c_i * (T_m - T_0);
+
+    if (E[k] < E_s) {
+      T_pa[k] = (E[k] / c_i) + T_0 - T_m + T_melting;
+    } else {
+      T_pa[k] = T_melting;
+      if (E[k] >= E_s + L)
+        result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Get liquid water fractions at levels z[0], ..., z[n-1] of an ice column.
+/*!
+See getWaterFraction() and getAbsTempColumn().
+ */
+PetscErrorCode EnthalpyConverter::getWaterFractionColumn(const double *E, double thickness,
+                                                         const double *z, int n, double *omega) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      E_s = c_i * (T_melting - beta * p - T_0);
+
+    if (E[k] <= E_s) {
+      omega[k] = 0.0;
+    } else if (E[k] < E_s + L) {
+      omega[k] = (E[k] - E_s) / L;
+    } else {
+      omega[k] = 1.0;
+      result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Get enthalpies E_s(p) at the cold-temperate transition at levels z[0], ..., z[n-1] of an ice column.
+/*!
+See getEnthalpyCTS().
+ */
+void EnthalpyConverter::getEnthalpyCTSColumn(double thickness, const double *z, int n,
+                                             double *E_s) const {
+  for (int k = 0; k < n; ++k) {
+    const double p = getPressureFromDepth(thickness - z[k]); // FIXME issue #15
+    E_s[k] = c_i * (T_melting - beta * p - T_0);
+  }
+}
@@ -52,6 +52,21 @@ The three methods that get the enthalpy from temperatures and liquid fractions,
 namely getEnth(), getEnthPermissive(), getEnthAtWaterFraction(), are more strict
 about error checking.  They call SETERRQ() if their arguments are invalid.
 
+Column methods getAbsTempColumn(), getPATempColumn(), getWaterFractionColumn()
+and getEnthalpyCTSColumn() compute the same quantities at all levels of an ice
+column (using the hydrostatic pressure) at the cost of one virtual call per
+column.  Derived classes re-implementing point-wise methods should
+re-implement these, too.  Use them in loops over all the levels of a column.
+
+Value-returning point-wise methods melting_temperature(), enthalpy_cts(),
+temperature(), pa_temperature(), water_fraction(), is_temperate() and
+enthalpy_permissive() are inline: for this (default) converter they do not
+make a virtual call, and for derived classes they call the virtual methods
+above.  They do no error checking (liquid water gets \f$T_m(p)\f$ and
+\f$\omega = 1\f$), so use them where errors are ignored anyway, for example in
+flow laws.  Derived classes re-implementing point-wise methods have to set
+\c inline_pointwise to false.
+
 This class is documented by [\ref AschwandenBuelerKhroulevBlatter].
 */
 class EnthalpyConverter {
@@ -61,7 +76,21 @@ public:
 
   virtual PetscErrorCode viewConstants(PetscViewer viewer) const;
 
-  virtual double         getPressureFromDepth(double depth) const;
+  //! Get pressure in ice from depth below surface using the hydrostatic assumption.
+  /*! If \f$d\f$ is the depth then
+        \f[ p = p_{\text{air}}  + \rho_i g d. \f]
+    Frequently \f$d\f$ is computed from the thickess minus a level in the ice,
+    something like "H[i][j] - z[k]".  The input depth to this routine is allowed to
+    be negative, representing a position above the surface of the ice.
+  */
+  inline double getPressureFromDepth(double depth) const {
+    if (depth <= 0.0) { // at or above surface of ice
+      return p_air;
+    } else {
+      return p_air + rho_i * g * depth;
+    }
+  }
+
   virtual double         getMeltingTemp(double p) const;
   virtual double         getEnthalpyCTS(double p) const;
   virtual PetscErrorCode getEnthalpyInterval(double p, double &E_s, double &E_l) const;
@@ -79,13 +108,97 @@ public:
   virtual PetscErrorCode getEnthPermissive(double T, double omega, double p, double &E) const;
   virtual PetscErrorCode getEnthAtWaterFraction(double omega, double p, double &E) const;
 
+  virtual PetscErrorCode getAbsTempColumn(const double *E, double thickness,
+                                          const double *z, int n, double *T) const;
+  virtual PetscErrorCode getPATempColumn(const double *E, double thickness,
+                                         const double *z, int n, double *T_pa) const;
+  virtual PetscErrorCode getWaterFractionColumn(const double *E, double thickness,
+                                                const double *z, int n, double *omega) const;
+  virtual void           getEnthalpyCTSColumn(double thickness, const double *z, int n,
+                                              double *E_s) const;
+
   virtual PetscReal c_from_T(PetscReal /*T*/)
   { return c_i; }
 
+  //! Melting temperature (see getMeltingTemp()).
+  inline double melting_temperature(double p) const {
+    if (inline_pointwise)
+      return T_melting - beta * p;
+    return getMeltingTemp(p);
+  }
+
+  //! Enthalpy at the cold-temperate transition (see getEnthalpyCTS()).
+  inline double enthalpy_cts(double p) const {
+    if (inline_pointwise)
+      return c_i * (T_melting - beta * p - T_0);
+    return getEnthalpyCTS(p);
+  }
+
+  //! Absolute temperature (see getAbsTemp()).
+  inline double temperature(double E, double p) const {
+    if (inline_pointwise) {
+      const double T_m = T_melting - beta * p;
+      return (E < c_i * (T_m - T_0)) ? (E / c_i) + T_0 : T_m;
+    }
+    double T;
+    getAbsTemp(E, p, T);
+    return T;
+  }
+
+  //! Pressure-adjusted temperature (see getPATemp()).
+  inline double pa_temperature(double E, double p) const {
+    if (inline_pointwise) {
+      const double T_m = T_melting - beta * p;
+      return (E < c_i * (T_m - T_0)) ? (E / c_i) + T_0 - T_m + T_melting : T_melting;
+    }
+    double T_pa;
+    getPATemp(E, p, T_pa);
+    return T_pa;
+  }
+
+  //! Liquid water fraction (see getWaterFraction()).
+  inline double water_fraction(double E, double p) const {
+    if (inline_pointwise) {
+      const double E_s = c_i * (T_melting - beta * p - T_0);
+      if (E <= E_s)
+        return 0.0;
+      return (E < E_s + L) ? (E - E_s) / L : 1.0;
+    }
+    double omega;
+    getWaterFraction(E, p, omega);
+    return omega;
+  }
+
+  //! Checks if ice is temperate (see isTemperate()).
+  inline bool is_temperate(double E, double p) const {
+    if (inline_pointwise) {
+      if (do_cold_ice_methods)
+        return (pa_temperature(E, p) >= T_melting - T_tol);
+      return (E >= c_i * (T_melting - beta * p - T_0));
+    }
+    return isTemperate(E, p);
+  }
+
+  //! Enthalpy from temperature and liquid water fraction (see getEnthPermissive()).
+  inline double enthalpy_permissive(double T, double omega, double p) const {
+    if (inline_pointwise) {
+      const double T_m = T_melting - beta * p;
+      if (T < T_m)
+        return c_i * (T - T_0);
+      return c_i * (T_m - T_0) + PetscMax(0.0, PetscMin(omega, 1.0)) * L;
+    }
+    double E;
+    getEnthPermissive(T, omega, p, E);
+    return E;
+  }
+
 protected:
   double T_melting, L, c_i, rho_i, g, p_air, beta, T_tol;
   double T_0;
   bool   do_cold_ice_methods;
+  bool   inline_pointwise;      //!< true if value-returning point-wise methods
+                                //!< can skip virtual calls
+  MPI_Comm com;                 //!< communicator used by viewConstants()
 };
 
 
@@ -103,6 +216,7 @@ class ICMEnthalpyConverter : public EnthalpyConverter {
 public:
   ICMEnthalpyConverter(const NCConfigVariable &config) : EnthalpyConverter(config) {
     do_cold_ice_methods = true;
+    inline_pointwise = false;
   }
 
   virtual ~ICMEnthalpyConverter() {}
@@ -144,6 +258,34 @@ public:
   /*! */
   virtual bool isTemperate(double /*E*/, double /*p*/) const {
     return false; }
+
+  /*! */
+  virtual PetscErrorCode getAbsTempColumn(const double *E, double /*thickness*/,
+                                          const double * /*z*/, int n, double *T) const {
+    for (int k = 0; k < n; ++k)
+      T[k] = (E[k] / c_i) + T_0;
+    return 0; }
+
+  /*! The pressure-melting temperature does not depend on pressure, so
+    \f$T_{pa} = T\f$. */
+  virtual PetscErrorCode getPATempColumn(const double *E, double thickness,
+                                         const double *z, int n, double *T_pa) const {
+    return getAbsTempColumn(E, thickness, z, n, T_pa); }
+
+  /*! */
+  virtual PetscErrorCode getWaterFractionColumn(const double * /*E*/, double /*thickness*/,
+                                                const double * /*z*/, int n, double *omega) const {
+    for (int k = 0; k < n; ++k)
+      omega[k] = 0.0;
+    return 0; }
+
+  /*! */
+  virtual void getEnthalpyCTSColumn(double /*thickness*/, const double * /*z*/, int n,
+                                    double *E_s) const {
+    const double E = c_i * (T_melting - T_0);
+    for (int k = 0; k < n; ++k)
+      E_s[k] = E;
+  }
 };
 
 
@@ -55,9 +55,9 @@ PetscErrorCode  IceModel::writeFiles(string default_filename) {
 
   ierr = PetscOptionsBegin(grid.com, "", "PISM output options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-o", "Output file name", filename, o_set); CHKERRQ(ierr);
-    ierr = PISMOptionsString("-dump_config", "File to write the config to",
-			     config_out, dump_config); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-o", "Output file name", filename, o_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-dump_config", "File to write the config to",
+          			     config_out, dump_config); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -409,18 +409,24 @@ PetscErrorCode IceModel::initFromFile(string filename) {
   ierr = nc.inq_nrecords(last_record); CHKERRQ(ierr); 
   last_record -= 1;
 
+  // Read fields stored in a binary checkpoint (if this is one; see
+  // IceModel::write_binary_checkpoint()):
+  set<string> binary_vars;
+  ierr = read_binary_checkpoint(nc, filename, binary_vars); CHKERRQ(ierr);
+
   // Read the model state, mapping and climate_steady variables:
   set<string> vars = variables.keys();
 
   set<string>::iterator i = vars.begin();
   while (i != vars.end()) {
-    IceModelVec *var = variables.get(*i++);
+    IceModelVec *var = variables.get(*i);
 
     string intent = var->string_attr("pism_intent");
-    if ((intent == "model_state") || (intent == "mapping") ||
-        (intent == "climate_steady")) {
+    if (((intent == "model_state") || (intent == "mapping") ||
+         (intent == "climate_steady")) && set_contains(binary_vars, *i) == false) {
       ierr = var->read(filename, last_record); CHKERRQ(ierr);
     }
+    ++i;
   }
 
   if (config.get_flag("do_cold_ice_methods")) {
@@ -429,7 +435,7 @@ PetscErrorCode IceModel::initFromFile(string filename) {
     ierr = compute_enthalpy_cold(T3, Enth3); CHKERRQ(ierr);
   }
 
-  if (config.get_flag("do_age")) {
+  if (config.get_flag("do_age") && set_contains(binary_vars, "age") == false) {
     bool age_exists;
     ierr = nc.inq_var("age", age_exists); CHKERRQ(ierr);
 
@@ -524,11 +530,11 @@ PetscErrorCode IceModel::initFromFile(string filename) {
     ierr = PetscOptionsBegin(grid.com, PETSC_NULL, "Options controlling regridding",
                              PETSC_NULL); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString("-regrid_file", "Specifies the file to regrid from",
-                               filename, regrid_file_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-regrid_file", "Specifies the file to regrid from",
+                                         filename, regrid_file_set); CHKERRQ(ierr);
 
-      ierr = PISMOptionsStringArray("-regrid_vars", "Specifies the list of variables to regrid",
-                                    "", vars_vector, regrid_vars_set); CHKERRQ(ierr);
+      ierr = PISMOptionsStringArray(grid.com, "-regrid_vars", "Specifies the list of variables to regrid",
+                                              "", vars_vector, regrid_vars_set); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -604,11 +610,11 @@ PetscErrorCode IceModel::init_snapshots() {
 
   ierr = PetscOptionsBegin(grid.com, "", "Options controlling the snapshot-saving mechanism", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-save_file", "Specifies a snapshot filename",
-                             snapshots_filename, save_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-save_file", "Specifies a snapshot filename",
+                                       snapshots_filename, save_file_set); CHKERRQ(ierr);
 
-    ierr = PISMOptionsString("-save_times", "Gives a list or a MATLAB-style range of times to save snapshots at",
-                             tmp, save_times_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-save_times", "Gives a list or a MATLAB-style range of times to save snapshots at",
+                                       tmp, save_times_set); CHKERRQ(ierr);
 
     ierr = PISMOptionsIsSet("-save_split", "Specifies whether to save snapshots to separate files",
                             split); CHKERRQ(ierr);
@@ -756,14 +762,14 @@ PetscErrorCode IceModel::init_snapshots() {
 
     ierr = PetscOptionsBegin(grid.com, "", "PISM output options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString("-o", "Output file name", backup_filename, o_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-o", "Output file name", backup_filename, o_set); CHKERRQ(ierr);
       if (!o_set)
         backup_filename = executable_short_name + "_backup.nc";
       else
         backup_filename = pism_filename_add_suffix(backup_filename, "_backup", "");
 
-      ierr = PISMOptionsReal("-backup_interval", "Automatic backup interval, hours",
-                             backup_interval, o_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(grid.com, "-backup_interval", "Automatic backup interval, hours",
+                                       backup_interval, o_set); CHKERRQ(ierr);
 
       ierr = set_output_size("-backup_size", "Sets the 'size' of a backup file.",
                              "small", backup_vars); CHKERRQ(ierr);
@@ -775,6 +781,33 @@ PetscErrorCode IceModel::init_snapshots() {
     return 0;
   }
 
+//! \brief Renames a binary checkpoint file (if it exists).
+/*!
+ * Only processor 0 does the renaming; other processors wait for it to finish.
+ */
+static PetscErrorCode move_binary_checkpoint(MPI_Comm com, PetscMPIInt rank,
+                                             string from, string to) {
+  PetscErrorCode ierr;
+
+  if (rank == 0) {
+    bool exists = false;
+    if (FILE *f = fopen(from.c_str(), "r")) {
+      fclose(f);
+      exists = true;
+    }
+
+    if (exists && rename(from.c_str(), to.c_str()) != 0) {
+      ierr = PetscPrintf(PETSC_COMM_SELF, "PISM ERROR: can't move '%s' to '%s'.\n",
+                         from.c_str(), to.c_str()); CHKERRQ(ierr);
+      PISMEnd();
+    }
+  }
+
+  ierr = MPI_Barrier(com); CHKERRQ(ierr);
+
+  return 0;
+}
+
   //! Write a backup (i.e. an intermediate result of a run).
 PetscErrorCode IceModel::write_backup() {
   PetscErrorCode ierr;
@@ -811,6 +844,12 @@ PetscErrorCode IceModel::write_backup() {
 
   // write metadata:
   ierr = nc.open(backup_filename, PISM_WRITE); CHKERRQ(ierr);
+  if (config.get_string("backup_format") == "binary") {
+    // nc.open() moved the previous manifest to backup_filename + "~"; move
+    // the binary file it refers to as well.
+    ierr = move_binary_checkpoint(grid.com, grid.rank, backup_filename + ".bin",
+                                  backup_filename + "~.bin"); CHKERRQ(ierr);
+  }
   ierr = nc.def_time(config.get_string("time_dimension_name"),
                      config.get_string("calendar"),
                      grid.time->CF_units()); CHKERRQ(ierr);
@@ -820,7 +859,11 @@ PetscErrorCode IceModel::write_backup() {
   // Write metadata *before* variables:
   ierr = write_metadata(backup_filename); CHKERRQ(ierr);
 
-  ierr = write_variables(backup_filename, backup_vars, PISM_DOUBLE); CHKERRQ(ierr);
+  if (config.get_string("backup_format") == "binary") {
+    ierr = write_binary_checkpoint(backup_filename, backup_vars); CHKERRQ(ierr);
+  } else {
+    ierr = write_variables(backup_filename, backup_vars, PISM_DOUBLE); CHKERRQ(ierr);
+  }
 
   // Also flush time-series:
   ierr = flush_timeseries(); CHKERRQ(ierr);
@@ -830,3 +873,151 @@ PetscErrorCode IceModel::write_backup() {
   return 0;
 }
 
+//! \brief Opens a PETSc binary file used by binary checkpoints, using MPI-IO
+//! if it is available.
+static PetscErrorCode open_binary_checkpoint(MPI_Comm com, string filename,
+                                             PetscFileMode mode, PetscViewer &viewer) {
+  PetscErrorCode ierr;
+
+  ierr = PetscViewerCreate(com, &viewer); CHKERRQ(ierr);
+  ierr = PetscViewerSetType(viewer, PETSCVIEWERBINARY); CHKERRQ(ierr);
+  ierr = PetscViewerBinarySkipInfo(viewer); CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPIIO)
+  ierr = PetscViewerBinarySetMPIIO(viewer); CHKERRQ(ierr);
+#endif
+  ierr = PetscViewerFileSetMode(viewer, mode); CHKERRQ(ierr);
+  ierr = PetscViewerFileSetName(viewer, filename.c_str()); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Writes variables listed in \c vars as a binary checkpoint.
+/*!
+ * A binary checkpoint consists of two files:
+ *
+ * - \c filename (the "manifest"), a NetCDF file containing metadata, the
+ *   time, variables of sub-models (bedrock thermal unit, yield stress,
+ *   boundary models, ...) and diagnostic quantities. Fields stored in the
+ *   binary file are \e defined in it (so that the grid can be read from
+ *   the manifest) but not written. The global attribute \c
+ *   pism_binary_checkpoint lists these fields in the order they are stored.
+ *
+ * - \c filename.bin, a PETSc binary file with values of all the IceModel
+ *   variables in \c vars. It is written using collective MPI-IO (if PETSc
+ *   was built with MPI-IO support) in the natural ordering, so it can be
+ *   read using any number of processors, but only using the same grid.
+ *   It is written to \c filename.bin.tmp first and renamed when complete.
+ *   When write_backup() moves an old manifest to \c filename~, it moves
+ *   the old binary file to \c filename~.bin.
+ *
+ * The binary file contains raw values in SI units, so writing it takes
+ * about as long as it takes to move the data to disk.
+ *
+ * Use the manifest as an input file (\c -i) to restart; see
+ * read_binary_checkpoint().
+ *
+ * The manifest has to be prepared (see write_backup()) before this is
+ * called.
+ */
+PetscErrorCode IceModel::write_binary_checkpoint(string filename, set<string> vars) {
+  PetscErrorCode ierr;
+  vector<IceModelVec*> binary_vars;
+  string names;
+
+  set<string>::iterator i = vars.begin();
+  while (i != vars.end()) {
+    IceModelVec *v = variables.get(*i);
+
+    if (v == NULL) {
+      ++i;
+    } else {
+      binary_vars.push_back(v);
+      names += *i + " ";
+
+      vars.erase(i++);
+    }
+  }
+
+  // Define fields stored in the binary file and list them in the manifest:
+  {
+    string output_format = grid.config.get_string("output_format");
+    // See the comment in IceModel::write_variables().
+    if (output_format == "pnetcdf")
+      output_format = "netcdf3";
+
+    PIO nc(grid.com, grid.rank, output_format);
+    ierr = nc.open(filename, PISM_WRITE, true); CHKERRQ(ierr);
+
+    for (unsigned int k = 0; k < binary_vars.size(); ++k) {
+      ierr = binary_vars[k]->define(nc, PISM_DOUBLE); CHKERRQ(ierr);
+    }
+
+    ierr = nc.put_att_text("PISM_GLOBAL", "pism_binary_checkpoint", names); CHKERRQ(ierr);
+    ierr = nc.close(); CHKERRQ(ierr);
+  }
+
+  // Write to a temporary file and move it into place once it is complete, so
+  // that an interrupted write does not leave a truncated checkpoint.
+  PetscViewer viewer;
+  ierr = open_binary_checkpoint(grid.com, filename + ".bin.tmp", FILE_MODE_WRITE, viewer); CHKERRQ(ierr);
+
+  for (unsigned int k = 0; k < binary_vars.size(); ++k) {
+    ierr = binary_vars[k]->write_binary(viewer); CHKERRQ(ierr);
+  }
+
+  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+  ierr = move_binary_checkpoint(grid.com, grid.rank, filename + ".bin.tmp",
+                                filename + ".bin"); CHKERRQ(ierr);
+
+  // Everything else goes into the manifest:
+  ierr = write_variables(filename, vars, PISM_DOUBLE); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Reads fields stored in a binary checkpoint written by
+//! write_binary_checkpoint().
+/*!
+ * Does nothing if \c filename (opened using \c nc) is not a binary checkpoint
+ * manifest. Otherwise reads all the fields from \c filename.bin and sets
+ * \c result to the set of their names. Other variables are read from the
+ * manifest as usual.
+ */
+PetscErrorCode IceModel::read_binary_checkpoint(const PIO &nc, string filename, set<string> &result) {
+  PetscErrorCode ierr;
+  string names, name;
+
+  result.clear();
+
+  ierr = nc.get_att_text("PISM_GLOBAL", "pism_binary_checkpoint", names); CHKERRQ(ierr);
+  if (names.empty())
+    return 0;
+
+  ierr = verbPrintf(2, grid.com, "  reading model state from the binary checkpoint '%s.bin'...\n",
+                    filename.c_str()); CHKERRQ(ierr);
+
+  PetscViewer viewer;
+  ierr = open_binary_checkpoint(grid.com, filename + ".bin", FILE_MODE_READ, viewer); CHKERRQ(ierr);
+
+  // Fields have to be read in the order they were written:
+  istringstream arg(names);
+  while (arg >> name) {
+    IceModelVec *v = variables.get(name);
+
+    if (v == NULL) {
+      PetscPrintf(grid.com,
+                  "PISM ERROR: binary checkpoint '%s' contains '%s', which is not used by this run.\n"
+                  "            Binary checkpoints can only be read using the same model configuration.\n",
+                  filename.c_str(), name.c_str());
+      PISMEnd();
+    }
+
+    ierr = v->read_binary(viewer); CHKERRQ(ierr);
+    result.insert(name);
+  }
+
+  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+  return 0;
+}
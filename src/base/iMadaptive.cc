@@ -151,6 +151,10 @@ PetscErrorCode IceModel::adaptTimeStepDiffusivity() {
           gridfactor = 1.0/(grid.dx*grid.dx) + 1.0/(grid.dy*grid.dy);
   dt_from_diffus = adaptTimeStepRatio
                      * 2 / ((gDmax + DEFAULT_ADDED_TO_GDMAX_ADAPT) * gridfactor);
+  // The semi-implicit scheme is stable for larger time steps; see
+  // IceModel::diffusive_flux_implicit().
+  if (config.get_flag("mass_continuity_implicit"))
+    dt_from_diffus *= config.get("mass_continuity_implicit_dt_factor");
   if (do_skip && (skipCountDown == 0)) {
     const PetscScalar  conservativeFactor = 0.95;
     // typically "dt" in next line is from CFL for advection in temperature equation,
@@ -197,6 +201,12 @@ PetscErrorCode IceModel::determineTimeStep(const bool doTemperatureCFL) {
     if ((do_energy == PETSC_TRUE) && (doTemperatureCFL == PETSC_TRUE)) {
       // CFLmaxdt is set by computeMax3DVelocities() in call to velocity() iMvelocity.cc
       dt_from_cfl = CFLmaxdt;
+      // The semi-lagrangian horizontal advection scheme (enthalpy and age)
+      // allows displacements up to semi_lagrangian_cfl_factor grid cells (the
+      // halo of Enth3 and tau3 is sized accordingly; see createVecs()).
+      if (config.get_flag("semi_lagrangian_advection") &&
+          config.get_flag("do_cold_ice_methods") == false)
+        dt_from_cfl *= config.get("semi_lagrangian_cfl_factor");
       if (dt_from_cfl < dt) {
         dt = dt_from_cfl;
         adaptReasonFlag = 'c';
@@ -256,14 +266,34 @@ solved by IceModel::ageStep() and the advection, ice-only part of the problem so
 temperatureStep().  These methods use a fine vertical grid, and so we consider CFL
 violations on that same fine grid. (FIXME: should we actually use the fine grid?)
 
+If semi-Lagrangian advection is used, also counts (in \c clipped) points with
+horizontal displacements that do not fit in the halo of Enth3. Departure points
+of these are moved to the edge of the ghosted sub-domain (see
+IceModelVec3::getValDeparture_fine()), so results are wrong there.
+
 Communication is needed to determine total CFL violation count over entire grid.
 It is handled by temperatureAgeStep(), not here.
 */
-PetscErrorCode IceModel::countCFLViolations(PetscScalar* CFLviol) {
+PetscErrorCode IceModel::countCFLViolations(PetscScalar* CFLviol, PetscScalar* clipped) {
   PetscErrorCode  ierr;
 
-  const PetscScalar cflx = grid.dx / dt_TempAge,
-                    cfly = grid.dy / dt_TempAge;
+  PetscScalar cflx = grid.dx / dt_TempAge,
+              cfly = grid.dy / dt_TempAge;
+
+  // See determineTimeStep().
+  if (config.get_flag("semi_lagrangian_advection") &&
+      config.get_flag("do_cold_ice_methods") == false) {
+    cflx *= config.get("semi_lagrangian_cfl_factor");
+    cfly *= config.get("semi_lagrangian_cfl_factor");
+  }
+
+  // Largest speeds semi-Lagrangian departure points can handle (zero: don't
+  // count).
+  PetscScalar halo_u = 0.0, halo_v = 0.0;
+  if (config.get_flag("semi_lagrangian_advection")) {
+    halo_u = Enth3.get_stencil_width() * grid.dx / dt_TempAge;
+    halo_v = Enth3.get_stencil_width() * grid.dy / dt_TempAge;
+  }
 
   PetscScalar *u, *v;
   IceModelVec3 *u3, *v3, *dummy;
@@ -284,6 +314,8 @@ PetscErrorCode IceModel::countCFLViolations(PetscScalar* CFLviol) {
       for (PetscInt k=0; k<=fks; k++) {
         if (PetscAbs(u[k]) > cflx)  *CFLviol += 1.0;
         if (PetscAbs(v[k]) > cfly)  *CFLviol += 1.0;
+        if (halo_u > 0.0 &&
+            (PetscAbs(u[k]) > halo_u || PetscAbs(v[k]) > halo_v))  *clipped += 1.0;
       }
     }
   }
@@ -23,6 +23,7 @@
 #include "pism_signal.h"
 #include "Mask.hh"
 #include "PISMOcean.hh"
+#include "PISMHaloSweep.hh"
 
 
 //! \file iMcalving.cc Methods implementing PIK options -eigen_calving and -calving_at_thickness [\ref Winkelmannetal2011].
@@ -75,11 +76,12 @@ PetscErrorCode IceModel::eigenCalving() {
   // Distance (grid cells) from calving front where strain rate is evaluated
   PetscInt offset = 2;
 
-  MaskQuery mask(vMask);
+  // vMask is read-only here (and is looked up up to offset + 1 cells away)
+  ierr = vMaskCompact.update(vMask); CHKERRQ(ierr);
+  CompactMaskQuery mask(vMaskCompact);
 
   ierr = vH.begin_access(); CHKERRQ(ierr);
   ierr = vHnew.begin_access(); CHKERRQ(ierr);
-  ierr = vMask.begin_access(); CHKERRQ(ierr);
   ierr = vbed.begin_access(); CHKERRQ(ierr);
   ierr = vHref.begin_access(); CHKERRQ(ierr);
   ierr = vPrinStrain1.begin_access(); CHKERRQ(ierr);
@@ -184,41 +186,45 @@ PetscErrorCode IceModel::eigenCalving() {
   }
   ierr = vDiffCalvRate.end_access(); CHKERRQ(ierr);
 
-  ierr = vDiffCalvRate.beginGhostComm(); CHKERRQ(ierr);
-  ierr = vDiffCalvRate.endGhostComm(); CHKERRQ(ierr);
+  PISMHaloSweep sweep(grid, 1);
+  sweep.add(vDiffCalvRate);
+  ierr = sweep.begin(); CHKERRQ(ierr);
 
   ierr = vDiffCalvRate.begin_access(); CHKERRQ(ierr);
-  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
-    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+  for (int b = 0; b < PISMHaloSweep::N_BLOCKS; ++b) {
+    PetscInt xs, xm, ys, ym;
+    ierr = sweep.block(b, xs, xm, ys, ym); CHKERRQ(ierr);
+    for (PetscInt i = xs; i < xs + xm; ++i) {
+      for (PetscInt j = ys; j < ys + ym; ++j) {
 
-      PetscScalar restCalvRate = 0.0;
-      bool hereFloating = (vH(i, j) > 0.0 && (vbed(i, j) < (sea_level - ice_rho / ocean_rho*vH(i, j))));
+        PetscScalar restCalvRate = 0.0;
+        bool hereFloating = (vH(i, j) > 0.0 && (vbed(i, j) < (sea_level - ice_rho / ocean_rho*vH(i, j))));
 
-      if (hereFloating &&
-          (vDiffCalvRate(i + 1, j) > 0.0 || vDiffCalvRate(i - 1, j) > 0.0 ||
-           vDiffCalvRate(i, j + 1) > 0.0 || vDiffCalvRate(i, j - 1) > 0.0 )) {
+        if (hereFloating &&
+            (vDiffCalvRate(i + 1, j) > 0.0 || vDiffCalvRate(i - 1, j) > 0.0 ||
+             vDiffCalvRate(i, j + 1) > 0.0 || vDiffCalvRate(i, j - 1) > 0.0 )) {
 
-        restCalvRate = (vDiffCalvRate(i + 1, j) +
-                        vDiffCalvRate(i - 1, j) +
-                        vDiffCalvRate(i, j + 1) +
-                        vDiffCalvRate(i, j - 1));     // in m/s
+          restCalvRate = (vDiffCalvRate(i + 1, j) +
+                          vDiffCalvRate(i - 1, j) +
+                          vDiffCalvRate(i, j + 1) +
+                          vDiffCalvRate(i, j - 1));     // in m/s
 
-        vHref(i, j) = vH(i, j) - (restCalvRate * dt); // in m
+          vHref(i, j) = vH(i, j) - (restCalvRate * dt); // in m
 
-        vHnew(i, j) = 0.0;
+          vHnew(i, j) = 0.0;
 
-        if(vHref(i, j) < 0.0) { // i.e. terminal floating ice grid cell has calved off completely.
-          // We do not account for further calving ice-inwards!
-          // Alternatively CFL criterion for time stepping could be adjusted to maximum of calving rate.
-          // ierr = verbPrintf(2, grid.com, "!!!!! calving front would even retreat further at point %d, %d with volume %.2f \n",i,j,-vHref(i, j));    CHKERRQ(ierr);
-          vHref(i, j) = 0.0;
+          if(vHref(i, j) < 0.0) { // i.e. terminal floating ice grid cell has calved off completely.
+            // We do not account for further calving ice-inwards!
+            // Alternatively CFL criterion for time stepping could be adjusted to maximum of calving rate.
+            // ierr = verbPrintf(2, grid.com, "!!!!! calving front would even retreat further at point %d, %d with volume %.2f \n",i,j,-vHref(i, j));    CHKERRQ(ierr);
+            vHref(i, j) = 0.0;
+          }
         }
       }
     }
   }
   ierr = vHnew.end_access(); CHKERRQ(ierr);
   ierr = vH.end_access(); CHKERRQ(ierr);
-  ierr = vMask.end_access(); CHKERRQ(ierr);
   ierr = vbed.end_access(); CHKERRQ(ierr);
   ierr = vHref.end_access(); CHKERRQ(ierr);
   ierr = vPrinStrain1.end_access(); CHKERRQ(ierr);
@@ -337,10 +343,10 @@ PetscErrorCode IceModel::dt_from_eigenCalving() {
   PetscScalar my_maxCalvingRate=0.0, my_meancalvrate=0.0, my_cratecounter=0.0;
   PetscInt i0=0, j0=0;
 
-  MaskQuery mask(vMask);
+  ierr = vMaskCompact.update(vMask); CHKERRQ(ierr);
+  CompactMaskQuery mask(vMaskCompact);
 
   ierr = vH.begin_access(); CHKERRQ(ierr);
-  ierr = vMask.begin_access(); CHKERRQ(ierr);
   ierr = vbed.begin_access(); CHKERRQ(ierr);
   ierr = vPrinStrain1.begin_access(); CHKERRQ(ierr);
   ierr = vPrinStrain2.begin_access(); CHKERRQ(ierr);
@@ -409,7 +415,6 @@ PetscErrorCode IceModel::dt_from_eigenCalving() {
   }
 
   ierr = vH.end_access(); CHKERRQ(ierr);
-  ierr = vMask.end_access(); CHKERRQ(ierr);
   ierr = vbed.end_access(); CHKERRQ(ierr);
   ierr = vPrinStrain1.end_access(); CHKERRQ(ierr);
   ierr = vPrinStrain2.end_access(); CHKERRQ(ierr);
@@ -39,17 +39,21 @@ do_cold_ice_methods == true, then energyStep() must also update this field
 
 Normally calls the method enthalpyAndDrainageStep().  Calls temperatureStep() if
 do_cold_ice_methods == true.
+
+If \c age_in_energy_step is set, enthalpyAndDrainageStep() also puts new age
+values in vWork3dAge; they are copied to tau3 here.
  */
 PetscErrorCode IceModel::energyStep() {
   PetscErrorCode  ierr;
 
   PetscScalar  myCFLviolcount = 0.0,   // these are counts but they are type "PetscScalar"
                myVertSacrCount = 0.0,  //   because that type works with PISMGlobalSum()
-               myBulgeCount = 0.0;
-  PetscScalar gVertSacrCount, gBulgeCount;
+               myBulgeCount = 0.0,
+               myClippedCount = 0.0;
+  PetscScalar gVertSacrCount, gBulgeCount, gClippedCount;
 
   // always count CFL violations for sanity check (but can occur only if -skip N with N>1)
-  ierr = countCFLViolations(&myCFLviolcount); CHKERRQ(ierr);
+  ierr = countCFLViolations(&myCFLviolcount, &myClippedCount); CHKERRQ(ierr);
 
   // operator-splitting occurs here (ice and bedrock energy updates are split):
   //   tell PISMBedThermalUnit* btu that we have an ice base temp; it will return
@@ -78,7 +82,13 @@ PetscErrorCode IceModel::energyStep() {
        CHKERRQ(ierr);
 
     ierr = Enth3.beginGhostCommTransfer(vWork3d); CHKERRQ(ierr);
+    if (age_in_energy_step) {
+      ierr = tau3.beginGhostCommTransfer(vWork3dAge); CHKERRQ(ierr);
+    }
     ierr = Enth3.endGhostCommTransfer(vWork3d); CHKERRQ(ierr);
+    if (age_in_energy_step) {
+      ierr = tau3.endGhostCommTransfer(vWork3dAge); CHKERRQ(ierr);
+    }
 
     ierr = PISMGlobalSum(&myLiquifiedVol, &gLiquifiedVol, grid.com); CHKERRQ(ierr);
     if (gLiquifiedVol > 0.0) {
@@ -95,6 +105,14 @@ PetscErrorCode IceModel::energyStep() {
 
   ierr = PISMGlobalSum(&myCFLviolcount, &CFLviolcount, grid.com); CHKERRQ(ierr);
 
+  ierr = PISMGlobalSum(&myClippedCount, &gClippedCount, grid.com); CHKERRQ(ierr);
+  if (gClippedCount > 0.0) {
+    ierr = verbPrintf(1, grid.com,
+      "\n PISM WARNING: %.0f semi-Lagrangian departure points are outside the halo\n"
+      "  of enthalpy and age and were clipped (try a larger -semi_lagrangian_cfl)\n\n",
+      gClippedCount); CHKERRQ(ierr);
+  }
+
   ierr = PISMGlobalSum(&myVertSacrCount, &gVertSacrCount, grid.com); CHKERRQ(ierr);
   if (gVertSacrCount > 0.0) { // count of when BOMBPROOF switches to lower accuracy
     const PetscScalar bfsacrPRCNT = 100.0 * (gVertSacrCount / (grid.Mx * grid.My));
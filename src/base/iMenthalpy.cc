@@ -18,6 +18,7 @@
 
 #include "iceModel.hh"
 #include "enthSystem.hh"
+#include "ageSystem.hh"
 #include "varenthSystem.hh"
 #include "DrainageCalculator.hh"
 #include "Mask.hh"
@@ -27,6 +28,7 @@
 #include "bedrockThermalUnit.hh"
 #include "enthalpyConverter.hh"
 #include "pism_options.hh"
+#include "pism_threads.hh"
 
 //! \file iMenthalpy.cc Methods of IceModel which implement the enthalpy formulation of conservation of energy.
 
@@ -134,11 +136,8 @@ PetscErrorCode IceModel::compute_liquid_water_fraction(IceModelVec3 &enthalpy,
     for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
       ierr = result.getInternalColumn(i,j,&omegaij); CHKERRQ(ierr);
       ierr = enthalpy.getInternalColumn(i,j,&Enthij); CHKERRQ(ierr);
-      for (PetscInt k=0; k<grid.Mz; ++k) {
-        const PetscScalar depth = vH(i,j) - grid.zlevels[k]; // FIXME issue #15
-        ierr = EC->getWaterFraction(Enthij[k],EC->getPressureFromDepth(depth),
-                                   omegaij[k]); CHKERRQ(ierr);
-      }
+      ierr = EC->getWaterFractionColumn(Enthij, vH(i,j), &grid.zlevels[0], grid.Mz,
+                                        omegaij); CHKERRQ(ierr);
     }
   }
   ierr = enthalpy.end_access(); CHKERRQ(ierr);
@@ -172,7 +171,7 @@ PetscErrorCode IceModel::setCTSFromEnthalpy(IceModelVec3 &useForCTS) {
       ierr = Enth3.getInternalColumn(i,j,&Enthij); CHKERRQ(ierr);
       for (PetscInt k=0; k<grid.Mz; ++k) {
         const PetscScalar depth = vH(i,j) - grid.zlevels[k]; // FIXME issue #15
-        CTSij[k] = EC->getCTS(Enthij[k], EC->getPressureFromDepth(depth));
+        CTSij[k] = Enthij[k] / EC->enthalpy_cts(EC->getPressureFromDepth(depth));
       }
     }
   }
@@ -193,11 +192,8 @@ PetscErrorCode IceModel::getEnthalpyCTSColumn(PetscScalar p_air,
 					      PetscInt ks,
 					      PetscScalar **Enth_s) {
 
-  for (PetscInt k = 0; k <= ks; k++) {
-    const PetscScalar p = EC->getPressureFromDepth(thk - grid.zlevels_fine[k]); // FIXME issue #15
-    (*Enth_s)[k] = EC->getEnthalpyCTS(p);
-  }
-  const PetscScalar Es_air = EC->getEnthalpyCTS(p_air);
+  EC->getEnthalpyCTSColumn(thk, &grid.zlevels_fine[0], ks + 1, *Enth_s);
+  const PetscScalar Es_air = EC->enthalpy_cts(p_air);
   for (PetscInt k = ks+1; k < grid.Mz_fine; k++) {
     (*Enth_s)[k] = Es_air;
   }
@@ -239,6 +235,10 @@ AschwandenBuelerKhroulevBlatter].
 This method updates IceModelVec3 vWork3d = vEnthnew, IceModelVec2S vbmr, and 
 IceModelVec2S vbwat.  No communication of ghosts is done for any of these fields.
 
+If \c age_in_energy_step is set (see IceModel::step()), this method also
+updates the age, putting new values in vWork3dAge (see ageColumnStep()). The
+3D velocity is then read once per column and shared by the two systems.
+
 We use an instance of enthSystemCtx.
 
 Regarding drainage, see [\ref AschwandenBuelerKhroulevBlatter] and references therein.
@@ -285,24 +285,46 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
   ierr = stress_balance->get_3d_velocity(u3, v3, w3); CHKERRQ(ierr);
   ierr = stress_balance->get_volumetric_strain_heating(Sigma3); CHKERRQ(ierr); 
 
-  PetscScalar *Enthnew;
-  Enthnew = new PetscScalar[fMz];  // new enthalpy in column
+  // Column systems and work space, one set per thread (see pism_threads.hh):
+  const int n_threads = pism_max_threads();
+  vector<enthSystemCtx*> enth_systems(n_threads, NULL);
+  vector<ageSystemCtx*> age_systems(n_threads, NULL);
+  vector<PetscScalar*> enth_new(n_threads, NULL), age_new(n_threads, NULL);
+  vector<PetscErrorCode> thread_error(n_threads, 0);
 
-  enthSystemCtx *esys;
-  if (config.get_flag("use_temperature_dependent_thermal_conductivity") ||
-      config.get_flag("use_linear_in_temperature_heat_capacity")) {
-    esys  = new varenthSystemCtx(config, Enth3, fMz, "varenth", EC);
-  } else {
-    esys  = new enthSystemCtx(config, Enth3, fMz, "enth");
+  const bool use_varenth = config.get_flag("use_temperature_dependent_thermal_conductivity") ||
+    config.get_flag("use_linear_in_temperature_heat_capacity");
+
+  for (int t = 0; t < n_threads; ++t) {
+    enth_new[t] = new PetscScalar[fMz];  // new enthalpy in column
+
+    if (use_varenth) {
+      enth_systems[t] = new varenthSystemCtx(config, Enth3, fMz, "varenth", EC);
+    } else {
+      enth_systems[t] = new enthSystemCtx(config, Enth3, fMz, "enth");
+    }
+    ierr = enth_systems[t]->initAllColumns(grid.dx, grid.dy, dt_secs, fdz); CHKERRQ(ierr);
+
+    // If the age update is fused with this one, the age system shares velocity
+    // columns with the enthalpy system, so they are read once per column.
+    if (age_in_energy_step) {
+      ageSystemCtx *asys = new ageSystemCtx(fMz, "age");
+      ierr = init_age_system(*asys); CHKERRQ(ierr);
+      asys->u = enth_systems[t]->u;
+      asys->v = enth_systems[t]->v;
+      asys->w = enth_systems[t]->w;
+      ierr = asys->initAllColumns(); CHKERRQ(ierr);
+      age_systems[t] = asys;
+      age_new[t] = new PetscScalar[fMz];
+    }
   }
-  ierr = esys->initAllColumns(grid.dx, grid.dy, dt_secs, fdz); CHKERRQ(ierr);
 
   bool viewOneColumn;
   ierr = PISMOptionsIsSet("-view_sys", viewOneColumn); CHKERRQ(ierr);
 
   if (getVerbosityLevel() >= 4) {  // view: all column-independent constants correct?
     ierr = EC->viewConstants(NULL); CHKERRQ(ierr);
-    ierr = esys->viewConstants(NULL, false); CHKERRQ(ierr);
+    ierr = enth_systems[0]->viewConstants(NULL, false); CHKERRQ(ierr);
   }
 
   // now get map-plane coupler fields: Dirichlet upper surface boundary and
@@ -352,11 +374,30 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
   ierr = Sigma3->begin_access(); CHKERRQ(ierr);
   ierr = Enth3.begin_access(); CHKERRQ(ierr);
   ierr = vWork3d.begin_access(); CHKERRQ(ierr);
+  if (age_in_energy_step) {
+    ierr = tau3.begin_access(); CHKERRQ(ierr);
+    ierr = vWork3dAge.begin_access(); CHKERRQ(ierr);
+  }
 
   PetscInt liquifiedCount = 0;
+  PetscScalar my_vertSacrCount = 0.0, my_bulgeCount = 0.0;
 
   MaskQuery mask(vMask);
 
+  // Columns are independent, so they can be updated by different threads.
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr) reduction(+:liquifiedCount,my_vertSacrCount,my_bulgeCount)
+#endif
+  {
+  const int thread = pism_thread_id();
+  enthSystemCtx *esys = enth_systems[thread];
+  ageSystemCtx *asys = age_systems[thread];
+  PetscScalar *Enthnew = enth_new[thread];
+  PetscErrorCode &error = thread_error[thread];
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp for schedule(dynamic)
+#endif
   for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
     for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
 
@@ -365,25 +406,37 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
 #if (PISM_DEBUG==1)
       // check if ks is valid
       if ((ks < 0) || (ks >= grid.Mz_fine)) {
-        PetscPrintf(grid.com,
+        PetscPrintf(PETSC_COMM_SELF,
                     "ERROR: ks = %d computed at i = %d, j = %d is invalid,"
                     " possibly because of invalid ice thickness.\n",
                     ks, i, j);
-        SETERRQ(grid.com, 1, "invalid ks");
+        error = 1;
+        continue;
       }
 #endif
 
       const bool ice_free_column = (ks == 0),
                  is_floating     = mask.ocean(i,j);
 
+      // read 3D velocity columns (used by both systems) once:
+      if (ice_free_column == false) {
+        ierr = u3->getValColumn(i,j,ks,esys->u); PISM_THREAD_CHKERRQ(ierr, error);
+        ierr = v3->getValColumn(i,j,ks,esys->v); PISM_THREAD_CHKERRQ(ierr, error);
+        ierr = w3->getValColumn(i,j,ks,esys->w); PISM_THREAD_CHKERRQ(ierr, error);
+      }
+
+      if (age_in_energy_step) {
+        ierr = ageColumnStep(*asys, i, j, ks, age_new[thread], vWork3dAge,
+                             viewOneColumn && issounding(i,j)); PISM_THREAD_CHKERRQ(ierr, error);
+      }
+
       // enthalpy and pressures at top of ice
       const PetscScalar p_ks = EC->getPressureFromDepth(vH(i,j) - fzlev[ks]); // FIXME issue #15
-      PetscScalar Enth_ks;
-      ierr = EC->getEnthPermissive(artm(i,j), liqfrac_surface(i,j), p_ks, Enth_ks); CHKERRQ(ierr);
+      const PetscScalar Enth_ks = EC->enthalpy_permissive(artm(i,j), liqfrac_surface(i,j), p_ks);
 
       // deal completely with columns with no ice; enthalpy, vbwat, vbmr all need setting
       if (ice_free_column) {
-        ierr = vWork3d.setColumn(i,j,Enth_ks); CHKERRQ(ierr);
+        ierr = vWork3d.setColumn(i,j,Enth_ks); PISM_THREAD_CHKERRQ(ierr, error);
         if (mask.floating_ice(i,j)) {
           // if floating then assume-maximally saturated till to avoid "shock"
           //   when grounding line advances
@@ -406,16 +459,15 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
                                  vH(i+1,j),vH(i+1,j+1),vH(i,j+1),vH(i-1,j+1),
                                  vH(i-1,j),vH(i-1,j-1),vH(i,j-1),vH(i+1,j-1)  );
 
-        ierr = Enth3.getValColumn(i,j,ks,esys->Enth); CHKERRQ(ierr);
-        ierr = w3->getValColumn(i,j,ks,esys->w); CHKERRQ(ierr);
+        ierr = Enth3.getValColumn(i,j,ks,esys->Enth); PISM_THREAD_CHKERRQ(ierr, error);
 
-        ierr = getEnthalpyCTSColumn(p_air, vH(i,j), ks, &esys->Enth_s); CHKERRQ(ierr);
+        ierr = getEnthalpyCTSColumn(p_air, vH(i,j), ks, &esys->Enth_s); PISM_THREAD_CHKERRQ(ierr, error);
 
         PetscScalar lambda;
         ierr = getlambdaColumn(ks, ice_rho * default_ice_c, default_ice_k,
                                esys->Enth, esys->Enth_s, esys->w,
-                               &lambda); CHKERRQ(ierr);
-        if (lambda < 1.0)  *vertSacrCount += 1; // count columns with lambda < 1
+                               &lambda); PISM_THREAD_CHKERRQ(ierr, error);
+        if (lambda < 1.0)  my_vertSacrCount += 1; // count columns with lambda < 1
 
         // if there is subglacial water, don't allow ice base enthalpy to be below
         // pressure-melting; that is, assume subglacial water is at the pressure-
@@ -426,7 +478,7 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
 
         const bool base_is_cold = (esys->Enth[0] < esys->Enth_s[0]);
         const PetscScalar p1 = EC->getPressureFromDepth(vH(i,j) - fdz); // FIXME issue #15
-        const bool k1_istemperate = EC->isTemperate(esys->Enth[1], p1); // level  z = + \Delta z
+        const bool k1_istemperate = EC->is_temperate(esys->Enth[1], p1); // level  z = + \Delta z
 
         // can now determine melt, but only preliminarily because of drainage,
         //   from heat flux out of bedrock, heat flux into ice, and frictional heating
@@ -439,11 +491,11 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
             const PetscScalar pbasal = EC->getPressureFromDepth(vH(i,j)); // FIXME issue #15
             PetscScalar hf_up;
             if (k1_istemperate) {
-              const PetscScalar Tpmpbasal = EC->getMeltingTemp(pbasal);
-              hf_up = - esys->k_from_T(Tpmpbasal) * (EC->getMeltingTemp(p1) - Tpmpbasal) / fdz;
+              const PetscScalar Tpmpbasal = EC->melting_temperature(pbasal);
+              hf_up = - esys->k_from_T(Tpmpbasal) * (EC->melting_temperature(p1) - Tpmpbasal) / fdz;
             } else {
               PetscScalar Tbasal;
-              ierr = EC->getAbsTemp(esys->Enth[0], pbasal, Tbasal); CHKERRQ(ierr);
+              ierr = EC->getAbsTemp(esys->Enth[0], pbasal, Tbasal); PISM_THREAD_CHKERRQ(ierr, error);
               const PetscScalar Kbasal = esys->k_from_T(Tbasal) / EC->c_from_T(Tbasal);
               hf_up = - Kbasal * (esys->Enth[1] - esys->Enth[0]) / fdz;
             }
@@ -460,54 +512,52 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
 
         // now set-up for solve in ice; note esys->Enth[], esys->w[],
         //   esys->Enth_s[] are already filled
-        ierr = esys->setIndicesAndClearThisColumn(i,j,ks); CHKERRQ(ierr);
+        ierr = esys->setIndicesAndClearThisColumn(i,j,ks); PISM_THREAD_CHKERRQ(ierr, error);
 
-        ierr = u3->getValColumn(i,j,ks,esys->u); CHKERRQ(ierr);
-        ierr = v3->getValColumn(i,j,ks,esys->v); CHKERRQ(ierr);
-        ierr = Sigma3->getValColumn(i,j,ks,esys->Sigma); CHKERRQ(ierr);
+        ierr = Sigma3->getValColumn(i,j,ks,esys->Sigma); PISM_THREAD_CHKERRQ(ierr, error);
 
-        ierr = esys->initThisColumn(isMarginal, lambda, vH(i, j)); CHKERRQ(ierr);
-        ierr = esys->setBoundaryValuesThisColumn(Enth_ks); CHKERRQ(ierr);
+        ierr = esys->initThisColumn(isMarginal, lambda, vH(i, j)); PISM_THREAD_CHKERRQ(ierr, error);
+        ierr = esys->setBoundaryValuesThisColumn(Enth_ks); PISM_THREAD_CHKERRQ(ierr, error);
 
         // determine lowest-level equation at bottom of ice; see decision chart
         //   in [\ref AschwandenBuelerKhroulevBlatter], and page documenting BOMBPROOF
         if (is_floating) {
           // floating base: Dirichlet application of known temperature from ocean
           //   coupler; assumes base of ice shelf has zero liquid fraction
-          PetscScalar Enth0;
-          ierr = EC->getEnthPermissive(shelfbtemp(i,j), 0.0, EC->getPressureFromDepth(vH(i,j)),
-                                       Enth0); CHKERRQ(ierr);
-          ierr = esys->setDirichletBasal(Enth0); CHKERRQ(ierr);
+          const PetscScalar Enth0 = EC->enthalpy_permissive(shelfbtemp(i,j), 0.0,
+                                                            EC->getPressureFromDepth(vH(i,j)));
+          ierr = esys->setDirichletBasal(Enth0); PISM_THREAD_CHKERRQ(ierr, error);
         } else if (base_is_cold) {
           // cold, grounded base (Neumann) case:  q . n = q_lith . n + F_b
-          ierr = esys->setBasalHeatFlux(G0(i,j) + (*Rb)(i,j)); CHKERRQ(ierr);
+          ierr = esys->setBasalHeatFlux(G0(i,j) + (*Rb)(i,j)); PISM_THREAD_CHKERRQ(ierr, error);
         } else {
           // warm, grounded base case
           if (k1_istemperate) {
             // positive thickness of temperate ice; homogeneous Neumann case:  q . n = 0
-            ierr = esys->setBasalHeatFlux(0.0); CHKERRQ(ierr);
+            ierr = esys->setBasalHeatFlux(0.0); PISM_THREAD_CHKERRQ(ierr, error);
           } else {
             // no thickness of temperate ice:  Dirichlet  H = H_s(pbasal)
-            ierr = esys->setDirichletBasal(esys->Enth_s[0]); CHKERRQ(ierr);
+            ierr = esys->setDirichletBasal(esys->Enth_s[0]); PISM_THREAD_CHKERRQ(ierr, error);
           }
         }
 
         // solve the system
         PetscErrorCode pivoterr;
-        ierr = esys->solveThisColumn(&Enthnew,pivoterr); CHKERRQ(ierr);
+        ierr = esys->solveThisColumn(&Enthnew,pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
         if (pivoterr != 0) {
           ierr = PetscPrintf(PETSC_COMM_SELF,
             "\n\ntridiagonal solve of enthSystemCtx in enthalpyAndDrainageStep() FAILED at (%d,%d)\n"
                 " with zero pivot position %d; viewing system to m-file ... \n",
-            i, j, pivoterr); CHKERRQ(ierr);
-          ierr = esys->reportColumnZeroPivotErrorMFile(pivoterr); CHKERRQ(ierr);
-          SETERRQ(grid.com, 1,"PISM ERROR in enthalpyDrainageStep()\n");
+            i, j, pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
+          ierr = esys->reportColumnZeroPivotErrorMFile(pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
+          error = 1;
+          continue;
         }
         if (viewOneColumn && issounding(i,j)) {
           ierr = PetscPrintf(PETSC_COMM_SELF,
             "\n\nin enthalpyAndDrainageStep(): viewing enthSystemCtx at (i,j)=(%d,%d) to m-file ... \n\n",
-            i, j); CHKERRQ(ierr);
-          ierr = esys->viewColumnInfoMFile(Enthnew, fMz); CHKERRQ(ierr);
+            i, j); PISM_THREAD_CHKERRQ(ierr, error);
+          ierr = esys->viewColumnInfoMFile(Enthnew, fMz); PISM_THREAD_CHKERRQ(ierr, error);
         }
 
         // thermodynamic basal melt rate causes water to be added to layer
@@ -526,8 +576,7 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
               Enthnew[k] = esys->Enth_s[k] + 0.5 * L; //  but lose the energy
             }
             const PetscReal p = EC->getPressureFromDepth(vH(i,j) - fzlev[k]); // FIXME issue #15
-            PetscReal omega;
-            EC->getWaterFraction(Enthnew[k], p, omega);  // return code not checked
+            const PetscReal omega = EC->water_fraction(Enthnew[k], p);
             if (omega > 0.01) {
               PetscReal fractiondrained = dc.get_drainage_rate(omega) * dt_secs; // pure number
               fractiondrained = PetscMin(fractiondrained, omega - 0.01); // only drain down to 0.01
@@ -549,11 +598,11 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
         const PetscReal lowerEnthLimit = Enth_ks - bulgeEnthMax;
         for (PetscInt k=0; k < ks; k++) {
           if (Enthnew[k] < lowerEnthLimit) {
-            *bulgeCount += 1;      // count the columns which have very large cold 
+            my_bulgeCount += 1;    // count the columns which have very large cold 
             Enthnew[k] = lowerEnthLimit;  // limit advection bulge ... enthalpy not too low
           }
         }
-        ierr = vWork3d.setValColumnPL(i,j,Enthnew); CHKERRQ(ierr);
+        ierr = vWork3d.setValColumnPL(i,j,Enthnew); PISM_THREAD_CHKERRQ(ierr, error);
 
         // finalize bwat value
         bwatnew -= bwat_decay_rate * dt_secs;
@@ -574,6 +623,14 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
 
     }
   }
+  } // end of the parallel region
+
+  for (int t = 0; t < n_threads; ++t) {
+    CHKERRQ(thread_error[t]);
+  }
+
+  *vertSacrCount += my_vertSacrCount;
+  *bulgeCount += my_bulgeCount;
 
   ierr = artm.end_access(); CHKERRQ(ierr);
   ierr = shelfbmassflux.end_access(); CHKERRQ(ierr);
@@ -593,9 +650,17 @@ PetscErrorCode IceModel::enthalpyAndDrainageStep(
   ierr = Sigma3->end_access(); CHKERRQ(ierr);
   ierr = Enth3.end_access(); CHKERRQ(ierr);
   ierr = vWork3d.end_access(); CHKERRQ(ierr);
+  if (age_in_energy_step) {
+    ierr = tau3.end_access(); CHKERRQ(ierr);
+    ierr = vWork3dAge.end_access(); CHKERRQ(ierr);
+  }
 
-  delete [] Enthnew;
-  delete esys;
+  for (int t = 0; t < n_threads; ++t) {
+    delete [] enth_new[t];
+    delete [] age_new[t];
+    delete enth_systems[t];
+    delete age_systems[t];
+  }
 
   *liquifiedVol = ((double) liquifiedCount) * fdz * grid.dx * grid.dy;
   return 0;
@@ -47,8 +47,11 @@ PetscErrorCode IceModel::updateSurfaceElevationAndMask() {
   ierr = update_mask(); CHKERRQ(ierr);
   ierr = update_surface_elevation(); CHKERRQ(ierr);
 
-  if (config.get_flag("kill_icebergs")) {
+  if (config.get_flag("kill_icebergs") && scheduled("iceberg removal")) {
+    PetscLogDouble start;
+    ierr = PetscGetTime(&start); CHKERRQ(ierr);
     ierr = killIceBergs(); CHKERRQ(ierr);
+    ierr = schedule_add_time("iceberg removal", start); CHKERRQ(ierr);
   }
 
   return 0;
@@ -275,6 +278,9 @@ void IceModel::adjust_flow(planeStar<int> mask,
  *
  * 2) Adjust the flow using the mask by calling adjust_flow().
  *
+ * Uses vMaskCompact, which massContExplicitStep() updates before calling
+ * this method.
+ *
  * @param[in] dirichlet_bc true if Dirichlet B.C. are set.
  * @param[in] i i-index of the current cell
  * @param[in] j j-index of the current cell
@@ -290,7 +296,7 @@ void IceModel::cell_interface_fluxes(bool dirichlet_bc,
                                      planeStar<PetscScalar> &out_SSA_velocity,
                                      planeStar<PetscScalar> &out_SIA_flux) {
 
-  planeStar<int> mask = vMask.int_star(i,j);
+  planeStar<int> mask = vMaskCompact.int_star(i,j);
   PISM_Direction dirs[4] = {North, East, South, West};
   Mask M;
 
@@ -428,6 +434,10 @@ void IceModel::cell_interface_fluxes(bool dirichlet_bc,
   \c *Qdiff while the less-diffusive velocity \f$\mathbf{U}_b\f$ is stored in
   \c IceModelVec2V \c *vel_advective.
 
+  If \c mass_continuity_implicit is set (option \c -implicit_mass), \c Qdiff
+  is replaced by the flux computed by diffusive_flux_implicit(), which uses the
+  ice thickness at the end of the time step.
+
   The methods used here are first-order and explicit in time.  The derivatives in
   \f$\nabla \cdot (D \nabla h)\f$ are computed by centered finite difference
   methods.  The diffusive flux \c Qdiff is already stored on the staggered grid
@@ -519,7 +529,11 @@ PetscErrorCode IceModel::massContExplicitStep() {
   ierr = vH.copy_to(vHnew); CHKERRQ(ierr);
 
   IceModelVec2Stag *Qdiff;
-  ierr = stress_balance->get_diffusive_flux(Qdiff); CHKERRQ(ierr);
+  if (config.get_flag("mass_continuity_implicit")) {
+    ierr = diffusive_flux_implicit(Qdiff); CHKERRQ(ierr);
+  } else {
+    ierr = stress_balance->get_diffusive_flux(Qdiff); CHKERRQ(ierr);
+  }
 
   IceModelVec2V *vel_advective;
   ierr = stress_balance->get_advective_2d_velocity(vel_advective); CHKERRQ(ierr);
@@ -530,9 +544,12 @@ PetscErrorCode IceModel::massContExplicitStep() {
   ierr = vel_advective->begin_access(); CHKERRQ(ierr);
   ierr = acab.begin_access(); CHKERRQ(ierr);
   ierr = shelfbmassflux.begin_access(); CHKERRQ(ierr);
-  ierr = vMask.begin_access();  CHKERRQ(ierr);
   ierr = vHnew.begin_access(); CHKERRQ(ierr);
 
+  // The loop below looks up the mask several times per grid point and does
+  // not change it, so use the compact copy.
+  ierr = vMaskCompact.update(vMask); CHKERRQ(ierr);
+
   // related to PIK part_grid mechanism; see Albrecht et al 2011
   const bool do_part_grid = config.get_flag("part_grid"),
     do_redist = config.get_flag("part_redist");
@@ -559,7 +576,7 @@ PetscErrorCode IceModel::massContExplicitStep() {
     ierr = climatic_mass_balance_cumulative.begin_access(); CHKERRQ(ierr);
   }
 
-  MaskQuery mask(vMask);
+  CompactMaskQuery mask(vMaskCompact);
 
   for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
     for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
@@ -630,7 +647,7 @@ PetscErrorCode IceModel::massContExplicitStep() {
           }
 
           PetscReal H_average = get_average_thickness(do_redist,
-                                                      vMask.int_star(i, j),
+                                                      vMaskCompact.int_star(i, j),
                                                       vH.star(i, j)),
             coverage_ratio = vHref(i, j) / H_average;
 
@@ -737,7 +754,6 @@ PetscErrorCode IceModel::massContExplicitStep() {
   } // end of the outer (i) for loop
 
   ierr = vbmr.end_access(); CHKERRQ(ierr);
-  ierr = vMask.end_access(); CHKERRQ(ierr);
   ierr = Qdiff->end_access(); CHKERRQ(ierr);
   ierr = vel_advective->end_access(); CHKERRQ(ierr);
   ierr = acab.end_access(); CHKERRQ(ierr);
@@ -765,6 +781,10 @@ PetscErrorCode IceModel::massContExplicitStep() {
     ierr = ocean_kill_mask.end_access(); CHKERRQ(ierr);
   }
 
+  // start copying vHnew into vH; the ghost exchange overlaps with the
+  // reductions below
+  ierr = vHnew.beginGhostComm(vH); CHKERRQ(ierr);
+
   // flux accounting
   {
     ierr = PISMGlobalSum(&proc_grounded_basal_ice_flux, &total_grounded_basal_ice_flux, grid.com); CHKERRQ(ierr);
@@ -793,8 +813,7 @@ PetscErrorCode IceModel::massContExplicitStep() {
     cumulative_H_to_Href_flux     += total_H_to_Href_flux     * factor;
   }
 
-  // finally copy vHnew into vH and communicate ghosted values
-  ierr = vHnew.beginGhostComm(vH); CHKERRQ(ierr);
+  // finally copy vHnew into vH and communicate ghosted values (started above)
   ierr = vHnew.endGhostComm(vH); CHKERRQ(ierr);
 
   // the following calls are new routines adopted from PISM-PIK. The place and
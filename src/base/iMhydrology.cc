@@ -18,6 +18,7 @@
 
 #include "iceModel.hh"
 #include "IceGrid.hh"
+#include "PISMHaloSweep.hh"
 
 //! \file iMhydrology.cc Currently, only the most minimal possible hydrology model: diffusion of stored basal water.
 
@@ -55,18 +56,24 @@ PetscErrorCode IceModel::diffuse_bwat() {
 
   // communicate ghosted values so neighbors are valid;
   // note that temperatureStep() and enthalpyAndDrainageStep() modify vbwat,
-  // but they do not update ghosts because only the current process needs that
-  ierr = vbwat.beginGhostComm(); CHKERRQ(ierr);
-  ierr = vbwat.endGhostComm(); CHKERRQ(ierr);
+  // but they do not update ghosts because only the current process needs that;
+  // the interior of the sub-domain is updated while ghosts are in flight
+  PISMHaloSweep sweep(grid, 1);
+  sweep.add(vbwat);
+  ierr = sweep.begin(); CHKERRQ(ierr);
 
   PetscScalar **bwatnew; 
   ierr = vbwat.begin_access(); CHKERRQ(ierr);
   ierr = vWork2d[0].get_array(bwatnew); CHKERRQ(ierr);
-  for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
-    for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
-      bwatnew[i][j] = oneM4R * vbwat(i,j)
-                       + Rx * (vbwat(i+1,j  ) + vbwat(i-1,j  ))
-                       + Ry * (vbwat(i  ,j+1) + vbwat(i  ,j-1));
+  for (int b = 0; b < PISMHaloSweep::N_BLOCKS; ++b) {
+    PetscInt xs, xm, ys, ym;
+    ierr = sweep.block(b, xs, xm, ys, ym); CHKERRQ(ierr);
+    for (PetscInt i=xs; i<xs+xm; ++i) {
+      for (PetscInt j=ys; j<ys+ym; ++j) {
+        bwatnew[i][j] = oneM4R * vbwat(i,j)
+                         + Rx * (vbwat(i+1,j  ) + vbwat(i-1,j  ))
+                         + Ry * (vbwat(i  ,j+1) + vbwat(i  ,j-1));
+      }
     }
   }
   ierr = vWork2d[0].end_access(); CHKERRQ(ierr);
@@ -111,9 +111,11 @@ PetscErrorCode IceModel::findIceBergCandidates() {
   ierr = vIcebergMask.beginGhostComm(); CHKERRQ(ierr);
   ierr = vIcebergMask.endGhostComm(); CHKERRQ(ierr);
 
+  // vMask does not change below, so lookups use the compact copy
+  ierr = vMaskCompact.update(vMask); CHKERRQ(ierr);
+  CompactMaskQuery M(vMaskCompact);
+
   // set all floating points to ICEBERGMASK_ICEBERG_CAND
-  MaskQuery M(vMask);
-  ierr = vMask.begin_access(); CHKERRQ(ierr);
   ierr = vIcebergMask.begin_access(); CHKERRQ(ierr);
   for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
     for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
@@ -155,7 +157,6 @@ PetscErrorCode IceModel::findIceBergCandidates() {
       }
     }
   }
-  ierr = vMask.end_access(); CHKERRQ(ierr);
   ierr = vIcebergMask.end_access(); CHKERRQ(ierr);
 
   ierr = vIcebergMask.beginGhostComm(); CHKERRQ(ierr);
@@ -177,6 +178,16 @@ PetscErrorCode IceModel::identifyNotAnIceBerg() {
   ierr = vIcebergMask.beginGhostComm(); CHKERRQ(ierr);
   ierr = vIcebergMask.endGhostComm(); CHKERRQ(ierr);
 
+  // The mask is propagated through a chain of cells, one cell per sweep. If
+  // vIcebergMask has a halo of width W we do W sweeps per ghost exchange: the
+  // first one covers owned cells and W - 1 rings of ghosts, and each next
+  // sweep covers one ring less. This is redundant near sub-domain boundaries,
+  // but the propagation is monotone (candidates only become
+  // ICEBERGMASK_NO_ICEBERG), so the result does not depend on the halo width,
+  // while the number of exchanges (and reductions) is cut roughly W times.
+  const PetscInt sweeps = PetscMax(1, PetscMin((PetscInt)config.get("iterative_halo_width"),
+                                               vIcebergMask.get_stencil_width()));
+
   bool done = false;
   PetscInt loopcount = 0;
   while(! done){
@@ -184,28 +195,33 @@ PetscErrorCode IceModel::identifyNotAnIceBerg() {
     done = true;
 
     ierr = vIcebergMask.begin_access(); CHKERRQ(ierr);
-    for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
-      for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
-
-        planeStar<int> mask = vIcebergMask.int_star(i, j);
-
-        bool attached_to_grounded = (mask.e == ICEBERGMASK_STOP_ATTACHED ||
-                                     mask.w == ICEBERGMASK_STOP_ATTACHED ||
-                                     mask.n == ICEBERGMASK_STOP_ATTACHED ||
-                                     mask.s == ICEBERGMASK_STOP_ATTACHED),
-
-          attached_to_no_iceberg = (mask.e == ICEBERGMASK_NO_ICEBERG ||
-                                    mask.w == ICEBERGMASK_NO_ICEBERG ||
-                                    mask.n == ICEBERGMASK_NO_ICEBERG ||
-                                    mask.s == ICEBERGMASK_NO_ICEBERG);
-
-        if (vIcebergMask(i, j) == ICEBERGMASK_ICEBERG_CAND &&
-            (attached_to_grounded || attached_to_no_iceberg)) {
+    for (PetscInt sweep = 0; sweep < sweeps; ++sweep) {
+      const PetscInt GHOSTS = sweeps - 1 - sweep;
+      for (PetscInt i = grid.xs - GHOSTS; i < grid.xs + grid.xm + GHOSTS; ++i) {
+        for (PetscInt j = grid.ys - GHOSTS; j < grid.ys + grid.ym + GHOSTS; ++j) {
+
+          planeStar<int> mask = vIcebergMask.int_star(i, j);
+
+          bool attached_to_grounded = (mask.e == ICEBERGMASK_STOP_ATTACHED ||
+                                       mask.w == ICEBERGMASK_STOP_ATTACHED ||
+                                       mask.n == ICEBERGMASK_STOP_ATTACHED ||
+                                       mask.s == ICEBERGMASK_STOP_ATTACHED),
+
+            attached_to_no_iceberg = (mask.e == ICEBERGMASK_NO_ICEBERG ||
+                                      mask.w == ICEBERGMASK_NO_ICEBERG ||
+                                      mask.n == ICEBERGMASK_NO_ICEBERG ||
+                                      mask.s == ICEBERGMASK_NO_ICEBERG);
+
+          // changes in ghosts count, too: we stop only if nothing changed
+          // right after an exchange
+          if (vIcebergMask(i, j) == ICEBERGMASK_ICEBERG_CAND &&
+              (attached_to_grounded || attached_to_no_iceberg)) {
+
+            vIcebergMask(i, j) = ICEBERGMASK_NO_ICEBERG;
+            done = false;
+          }
 
-          vIcebergMask(i, j) = ICEBERGMASK_NO_ICEBERG;
-          done = false;
         }
-
       }
     }
     ierr = vIcebergMask.end_access(); CHKERRQ(ierr);
@@ -223,8 +239,8 @@ PetscErrorCode IceModel::identifyNotAnIceBerg() {
   }
 
   ierr = verbPrintf(3, grid.com,
-    "PISM-PIK INFO:  %d loop(s) were needed to identify whether there are icebergs \n",
-    loopcount); CHKERRQ(ierr);
+    "PISM-PIK INFO:  %d loop(s) (%d sweep(s) each) were needed to identify whether there are icebergs \n",
+    loopcount, sweeps); CHKERRQ(ierr);
 
   return 0;
 }
@@ -0,0 +1,315 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <petscdmda.h>
+
+#include "iceModel.hh"
+#include "IceGrid.hh"
+#include "PISMStressBalance.hh"
+#include "PISMSurface.hh"
+#include "Mask.hh"
+
+//! \file iMimplicit.cc Semi-implicit treatment of the diffusive (SIA) part of
+//! the mass continuity equation.
+
+//! \brief Allocate the linear system used by the semi-implicit mass
+//! continuity step.
+/*!
+ * Like SSAFD, we use a PETSc KSP and Mat directly: the diffusivity is frozen
+ * during a time step, so the system is linear. Use "-mass_" PETSc options
+ * (such as -mass_ksp_type, -mass_pc_type) to choose the solver.
+ */
+PetscErrorCode IceModel::allocate_implicit_mass_continuity() {
+  PetscErrorCode ierr;
+
+  if (thickness_ksp != PETSC_NULL)
+    return 0;
+
+  ierr = vDiffusivityStag.create(grid, "diffusivity_staggered", true); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.set_attrs("internal",
+                                    "SIA diffusivity on the staggered grid (frozen during a time step)",
+                                    "m2 s-1", ""); CHKERRQ(ierr);
+
+  ierr = vQdiffImplicit.create(grid, "Qdiff_implicit", true); CHKERRQ(ierr);
+  ierr = vQdiffImplicit.set_attrs("internal",
+                                  "diffusive flux computed using the new ice thickness",
+                                  "m2 s-1", ""); CHKERRQ(ierr);
+
+  ierr = DMCreateGlobalVector(grid.da2, &thickness_x); CHKERRQ(ierr);
+  ierr = VecDuplicate(thickness_x, &thickness_rhs); CHKERRQ(ierr);
+
+  ierr = DMCreateMatrix(grid.da2, MATAIJ, &thickness_matrix); CHKERRQ(ierr);
+
+  MatInfo info;
+  PetscInt local_size;
+  ierr = MatGetInfo(thickness_matrix, MAT_LOCAL, &info); CHKERRQ(ierr);
+  ierr = VecGetLocalSize(thickness_x, &local_size); CHKERRQ(ierr);
+  grid.memory->allocate(grid.memory->current_component(),
+                        info.memory + 2 * local_size * sizeof(PetscScalar),
+                        MEMORY_LOCAL_2D);
+
+  ierr = KSPCreate(grid.com, &thickness_ksp); CHKERRQ(ierr);
+  ierr = KSPSetOptionsPrefix(thickness_ksp, "mass_"); CHKERRQ(ierr);
+  // The system is diagonally dominant, so block Jacobi works well. (It is not
+  // symmetric if Dirichlet boundary conditions are used, so we keep the
+  // default KSP type.)
+  PC pc;
+  ierr = KSPGetPC(thickness_ksp, &pc); CHKERRQ(ierr);
+  ierr = PCSetType(pc, PCBJACOBI); CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(thickness_ksp); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief De-allocate objects allocated by allocate_implicit_mass_continuity().
+PetscErrorCode IceModel::deallocate_implicit_mass_continuity() {
+  PetscErrorCode ierr;
+
+  if (thickness_ksp != PETSC_NULL) {
+    ierr = KSPDestroy(&thickness_ksp); CHKERRQ(ierr);
+  }
+
+  if (thickness_matrix != PETSC_NULL) {
+    ierr = MatDestroy(&thickness_matrix); CHKERRQ(ierr);
+  }
+
+  if (thickness_x != PETSC_NULL) {
+    ierr = VecDestroy(&thickness_x); CHKERRQ(ierr);
+  }
+
+  if (thickness_rhs != PETSC_NULL) {
+    ierr = VecDestroy(&thickness_rhs); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Compute the diffusive (SIA) flux using a linearized backward Euler
+//! step of the mass continuity equation.
+/*!
+  The explicit scheme in massContExplicitStep() uses the diffusive flux
+  \f$Q = -D \nabla h\f$ at the beginning of a time step and is stable only if
+  \f$\Delta t \le \Delta x^2 / (2 D_{\max})\f$ (see
+  adaptTimeStepDiffusivity()).
+
+  Here we recover the diffusivity \f$D = -Q / \nabla h\f$ on the staggered grid
+  from the flux provided by the stress balance model, freeze it (a Picard
+  linearization) and solve
+  \f[ H^{n+1} - \Delta t\, \nabla\cdot(D \nabla H^{n+1}) = H^n + \Delta t\, M + \Delta t\, \nabla\cdot(D \nabla b), \f]
+  where \f$b = h - H\f$ is the elevation of the base of the ice and \f$M\f$ is
+  the surface mass balance. The resulting flux \f$-D \nabla h^{n+1}\f$ is then
+  used by massContExplicitStep() instead of the explicit one, so the mask,
+  part-grid, calving, Dirichlet boundary condition and flux accounting logic
+  are shared by both schemes and the update remains conservative.
+
+  The recovered diffusivity is limited by the maximum diffusivity reported by
+  the stress balance model (to avoid division by tiny surface slopes). With
+  \f$D\f$ frozen, large steps are stable but not necessarily accurate; the
+  time step is still bounded by \c mass_continuity_implicit_dt_factor times
+  the explicit limit.
+ */
+PetscErrorCode IceModel::diffusive_flux_implicit(IceModelVec2Stag* &result) {
+  PetscErrorCode ierr;
+
+  if (thickness_ksp == PETSC_NULL) {
+    ierr = allocate_implicit_mass_continuity(); CHKERRQ(ierr);
+  }
+
+  const PetscScalar dx = grid.dx, dy = grid.dy,
+    slope_threshold = 1e-8;       // surface slopes smaller than this are "flat"
+  const bool dirichlet_bc = config.get_flag("ssa_dirichlet_bc");
+
+  IceModelVec2Stag *Qdiff;
+  ierr = stress_balance->get_diffusive_flux(Qdiff); CHKERRQ(ierr);
+
+  PetscReal D_max;
+  ierr = stress_balance->get_max_diffusivity(D_max); CHKERRQ(ierr);
+
+  // Recover the diffusivity on the staggered grid:
+  ierr = vh.begin_access(); CHKERRQ(ierr);
+  ierr = Qdiff->begin_access(); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      for (int o = 0; o < 2; ++o) {
+        const PetscInt oi = 1 - o, oj = o;
+        const PetscScalar
+          slope = (vh(i + oi, j + oj) - vh(i, j)) / (o == 0 ? dx : dy),
+          Q = (*Qdiff)(i, j, o);
+
+        if (PetscAbs(slope) > slope_threshold && Q * slope < 0.0)
+          vDiffusivityStag(i, j, o) = PetscMin(-Q / slope, D_max);
+        else
+          vDiffusivityStag(i, j, o) = 0.0;
+      }
+    }
+  }
+  ierr = vDiffusivityStag.end_access(); CHKERRQ(ierr);
+  ierr = Qdiff->end_access(); CHKERRQ(ierr);
+
+  ierr = vDiffusivityStag.beginGhostComm(); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.endGhostComm(); CHKERRQ(ierr);
+
+  // Assemble the system:
+  PetscScalar **rhs;
+  ierr = DMDAVecGetArray(grid.da2, thickness_rhs, &rhs); CHKERRQ(ierr);
+
+  ierr = vH.begin_access(); CHKERRQ(ierr);
+  ierr = acab.begin_access(); CHKERRQ(ierr);
+  ierr = vMask.begin_access(); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.begin_access(); CHKERRQ(ierr);
+  if (dirichlet_bc) {
+    ierr = vBCMask.begin_access(); CHKERRQ(ierr);
+  }
+
+  MaskQuery mask(vMask);
+
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      // Note that the horizontal DA is transposed:
+      MatStencil row, col[5];
+      PetscScalar values[5];
+      row.j = i; row.i = j; row.c = 0;
+
+      if (dirichlet_bc && vBCMask.as_int(i, j) == 1) {
+        values[0] = 1.0;
+        ierr = MatSetValuesStencil(thickness_matrix, 1, &row, 1, &row, values,
+                                   INSERT_VALUES); CHKERRQ(ierr);
+        rhs[i][j] = vH(i, j);
+        continue;
+      }
+
+      planeStar<PetscScalar> D = vDiffusivityStag.star(i, j), b = vh.star(i, j),
+        H = vH.star(i, j);
+      const PetscScalar
+        cx = dt / (dx * dx),
+        cy = dt / (dy * dy);
+
+      const PetscScalar
+        b_e = b.e - H.e,
+        b_w = b.w - H.w,
+        b_n = b.n - H.n,
+        b_s = b.s - H.s,
+        b_ij = b.ij - H.ij;
+
+      for (int k = 0; k < 5; ++k) {
+        col[k].c = 0;
+        col[k].j = i;
+        col[k].i = j;
+      }
+      col[1].j = i + 1;
+      col[2].j = i - 1;
+      col[3].i = j + 1;
+      col[4].i = j - 1;
+
+      values[0] = 1.0 + cx * (D.e + D.w) + cy * (D.n + D.s);
+      values[1] = - cx * D.e;
+      values[2] = - cx * D.w;
+      values[3] = - cy * D.n;
+      values[4] = - cy * D.s;
+
+      ierr = MatSetValuesStencil(thickness_matrix, 1, &row, 5, col, values,
+                                 INSERT_VALUES); CHKERRQ(ierr);
+
+      // The surface mass balance does not apply to ice-free ocean cells (see
+      // massContExplicitStep()).
+      const PetscScalar M = mask.ice_free_ocean(i, j) ? 0.0 : acab(i, j);
+
+      // Ablation cannot remove more ice than there is: in ice-free cells the
+      // thickness (before the flux is added) is clipped at zero, as in
+      // massContExplicitStep(). Otherwise the negative thickness would drive
+      // a spurious flux out of neighboring icy cells.
+      PetscScalar H_smb = H.ij + dt * M;
+      if (mask.ice_free(i, j) && H_smb < 0.0)
+        H_smb = 0.0;
+
+      rhs[i][j] = H_smb
+        + cx * (D.e * (b_e - b_ij) - D.w * (b_ij - b_w))
+        + cy * (D.n * (b_n - b_ij) - D.s * (b_ij - b_s));
+    }
+  }
+
+  if (dirichlet_bc) {
+    ierr = vBCMask.end_access(); CHKERRQ(ierr);
+  }
+  ierr = vDiffusivityStag.end_access(); CHKERRQ(ierr);
+  ierr = vMask.end_access(); CHKERRQ(ierr);
+  ierr = acab.end_access(); CHKERRQ(ierr);
+  ierr = vH.end_access(); CHKERRQ(ierr);
+  ierr = vh.end_access(); CHKERRQ(ierr);
+
+  ierr = DMDAVecRestoreArray(grid.da2, thickness_rhs, &rhs); CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(thickness_matrix, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(thickness_matrix, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+  // Solve, using the current thickness as the initial guess:
+  ierr = vH.copy_to(thickness_x); CHKERRQ(ierr);
+  ierr = KSPSetInitialGuessNonzero(thickness_ksp, PETSC_TRUE); CHKERRQ(ierr);
+  ierr = KSPSetOperators(thickness_ksp, thickness_matrix, thickness_matrix,
+                         SAME_NONZERO_PATTERN); CHKERRQ(ierr);
+  ierr = KSPSolve(thickness_ksp, thickness_rhs, thickness_x); CHKERRQ(ierr);
+
+  KSPConvergedReason reason;
+  ierr = KSPGetConvergedReason(thickness_ksp, &reason); CHKERRQ(ierr);
+  if (reason < 0) {
+    // Fall back to the explicit flux. This is safe only because the time
+    // step is bounded (see adaptTimeStepDiffusivity()).
+    ierr = verbPrintf(1, grid.com,
+                      "PISM WARNING: KSPSolve() in the semi-implicit mass continuity step"
+                      " reports 'diverged'; reason = %d = '%s'.\n"
+                      "  Using the explicit diffusive flux.\n",
+                      reason, KSPConvergedReasons[reason]); CHKERRQ(ierr);
+    result = Qdiff;
+    return 0;
+  }
+
+  // Compute the flux using the new surface elevation h = H^{n+1} + b:
+  IceModelVec2S Hnew = vWork2d[1];
+  ierr = Hnew.copy_from(thickness_x); CHKERRQ(ierr);
+
+  ierr = vh.begin_access(); CHKERRQ(ierr);
+  ierr = vH.begin_access(); CHKERRQ(ierr);
+  ierr = Hnew.begin_access(); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.begin_access(); CHKERRQ(ierr);
+  ierr = vQdiffImplicit.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      for (int o = 0; o < 2; ++o) {
+        const PetscInt oi = 1 - o, oj = o;
+        const PetscScalar
+          h_ij = vh(i, j) - vH(i, j) + Hnew(i, j),
+          h_n  = vh(i + oi, j + oj) - vH(i + oi, j + oj) + Hnew(i + oi, j + oj);
+
+        vQdiffImplicit(i, j, o) = - vDiffusivityStag(i, j, o) * (h_n - h_ij) / (o == 0 ? dx : dy);
+      }
+    }
+  }
+  ierr = vQdiffImplicit.end_access(); CHKERRQ(ierr);
+  ierr = vDiffusivityStag.end_access(); CHKERRQ(ierr);
+  ierr = Hnew.end_access(); CHKERRQ(ierr);
+  ierr = vH.end_access(); CHKERRQ(ierr);
+  ierr = vh.end_access(); CHKERRQ(ierr);
+
+  ierr = vQdiffImplicit.beginGhostComm(); CHKERRQ(ierr);
+  ierr = vQdiffImplicit.endGhostComm(); CHKERRQ(ierr);
+
+  result = &vQdiffImplicit;
+
+  return 0;
+}
@@ -55,8 +55,8 @@ PetscErrorCode IceModel::set_grid_defaults() {
 
   // Get the bootstrapping file name:
 
-  ierr = PISMOptionsString("-boot_file", "Specifies the file to bootstrap from",
-			   filename, boot_file_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-boot_file", "Specifies the file to bootstrap from",
+          			   filename, boot_file_set); CHKERRQ(ierr);
 
   if (!boot_file_set) {
     ierr = PetscPrintf(grid.com,
@@ -162,28 +162,28 @@ PetscErrorCode IceModel::set_grid_from_options() {
   // Process the options:
 
   // Read -Lx and -Ly.
-  ierr = PISMOptionsReal("-Ly", "Half of the grid extent in the X direction, in km",
-			 y_scale,  Ly_set); CHKERRQ(ierr);
-  ierr = PISMOptionsReal("-Lx", "Half of the grid extent in the Y direction, in km",
-			 x_scale,  Lx_set); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Ly", "Half of the grid extent in the X direction, in km",
+          			 y_scale,  Ly_set); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Lx", "Half of the grid extent in the Y direction, in km",
+          			 x_scale,  Lx_set); CHKERRQ(ierr);
   // Vertical extent (in the ice):
-  ierr = PISMOptionsReal("-Lz", "Grid extent in the Z (vertical) direction in the ice, in meters",
-			 z_scale,  Lz_set); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Lz", "Grid extent in the Z (vertical) direction in the ice, in meters",
+          			 z_scale,  Lz_set); CHKERRQ(ierr);
 
   // Read -Mx, -My, -Mz and -Mbz.
-  ierr = PISMOptionsInt("-My", "Number of grid points in the X direction",
-			grid.My, My_set); CHKERRQ(ierr);
-  ierr = PISMOptionsInt("-Mx", "Number of grid points in the Y direction",
-			grid.Mx, Mx_set); CHKERRQ(ierr);
-  ierr = PISMOptionsInt("-Mz", "Number of grid points in the Z (vertical) direction in the ice",
-			grid.Mz, Mz_set); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-My", "Number of grid points in the X direction",
+          			grid.My, My_set); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-Mx", "Number of grid points in the Y direction",
+          			grid.Mx, Mx_set); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-Mz", "Number of grid points in the Z (vertical) direction in the ice",
+          			grid.Mz, Mz_set); CHKERRQ(ierr);
 
   vector<double> x_range, y_range;
   bool x_range_set, y_range_set;
-  ierr = PISMOptionsRealArray("-x_range", "min,max x coordinate values",
-                              x_range, x_range_set); CHKERRQ(ierr);
-  ierr = PISMOptionsRealArray("-y_range", "min,max y coordinate values",
-                              y_range, y_range_set); CHKERRQ(ierr);
+  ierr = PISMOptionsRealArray(grid.com, "-x_range", "min,max x coordinate values",
+                                        x_range, x_range_set); CHKERRQ(ierr);
+  ierr = PISMOptionsRealArray(grid.com, "-y_range", "min,max y coordinate values",
+                                        y_range, y_range_set); CHKERRQ(ierr);
 
   string keyword;
   set<string> z_spacing_choices;
@@ -270,8 +270,8 @@ PetscErrorCode IceModel::grid_setup() {
 		    "Setting up the computational grid...\n"); CHKERRQ(ierr);
 
   // Check if we are initializing from a PISM output file:
-  ierr = PISMOptionsString("-i", "Specifies a PISM input file",
-			   filename, i_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-i", "Specifies a PISM input file",
+          			   filename, i_set); CHKERRQ(ierr);
 
   if (i_set) {
     PIO nc(grid.com, grid.rank, grid.config.get_string("output_format"));
@@ -351,10 +351,10 @@ PetscErrorCode IceModel::grid_setup() {
   }
 
   bool Nx_set, Ny_set;
-  ierr = PISMOptionsInt("-Nx", "Number of processors in the x direction",
-			grid.Nx, Nx_set); CHKERRQ(ierr);
-  ierr = PISMOptionsInt("-Ny", "Number of processors in the y direction",
-			grid.Ny, Ny_set); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-Nx", "Number of processors in the x direction",
+          			grid.Nx, Nx_set); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-Ny", "Number of processors in the y direction",
+          			grid.Ny, Ny_set); CHKERRQ(ierr);
 
   if (Nx_set ^ Ny_set) {
     ierr = PetscPrintf(grid.com,
@@ -394,10 +394,10 @@ PetscErrorCode IceModel::grid_setup() {
 
     bool procs_x_set, procs_y_set;
     vector<PetscInt> tmp_x, tmp_y;
-    ierr = PISMOptionsIntArray("-procs_x", "Processor ownership ranges (x direction)",
-			       tmp_x, procs_x_set); CHKERRQ(ierr);
-    ierr = PISMOptionsIntArray("-procs_y", "Processor ownership ranges (y direction)",
-			       tmp_y, procs_y_set); CHKERRQ(ierr);
+    ierr = PISMOptionsIntArray(grid.com, "-procs_x", "Processor ownership ranges (x direction)",
+          			       tmp_x, procs_x_set); CHKERRQ(ierr);
+    ierr = PISMOptionsIntArray(grid.com, "-procs_y", "Processor ownership ranges (y direction)",
+          			       tmp_y, procs_y_set); CHKERRQ(ierr);
 
     if (procs_x_set ^ procs_y_set) {
       ierr = PetscPrintf(grid.com,
@@ -470,10 +470,18 @@ PetscErrorCode IceModel::model_state_setup() {
   string filename;
 
   // Check if we are initializing from a PISM output file:
-  ierr = PISMOptionsString("-i", "Specifies a PISM input file",
-			   filename, i_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-i", "Specifies a PISM input file",
+          			   filename, i_set); CHKERRQ(ierr);
 
-  if (i_set) {
+  // If IceModel::run() saved the model state before the preliminary time
+  // step, roll back using the in-memory copy instead of re-reading files:
+  bool restoring = (model_state_snapshot.empty() == false);
+
+  if (restoring) {
+    ierr = restore_model_state_from_memory(); CHKERRQ(ierr);
+
+    ierr = updateSurfaceElevationAndMask(); CHKERRQ(ierr);
+  } else if (i_set) {
     ierr = initFromFile(filename.c_str()); CHKERRQ(ierr);
 
     ierr = regrid(0); CHKERRQ(ierr);
@@ -489,7 +497,8 @@ PetscErrorCode IceModel::model_state_setup() {
     ierr = beddef->init(variables); CHKERRQ(ierr);
   }
 
-  if (btu) {
+  // The bedrock temperature was restored by restore_model_state_from_memory().
+  if (btu && restoring == false) {
     PetscReal max_dt = 0;
     bool restrict = false;
     // FIXME: this will break if a surface or an ocean model requires
@@ -511,7 +520,10 @@ PetscErrorCode IceModel::model_state_setup() {
     ierr = btu->init(variables); CHKERRQ(ierr);
   }
 
-  if (basal_yield_stress) {
+  // The till friction angle does not change during the preliminary step and
+  // tauc is re-computed at every step, so the yield stress model does not
+  // need to be re-initialized (and re-read its inputs) when rolling back.
+  if (basal_yield_stress && restoring == false) {
     ierr = basal_yield_stress->init(variables); CHKERRQ(ierr);
   }
 
@@ -541,6 +553,107 @@ PetscErrorCode IceModel::model_state_setup() {
   return 0;
 }
 
+//! \brief Save model state variables in memory, so that IceModel::run() can
+//! roll back after the preliminary time step without re-reading input files.
+/*!
+ * Saves the same set of variables IceModel::initFromFile() reads (pism_intent
+ * "model_state", "mapping" and "climate_steady") plus the bedrock temperature.
+ * Diagnostic quantities computed during the preliminary step are kept.
+ *
+ * The snapshot is used by the next call of model_state_setup().
+ */
+PetscErrorCode IceModel::save_model_state_in_memory() {
+  PetscErrorCode ierr;
+
+  ierr = discard_model_state_snapshot(); CHKERRQ(ierr);
+
+  set<string> vars = variables.keys();
+  set<string>::iterator i = vars.begin();
+  while (i != vars.end()) {
+    IceModelVec *var = variables.get(*i);
+
+    string intent = var->string_attr("pism_intent");
+    if ((intent == "model_state") || (intent == "mapping") ||
+        (intent == "climate_steady")) {
+      Vec copy;
+      PetscInt local_size;
+
+      ierr = var->save_state(copy); CHKERRQ(ierr);
+      ierr = VecGetLocalSize(copy, &local_size); CHKERRQ(ierr);
+
+      grid.memory->allocate("IceModel", (double)local_size * sizeof(PetscScalar),
+                            var->get_ndims() == 3 ? MEMORY_LOCAL_3D : MEMORY_LOCAL_2D);
+
+      model_state_snapshot[*i] = copy;
+    }
+
+    ++i;
+  }
+
+  if (btu) {
+    Vec copy;
+    ierr = btu->save_state(copy); CHKERRQ(ierr);
+
+    if (copy != PETSC_NULL) {
+      PetscInt local_size;
+      ierr = VecGetLocalSize(copy, &local_size); CHKERRQ(ierr);
+      grid.memory->allocate("IceModel", (double)local_size * sizeof(PetscScalar),
+                            MEMORY_LOCAL_2D);
+
+      model_state_snapshot["litho_temp"] = copy;
+    }
+  }
+
+  return 0;
+}
+
+//! \brief Restore model state variables saved by save_model_state_in_memory().
+PetscErrorCode IceModel::restore_model_state_from_memory() {
+  PetscErrorCode ierr;
+
+  ierr = verbPrintf(3, grid.com,
+                    "  restoring the model state from memory ...\n"); CHKERRQ(ierr);
+
+  map<string,Vec>::iterator j = model_state_snapshot.begin();
+  while (j != model_state_snapshot.end()) {
+    IceModelVec *var = variables.get(j->first);
+
+    if (var != NULL) {
+      ierr = var->restore_state(j->second); CHKERRQ(ierr);
+    } else if (j->first == "litho_temp" && btu != NULL) {
+      ierr = btu->restore_state(j->second); CHKERRQ(ierr);
+    } else {
+      SETERRQ1(grid.com, 1, "IceModel::restore_model_state_from_memory(): '%s' is not available",
+               j->first.c_str());
+    }
+
+    ++j;
+  }
+
+  return 0;
+}
+
+//! \brief Free memory used by the in-memory copy of the model state.
+PetscErrorCode IceModel::discard_model_state_snapshot() {
+  PetscErrorCode ierr;
+
+  map<string,Vec>::iterator j = model_state_snapshot.begin();
+  while (j != model_state_snapshot.end()) {
+    IceModelVec *var = variables.get(j->first);
+    PetscInt local_size;
+
+    ierr = VecGetLocalSize(j->second, &local_size); CHKERRQ(ierr);
+    grid.memory->deallocate("IceModel", (double)local_size * sizeof(PetscScalar),
+                            (var != NULL && var->get_ndims() == 3) ? MEMORY_LOCAL_3D : MEMORY_LOCAL_2D);
+
+    ierr = VecDestroy(&j->second); CHKERRQ(ierr);
+    ++j;
+  }
+  model_state_snapshot.clear();
+
+  return 0;
+}
+
 //! Sets starting values of model state variables using command-line options.
 /*!
   Sets starting values of model state variables using command-line options and
@@ -556,8 +669,8 @@ PetscErrorCode IceModel::set_vars_from_options() {
   ierr = verbPrintf(3, grid.com,
 		    "Setting initial values of model state variables...\n"); CHKERRQ(ierr);
 
-  ierr = PISMOptionsString("-boot_file", "Specifies the file to bootstrap from",
-			   filename, boot_file_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-boot_file", "Specifies the file to bootstrap from",
+          			   filename, boot_file_set); CHKERRQ(ierr);
 
   if (boot_file_set) {
     ierr = bootstrapFromFile(filename.c_str()); CHKERRQ(ierr);
@@ -612,7 +725,7 @@ PetscErrorCode IceModel::allocate_enthalpy_converter() {
 
   if (getVerbosityLevel() > 3) {
     PetscViewer viewer;
-    ierr = PetscViewerASCIIGetStdout(PETSC_COMM_WORLD,&viewer); CHKERRQ(ierr);
+    ierr = PetscViewerASCIIGetStdout(grid.com,&viewer); CHKERRQ(ierr);
     ierr = EC->viewConstants(viewer); CHKERRQ(ierr);
   }
 
@@ -743,13 +856,21 @@ PetscErrorCode IceModel::allocate_submodels() {
   // this has to happen before allocate_stressbalance() is called
   ierr = allocate_basal_resistance_law(); CHKERRQ(ierr);
 
+  grid.memory->begin("stress balance");
   ierr = allocate_stressbalance(); CHKERRQ(ierr);
+  grid.memory->end();
 
+  grid.memory->begin("yield stress");
   ierr = allocate_basal_yield_stress(); CHKERRQ(ierr);
+  grid.memory->end();
 
+  grid.memory->begin("bedrock thermal unit");
   ierr = allocate_bedrock_thermal_unit(); CHKERRQ(ierr);
+  grid.memory->end();
 
+  grid.memory->begin("bed deformation");
   ierr = allocate_bed_deformation(); CHKERRQ(ierr);
+  grid.memory->end();
 
   return 0;
 }
@@ -763,11 +884,15 @@ PetscErrorCode IceModel::init_couplers() {
 		    "Initializing boundary models...\n"); CHKERRQ(ierr);
 
   if (surface != PETSC_NULL) {
+    grid.memory->begin("surface model");
     ierr = surface->init(variables); CHKERRQ(ierr);
+    grid.memory->end();
   } else {  SETERRQ(grid.com, 2,"PISM ERROR: surface == PETSC_NULL");  }
 
   if (ocean != PETSC_NULL) {
+    grid.memory->begin("ocean model");
     ierr = ocean->init(variables); CHKERRQ(ierr);
+    grid.memory->end();
   } else {  SETERRQ(grid.com, 2,"PISM ERROR: ocean == PETSC_NULL");  }
 
   return 0;
@@ -797,6 +922,17 @@ PetscErrorCode IceModel::allocate_internal_objects() {
            "e.g. new values of temperature or age or enthalpy during time step",
            "", ""); CHKERRQ(ierr);
 
+  if (config.get_flag("do_age") && config.get_flag("fuse_energy_age_steps") &&
+      config.get_flag("do_cold_ice_methods") == false) {
+    ierr = vWork3dAge.create(grid, "work_vector_3d_age", false); CHKERRQ(ierr);
+    ierr = vWork3dAge.set_attrs("internal", "new values of age during time step",
+                                "", ""); CHKERRQ(ierr);
+  }
+
+  if (config.get_flag("mass_continuity_implicit")) {
+    ierr = allocate_implicit_mass_continuity(); CHKERRQ(ierr);
+  }
+
   return 0;
 }
 
@@ -857,8 +993,8 @@ PetscErrorCode IceModel::init_ocean_kill() {
 
   ierr = PetscOptionsBegin(grid.com, "", "Fixed calving front options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-ocean_kill", "Specifies a file to get -ocean_kill thickness from",
-                             filename, flag, true); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-ocean_kill", "Specifies a file to get -ocean_kill thickness from",
+                                       filename, flag, true); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -946,3 +1082,41 @@ PetscErrorCode IceModel::allocate_bed_deformation() {
 
   return 0;
 }
+
+//! \brief Report memory use by PISM components; handle the -memory_report
+//! and -memory_predict options.
+/*!
+ * The report is printed at the verbosity level 3, or 2 if -memory_report is
+ * set.
+ *
+ * With <tt>-memory_predict Mx,My,Mz,N</tt> PISM prints an estimate of the
+ * per-processor peak memory use on a Mx*My*Mz grid distributed across N
+ * processors and stops. This makes it possible to use a small grid to check
+ * if a run fits in the memory of a given machine.
+ */
+PetscErrorCode IceModel::memory_report_setup() {
+  PetscErrorCode ierr;
+  bool memory_report, memory_predict;
+  vector<PetscInt> target;
+
+  ierr = PISMOptionsIsSet("-memory_report", "Report memory use by PISM components",
+                          memory_report); CHKERRQ(ierr);
+  ierr = PISMOptionsIntArray(grid.com, "-memory_predict",
+                                       "Predict memory use on a given grid and processor count (Mx,My,Mz,N) and stop",
+                                       target, memory_predict); CHKERRQ(ierr);
+
+  ierr = grid.memory->report(memory_report ? 2 : 3); CHKERRQ(ierr);
+
+  if (memory_predict) {
+    if (target.size() != 4) {
+      PetscPrintf(grid.com,
+                  "PISM ERROR: -memory_predict requires exactly 4 numbers (Mx,My,Mz,N)\n");
+      PISMEnd();
+    }
+
+    ierr = grid.memory->predict(grid, target[0], target[1], target[2], target[3]); CHKERRQ(ierr);
+    PISMEnd();
+  }
+
+  return 0;
+}
@@ -30,6 +30,7 @@
 #include "PISMSurface.hh"
 #include "pism_options.hh"
 #include "IceGrid.hh"
+#include "pism_threads.hh"
 
 //! \file iMoptions.cc Reading runtime options and setting configuration parameters.
 
@@ -61,8 +62,8 @@ PetscErrorCode  IceModel::setFromOptions() {
 
   ierr = set_config_from_options(grid.com, config); CHKERRQ(ierr);
 
-  ierr = PISMOptionsInt("-id", "Specifies the sounding row", id, flag); CHKERRQ(ierr);
-  ierr = PISMOptionsInt("-jd", "Specifies the sounding column", jd, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-id", "Specifies the sounding row", id, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-jd", "Specifies the sounding column", jd, flag); CHKERRQ(ierr);
 
   bool initfromT, initfromTandOm;
   ierr = PISMOptionsIsSet("-init_from_temp", initfromT); CHKERRQ(ierr);
@@ -73,6 +74,8 @@ PetscErrorCode  IceModel::setFromOptions() {
   // Set global attributes using the config database:
   global_attributes.set_from_config(config);
 
+  ierr = pism_set_threads(grid.com, (int)config.get("threads_per_process")); CHKERRQ(ierr);
+
   // warn about some option combinations
 
   if (config.get("maximum_time_step_years") <= 0) {
@@ -290,6 +290,14 @@ PetscErrorCode IceModel::summaryPrintLine(PetscBool printPrototype,  bool tempAn
     }
 
     stdout_flags_count0 += tempstr;
+
+    // report the wall-clock time saved by multirate scheduling (if any):
+    const double saved = schedule_saved_time();
+    if (saved > 0.0) {
+      snprintf(tempstr, 90, " (multirate: %.1f s saved)", saved);
+      stdout_flags_count0 += tempstr;
+    }
+
     if (delta_t > 0.0) { // avoids printing an empty line if we have not done anything
       stdout_flags_count0 += "\n";
       ierr = verbPrintf(2,grid.com, stdout_flags_count0.c_str()); CHKERRQ(ierr);
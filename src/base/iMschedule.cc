@@ -0,0 +1,223 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "iceModel.hh"
+#include "PISMTime.hh"
+#include "IceGrid.hh"
+
+//! \file iMschedule.cc Multirate scheduling of sub-model updates.
+
+//! \brief Initialize the multirate scheduler.
+/*!
+ * Each sub-model listed here is updated at most once every
+ * `*_update_interval_years` model years (0 means "every time step", which is
+ * the default). The -skip mechanism still controls the 3D velocity, energy
+ * and age updates; the bed deformation model has its own interval
+ * (`bed_def_interval_years`).
+ *
+ * Called by IceModel::run() after the preliminary time step, so that all the
+ * sub-models are updated at the first "real" step.
+ */
+PetscErrorCode IceModel::init_schedule() {
+  PetscErrorCode ierr;
+
+  schedule.clear();
+
+  map<string,string> intervals;
+  intervals["yield stress"]    = "yield_stress_update_interval_years";
+  intervals["couplers"]        = "coupler_update_interval_years";
+  intervals["iceberg removal"] = "iceberg_removal_interval_years";
+
+  map<string,string>::iterator j = intervals.begin();
+  while (j != intervals.end()) {
+    PISMSchedule &s = schedule[j->first];
+
+    s.interval    = config.get(j->second, "years", "seconds");
+    s.last_update = 0.0;
+    s.next_update = 0.0;
+    s.wall_time   = 0.0;
+    s.runs        = 0;
+    s.skips       = 0;
+    s.window      = false;
+
+    if (s.interval > 0.0) {
+      ierr = verbPrintf(2, grid.com,
+                        "* Updating %s at most every %3.3f years (multirate scheduling).\n",
+                        j->first.c_str(), convert(s.interval, "seconds", "years")); CHKERRQ(ierr);
+    }
+
+    ++j;
+  }
+
+  return 0;
+}
+
+//! \brief Returns true if the sub-model `name` should be updated at the
+//! current time step.
+/*!
+ * Sub-models that are not known to the scheduler are always updated.
+ */
+bool IceModel::scheduled(string name) {
+  map<string,PISMSchedule>::iterator j = schedule.find(name);
+  if (j == schedule.end())
+    return true;
+
+  PISMSchedule &s = j->second;
+  const double t = grid.time->current();
+
+  // Time steps end exactly at next_update if it is set by schedule_window()
+  // (see schedule_max_timestep()), up to round-off:
+  if (s.interval <= 0.0 || s.runs == 0 || t >= s.next_update - 1e-6 * s.interval) {
+    s.last_update = t;
+    s.next_update = t + s.interval;
+    s.runs += 1;
+    return true;
+  }
+
+  s.skips += 1;
+  return false;
+}
+
+//! \brief Returns the length of the time interval an update of `name` at the
+//! current time has to cover.
+/*!
+ * Models updated using update(t, dt) (the surface and ocean models) compute
+ * averages over [t, t + dt]. If the next update is skipped, these values
+ * are used until the next scheduled update, so they have to be averaged over
+ * that whole interval (and not over the current time step only).
+ *
+ * Returns `my_dt` if `name` is updated at every step. Otherwise returns the
+ * scheduling interval, reduced to stay within the run and below `max_dt`
+ * (if positive), but not below `my_dt`. schedule_max_timestep() makes time
+ * steps end exactly at the end of this interval.
+ *
+ * Call this right after scheduled(name) returned true.
+ */
+double IceModel::schedule_window(string name, double my_dt, double max_dt) {
+  map<string,PISMSchedule>::iterator j = schedule.find(name);
+  if (j == schedule.end() || j->second.interval <= 0.0)
+    return my_dt;
+
+  PISMSchedule &s = j->second;
+  const double t = grid.time->current();
+
+  double result = PetscMin(s.interval, grid.time->end() - t);
+  if (max_dt > 0.0)
+    result = PetscMin(result, max_dt);
+  result = PetscMax(result, my_dt);
+
+  s.window      = true;
+  s.next_update = t + result;
+
+  return result;
+}
+
+//! \brief Restricts the time step so that steps end at the end of intervals
+//! covered by updates (see schedule_window()).
+PetscErrorCode IceModel::schedule_max_timestep(double my_t, double &my_dt, bool &restrict) {
+  restrict = false;
+  my_dt = 0.0;
+
+  map<string,PISMSchedule>::iterator j = schedule.begin();
+  while (j != schedule.end()) {
+    PISMSchedule &s = j->second;
+
+    if (s.window && s.next_update > my_t) {
+      const double dt = s.next_update - my_t;
+      if (restrict == false || dt < my_dt)
+        my_dt = dt;
+      restrict = true;
+    }
+
+    ++j;
+  }
+
+  return 0;
+}
+
+//! \brief Record the wall-clock time spent updating `name` (since `start`).
+/*!
+ * Used to estimate the time saved by skipping updates.
+ */
+PetscErrorCode IceModel::schedule_add_time(string name, PetscLogDouble start) {
+  PetscErrorCode ierr;
+  PetscLogDouble now;
+
+  map<string,PISMSchedule>::iterator j = schedule.find(name);
+  if (j == schedule.end())
+    return 0;
+
+  ierr = PetscGetTime(&now); CHKERRQ(ierr);
+  j->second.wall_time += now - start;
+
+  return 0;
+}
+
+//! \brief Estimate of the wall-clock time saved by skipped updates, in seconds.
+double IceModel::schedule_saved_time() {
+  double result = 0.0;
+
+  map<string,PISMSchedule>::iterator j = schedule.begin();
+  while (j != schedule.end()) {
+    PISMSchedule &s = j->second;
+    if (s.runs > 0)
+      result += s.skips * (s.wall_time / s.runs);
+    ++j;
+  }
+
+  return result;
+}
+
+//! \brief Print the number of updates and skipped updates of each scheduled
+//! sub-model and the estimated speedup.
+PetscErrorCode IceModel::schedule_report() {
+  PetscErrorCode ierr;
+  int total_skips = 0;
+
+  map<string,PISMSchedule>::iterator j = schedule.begin();
+  while (j != schedule.end()) {
+    total_skips += j->second.skips;
+    ++j;
+  }
+
+  if (total_skips == 0)
+    return 0;
+
+  ierr = verbPrintf(2, grid.com, "Multirate scheduling summary:\n"
+                    "  %-20s %8s %8s %14s\n", "sub-model", "updates", "skipped",
+                    "est. saved, s"); CHKERRQ(ierr);
+
+  for (j = schedule.begin(); j != schedule.end(); ++j) {
+    PISMSchedule &s = j->second;
+    double saved = s.runs > 0 ? s.skips * (s.wall_time / s.runs) : 0.0;
+
+    ierr = verbPrintf(2, grid.com, "  %-20s %8d %8d %14.2f\n",
+                      j->first.c_str(), s.runs, s.skips, saved); CHKERRQ(ierr);
+  }
+
+  PetscLogDouble now;
+  ierr = PetscGetTime(&now); CHKERRQ(ierr);
+
+  double elapsed = now - start_time, saved = schedule_saved_time();
+  if (elapsed > 0.0) {
+    ierr = verbPrintf(2, grid.com, "  estimated speedup: %.2f\n",
+                      (elapsed + saved) / elapsed); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
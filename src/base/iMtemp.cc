@@ -24,6 +24,7 @@
 #include "PISMStressBalance.hh"
 #include "bedrockThermalUnit.hh"
 #include "pism_options.hh"
+#include "pism_threads.hh"
 
 
 //! \file iMtemp.cc Methods of IceModel which implement the cold-ice, temperature-based formulation of conservation of energy.
@@ -149,17 +150,11 @@ PetscErrorCode IceModel::temperatureStep(PetscScalar* vertSacrCount, PetscScalar
       melting_point_temp = config.get("water_melting_point_temperature"),
       beta_CC_grad = config.get("beta_CC") * ice_rho * config.get("standard_gravity");
 
-    tempSystemCtx system(fMz, "temperature");
-    system.dx              = grid.dx;
-    system.dy              = grid.dy;
-    system.dtTemp          = dt_TempAge; // same time step for temp and age, currently
-    system.dzEQ            = fdz;
-    system.ice_rho         = ice_rho;
-    system.ice_k           = ice_k;
-    system.ice_c_p         = ice_c;
-
-    PetscScalar *x;
-    x = new PetscScalar[fMz]; // space for solution of system
+    // column systems and work space, one set per thread (see pism_threads.hh)
+    const int n_threads = pism_max_threads();
+    vector<tempSystemCtx*> systems(n_threads, NULL);
+    vector<PetscScalar*> thread_x(n_threads, NULL), thread_Tnew(n_threads, NULL);
+    vector<PetscErrorCode> thread_error(n_threads, 0);
 
     // this is bulge limit constant in K; is max amount by which ice
     //   or bedrock can be lower than surface temperature
@@ -167,20 +162,33 @@ PetscErrorCode IceModel::temperatureStep(PetscScalar* vertSacrCount, PetscScalar
 
     const PetscReal bwat_decay_rate = config.get("bwat_decay_rate");  // m s-1
 
-    PetscScalar *Tnew;
-    // pointers to values in current column
-    system.u     = new PetscScalar[fMz];
-    system.v     = new PetscScalar[fMz];
-    system.w     = new PetscScalar[fMz];
-    system.Sigma = new PetscScalar[fMz];
-    system.T     = new PetscScalar[fMz];
-    Tnew         = new PetscScalar[fMz];
-
-    // system needs access to T3 for T3.getPlaneStar_fine()
-    system.T3 = &T3;
-
-    // checks that all needed constants and pointers got set:
-    ierr = system.initAllColumns(); CHKERRQ(ierr);
+    for (int t = 0; t < n_threads; ++t) {
+      tempSystemCtx *system = new tempSystemCtx(fMz, "temperature");
+      system->dx              = grid.dx;
+      system->dy              = grid.dy;
+      system->dtTemp          = dt_TempAge; // same time step for temp and age, currently
+      system->dzEQ            = fdz;
+      system->ice_rho         = ice_rho;
+      system->ice_k           = ice_k;
+      system->ice_c_p         = ice_c;
+
+      // pointers to values in current column
+      system->u     = new PetscScalar[fMz];
+      system->v     = new PetscScalar[fMz];
+      system->w     = new PetscScalar[fMz];
+      system->Sigma = new PetscScalar[fMz];
+      system->T     = new PetscScalar[fMz];
+
+      // system needs access to T3 for T3.getPlaneStar_fine()
+      system->T3 = &T3;
+
+      // checks that all needed constants and pointers got set:
+      ierr = system->initAllColumns(); CHKERRQ(ierr);
+
+      systems[t] = system;
+      thread_x[t]    = new PetscScalar[fMz]; // space for solution of system
+      thread_Tnew[t] = new PetscScalar[fMz];
+    }
 
     // now get map-plane fields, starting with coupler fields
     PetscScalar  **bwat, **basalMeltRate;
@@ -241,160 +249,188 @@ PetscErrorCode IceModel::temperatureStep(PetscScalar* vertSacrCount, PetscScalar
 
     MaskQuery mask(vMask);
 
-    for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
-      for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
-
-        // this should *not* be replaced by call to grid.kBelowHeight():
-        const PetscInt  ks = static_cast<PetscInt>(floor(vH(i,j)/fdz));
-
-        if (ks>0) { // if there are enough points in ice to bother ...
-          ierr = system.setIndicesAndClearThisColumn(i,j,ks); CHKERRQ(ierr);
-
-          ierr = u3->getValColumn(i,j,ks,system.u); CHKERRQ(ierr);
-          ierr = v3->getValColumn(i,j,ks,system.v); CHKERRQ(ierr);
-          ierr = w3->getValColumn(i,j,ks,system.w); CHKERRQ(ierr);
-          ierr = Sigma3->getValColumn(i,j,ks,system.Sigma); CHKERRQ(ierr);
-          ierr = T3.getValColumn(i,j,ks,system.T); CHKERRQ(ierr);
-
-          // go through column and find appropriate lambda for BOMBPROOF
-          PetscScalar lambda = 1.0;  // start with centered implicit for more accuracy
-          for (PetscInt k = 1; k < ks; k++) {
-            const PetscScalar denom = (PetscAbs(system.w[k]) + 0.000001/secpera)
-              * ice_rho * ice_c * fdz;
-            lambda = PetscMin(lambda, 2.0 * ice_k / denom);
-          }
-          if (lambda < 1.0)  *vertSacrCount += 1; // count columns with lambda < 1
-          // if isMarginal then only do vertical conduction for ice; ignore advection
-          //   and strain heating if isMarginal
-          const bool isMarginal = checkThinNeigh(vH(i+1,j),vH(i+1,j+1),vH(i,j+1),vH(i-1,j+1),
-                                                 vH(i-1,j),vH(i-1,j-1),vH(i,j-1),vH(i+1,j-1));
-          PismMask mask_value = static_cast<PismMask>(vMask.as_int(i,j));
-          ierr = system.setSchemeParamsThisColumn(mask_value, isMarginal, lambda);
-          CHKERRQ(ierr);
-
-          // set boundary values for tridiagonal system
-          ierr = system.setSurfaceBoundaryValuesThisColumn(artm(i,j)); CHKERRQ(ierr);
-          ierr = system.setBasalBoundaryValuesThisColumn(G0(i,j),shelfbtemp(i,j),(*Rb)(i,j)); CHKERRQ(ierr);
-
-          // solve the system for this column; melting not addressed yet
-          PetscErrorCode pivoterr;
-          ierr = system.solveThisColumn(&x, pivoterr); CHKERRQ(ierr);
-
-          if (pivoterr != 0) {
-            ierr = PetscPrintf(PETSC_COMM_SELF,
-              "\n\ntridiagonal solve of tempSystemCtx in temperatureStep() FAILED at (%d,%d)\n"
-                  " with zero pivot position %d; viewing system to m-file ... \n",
-              i, j, pivoterr); CHKERRQ(ierr);
-            ierr = system.reportColumnZeroPivotErrorMFile(pivoterr); CHKERRQ(ierr);
-            SETERRQ(grid.com, 1,"PISM ERROR in temperatureStep()\n");
-          }
-          if (viewOneColumn && issounding(i,j)) {
-            ierr = PetscPrintf(grid.com,
-              "\n\nin temperatureStep(): viewing tempSystemCtx at (i,j)=(%d,%d) to m-file ... \n\n",
-              i, j); CHKERRQ(ierr);
-            ierr = system.viewColumnInfoMFile(x, fMz); CHKERRQ(ierr);
-          }
+    PetscScalar my_vertSacrCount = 0.0, my_bulgeCount = 0.0;
+
+    // Columns are independent, so they can be updated by different threads.
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr) reduction(+:myLowTempCount,my_vertSacrCount,my_bulgeCount)
+#endif
+    {
+      const int thread = pism_thread_id();
+      tempSystemCtx &system = *systems[thread];
+      PetscScalar *x = thread_x[thread], *Tnew = thread_Tnew[thread];
+      PetscErrorCode &error = thread_error[thread];
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp for schedule(dynamic)
+#endif
+      for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
+        for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
+
+          // this should *not* be replaced by call to grid.kBelowHeight():
+          const PetscInt  ks = static_cast<PetscInt>(floor(vH(i,j)/fdz));
+
+          if (ks>0) { // if there are enough points in ice to bother ...
+            ierr = system.setIndicesAndClearThisColumn(i,j,ks); PISM_THREAD_CHKERRQ(ierr, error);
+
+            ierr = u3->getValColumn(i,j,ks,system.u); PISM_THREAD_CHKERRQ(ierr, error);
+            ierr = v3->getValColumn(i,j,ks,system.v); PISM_THREAD_CHKERRQ(ierr, error);
+            ierr = w3->getValColumn(i,j,ks,system.w); PISM_THREAD_CHKERRQ(ierr, error);
+            ierr = Sigma3->getValColumn(i,j,ks,system.Sigma); PISM_THREAD_CHKERRQ(ierr, error);
+            ierr = T3.getValColumn(i,j,ks,system.T); PISM_THREAD_CHKERRQ(ierr, error);
+
+            // go through column and find appropriate lambda for BOMBPROOF
+            PetscScalar lambda = 1.0;  // start with centered implicit for more accuracy
+            for (PetscInt k = 1; k < ks; k++) {
+              const PetscScalar denom = (PetscAbs(system.w[k]) + 0.000001/secpera)
+                * ice_rho * ice_c * fdz;
+              lambda = PetscMin(lambda, 2.0 * ice_k / denom);
+            }
+            if (lambda < 1.0)  my_vertSacrCount += 1; // count columns with lambda < 1
+            // if isMarginal then only do vertical conduction for ice; ignore advection
+            //   and strain heating if isMarginal
+            const bool isMarginal = checkThinNeigh(vH(i+1,j),vH(i+1,j+1),vH(i,j+1),vH(i-1,j+1),
+                                                   vH(i-1,j),vH(i-1,j-1),vH(i,j-1),vH(i+1,j-1));
+            PismMask mask_value = static_cast<PismMask>(vMask.as_int(i,j));
+            ierr = system.setSchemeParamsThisColumn(mask_value, isMarginal, lambda);
+            PISM_THREAD_CHKERRQ(ierr, error);
+
+            // set boundary values for tridiagonal system
+            ierr = system.setSurfaceBoundaryValuesThisColumn(artm(i,j)); PISM_THREAD_CHKERRQ(ierr, error);
+            ierr = system.setBasalBoundaryValuesThisColumn(G0(i,j),shelfbtemp(i,j),(*Rb)(i,j)); PISM_THREAD_CHKERRQ(ierr, error);
+
+            // solve the system for this column; melting not addressed yet
+            PetscErrorCode pivoterr;
+            ierr = system.solveThisColumn(&x, pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
+
+            if (pivoterr != 0) {
+              ierr = PetscPrintf(PETSC_COMM_SELF,
+                "\n\ntridiagonal solve of tempSystemCtx in temperatureStep() FAILED at (%d,%d)\n"
+                    " with zero pivot position %d; viewing system to m-file ... \n",
+                i, j, pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
+              ierr = system.reportColumnZeroPivotErrorMFile(pivoterr); PISM_THREAD_CHKERRQ(ierr, error);
+              error = 1;
+              continue;
+            }
+            if (viewOneColumn && issounding(i,j)) {
+              ierr = PetscPrintf(PETSC_COMM_SELF,
+                "\n\nin temperatureStep(): viewing tempSystemCtx at (i,j)=(%d,%d) to m-file ... \n\n",
+                i, j); PISM_THREAD_CHKERRQ(ierr, error);
+              ierr = system.viewColumnInfoMFile(x, fMz); PISM_THREAD_CHKERRQ(ierr, error);
+            }
 
-        }	// end of "if there are enough points in ice to bother ..."
+          }	// end of "if there are enough points in ice to bother ..."
 
-        // prepare for melting/refreezing
-        PetscScalar bwatnew = bwat[i][j];
+          // prepare for melting/refreezing
+          PetscScalar bwatnew = bwat[i][j];
 
-        // insert solution for generic ice segments
-        for (PetscInt k=1; k <= ks; k++) {
-          if (allowAboveMelting == PETSC_TRUE) { // in the ice
-            Tnew[k] = x[k];
-          } else {
-            const PetscScalar
-              Tpmp = melting_point_temp - beta_CC_grad * (vH(i,j) - fzlev[k]); // FIXME issue #15
-            if (x[k] > Tpmp) {
-              Tnew[k] = Tpmp;
-              PetscScalar Texcess = x[k] - Tpmp; // always positive
-              excessToFromBasalMeltLayer(ice_rho, ice_c, L, fzlev[k], fdz, &Texcess, &bwatnew);
-              // Texcess  will always come back zero here; ignore it
-            } else {
+          // insert solution for generic ice segments
+          for (PetscInt k=1; k <= ks; k++) {
+            if (allowAboveMelting == PETSC_TRUE) { // in the ice
               Tnew[k] = x[k];
-            }
-          }
-          if (Tnew[k] < globalMinAllowedTemp) {
-            ierr = PetscPrintf(PETSC_COMM_SELF,
-                               "  [[too low (<200) ice segment temp T = %f at %d,%d,%d;"
-                               " proc %d; mask=%d; w=%f m/a]]\n",
-                               Tnew[k],i,j,k,grid.rank,vMask.as_int(i,j),
-                               convert(system.w[k], "m/s", "m/year")); CHKERRQ(ierr);
-            myLowTempCount++;
-          }
-          if (Tnew[k] < artm(i,j) - bulgeMax) {
-            Tnew[k] = artm(i,j) - bulgeMax;  bulgeCount++;   }
-        }
-
-        // insert solution for ice base segment
-        if (ks > 0) {
-          if (allowAboveMelting == PETSC_TRUE) { // ice/rock interface
-            Tnew[0] = x[0];
-          } else {  // compute diff between x[k0] and Tpmp; melt or refreeze as appropriate
-            const PetscScalar Tpmp = melting_point_temp - beta_CC_grad * vH(i,j); // FIXME issue #15
-            PetscScalar Texcess = x[0] - Tpmp; // positive or negative
-            if (mask.ocean(i,j)) {
-              // when floating, only half a segment has had its temperature raised
-              // above Tpmp
-              excessToFromBasalMeltLayer(ice_rho, ice_c, L, 0.0, fdz/2.0, &Texcess, &bwatnew);
             } else {
-              excessToFromBasalMeltLayer(ice_rho, ice_c, L, 0.0, fdz, &Texcess, &bwatnew);
+              const PetscScalar
+                Tpmp = melting_point_temp - beta_CC_grad * (vH(i,j) - fzlev[k]); // FIXME issue #15
+              if (x[k] > Tpmp) {
+                Tnew[k] = Tpmp;
+                PetscScalar Texcess = x[k] - Tpmp; // always positive
+                excessToFromBasalMeltLayer(ice_rho, ice_c, L, fzlev[k], fdz, &Texcess, &bwatnew);
+                // Texcess  will always come back zero here; ignore it
+              } else {
+                Tnew[k] = x[k];
+              }
             }
-            Tnew[0] = Tpmp + Texcess;
-            if (Tnew[0] > (Tpmp + 0.00001)) {
-              SETERRQ(grid.com, 1,"updated temperature came out above Tpmp");
+            if (Tnew[k] < globalMinAllowedTemp) {
+              ierr = PetscPrintf(PETSC_COMM_SELF,
+                                 "  [[too low (<200) ice segment temp T = %f at %d,%d,%d;"
+                                 " proc %d; mask=%d; w=%f m/a]]\n",
+                                 Tnew[k],i,j,k,grid.rank,vMask.as_int(i,j),
+                                 convert(system.w[k], "m/s", "m/year")); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+              myLowTempCount++;
             }
+            if (Tnew[k] < artm(i,j) - bulgeMax) {
+              Tnew[k] = artm(i,j) - bulgeMax;  my_bulgeCount += 1;   }
           }
-          if (Tnew[0] < globalMinAllowedTemp) {
-            ierr = PetscPrintf(PETSC_COMM_SELF,
-                               "  [[too low (<200) ice/bedrock segment temp T = %f at %d,%d;"
-                               " proc %d; mask=%d; w=%f]]\n",
-                               Tnew[0],i,j,grid.rank,vMask.as_int(i,j),
-                               convert(system.w[0], "m/s", "m/year")); CHKERRQ(ierr);
-            myLowTempCount++;
+          PISM_THREAD_CHKERRQ(error, error);
+
+          // insert solution for ice base segment
+          if (ks > 0) {
+            if (allowAboveMelting == PETSC_TRUE) { // ice/rock interface
+              Tnew[0] = x[0];
+            } else {  // compute diff between x[k0] and Tpmp; melt or refreeze as appropriate
+              const PetscScalar Tpmp = melting_point_temp - beta_CC_grad * vH(i,j); // FIXME issue #15
+              PetscScalar Texcess = x[0] - Tpmp; // positive or negative
+              if (mask.ocean(i,j)) {
+                // when floating, only half a segment has had its temperature raised
+                // above Tpmp
+                excessToFromBasalMeltLayer(ice_rho, ice_c, L, 0.0, fdz/2.0, &Texcess, &bwatnew);
+              } else {
+                excessToFromBasalMeltLayer(ice_rho, ice_c, L, 0.0, fdz, &Texcess, &bwatnew);
+              }
+              Tnew[0] = Tpmp + Texcess;
+              if (Tnew[0] > (Tpmp + 0.00001)) {
+                PetscPrintf(PETSC_COMM_SELF,
+                            "PISM ERROR: updated temperature came out above Tpmp at %d,%d\n", i, j);
+                error = 1;
+                continue;
+              }
+            }
+            if (Tnew[0] < globalMinAllowedTemp) {
+              ierr = PetscPrintf(PETSC_COMM_SELF,
+                                 "  [[too low (<200) ice/bedrock segment temp T = %f at %d,%d;"
+                                 " proc %d; mask=%d; w=%f]]\n",
+                                 Tnew[0],i,j,grid.rank,vMask.as_int(i,j),
+                                 convert(system.w[0], "m/s", "m/year")); PISM_THREAD_CHKERRQ(ierr, error);
+              myLowTempCount++;
+            }
+            if (Tnew[0] < artm(i,j) - bulgeMax) {
+              Tnew[0] = artm(i,j) - bulgeMax;   my_bulgeCount += 1;   }
+          } else {
+            bwatnew = 0.0;
           }
-          if (Tnew[0] < artm(i,j) - bulgeMax) {
-            Tnew[0] = artm(i,j) - bulgeMax;   bulgeCount++;   }
-        } else {
-          bwatnew = 0.0;
-        }
 
-        // set to air temp above ice
-        for (PetscInt k=ks; k<fMz; k++) {
-          Tnew[k] = artm(i,j);
-        }
+          // set to air temp above ice
+          for (PetscInt k=ks; k<fMz; k++) {
+            Tnew[k] = artm(i,j);
+          }
 
-        // transfer column into vWork3d; communication later
-        ierr = vWork3d.setValColumnPL(i,j,Tnew); CHKERRQ(ierr);
-
-        // basalMeltRate[][] is rate of mass loss at bottom of ice; finalize it and bwat
-        //   note massContExplicitStep() calls PISMOceanCoupler; FIXME: does there
-        //   need to be a check that shelfbmassflux(i,j) is up to date?
-        if (mask.ocean(i,j)) {
-          if (mask.icy(i,j)) {
-            // rate of mass loss at bottom of ice shelf;  can be negative (marine freeze-on)
-            basalMeltRate[i][j] = shelfbmassflux(i,j); // set by PISMOceanCoupler
-            // if floating ice is present assume maximally saturated till to avoid "shock" if
-            //   grounding line advances
-            bwat[i][j] = bwat_max;
+          // transfer column into vWork3d; communication later
+          ierr = vWork3d.setValColumnPL(i,j,Tnew); PISM_THREAD_CHKERRQ(ierr, error);
+
+          // basalMeltRate[][] is rate of mass loss at bottom of ice; finalize it and bwat
+          //   note massContExplicitStep() calls PISMOceanCoupler; FIXME: does there
+          //   need to be a check that shelfbmassflux(i,j) is up to date?
+          if (mask.ocean(i,j)) {
+            if (mask.icy(i,j)) {
+              // rate of mass loss at bottom of ice shelf;  can be negative (marine freeze-on)
+              basalMeltRate[i][j] = shelfbmassflux(i,j); // set by PISMOceanCoupler
+              // if floating ice is present assume maximally saturated till to avoid "shock" if
+              //   grounding line advances
+              bwat[i][j] = bwat_max;
+            } else {
+              basalMeltRate[i][j] = 0.0;
+              bwat[i][j] = 0.0;
+            }
           } else {
-            basalMeltRate[i][j] = 0.0;
-            bwat[i][j] = 0.0;
+            // basalMeltRate is rate of change of bwat[][];  can be negative
+            //   (subglacial water freezes-on); note this rate is calculated
+            //   *before* limiting bwat.
+            basalMeltRate[i][j] = (bwatnew - bwat[i][j]) / dt_TempAge;
+            // model loss to undetermined exterior:
+            bwatnew -= bwat_decay_rate * dt_TempAge;
+            bwat[i][j] = PetscMin(bwat_max, PetscMax(bwatnew, 0.0));
           }
-        } else {
-          // basalMeltRate is rate of change of bwat[][];  can be negative
-          //   (subglacial water freezes-on); note this rate is calculated
-          //   *before* limiting bwat.
-          basalMeltRate[i][j] = (bwatnew - bwat[i][j]) / dt_TempAge;
-          // model loss to undetermined exterior:
-          bwatnew -= bwat_decay_rate * dt_TempAge;
-          bwat[i][j] = PetscMin(bwat_max, PetscMax(bwatnew, 0.0));
+
         }
+      }
+    } // end of the parallel region
 
+    for (int t = 0; t < n_threads; ++t) {
+      CHKERRQ(thread_error[t]);
     }
-  }
+
+    *vertSacrCount += my_vertSacrCount;
+    *bulgeCount += my_bulgeCount;
 
   if (myLowTempCount > maxLowTempCount) { SETERRQ(grid.com, 1,"too many low temps"); }
 
@@ -417,10 +453,12 @@ PetscErrorCode IceModel::temperatureStep(PetscScalar* vertSacrCount, PetscScalar
   ierr = T3.end_access(); CHKERRQ(ierr);
   ierr = vWork3d.end_access(); CHKERRQ(ierr);
 
-  delete [] x;
-  delete [] system.T;  delete [] system.Sigma;
-  delete [] system.u;  delete [] system.v;  delete [] system.w;
-  delete [] Tnew;
+  for (int t = 0; t < n_threads; ++t) {
+    delete [] thread_x[t];  delete [] thread_Tnew[t];
+    delete [] systems[t]->T;  delete [] systems[t]->Sigma;
+    delete [] systems[t]->u;  delete [] systems[t]->v;  delete [] systems[t]->w;
+    delete systems[t];
+  }
   return 0;
 }
 
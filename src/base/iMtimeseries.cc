@@ -35,14 +35,14 @@ PetscErrorCode IceModel::init_timeseries() {
 
   ierr = PetscOptionsBegin(grid.com, "", "Options controlling scalar diagnostic time-series", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-ts_file", "Specifies the time-series output file name",
-			     ts_filename, ts_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-ts_file", "Specifies the time-series output file name",
+          			     ts_filename, ts_file_set); CHKERRQ(ierr);
 
-    ierr = PISMOptionsString("-ts_times", "Specifies a MATLAB-style range or a list of requested times",
-			     times, ts_times_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-ts_times", "Specifies a MATLAB-style range or a list of requested times",
+          			     times, ts_times_set); CHKERRQ(ierr);
 
-    ierr = PISMOptionsString("-ts_vars", "Specifies a comma-separated list of veriables to save",
-			     vars, ts_vars_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-ts_vars", "Specifies a comma-separated list of veriables to save",
+          			     vars, ts_vars_set); CHKERRQ(ierr);
 
     // default behavior is to move the file aside if it exists already; option allows appending
     ierr = PISMOptionsIsSet("-ts_append", append); CHKERRQ(ierr);
@@ -189,14 +189,14 @@ PetscErrorCode IceModel::init_extras() {
 
   ierr = PetscOptionsBegin(grid.com, "", "Options controlling 2D and 3D diagnostic output", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-extra_file", "Specifies the output file",
-			     extra_filename, extra_file_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-extra_file", "Specifies the output file",
+          			     extra_filename, extra_file_set); CHKERRQ(ierr);
 
-    ierr = PISMOptionsString("-extra_times", "Specifies times to save at",
-			     times, extra_times_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-extra_times", "Specifies times to save at",
+          			     times, extra_times_set); CHKERRQ(ierr);
 
-    ierr = PISMOptionsString("-extra_vars", "Spacifies a comma-separated list of variables to save",
-			     vars, extra_vars_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-extra_vars", "Spacifies a comma-separated list of variables to save",
+          			     vars, extra_vars_set); CHKERRQ(ierr);
 
     ierr = PISMOptionsIsSet("-extra_split", "Specifies whether to save to separate files",
 			    split); CHKERRQ(ierr);
@@ -52,7 +52,8 @@ model year.  In addition the time series (\c -ts_file, etc.) is flushed out
 There is no indication of these actions in the history attribute of the output (\c -o)
 NetCDF file because there is no effect on it, but there is an indication at \c stdout.
 
-Signal \c SIGUSR2 makes PISM flush time-series, without saving model state.
+Signal \c SIGUSR2 makes PISM flush time-series, without saving model state,
+and print current and peak memory use by component.
  */
 int IceModel::endOfTimeStepHook() {
   PetscErrorCode ierr;
@@ -89,6 +90,8 @@ int IceModel::endOfTimeStepHook() {
 
     // flush all the time-series buffers:
     ierr = flush_timeseries(); CHKERRQ(ierr);
+
+    ierr = grid.memory->report(1); CHKERRQ(ierr);
   }
 
   return 0;
@@ -65,6 +65,12 @@ IceModel::IceModel(IceGrid &g, NCConfigVariable &conf, NCConfigVariable &conf_ov
   EC = NULL;
   btu = NULL;
 
+  age_in_energy_step = false;
+
+  thickness_ksp = PETSC_NULL;
+  thickness_matrix = PETSC_NULL;
+  thickness_rhs = thickness_x = PETSC_NULL;
+
   executable_short_name = "pism"; // drivers typically override this
 
   shelvesDragToo = PETSC_FALSE;
@@ -124,6 +130,7 @@ void IceModel::reset_counters() {
 
 IceModel::~IceModel() {
 
+  discard_model_state_snapshot();
   deallocate_internal_objects();
 
   // de-allocate time-series diagnostics
@@ -179,7 +186,22 @@ PetscErrorCode IceModel::createVecs() {
   // the CF conventions; see
   // http://cf-pcmdi.llnl.gov/documents/cf-standard-names
 
-  ierr = Enth3.create(grid, "enthalpy", true, WIDE_STENCIL); CHKERRQ(ierr);
+  // The semi-Lagrangian horizontal advection scheme reads enthalpy and age at
+  // departure points up to semi_lagrangian_cfl_factor grid cells away (see
+  // IceModelVec3::getValDeparture_fine()), so these need a wider halo.
+  PetscInt ADVECTION_STENCIL = WIDE_STENCIL;
+  if (config.get_flag("semi_lagrangian_advection")) {
+    const PetscReal cfl_factor = config.get("semi_lagrangian_cfl_factor");
+    if (cfl_factor < 1.0) {
+      PetscPrintf(grid.com,
+                  "PISM ERROR: semi_lagrangian_cfl_factor = %f is invalid (has to be at least 1).\n",
+                  cfl_factor);
+      PISMEnd();
+    }
+    ADVECTION_STENCIL = PetscMax(WIDE_STENCIL, static_cast<PetscInt>(ceil(cfl_factor)));
+  }
+
+  ierr = Enth3.create(grid, "enthalpy", true, ADVECTION_STENCIL); CHKERRQ(ierr);
   // POSSIBLE standard name = land_ice_enthalpy
   ierr = Enth3.set_attrs(
                          "model_state",
@@ -199,7 +221,7 @@ PetscErrorCode IceModel::createVecs() {
 
   // age of ice but only if age will be computed
   if (config.get_flag("do_age")) {
-    ierr = tau3.create(grid, "age", true, WIDE_STENCIL); CHKERRQ(ierr);
+    ierr = tau3.create(grid, "age", true, ADVECTION_STENCIL); CHKERRQ(ierr);
     // PROPOSED standard_name = land_ice_age
     ierr = tau3.set_attrs("model_state", "age of ice",
                           "s", ""); CHKERRQ(ierr);
@@ -258,9 +280,12 @@ PetscErrorCode IceModel::createVecs() {
   vMask.output_data_type = PISM_BYTE;
   ierr = variables.add(vMask); CHKERRQ(ierr);
 
-  // iceberg identifying integer mask
+  // iceberg identifying integer mask; a wider halo allows
+  // identifyNotAnIceBerg() to do several sweeps per ghost exchange
   if (config.get_flag("kill_icebergs")) {
-    ierr = vIcebergMask.create(grid, "IcebergMask", true, WIDE_STENCIL); CHKERRQ(ierr);
+    PetscInt iceberg_mask_width = PetscMax(WIDE_STENCIL,
+                                           (PetscInt)config.get("iterative_halo_width"));
+    ierr = vIcebergMask.create(grid, "IcebergMask", true, iceberg_mask_width); CHKERRQ(ierr);
     ierr = vIcebergMask.set_attrs("internal", 
                                   "iceberg-identifying integer mask",
                                   "", ""); CHKERRQ(ierr);
@@ -497,6 +522,10 @@ PetscErrorCode IceModel::createVecs() {
   deformation model.
  */
 PetscErrorCode IceModel::deallocate_internal_objects() {
+  PetscErrorCode ierr;
+
+  ierr = deallocate_implicit_mass_continuity(); CHKERRQ(ierr);
+
   return 0;
 }
 
@@ -521,7 +550,7 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
   ierr = additionalAtStartTimestep(); CHKERRQ(ierr);  // might set dt_force,maxdt_temporary
 
   //! \li determine the maximum time-step boundary models can take
-  double apcc_dt;
+  double apcc_dt, coupler_max_dt = -1.0;
   bool restrict_dt;
   ierr = surface->max_timestep(grid.time->current(), apcc_dt, restrict_dt); CHKERRQ(ierr);
   if (restrict_dt) {
@@ -529,6 +558,7 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
       maxdt_temporary = PetscMin(apcc_dt, maxdt_temporary);
     else
       maxdt_temporary = apcc_dt;
+    coupler_max_dt = apcc_dt;
   }
 
   double opcc_dt;
@@ -538,6 +568,18 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
       maxdt_temporary = PetscMin(opcc_dt, maxdt_temporary);
     else
       maxdt_temporary = opcc_dt;
+    coupler_max_dt = coupler_max_dt > 0 ? PetscMin(opcc_dt, coupler_max_dt) : opcc_dt;
+  }
+
+  //! \li end the step when the interval covered by the last surface and ocean
+  //! model update ends (multirate scheduling; see schedule_window())
+  double schedule_dt;
+  ierr = schedule_max_timestep(grid.time->current(), schedule_dt, restrict_dt); CHKERRQ(ierr);
+  if (restrict_dt) {
+    if (maxdt_temporary > 0)
+      maxdt_temporary = PetscMin(schedule_dt, maxdt_temporary);
+    else
+      maxdt_temporary = schedule_dt;
   }
 
   double ts_dt;
@@ -572,10 +614,14 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
   bool updateAtDepth = (skipCountDown == 0),
     do_energy_step = updateAtDepth && do_energy;
 
+  PetscLogDouble update_start;
+
   //! \li update the yield stress for the plastic till model (if appropriate)
-  if (updateAtDepth && basal_yield_stress) {
+  if (updateAtDepth && basal_yield_stress && scheduled("yield stress")) {
+    ierr = PetscGetTime(&update_start); CHKERRQ(ierr);
     ierr = basal_yield_stress->update(grid.time->current(), dt); CHKERRQ(ierr);
     ierr = basal_yield_stress->basal_material_yield_stress(vtauc); CHKERRQ(ierr);
+    ierr = schedule_add_time("yield stress", update_start); CHKERRQ(ierr);
     stdout_flags += "y";
   } else stdout_flags += "$";
 
@@ -604,9 +650,16 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
   //!  see determineTimeStep()
   ierr = determineTimeStep(do_energy); CHKERRQ(ierr);
 
-  //! \li Update surface and ocean models.
-  ierr = surface->update(grid.time->current(), dt); CHKERRQ(ierr);
-  ierr = ocean->update(grid.time->current(),   dt); CHKERRQ(ierr);
+  //! \li Update surface and ocean models (if scheduled; see init_schedule()).
+  //! Skipped updates reuse these fields, so they are computed over the whole
+  //! interval until the next update (see schedule_window()).
+  if (scheduled("couplers")) {
+    const double coupler_dt = schedule_window("couplers", dt, coupler_max_dt);
+    ierr = PetscGetTime(&update_start); CHKERRQ(ierr);
+    ierr = surface->update(grid.time->current(), coupler_dt); CHKERRQ(ierr);
+    ierr = ocean->update(grid.time->current(),   coupler_dt); CHKERRQ(ierr);
+    ierr = schedule_add_time("couplers", update_start); CHKERRQ(ierr);
+  }
 
   dt_TempAge += dt;
   // IceModel::dt,dtTempAge are now set correctly according to
@@ -616,9 +669,17 @@ PetscErrorCode IceModel::step(bool do_mass_continuity,
 
   grid.profiler->begin(event_age);
 
-  //! \li update the age of the ice (if appropriate)
+  //! \li update the age of the ice (if appropriate); if the energy step
+  //!  happens at this time step and vWork3dAge is allocated, the age is
+  //!  updated in the same pass over the grid (see enthalpyAndDrainageStep())
+  age_in_energy_step = (do_age && do_energy_step &&
+                        vWork3dAge.was_created() &&
+                        config.get_flag("do_cold_ice_methods") == false);
+
   if (do_age && updateAtDepth) {
-    ierr = ageStep(); CHKERRQ(ierr);
+    if (age_in_energy_step == false) {
+      ierr = ageStep(); CHKERRQ(ierr);
+    }
     stdout_flags += "a";
   } else {
     stdout_flags += "$";
@@ -753,6 +814,12 @@ PetscErrorCode IceModel::run() {
   //         where A>B.  See IcePSTexModel.
   grid.time->set_end(grid.time->start() + 1); // run for 1 second
 
+  // Save the model state so that we can roll back without re-reading input
+  // files (see model_state_setup()).
+  if (config.get_flag("preliminary_step_restore_from_memory")) {
+    ierr = save_model_state_in_memory(); CHKERRQ(ierr);
+  }
+
   ierr = step(do_mass_conserve, do_energy, do_age, do_skip); CHKERRQ(ierr);
 
   // print verbose messages according to user-set verbosity
@@ -770,6 +837,10 @@ PetscErrorCode IceModel::run() {
   dt_TempAge = 0.0;
   grid.time->set_end(run_end);
   ierr = model_state_setup(); CHKERRQ(ierr);
+  ierr = discard_model_state_snapshot(); CHKERRQ(ierr);
+
+  // start multirate scheduling at the first "real" step:
+  ierr = init_schedule(); CHKERRQ(ierr);
 
   // restore verbosity:
   ierr = setVerbosityLevel(tmp_verbosity); CHKERRQ(ierr);
@@ -817,10 +888,17 @@ PetscErrorCode IceModel::run() {
     if (endOfTimeStepHook() != 0) break;
   } // end of the time-stepping loop
 
+  ierr = schedule_report(); CHKERRQ(ierr);
+
   bool flag;
+  ierr = PISMOptionsIsSet("-memory_report", flag); CHKERRQ(ierr);
+  if (flag) {
+    ierr = grid.memory->report(1); CHKERRQ(ierr);
+  }
+
   PetscInt pause_time = 0;
-  ierr = PISMOptionsInt("-pause", "Pause after the run, seconds",
-			pause_time, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsInt(grid.com, "-pause", "Pause after the run, seconds",
+          			pause_time, flag); CHKERRQ(ierr);
   if (pause_time > 0) {
     ierr = verbPrintf(2,grid.com,"pausing for %d secs ...\n",pause_time); CHKERRQ(ierr);
     ierr = PetscSleep(pause_time); CHKERRQ(ierr);
@@ -864,7 +942,9 @@ PetscErrorCode IceModel::init() {
   ierr = setFromOptions(); CHKERRQ(ierr);
 
   //! 3) Memory allocation:
+  grid.memory->begin("IceModel");
   ierr = createVecs(); CHKERRQ(ierr);
+  grid.memory->end();
 
   //! 4) Allocate PISM components modeling some physical processes.
   ierr = allocate_submodels(); CHKERRQ(ierr);
@@ -873,7 +953,9 @@ PetscErrorCode IceModel::init() {
   ierr = init_couplers(); CHKERRQ(ierr);
 
   //! 6) Allocate work vectors:
+  grid.memory->begin("IceModel");
   ierr = allocate_internal_objects(); CHKERRQ(ierr);
+  grid.memory->end();
 
   //! 7) Fill the model state variables (from a PISM output file, from a
   //! bootstrapping file using some modeling choices or using formulas). Calls
@@ -888,6 +970,10 @@ PetscErrorCode IceModel::init() {
   //! regridding.
   ierr = misc_setup();
 
+  //! 10) Report memory use (and optionally predict memory use on a
+  //! different grid and processor count, then stop):
+  ierr = memory_report_setup(); CHKERRQ(ierr);
+
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
   //! The following flow-chart illustrates the process.
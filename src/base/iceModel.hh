@@ -56,6 +56,7 @@ class PISMSurfaceModel;
 class PISMOceanModel;
 class PISMBedDef;
 class PISMBedThermalUnit;
+class ageSystemCtx;
 class PISMDiagnostic;
 class PISMTSDiagnostic;
 
@@ -150,6 +151,7 @@ public:
   virtual PetscErrorCode set_vars_from_options();
   virtual PetscErrorCode allocate_internal_objects();
   virtual PetscErrorCode misc_setup();
+  virtual PetscErrorCode memory_report_setup();
   virtual PetscErrorCode init_diagnostics();
   virtual PetscErrorCode init_ocean_kill();
 
@@ -211,6 +213,10 @@ protected:
   //! from the IceModel core to other components (such as surface and ocean models)
   PISMVars variables;
 
+  //! \brief In-memory copies of model state variables, used to roll back
+  //! after the preliminary time step (see IceModel::run()).
+  map<string,Vec> model_state_snapshot;
+
   // state variables and some diagnostics/internals
   IceModelVec2S vh,		//!< ice surface elevation; ghosted
     vH,		//!< ice thickness; ghosted
@@ -241,6 +247,11 @@ protected:
     vIcebergMask, //!< mask for iceberg identification
 
     vBCMask; //!< mask to determine Dirichlet boundary locations
+
+  IceModelVec2IntCompact vMaskCompact; //!< \brief one-byte copy of vMask used
+                                       //!< by read-only loops (mass continuity,
+                                       //!< calving, iceberg candidates); each
+                                       //!< of them updates it first
  
   IceModelVec2V vBCvel; //!< Dirichlet boundary velocities
 
@@ -290,16 +301,23 @@ protected:
   // see iceModel.cc
   virtual PetscErrorCode createVecs();
   virtual PetscErrorCode deallocate_internal_objects();
+  virtual PetscErrorCode save_model_state_in_memory();
+  virtual PetscErrorCode restore_model_state_from_memory();
+  virtual PetscErrorCode discard_model_state_snapshot();
 
   // see iMadaptive.cc
   virtual PetscErrorCode computeMax3DVelocities();
   virtual PetscErrorCode computeMax2DSlidingSpeed();
   virtual PetscErrorCode adaptTimeStepDiffusivity();
   virtual PetscErrorCode determineTimeStep(const bool doTemperatureCFL);
-  virtual PetscErrorCode countCFLViolations(PetscScalar* CFLviol);
+  virtual PetscErrorCode countCFLViolations(PetscScalar* CFLviol, PetscScalar* clipped);
 
   // see iMage.cc
   virtual PetscErrorCode ageStep();
+  virtual PetscErrorCode init_age_system(ageSystemCtx &system);
+  virtual PetscErrorCode ageColumnStep(ageSystemCtx &system, PetscInt i, PetscInt j,
+                                       PetscInt fks, PetscScalar *x,
+                                       IceModelVec3 &result, bool view);
 
   // see iMcalving.cc
   virtual PetscErrorCode eigenCalving();
@@ -355,6 +373,11 @@ protected:
                            planeStar<PetscScalar> &SIA_flux);
   virtual PetscErrorCode massContExplicitStep();
 
+  // see iMimplicit.cc
+  virtual PetscErrorCode allocate_implicit_mass_continuity();
+  virtual PetscErrorCode deallocate_implicit_mass_continuity();
+  virtual PetscErrorCode diffusive_flux_implicit(IceModelVec2Stag* &result);
+
   // see iMhydrology.cc
   virtual PetscErrorCode diffuse_bwat();
 
@@ -426,6 +449,14 @@ protected:
 
   // 3D working space
   IceModelVec3 vWork3d;
+  IceModelVec3 vWork3dAge;      //!< new age values if age and energy updates are fused
+  bool age_in_energy_step;      //!< true if enthalpyAndDrainageStep() updates the age, too
+
+  // semi-implicit mass continuity (see iMimplicit.cc)
+  IceModelVec2Stag vDiffusivityStag, vQdiffImplicit;
+  KSP thickness_ksp;
+  Mat thickness_matrix;
+  Vec thickness_rhs, thickness_x;
 
   PISMStressBalance *stress_balance;
 
@@ -476,6 +507,27 @@ protected:
   PetscErrorCode init_backups();
   PetscErrorCode write_backup();
 
+  // see iMschedule.cc
+  //! \brief Multirate scheduling state of a sub-model (see IceModel::scheduled()).
+  struct PISMSchedule {
+    double interval,            //!< minimum time between updates, in seconds (0: every step)
+      last_update,              //!< time of the last update, in seconds
+      next_update,              //!< time the next update is due, in seconds
+      wall_time;                //!< wall-clock time spent in updates, in seconds
+    int runs, skips;
+    bool window;                //!< true if updates cover a time interval (see schedule_window())
+  };
+  map<string,PISMSchedule> schedule;
+  virtual PetscErrorCode init_schedule();
+  virtual bool scheduled(string name);
+  virtual double schedule_window(string name, double my_dt, double max_dt);
+  virtual PetscErrorCode schedule_max_timestep(double my_t, double &my_dt, bool &restrict);
+  virtual PetscErrorCode schedule_add_time(string name, PetscLogDouble start);
+  virtual double schedule_saved_time();
+  virtual PetscErrorCode schedule_report();
+  PetscErrorCode write_binary_checkpoint(string filename, set<string> vars);
+  PetscErrorCode read_binary_checkpoint(const PIO &nc, string filename, set<string> &result);
+
   // diagnostic viewers; see iMviewers.cc
   virtual PetscErrorCode init_viewers();
   virtual PetscErrorCode update_viewers();
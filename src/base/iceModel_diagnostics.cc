@@ -452,18 +452,14 @@ PetscErrorCode IceModel_temp::compute(IceModelVec* &output) {
     for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
       ierr = result->getInternalColumn(i,j,&Tij); CHKERRQ(ierr);
       ierr = enthalpy->getInternalColumn(i,j,&Enthij); CHKERRQ(ierr);
-      for (PetscInt k=0; k<grid.Mz; ++k) {
-        const PetscScalar depth = (*thickness)(i,j) - grid.zlevels[k];
-        ierr = model->EC->getAbsTemp(Enthij[k],
-                                     model->EC->getPressureFromDepth(depth),
-                                     Tij[k]);
-        if (ierr) {
-          PetscPrintf(grid.com,
-                      "\n\nEnthalpyConverter.getAbsTemp() error at i=%d,j=%d,k=%d\n\n",
-                      i,j,k);
-        }
-        CHKERRQ(ierr);
+      ierr = model->EC->getAbsTempColumn(Enthij, (*thickness)(i,j),
+                                         &grid.zlevels[0], grid.Mz, Tij);
+      if (ierr) {
+        PetscPrintf(grid.com,
+                    "\n\nEnthalpyConverter.getAbsTempColumn() error at i=%d,j=%d\n\n",
+                    i,j);
       }
+      CHKERRQ(ierr);
     }
   }
   ierr = enthalpy->end_access(); CHKERRQ(ierr);
@@ -515,24 +511,24 @@ PetscErrorCode IceModel_temp_pa::compute(IceModelVec* &output) {
     for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
       ierr = result->getInternalColumn(i,j,&Tij); CHKERRQ(ierr);
       ierr = enthalpy->getInternalColumn(i,j,&Enthij); CHKERRQ(ierr);
-      for (PetscInt k=0; k<grid.Mz; ++k) {
-        const PetscScalar depth = (*thickness)(i,j) - grid.zlevels[k],
-          p = model->EC->getPressureFromDepth(depth);
-        ierr = model->EC->getPATemp(Enthij[k], p, Tij[k]);
-        if (ierr) {
-          PetscPrintf(grid.com,
-                      "\n\nEnthalpyConverter.getAbsTemp() error at i=%d,j=%d,k=%d\n\n",
-                      i,j,k);
-        }
-        CHKERRQ(ierr);
+      ierr = model->EC->getPATempColumn(Enthij, (*thickness)(i,j),
+                                        &grid.zlevels[0], grid.Mz, Tij);
+      if (ierr) {
+        PetscPrintf(grid.com,
+                    "\n\nEnthalpyConverter.getPATempColumn() error at i=%d,j=%d\n\n",
+                    i,j);
+      }
+      CHKERRQ(ierr);
 
-        if (cold_mode) { // if ice is temperate then its pressure-adjusted temp
-          // is 273.15
-          if ( model->EC->isTemperate(Enthij[k],p) && ((*thickness)(i,j) > 0)) {
+      if (cold_mode && (*thickness)(i,j) > 0) {
+        // if ice is temperate then its pressure-adjusted temp is 273.15
+        for (PetscInt k=0; k<grid.Mz; ++k) {
+          const PetscScalar depth = (*thickness)(i,j) - grid.zlevels[k],
+            p = model->EC->getPressureFromDepth(depth);
+          if (model->EC->is_temperate(Enthij[k],p)) {
             Tij[k] = melting_point_temp;
           }
         }
-
       }
     }
   }
@@ -596,7 +592,7 @@ PetscErrorCode IceModel_temppabase::compute(IceModelVec* &output) {
 
       if (cold_mode) { // if ice is temperate then its pressure-adjusted temp
         // is 273.15
-        if ( model->EC->isTemperate(Enthij[0],p) && ((*thickness)(i,j) > 0)) {
+        if ( model->EC->is_temperate(Enthij[0],p) && ((*thickness)(i,j) > 0)) {
           (*result)(i,j) = melting_point_temp;
         }
       }
@@ -863,13 +859,13 @@ PetscErrorCode IceModel_tempicethk::compute(IceModelVec* &output) {
         for (PetscInt k=0; k<ks; ++k) { // FIXME issue #15
           PetscReal pressure = model->EC->getPressureFromDepth(model->vH(i,j) - grid.zlevels[k]);
 
-          if (model->EC->isTemperate(Enth[k], pressure)) {
+          if (model->EC->is_temperate(Enth[k], pressure)) {
             tithk += grid.zlevels[k+1] - grid.zlevels[k];
           }
         }
 
         PetscReal pressure = model->EC->getPressureFromDepth(model->vH(i,j) - grid.zlevels[ks]);
-        if (model->EC->isTemperate(Enth[ks], pressure)) {
+        if (model->EC->is_temperate(Enth[ks], pressure)) {
           tithk += model->vH(i,j) - grid.zlevels[ks];
         }
 
@@ -933,7 +929,7 @@ PetscErrorCode IceModel_tempicethk_basal::compute(IceModelVec* &output) {
       while (k <= ks) {         // FIXME issue #15
         pressure = EC->getPressureFromDepth(thk - grid.zlevels[k]);
 
-        if (EC->isTemperate(Enth[k],pressure))
+        if (EC->is_temperate(Enth[k], pressure))
           k++;
         else
           break;
@@ -958,11 +954,11 @@ PetscErrorCode IceModel_tempicethk_basal::compute(IceModelVec* &output) {
         pressure_0 = EC->getPressureFromDepth(thk - grid.zlevels[k-1]),
         dz = grid.zlevels[k] - grid.zlevels[k-1],
         slope1 = (Enth[k] - Enth[k-1]) / dz,
-        slope2 = (EC->getEnthalpyCTS(pressure) - EC->getEnthalpyCTS(pressure_0)) / dz;
+        slope2 = (EC->enthalpy_cts(pressure) - EC->enthalpy_cts(pressure_0)) / dz;
 
       if (slope1 != slope2) {
         (*result)(i,j) = grid.zlevels[k-1] +
-          (EC->getEnthalpyCTS(pressure_0) - Enth[k-1]) / (slope1 - slope2);
+          (EC->enthalpy_cts(pressure_0) - Enth[k-1]) / (slope1 - slope2);
 
         // check if the resulting thickness is valid:
         (*result)(i,j) = PetscMax((*result)(i,j), grid.zlevels[k-1]);
@@ -188,14 +188,14 @@ PetscErrorCode GPBLDIce::setFromOptions() {
 
   ierr = PetscOptionsBegin(com, prefix, "GPBLDIce options", NULL); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsReal("-ice_gpbld_water_frac_coeff",
-                           "coefficient of softness factor in temperate ice, "
-                           " as function of liquid water fraction; no units",
+    ierr = PISMOptionsReal(com, "-ice_gpbld_water_frac_coeff",
+                                "coefficient of softness factor in temperate ice, "
+                                " as function of liquid water fraction; no units",
                            water_frac_coeff, flag); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-ice_gpbld_water_frac_observed_limit",
-                           "maximum value of liquid water fraction 'omega' for"
-                           " which softness values are parameterized by Lliboutry and"
-                           " Duval (1985); no units",
+    ierr = PISMOptionsReal(com, "-ice_gpbld_water_frac_observed_limit",
+                                "maximum value of liquid water fraction 'omega' for"
+                                " which softness values are parameterized by Lliboutry and"
+                                " Duval (1985); no units",
                            water_frac_observed_limit, flag); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
@@ -208,32 +208,21 @@ This is a modification of Glen-Paterson-Budd ice, which is ThermoGlenIce.  In pa
 \f$A()\f$ is the softness factor for ThermoGlenIce, if \f$E\f$ is the enthalpy, and \f$p\f$ is
 the pressure then the softness we compute is
    \f[A = A(T_{pa}(E, p))(1+184\omega).\f]
-The pressure-melting temperature \f$T_{pa}(E, p)\f$ is computed by getPATemp().
+The pressure-adjusted temperature \f$T_{pa}(E, p)\f$ is computed by EnthalpyConverter::pa_temperature().
  */
 PetscReal GPBLDIce::softness_parameter(
                 PetscReal enthalpy, PetscReal pressure) const {
-  PetscErrorCode ierr;
-
   if (EC == NULL) {
     PetscErrorPrintf("EC is NULL in GPBLDIce::softness_parameter()\n");
     endPrintRank();
   }
-  PetscReal E_s, E_l;
-  EC->getEnthalpyInterval(pressure, E_s, E_l);
+  const PetscReal E_s = EC->enthalpy_cts(pressure);
   if (enthalpy < E_s) {       // cold ice
-    PetscReal T_pa;
-    ierr = EC->getPATemp(enthalpy, pressure, T_pa);
-    if (ierr) {
-      PetscErrorPrintf(
-        "getPATemp() returned ierr>0 in GPBLDIce::softness_parameter()\n");
-      endPrintRank();
-    }
-    return softness_parameter_paterson_budd( T_pa );
+    return softness_parameter_paterson_budd(EC->pa_temperature(enthalpy, pressure));
   } else { // temperate ice
-    PetscReal omega;
-    ierr = EC->getWaterFraction(enthalpy, pressure, omega);
     // as stated in \ref AschwandenBuelerBlatter, cap omega at max of observations:
-    omega = PetscMin(omega, water_frac_observed_limit);
+    const PetscReal omega = PetscMin(EC->water_fraction(enthalpy, pressure),
+                                     water_frac_observed_limit);
     // next line implements eqn (23) in \ref AschwandenBlatter2009
     return softness_parameter_paterson_budd(T_0) * (1.0 + water_frac_coeff * omega);
   }
@@ -243,17 +232,13 @@ PetscReal GPBLDIce::softness_parameter(
 
 /*! Converts enthalpy to temperature and uses the Paterson-Budd formula. */
 PetscReal ThermoGlenIce::softness_parameter(PetscReal E, PetscReal pressure) const {
-  PetscReal T_pa;
-  EC->getPATemp(E, pressure, T_pa);
-  return softness_parameter_from_temp(T_pa);
+  return softness_parameter_from_temp(EC->pa_temperature(E, pressure));
 }
 
 /*! Converts enthalpy to temperature and calls flow_from_temp. */
 PetscReal ThermoGlenIce::flow(PetscReal stress, PetscReal E,
                                         PetscReal pressure, PetscReal gs) const {
-  PetscReal temp;
-  EC->getAbsTemp(E, pressure, temp);
-  return flow_from_temp(stress, temp, pressure, gs);
+  return flow_from_temp(stress, EC->temperature(E, pressure), pressure, gs);
 }
 
 //! The flow law (temperature-dependent version).
@@ -334,9 +319,7 @@ GoldsbyKohlstedtIce::GoldsbyKohlstedtIce(MPI_Comm c, const char pre[],
 
 PetscReal GoldsbyKohlstedtIce::flow(PetscReal stress, PetscReal E,
                                     PetscReal pressure, PetscReal grainsize) const {
-  PetscReal temp;
-  EC->getAbsTemp(E, pressure, temp);
-  return flow_from_temp(stress, temp, pressure, grainsize);
+  return flow_from_temp(stress, EC->temperature(E, pressure), pressure, grainsize);
 }
 
 PetscReal GoldsbyKohlstedtIce::effective_viscosity(PetscReal,
@@ -363,12 +346,12 @@ PetscReal GoldsbyKohlstedtIce::averaged_hardness(PetscReal,
 }
 
 PetscReal GoldsbyKohlstedtIce::hardness_parameter(PetscReal enthalpy, PetscReal pressure) const {
-  double softness, T_pa;
+  double softness;
 
   // FIXME: The following is a re-implementation of the Paterson-Budd relation
   // for the hardness parameter. This should not be here, but we currently need
-  // ice hardness to compute the strain heating. See SIAFD::compute_sigma().
-  EC->getPATemp(enthalpy, pressure, T_pa);
+  // ice hardness to compute the strain heating. See SIAFD::compute_diffusive_flux().
+  const double T_pa = EC->pa_temperature(enthalpy, pressure);
 
   if (T_pa < crit_temp) {
     softness = A_cold * exp(-Q_cold/(ideal_gas_constant * T_pa));
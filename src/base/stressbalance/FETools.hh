@@ -274,11 +274,13 @@ public:
   virtual PetscErrorCode setJacobianDiag(PetscInt i, PetscInt j, const PetscReal *K, Mat J);
 
   static const PetscInt Nk = 4; //<! The number of test functions defined on an element.
+
+  //! Offsets of the nodes of an element relative to its lower left node.
+  static const PetscInt kIOffset[Nk];
+  static const PetscInt kJOffset[Nk];
   
 protected:
   static const PetscInt kDofInvalid = PETSC_MIN_INT / 8; //!< Constant for marking invalid row/columns.
-  static const PetscInt kIOffset[Nk];
-  static const PetscInt kJOffset[Nk];
 
   //! Indices of the current element (for updating residual/Jacobian).
   PetscInt m_i, m_j;
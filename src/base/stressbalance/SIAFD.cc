@@ -23,6 +23,7 @@
 #include "PISMVars.hh"
 #include "PISMProf.hh"
 #include "flowlaw_factory.hh"
+#include "pism_threads.hh"
 
 SIAFD::~SIAFD() {
   delete bed_smoother;
@@ -36,6 +37,8 @@ SIAFD::~SIAFD() {
 PetscErrorCode SIAFD::allocate() {
   PetscErrorCode ierr;
 
+  grid.memory->begin("SIAFD");
+
   // 2D temporary storage:
   for (int i = 0; i < 2; ++i) {
     char namestr[30];
@@ -50,12 +53,8 @@ PetscErrorCode SIAFD::allocate() {
     ierr = work_2d_stag[i].set_name(namestr); CHKERRQ(ierr);
   }
 
-  ierr = delta[0].create(grid, "delta_0", true); CHKERRQ(ierr);
-  ierr = delta[1].create(grid, "delta_1", true); CHKERRQ(ierr);
-
-  // 3D temporary storage:
-  ierr = work_3d[0].create(grid, "work_3d_0", true); CHKERRQ(ierr);
-  ierr = work_3d[1].create(grid, "work_3d_1", true); CHKERRQ(ierr);
+  ierr = diffusivity_stag.create(grid, "diffusivity_stag", true); CHKERRQ(ierr);
+  ierr = diffusivity_stag.set(0.0); CHKERRQ(ierr);
 
   // bed smoother
   bed_smoother = new PISMBedSmoother(grid, config, WIDE_STENCIL);
@@ -71,6 +70,8 @@ PetscErrorCode SIAFD::allocate() {
     ierr = ice_factory.create(&flow_law); CHKERRQ(ierr);
   }
 
+  grid.memory->end();
+
   return 0;
 }
 
@@ -134,13 +135,8 @@ PetscErrorCode SIAFD::update(IceModelVec2V *vel_input, IceModelVec2S *D2_input,
 
   ierr = compute_surface_gradient(h_x, h_y); CHKERRQ(ierr);
 
-  ierr = compute_diffusive_flux(h_x, h_y, diffusive_flux, fast); CHKERRQ(ierr);
-
-  if (!fast) {
-    ierr = compute_sigma(D2_input, h_x, h_y); CHKERRQ(ierr);
-
-    ierr = compute_3d_horizontal_velocity(h_x, h_y, vel_input, u, v); CHKERRQ(ierr);
-  }
+  ierr = compute_diffusive_flux(h_x, h_y, vel_input, D2_input,
+                                diffusive_flux, fast); CHKERRQ(ierr);
 
   grid.profiler->end(event_sia);
 
@@ -415,7 +411,8 @@ PetscErrorCode SIAFD::surface_gradient_mahaffy(IceModelVec2Stag &h_x, IceModelVe
   return 0;
 }
 
-//! \brief Compute the SIA flux. If fast == false, also store delta on the staggered grid.
+//! \brief Compute the SIA flux. If fast == false, also compute the 3D
+//! horizontal velocity and the volumetric strain heating.
 /*!
  * Recall that \f$ Q = -D \nabla h \f$ is the diffusive flux in the mass-continuity equation
  *
@@ -443,20 +440,56 @@ PetscErrorCode SIAFD::surface_gradient_mahaffy(IceModelVec2Stag &h_x, IceModelVe
  * \f[D = \int_b^h\delta(z)(h-z)dz. \f]
  *
  * The advantage is that it is then possible to avoid re-evaluating \f$F(z)\f$
- * (which is computationally expensive) in strain heating (see compute_sigma())
- * and horizontal ice velocity (see compute_3d_horizontal_velocity())
- * computations.
+ * (which is computationally expensive) in strain heating and horizontal ice
+ * velocity computations.
+ *
+ * The trapezoidal rule is used to approximate the integrals.
+ *
+ * \section fused_3d Horizontal velocity and strain heating
+ *
+ * If fast == false, this method also computes
+ *
+ * \f[ I(z) = \int_b^z\delta(s)ds \f]
  *
- * This method computes \f$Q\f$ and stores \f$\delta\f$ in delta[0,1] is fast == false.
+ * and the staggered-grid strain heating (see below) in each staggered-grid
+ * column, right after computing \f$\delta\f$ in it. Staggered-grid columns are
+ * visited row by row, so \f$I\f$ and \f$\Sigma\f$ at the four staggered
+ * neighbors of a regular grid point (i,j) are available as soon as both
+ * staggered points "belonging" to (i,j) are done. This makes it possible to
+ * keep \f$\delta\f$, \f$I\f$ and \f$\Sigma\f$ in two rows of columns instead
+ * of storing them on the whole (3D) staggered grid.
  *
- * The trapezoidal rule is used to approximate the integral.
+ * Recall that
+ *
+ * \f[ \mathbf{U}(z) = -2 \nabla h \int_b^z F(s)P(s)ds + \mathbf{U}_b,\f]
+ *
+ * which can be written in terms of \f$I(z)\f$:
+ *
+ * \f[ \mathbf{U}(z) = -I(z) \nabla h + \mathbf{U}_b. \f]
+ *
+ * The volumetric strain heating \f$\Sigma\f$ combines the contribution from
+ * the underlying stress balance (usually the SSA) in the form of the
+ * (partial) square of the Frobenius norm of \f$D_{ij}\f$, the combined strain
+ * rates with the SIA contribution; see section 2.8 of [\ref BBssasliding].
+ *
+ * Uses the fact that in the combined strain rate tensor SIA and SSA have
+ * disjoint sets of non-zero elements, making it possible to \e literally add
+ * SSA and SIA contributions when computing \f$D^2\f$.
+ *
+ * \note This is one of the places where "hybridization" is done.
+ *
+ * The vertical velocity is computed by PISMStressBalance, because it needs
+ * horizontal velocity values at neighboring (possibly off-processor) points.
  *
  * \param[in]  h_x x-component of the surface gradient, on the staggered grid
  * \param[in]  h_y y-component of the surface gradient, on the staggered grid
+ * \param[in]  vel_input the thickness-advective velocity from the underlying stress balance module
+ * \param[in]  D2_input the "SSA" contribution to the strain heating
  * \param[out] result diffusive ice flux
  * \param[in]  fast the boolean flag specitying if we're doing a "fast" update.
  */
 PetscErrorCode SIAFD::compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2Stag &h_y,
+                                             IceModelVec2V *vel_input, IceModelVec2S *D2_input,
                                              IceModelVec2Stag &result, bool fast) {
   PetscErrorCode  ierr;
   IceModelVec2S thk_smooth = work_2d[0],
@@ -466,14 +499,20 @@ PetscErrorCode SIAFD::compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2
 
   ierr = result.set(0.0); CHKERRQ(ierr);
 
-  PetscScalar *delta_ij;
-  delta_ij = new PetscScalar[grid.Mz];
+  const PetscInt Mz = grid.Mz;
+
+  // Scratch storage for I and sigma at staggered grid points (see below) has
+  // this many columns per row; rows include one ghost on each side.
+  const PetscInt row_length = grid.ym + 2;
 
   const double enhancement_factor = flow_law->enhancement_factor(),
     standard_gravity = config.get("standard_gravity"),
-    ice_rho = config.get("ice_density");
+    ice_rho = config.get("ice_density"),
+    n_glen  = flow_law->exponent(),
+    Sig_pow = (1.0 + n_glen) / (2.0 * n_glen),
+    e_to_a_power = pow(enhancement_factor,-1/n_glen);
 
-  double ice_grain_size = config.get("ice_grain_size");
+  const double default_grain_size = config.get("ice_grain_size");
 
   bool compute_grain_size_using_age = config.get_flag("compute_grain_size_using_age");
 
@@ -502,29 +541,76 @@ PetscErrorCode SIAFD::compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2
   ierr = theta.begin_access(); CHKERRQ(ierr);
   ierr = thk_smooth.begin_access(); CHKERRQ(ierr);
   ierr = result.begin_access(); CHKERRQ(ierr);
+  ierr = diffusivity_stag.begin_access(); CHKERRQ(ierr);
 
   ierr = h_x.begin_access(); CHKERRQ(ierr);
   ierr = h_y.begin_access(); CHKERRQ(ierr);
 
-  PetscScalar *age_ij, *age_offset;
   if (use_age) {
     ierr = age->begin_access(); CHKERRQ(ierr);
   }
 
+  MaskQuery M(*mask);
   if (full_update) {
-    ierr = delta[0].begin_access(); CHKERRQ(ierr);
-    ierr = delta[1].begin_access(); CHKERRQ(ierr);
+    ierr = u.begin_access(); CHKERRQ(ierr);
+    ierr = v.begin_access(); CHKERRQ(ierr);
+    ierr = Sigma.begin_access(); CHKERRQ(ierr);
+    ierr = vel_input->begin_access(); CHKERRQ(ierr);
+    ierr = D2_input->begin_access(); CHKERRQ(ierr);
+    ierr = mask->begin_access(); CHKERRQ(ierr);
   }
 
   // some flow laws use enthalpy while some ("cold ice methods") use temperature
-  PetscScalar *E_ij, *E_offset;
   ierr = enthalpy->begin_access(); CHKERRQ(ierr);
 
+  const int n_threads = pism_max_threads();
+  vector<PetscScalar> thread_D_max(n_threads, 0.0);
+  vector<PetscErrorCode> thread_error(n_threads, 0);
+
+  const PetscInt GHOSTS = 1,
+    i_start = grid.xs - GHOSTS,
+    i_end   = grid.xs + grid.xm + GHOSTS;
+
+  // Each thread processes a contiguous block of rows [i0, i1); the 3D
+  // velocity at (i,j) needs staggered values from rows i-1 and i, so a thread
+  // re-computes the row preceding its block (without storing anything).
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr)
+#endif
+  {
+  const int thread = pism_thread_id();
+  PetscErrorCode &error = thread_error[thread];
   PetscScalar my_D_max = 0.0;
-  for (PetscInt o=0; o<2; o++) {
-    PetscInt GHOSTS = 1;
-    for (PetscInt   i = grid.xs - GHOSTS; i < grid.xs+grid.xm + GHOSTS; ++i) {
-      for (PetscInt j = grid.ys - GHOSTS; j < grid.ys+grid.ym + GHOSTS; ++j) {
+  double ice_grain_size = default_grain_size;
+
+  PetscScalar *age_ij, *age_offset, *E_ij, *E_offset;
+  vector<PetscScalar> delta_ij(Mz);
+
+  // Scratch storage for I and sigma at staggered grid points: "east" points
+  // of the previous and the current row (i-1 and i) and "north" points at
+  // (i,j-1) and (i,j).
+  vector<PetscScalar> I_east, sigma_east, I_north, sigma_north;
+  if (full_update) {
+    I_east.resize(2 * row_length * Mz);
+    sigma_east.resize(2 * row_length * Mz);
+    I_north.resize(2 * Mz);
+    sigma_north.resize(2 * Mz);
+  }
+
+  PetscInt i0, i1;
+  pism_thread_range(i_start, i_end, i0, i1);
+  const PetscInt first_row = (i0 > i_start && i0 < i1) ? i0 - 1 : i0;
+
+  for (PetscInt   i = first_row; i < i1; ++i) {
+    // index of the current row in I_east and sigma_east
+    const PetscInt row = (i - first_row) % 2;
+    // false if this row is computed only to get I and sigma:
+    const bool store = (i >= i0);
+
+    for (PetscInt j = grid.ys - GHOSTS; j < grid.ys+grid.ym + GHOSTS; ++j) {
+      const PetscInt col = j - grid.ys + GHOSTS, north = col % 2;
+
+      for (PetscInt o=0; o<2; o++) {
         // staggered point: o=0 is i+1/2, o=1 is j+1/2, (i,j) and (i+oi,j+oj)
         //   are regular grid neighbors of a staggered point:
         const PetscInt oi = 1 - o, oj = o;
@@ -532,22 +618,39 @@ PetscErrorCode SIAFD::compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2
         const PetscScalar
           thk = 0.5 * ( thk_smooth(i,j) + thk_smooth(i+oi,j+oj) );
 
+        PetscScalar *I_ij = NULL, *sigma_ij = NULL;
+        if (full_update) {
+          if (o == 0) {
+            I_ij     = &I_east[(row * row_length + col) * Mz];
+            sigma_ij = &sigma_east[(row * row_length + col) * Mz];
+          } else {
+            I_ij     = &I_north[north * Mz];
+            sigma_ij = &sigma_north[north * Mz];
+          }
+        }
+
         // zero thickness case:
         if (thk == 0.0) {
-          result(i,j,o) = 0.0;
+          if (store) {
+            result(i,j,o) = 0.0;
+            diffusivity_stag(i,j,o) = 0.0;
+          }
           if (full_update) {
-            ierr = delta[o].setColumn(i, j, 0.0); CHKERRQ(ierr);
+            for (PetscInt k = 0; k < Mz; ++k) {
+              I_ij[k] = 0.0;
+              sigma_ij[k] = 0.0;
+            }
           }
           continue;
         }
 
         if (use_age) {
-          ierr = age->getInternalColumn(i, j, &age_ij); CHKERRQ(ierr);
-          ierr = age->getInternalColumn(i+oi, j+oj, &age_offset); CHKERRQ(ierr);
+          ierr = age->getInternalColumn(i, j, &age_ij); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+          ierr = age->getInternalColumn(i+oi, j+oj, &age_offset); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
         }
 
-        ierr = enthalpy->getInternalColumn(i, j, &E_ij); CHKERRQ(ierr);
-        ierr = enthalpy->getInternalColumn(i+oi, j+oj, &E_offset); CHKERRQ(ierr);
+        ierr = enthalpy->getInternalColumn(i, j, &E_ij); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+        ierr = enthalpy->getInternalColumn(i+oi, j+oj, &E_offset); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
 
         const PetscScalar slope = (o==0) ? h_x(i,j,o) : h_y(i,j,o);
         const PetscInt      ks = grid.kBelowHeight(thk);
@@ -587,215 +690,37 @@ PetscErrorCode SIAFD::compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2
         // vertically-averaged SIA-only flux, sans sliding; note
         //   result(i,j,0) is  u  at E (east)  staggered point (i+1/2,j)
         //   result(i,j,1) is  v  at N (north) staggered point (i,j+1/2)
-        result(i,j,o) = - Dfoffset * slope;
-
-        // if doing the full update, fill the delta column above the ice and
-        // store it:
-        if (full_update) {
-          for (PetscInt k = ks + 1; k < grid.Mz; ++k) {
-            delta_ij[k] = 0.0;
-          }
-          ierr = delta[o].setInternalColumn(i,j,delta_ij); CHKERRQ(ierr);
+        if (store) {
+          result(i,j,o) = - Dfoffset * slope;
+          diffusivity_stag(i,j,o) = Dfoffset;
         }
-      } // o
-    } // j
-  } // i
-
-  ierr = h_y.end_access(); CHKERRQ(ierr);
-  ierr = h_x.end_access(); CHKERRQ(ierr);
-
-  ierr = result.end_access(); CHKERRQ(ierr);
-  ierr = theta.end_access(); CHKERRQ(ierr);
-  ierr = thk_smooth.end_access(); CHKERRQ(ierr);
-
-  if (use_age) {
-    ierr = age->end_access(); CHKERRQ(ierr);
-  }
-
-  ierr = enthalpy->end_access(); CHKERRQ(ierr);
-
-  if (full_update) {
-    ierr = delta[1].end_access(); CHKERRQ(ierr);
-    ierr = delta[0].end_access(); CHKERRQ(ierr);
-  }
-
-  ierr = PISMGlobalMax(&my_D_max, &D_max, grid.com); CHKERRQ(ierr);
-
-  delete [] delta_ij;
 
-  return 0;
-}
-
-//! \brief Compute diffusivity (diagnostically).
-/*!
- * Computes \f$D\f$ as
- *
- * \f[D = \int_b^h\delta(z)(h-z)dz. \f]
- *
- * Uses the trapezoidal rule to approximate the integral.
- *
- * See compute_diffusive_flux() for the rationale and the definition of
- * \f$\delta\f$.
- * \param[out] result The diffusivity of the SIA flow.
- */
-PetscErrorCode SIAFD::compute_diffusivity(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-  // delta on the staggered grid:
-  IceModelVec2Stag D_stag = work_2d_stag[0];
-  PetscScalar *delta_ij;
-  IceModelVec2S thk_smooth = work_2d[0];
-
-  ierr = bed_smoother->get_smoothed_thk(*surface, *thickness, *mask,
-                                        WIDE_STENCIL,
-                                        &thk_smooth); CHKERRQ(ierr);
-
-  ierr = thk_smooth.begin_access(); CHKERRQ(ierr);
-  ierr = delta[0].begin_access(); CHKERRQ(ierr);
-  ierr = delta[1].begin_access(); CHKERRQ(ierr);
-  ierr = D_stag.begin_access(); CHKERRQ(ierr);
-  for (PetscInt   i = grid.xs; i < grid.xs+grid.xm; ++i) {
-    for (PetscInt j = grid.ys; j < grid.ys+grid.ym; ++j) {
-      for (int o = 0; o < 2; ++o) {
-        const PetscInt oi = 1 - o, oj = o;
-
-        ierr = delta[o].getInternalColumn(i,j,&delta_ij); CHKERRQ(ierr);
-
-        const PetscScalar
-          thk = 0.5 * ( thk_smooth(i,j) + thk_smooth(i+oi,j+oj) );
-
-        if (thk == 0) {
-          D_stag(i,j,o) = 0.0;
+        if (full_update == false)
           continue;
-        }
-
-        const PetscInt ks = grid.kBelowHeight(thk);
-        PetscScalar Dfoffset = 0.0;
 
+        // I in the ice:
+        I_ij[0] = 0.0;
         for (PetscInt k = 1; k <= ks; ++k) {
-          PetscReal depth = thk - grid.zlevels[k];
-
-          const PetscScalar dz = grid.zlevels[k] - grid.zlevels[k-1];
+          const PetscReal dz = grid.zlevels[k] - grid.zlevels[k-1];
           // trapezoidal rule
-          Dfoffset += 0.5 * dz * ((depth + dz) * delta_ij[k-1] + depth * delta_ij[k]);
+          I_ij[k] = I_ij[k-1] + 0.5 * dz * (delta_ij[k-1] + delta_ij[k]);
+        }
+        // above the ice:
+        for (PetscInt k = ks + 1; k < Mz; ++k) {
+          I_ij[k] = I_ij[ks];
         }
 
-        // finish off D with (1/2) dz (0 + (H-z[ks])*delta_ij[ks]), but dz=H-z[ks]:
-        const PetscScalar dz = thk - grid.zlevels[ks];
-        Dfoffset += 0.5 * dz * dz * delta_ij[ks];
-
-        D_stag(i,j,o) = Dfoffset;
-      }
-    }
-  }
-  ierr = D_stag.end_access(); CHKERRQ(ierr);
-  ierr = delta[1].end_access(); CHKERRQ(ierr);
-  ierr = delta[0].end_access(); CHKERRQ(ierr);
-  ierr = thk_smooth.end_access(); CHKERRQ(ierr);
-
-  ierr = D_stag.beginGhostComm(); CHKERRQ(ierr);
-  ierr = D_stag.endGhostComm(); CHKERRQ(ierr);
-
-  ierr = D_stag.staggered_to_regular(result); CHKERRQ(ierr);
-
-  return 0;
-}
-
-//! \brief Extend the grid vertically.
-PetscErrorCode SIAFD::extend_the_grid(PetscInt old_Mz) {
-  PetscErrorCode ierr;
-
-  ierr = SSB_Modifier::extend_the_grid(old_Mz); CHKERRQ(ierr);
-
-  ierr = delta[0].extend_vertically(old_Mz, 0.0); CHKERRQ(ierr);
-  ierr = delta[1].extend_vertically(old_Mz, 0.0); CHKERRQ(ierr);
-
-  ierr = work_3d[0].extend_vertically(old_Mz, 0.0); CHKERRQ(ierr);
-  ierr = work_3d[1].extend_vertically(old_Mz, 0.0); CHKERRQ(ierr);
-
-  return 0;
-}
-
-//! \brief Compute the volumetric strain heating.
-/*!
- * See section 2.8 of [\ref BBssasliding].
- *
- * Computes the volumetric strain heating Sigma by combining the contribution
- * from the underlying stress balance (usually the SSA) in the form of the
- * (partial) square of the Frobenius norm of \f$D_{ij}\f$, the combined strain
- * rates with the SIA contribution.
- *
- * Uses the fact that in the combined strain rate tensor SIA and SSA have
- * disjoint sets of non-zero elements, making it possible to \e literally add
- * SSA and SIA contributions when computing \f$D^2\f$.
- *
- * \note This is one of the places where "hybridization" is done.
- *
- * \param[in] D2_input the "SSA" contribution to the strain heating
- * \param[in] h_x the X-component of the surface gradient, on the staggered grid
- * \param[in] h_y the Y-component of the surface gradient, on the staggered grid
- */
-PetscErrorCode SIAFD::compute_sigma(IceModelVec2S *D2_input,
-                                    IceModelVec2Stag &h_x,
-                                    IceModelVec2Stag &h_y) {
-  PetscErrorCode ierr;
-  PetscScalar *sigma_ij, *delta_ij, *E;
-
-  // aliases
-  IceModelVec2S thk_smooth = work_2d[0];
-  IceModelVec3 sigma[2] = {work_3d[0], work_3d[1]};
-
-  ierr = bed_smoother->get_smoothed_thk(*surface, *thickness, *mask,
-                                        WIDE_STENCIL,
-                                        &thk_smooth); CHKERRQ(ierr);
-
-  ierr = delta[0].begin_access(); CHKERRQ(ierr);
-  ierr = delta[1].begin_access(); CHKERRQ(ierr);
-  ierr = sigma[0].begin_access(); CHKERRQ(ierr);
-  ierr = sigma[1].begin_access(); CHKERRQ(ierr);
-  ierr = enthalpy->begin_access(); CHKERRQ(ierr);
-
-  ierr = h_x.begin_access(); CHKERRQ(ierr);
-  ierr = h_y.begin_access(); CHKERRQ(ierr);
-  ierr = D2_input->begin_access(); CHKERRQ(ierr);
-  ierr = thk_smooth.begin_access(); CHKERRQ(ierr);
-  ierr = mask->begin_access(); CHKERRQ(ierr);
-
-  MaskQuery M(*mask);
-
-  double enhancement_factor = flow_law->enhancement_factor(),
-    n_glen  = flow_law->exponent(),
-    Sig_pow = (1.0 + n_glen) / (2.0 * n_glen),
-    e_to_a_power = pow(enhancement_factor,-1/n_glen);
-
-  for (PetscInt o = 0; o < 2; ++o) {
-    PetscInt GHOSTS = 1;
-    for (PetscInt   i = grid.xs - GHOSTS; i < grid.xs+grid.xm + GHOSTS; ++i) {
-      for (PetscInt j = grid.ys - GHOSTS; j < grid.ys+grid.ym + GHOSTS; ++j) {
-        const PetscInt oi = 1-o, oj=o;
-
-        ierr = delta[o].getInternalColumn(i,j,&delta_ij); CHKERRQ(ierr);
-        ierr = sigma[o].getInternalColumn(i,j,&sigma_ij); CHKERRQ(ierr);
-        ierr = enthalpy->getInternalColumn(i,j,&E); CHKERRQ(ierr);
-
-        const PetscScalar
-          thk = 0.5 * ( thk_smooth(i,j) + thk_smooth(i+oi,j+oj) );
-
-        const PetscInt ks = grid.kBelowHeight(thk);
-
-        // alpha_squared is the square of the magnitude of the surface gradient
-        const PetscScalar alpha_squared =
-          PetscSqr(h_x(i,j,o)) + PetscSqr(h_y(i,j,o));
-
-        // in the ice:
-        for (PetscInt k=0; k<=ks; ++k) {
+        // strain heating in the ice:
+        const PetscReal D2_ssa = (*D2_input)(i,j);
+        const bool grounded = M.grounded_ice(i, j);
+        for (PetscInt k = 0; k <= ks; ++k) {
           PetscReal depth = thk - grid.zlevels[k];
           PetscReal pressure = EC.getPressureFromDepth(depth);
 
-          PetscReal sigma_sia = delta_ij[k] * alpha_squared * pressure,
-            BofT = flow_law->hardness_parameter(E[k], pressure) * e_to_a_power,
-            D2_ssa = (*D2_input)(i,j);
+          PetscReal sigma_sia = delta_ij[k] * PetscSqr(alpha) * pressure,
+            BofT = flow_law->hardness_parameter(E_ij[k], pressure) * e_to_a_power;
 
-          if (M.grounded_ice(i, j)) {
+          if (grounded) {
             // combine SIA and SSA contributions
             PetscReal D2_sia = pow(sigma_sia / (2 * BofT), 1.0 / Sig_pow);
             sigma_ij[k] = 2.0 * BofT * pow(D2_sia + D2_ssa, Sig_pow);
@@ -804,211 +729,141 @@ PetscErrorCode SIAFD::compute_sigma(IceModelVec2S *D2_input,
             sigma_ij[k] = 2.0 * BofT * pow(D2_ssa, Sig_pow);
           }
         }
-
         // above the ice:
-        for (PetscInt k=ks+1; k<grid.Mz; ++k) {
+        for (PetscInt k = ks + 1; k < Mz; ++k) {
           sigma_ij[k] = 0.0;
         }
-      } // j
-    }   // i
-  }     // o
+      } // o
+      PISM_THREAD_CHKERRQ(error, error);
+
+      // All four staggered neighbors of (i,j) are available now, so we can
+      // compute 3D velocity and strain heating at (i,j) if it is owned by
+      // this processor.
+      if (full_update == false || store == false ||
+          i < grid.xs || j < grid.ys ||
+          i >= grid.xs + grid.xm || j >= grid.ys + grid.ym)
+        continue;
+
+      const PetscInt prev_row = 1 - row, south = 1 - north;
+      PetscScalar
+        *IEAST  = &I_east[(row * row_length + col) * Mz],
+        *IWEST  = &I_east[(prev_row * row_length + col) * Mz],
+        *INORTH = &I_north[north * Mz],
+        *ISOUTH = &I_north[south * Mz],
+        *SigmaEAST  = &sigma_east[(row * row_length + col) * Mz],
+        *SigmaWEST  = &sigma_east[(prev_row * row_length + col) * Mz],
+        *SigmaNORTH = &sigma_north[north * Mz],
+        *SigmaSOUTH = &sigma_north[south * Mz],
+        *u_ij, *v_ij, *Sigma_ij;
+
+      ierr = u.getInternalColumn(i, j, &u_ij); PISM_THREAD_CHKERRQ(ierr, error);
+      ierr = v.getInternalColumn(i, j, &v_ij); PISM_THREAD_CHKERRQ(ierr, error);
+      ierr = Sigma.getInternalColumn(i, j, &Sigma_ij); PISM_THREAD_CHKERRQ(ierr, error);
 
-  ierr = mask->end_access(); CHKERRQ(ierr);
-  ierr = D2_input->end_access(); CHKERRQ(ierr);
-  ierr = h_y.end_access(); CHKERRQ(ierr);
-  ierr = h_x.end_access(); CHKERRQ(ierr);
+      // Fetch values from 2D fields *outside* of the k-loop:
+      PetscScalar h_x_w = h_x(i - 1, j, 0), h_x_e = h_x(i, j, 0),
+        h_x_n = h_x(i, j, 1), h_x_s = h_x(i, j - 1, 1);
 
-  ierr = delta[1].end_access(); CHKERRQ(ierr);
-  ierr = delta[0].end_access(); CHKERRQ(ierr);
-  ierr = enthalpy->end_access(); CHKERRQ(ierr);
+      PetscScalar h_y_w = h_y(i - 1, j, 0), h_y_e = h_y(i, j, 0),
+        h_y_n = h_y(i, j, 1), h_y_s = h_y(i, j - 1, 1);
 
-  // Now transfer Sigma from the staggered onto the regular grid.
-  PetscScalar *Sigmareg, *SigmaEAST, *SigmaWEST, *SigmaNORTH, *SigmaSOUTH;
-  ierr = Sigma.begin_access(); CHKERRQ(ierr);
-  for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
-    for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
-      PetscReal thk = thk_smooth(i,j);
-      if (thk > 0.0) {
-        // horizontally average Sigma onto regular grid
-        const PetscInt ks = grid.kBelowHeight(thk);
-        ierr = Sigma.getInternalColumn(i,j,&Sigmareg); CHKERRQ(ierr);
-        ierr = sigma[0].getInternalColumn(i,j,&SigmaEAST); CHKERRQ(ierr);
-        ierr = sigma[0].getInternalColumn(i-1,j,&SigmaWEST); CHKERRQ(ierr);
-        ierr = sigma[1].getInternalColumn(i,j,&SigmaNORTH); CHKERRQ(ierr);
-        ierr = sigma[1].getInternalColumn(i,j-1,&SigmaSOUTH); CHKERRQ(ierr);
-        for (PetscInt k = 0; k <= ks; ++k) {
-          Sigmareg[k] = 0.25 * (SigmaEAST[k] + SigmaWEST[k] + SigmaNORTH[k] + SigmaSOUTH[k]);
-        }
-        for (PetscInt k = ks+1; k < grid.Mz; ++k) {
-          Sigmareg[k] = 0.0;
-        }
-      } else { // zero thickness case
-        ierr = Sigma.setColumn(i,j,0.0); CHKERRQ(ierr);
-      }
-    }
-  }
-  ierr = Sigma.end_access(); CHKERRQ(ierr);
+      PetscScalar vel_input_u = (*vel_input)(i, j).u,
+        vel_input_v = (*vel_input)(i, j).v;
 
-  ierr = thk_smooth.end_access(); CHKERRQ(ierr);
-  ierr = sigma[1].end_access(); CHKERRQ(ierr);
-  ierr = sigma[0].end_access(); CHKERRQ(ierr);
+      for (PetscInt k = 0; k < Mz; ++k) {
+        u_ij[k] = - 0.25 * ( IEAST[k]  * h_x_e + IWEST[k]  * h_x_w +
+                             INORTH[k] * h_x_n + ISOUTH[k] * h_x_s );
+        v_ij[k] = - 0.25 * ( IEAST[k]  * h_y_e + IWEST[k]  * h_y_w +
+                             INORTH[k] * h_y_n + ISOUTH[k] * h_y_s );
 
-  return 0;
-}
+        // Add the "SSA" velocity:
+        u_ij[k] += vel_input_u;
+        v_ij[k] += vel_input_v;
+      }
 
-//! \brief Compute I.
-/*!
- * This computes
- * \f[ I(z) = \int_b^z\delta(s)ds.\f]
- *
- * Uses the trapezoidal rule to approximate the integral.
- *
- * See compute_diffusive_flux() for the definition of \f$\delta\f$.
- *
- * The result is stored in work_3[0,1] and is used to compute the SIA component
- * of the 3D-distributed horizontal ice velocity.
- */
-PetscErrorCode SIAFD::compute_I() {
-  PetscErrorCode ierr;
-  PetscScalar *I_ij, *delta_ij;
+      // horizontally average Sigma onto the regular grid
+      const PetscReal thk = thk_smooth(i,j);
+      const PetscInt ks = thk > 0.0 ? grid.kBelowHeight(thk) : -1;
+      for (PetscInt k = 0; k <= ks; ++k) {
+        Sigma_ij[k] = 0.25 * (SigmaEAST[k] + SigmaWEST[k] + SigmaNORTH[k] + SigmaSOUTH[k]);
+      }
+      for (PetscInt k = ks + 1; k < Mz; ++k) {
+        Sigma_ij[k] = 0.0;
+      }
+    } // j
+  } // i
 
-  IceModelVec2S thk_smooth = work_2d[0];
-  IceModelVec3 I[2] = {work_3d[0], work_3d[1]};
+  thread_D_max[thread] = my_D_max;
+  } // end of the parallel region
 
-  ierr = bed_smoother->get_smoothed_thk(*surface, *thickness, *mask,
-                                        WIDE_STENCIL,
-                                        &thk_smooth); CHKERRQ(ierr);
+  PetscScalar my_D_max = 0.0;
+  for (int t = 0; t < n_threads; ++t) {
+    CHKERRQ(thread_error[t]);
+    my_D_max = PetscMax(my_D_max, thread_D_max[t]);
+  }
 
-  ierr = delta[0].begin_access(); CHKERRQ(ierr);
-  ierr = delta[1].begin_access(); CHKERRQ(ierr);
-  ierr = I[0].begin_access(); CHKERRQ(ierr);
-  ierr = I[1].begin_access(); CHKERRQ(ierr);
-  ierr = thk_smooth.begin_access(); CHKERRQ(ierr);
+  ierr = h_y.end_access(); CHKERRQ(ierr);
+  ierr = h_x.end_access(); CHKERRQ(ierr);
 
-  for (PetscInt o = 0; o < 2; ++o) {
-    PetscInt GHOSTS = 1;
-    for (PetscInt   i = grid.xs - GHOSTS; i < grid.xs+grid.xm + GHOSTS; ++i) {
-      for (PetscInt j = grid.ys - GHOSTS; j < grid.ys+grid.ym + GHOSTS; ++j) {
-        const PetscInt oi = 1-o, oj=o;
-        const PetscReal
-          thk = 0.5 * ( thk_smooth(i,j) + thk_smooth(i+oi,j+oj) );
+  ierr = diffusivity_stag.end_access(); CHKERRQ(ierr);
+  ierr = result.end_access(); CHKERRQ(ierr);
+  ierr = theta.end_access(); CHKERRQ(ierr);
+  ierr = thk_smooth.end_access(); CHKERRQ(ierr);
 
-        ierr = delta[o].getInternalColumn(i,j,&delta_ij); CHKERRQ(ierr);
-        ierr = I[o].getInternalColumn(i,j,&I_ij); CHKERRQ(ierr);
+  if (use_age) {
+    ierr = age->end_access(); CHKERRQ(ierr);
+  }
 
-        const PetscInt ks = grid.kBelowHeight(thk);
+  ierr = enthalpy->end_access(); CHKERRQ(ierr);
 
-        // within the ice:
-        I_ij[0] = 0.0;
-        for (int k = 1; k <= ks; ++k) {
-          const PetscReal dz = grid.zlevels[k] - grid.zlevels[k-1];
-          // trapezoidal rule
-          I_ij[k] = I_ij[k-1] + 0.5 * dz * (delta_ij[k-1] + delta_ij[k]);
-        }
-        // above the ice:
-        for (PetscInt k = ks + 1; k < grid.Mz; ++k) {
-          I_ij[k] = I_ij[ks];
-        }
-      }
-    }
+  if (full_update) {
+    ierr = mask->end_access(); CHKERRQ(ierr);
+    ierr = D2_input->end_access(); CHKERRQ(ierr);
+    ierr = vel_input->end_access(); CHKERRQ(ierr);
+    ierr = Sigma.end_access(); CHKERRQ(ierr);
+    ierr = v.end_access(); CHKERRQ(ierr);
+    ierr = u.end_access(); CHKERRQ(ierr);
+
+    // Communicate to get ghosts (overlaps with the reduction below):
+    ierr = u.beginGhostComm(); CHKERRQ(ierr);
+    ierr = v.beginGhostComm(); CHKERRQ(ierr);
   }
 
-  ierr = thk_smooth.end_access(); CHKERRQ(ierr);
-  ierr = I[1].end_access(); CHKERRQ(ierr);
-  ierr = I[0].end_access(); CHKERRQ(ierr);
-  ierr = delta[1].end_access(); CHKERRQ(ierr);
-  ierr = delta[0].end_access(); CHKERRQ(ierr);
+  ierr = PISMGlobalMax(&my_D_max, &D_max, grid.com); CHKERRQ(ierr);
+
+  if (full_update) {
+    ierr = u.endGhostComm(); CHKERRQ(ierr);
+    ierr = v.endGhostComm(); CHKERRQ(ierr);
+  }
 
   return 0;
 }
 
-//! \brief Compute horizontal components of the SIA velocity (in 3D).
+//! \brief Compute diffusivity (diagnostically).
 /*!
- * Recall that
+ * Averages the staggered-grid diffusivity
  *
- * \f[ \mathbf{U}(z) = -2 \nabla h \int_b^z F(s)P(s)ds + \mathbf{U}_b,\f]
+ * \f[D = \int_b^h\delta(z)(h-z)dz \f]
  *
- * which can be written in terms of \f$I(z)\f$ defined in compute_I():
+ * computed during the last update onto the regular grid.
  *
- * \f[ \mathbf{U}(z) = -I(z) \nabla h + \mathbf{U}_b. \f]
- *
- * \note This is one of the places where "hybridization" is done.
- *
- * \param[in] h_x the X-component of the surface gradient, on the staggered grid
- * \param[in] h_y the Y-component of the surface gradient, on the staggered grid
- * \param[in] vel_input the thickness-advective velocity from the underlying stress balance module
- * \param[out] u_out the X-component of the resulting horizontal velocity field
- * \param[out] v_out the Y-component of the resulting horizontal velocity field
+ * See compute_diffusive_flux() for the rationale and the definition of
+ * \f$\delta\f$.
+ * \param[out] result The diffusivity of the SIA flow.
  */
-PetscErrorCode SIAFD::compute_3d_horizontal_velocity(IceModelVec2Stag &h_x, IceModelVec2Stag &h_y,
-                                                     IceModelVec2V *vel_input,
-                                                     IceModelVec3 &u_out, IceModelVec3 &v_out) {
+PetscErrorCode SIAFD::compute_diffusivity(IceModelVec2S &result) {
   PetscErrorCode ierr;
 
-  ierr = compute_I(); CHKERRQ(ierr);
-  // after the compute_I() call work_3d[0,1] contains I on the staggered grid
-  IceModelVec3 I[2] = {work_3d[0], work_3d[1]};
-
-  PetscScalar *u_ij, *v_ij, *IEAST, *IWEST, *INORTH, *ISOUTH;
+  ierr = diffusivity_stag.staggered_to_regular(result); CHKERRQ(ierr);
 
-  ierr = u_out.begin_access(); CHKERRQ(ierr);
-  ierr = v_out.begin_access(); CHKERRQ(ierr);
-
-  ierr = h_x.begin_access(); CHKERRQ(ierr);
-  ierr = h_y.begin_access(); CHKERRQ(ierr);
-  ierr = vel_input->begin_access(); CHKERRQ(ierr);
-
-  ierr = I[0].begin_access(); CHKERRQ(ierr);
-  ierr = I[1].begin_access(); CHKERRQ(ierr);
-
-  for (PetscInt i=grid.xs; i<grid.xs+grid.xm; ++i) {
-    for (PetscInt j=grid.ys; j<grid.ys+grid.ym; ++j) {
-      ierr = I[0].getInternalColumn(i, j, &IEAST); CHKERRQ(ierr);
-      ierr = I[0].getInternalColumn(i - 1, j, &IWEST); CHKERRQ(ierr);
-      ierr = I[1].getInternalColumn(i, j, &INORTH); CHKERRQ(ierr);
-      ierr = I[1].getInternalColumn(i, j - 1, &ISOUTH); CHKERRQ(ierr);
-
-      ierr = u_out.getInternalColumn(i, j, &u_ij); CHKERRQ(ierr);
-      ierr = v_out.getInternalColumn(i, j, &v_ij); CHKERRQ(ierr);
-
-      // Fetch values from 2D fields *outside* of the k-loop:
-      PetscScalar h_x_w = h_x(i - 1, j, 0), h_x_e = h_x(i, j, 0),
-        h_x_n = h_x(i, j, 1), h_x_s = h_x(i, j - 1, 1);
-
-      PetscScalar h_y_w = h_y(i - 1, j, 0), h_y_e = h_y(i, j, 0),
-        h_y_n = h_y(i, j, 1), h_y_s = h_y(i, j - 1, 1);
-
-      PetscScalar vel_input_u = (*vel_input)(i, j).u,
-        vel_input_v = (*vel_input)(i, j).v;
-
-      for (PetscInt k = 0; k < grid.Mz; ++k) {
-        u_ij[k] = - 0.25 * ( IEAST[k]  * h_x_e + IWEST[k]  * h_x_w +
-                             INORTH[k] * h_x_n + ISOUTH[k] * h_x_s );
-        v_ij[k] = - 0.25 * ( IEAST[k]  * h_y_e + IWEST[k]  * h_y_w +
-                             INORTH[k] * h_y_n + ISOUTH[k] * h_y_s );
-
-        // Add the "SSA" velocity:
-        u_ij[k] += vel_input_u;
-        v_ij[k] += vel_input_v;
-      }
-    }
-  }
-
-  ierr = I[1].end_access(); CHKERRQ(ierr);
-  ierr = I[0].end_access(); CHKERRQ(ierr);
-
-  ierr = vel_input->end_access(); CHKERRQ(ierr);
-  ierr = h_y.end_access(); CHKERRQ(ierr);
-  ierr = h_x.end_access(); CHKERRQ(ierr);
+  return 0;
+}
 
-  ierr = u_out.end_access(); CHKERRQ(ierr);
-  ierr = v_out.end_access(); CHKERRQ(ierr);
+//! \brief Extend the grid vertically.
+PetscErrorCode SIAFD::extend_the_grid(PetscInt old_Mz) {
+  PetscErrorCode ierr;
 
-  // Communicate to get ghosts:
-  ierr = u_out.beginGhostComm(); CHKERRQ(ierr);
-  ierr = v_out.beginGhostComm(); CHKERRQ(ierr);
-  ierr = u_out.endGhostComm(); CHKERRQ(ierr);
-  ierr = v_out.endGhostComm(); CHKERRQ(ierr);
+  ierr = SSB_Modifier::extend_the_grid(old_Mz); CHKERRQ(ierr);
 
   return 0;
 }
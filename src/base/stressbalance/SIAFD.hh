@@ -76,16 +76,9 @@ protected:
   virtual PetscErrorCode surface_gradient_mahaffy(IceModelVec2Stag &h_x, IceModelVec2Stag &h_y);
 
   virtual PetscErrorCode compute_diffusive_flux(IceModelVec2Stag &h_x, IceModelVec2Stag &h_y,
+                                                IceModelVec2V *vel_input, IceModelVec2S *D2_input,
                                                 IceModelVec2Stag &result, bool fast);
 
-  virtual PetscErrorCode compute_3d_horizontal_velocity(IceModelVec2Stag &h_x, IceModelVec2Stag &h_y,
-                                                        IceModelVec2V *vel_input,
-                                                        IceModelVec3 &u_out, IceModelVec3 &v_out);
-
-  virtual PetscErrorCode compute_I();
-  virtual PetscErrorCode compute_sigma(IceModelVec2S *D2_input, IceModelVec2Stag &h_x,
-                                       IceModelVec2Stag &h_y);
-
   virtual PetscScalar grainSizeVostok(PetscScalar age) const;
 
   virtual PetscErrorCode compute_diffusivity(IceModelVec2S &result);
@@ -98,9 +91,8 @@ protected:
   // temporary storage:
   IceModelVec2S work_2d[2];         // for eta, theta and the smoothed thickness
   IceModelVec2Stag work_2d_stag[2]; // for the surface gradient
-  IceModelVec3 delta[2];            // store delta on the staggered grid
-  IceModelVec3 work_3d[2];      // replaces old Sigmastag3 and Istag3; used to
-                                // store I and Sigma on the staggered grid
+  IceModelVec2Stag diffusivity_stag; // SIA diffusivity on the staggered grid
+                                     // (computed during the last update)
 
   PISMBedSmoother *bed_smoother;
   const PetscInt WIDE_STENCIL;
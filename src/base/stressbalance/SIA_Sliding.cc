@@ -136,8 +136,7 @@ PetscErrorCode SIA_Sliding::update(bool /*fast*/) {
         // change r1200: new meaning of H
         const PetscScalar H = (*surface)(i,j) - (*bed)(i,j);
 
-        ierr = EC.getAbsTemp(enthalpy->getValZ(i,j,0.0),
-                             EC.getPressureFromDepth(H), T); CHKERRQ(ierr);
+        T = EC.temperature(enthalpy->getValZ(i,j,0.0), EC.getPressureFromDepth(H));
 
         basalC = basalVelocitySIA(myx, myy, H, T,
                                   alpha, mu_sliding,
@@ -225,13 +224,13 @@ PetscScalar SIA_Sliding::basalVelocitySIA(PetscScalar xIN, PetscScalar yIN,
 
   if ((eisII_experiment == "G") || (eisII_experiment == "H")) {
     const PetscScalar  Bfactor = 1e-3 / secpera; // m s^-1 Pa^-1
-    PetscReal pressure = EC.getPressureFromDepth(H), E;
-    EC.getEnthPermissive(T, 0.0, pressure, E);
+    const PetscReal pressure = EC.getPressureFromDepth(H),
+      E = EC.enthalpy_permissive(T, 0.0, pressure);
 
     if (eisII_experiment == "G") {
       return Bfactor * ice_rho * standard_gravity * H;
     } else if (eisII_experiment == "H") {
-      if (EC.isTemperate(E, pressure)) {
+      if (EC.is_temperate(E, pressure)) {
         return Bfactor * ice_rho * standard_gravity * H; // ditto case G
       } else {
         return 0.0;
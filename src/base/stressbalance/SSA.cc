@@ -24,6 +24,7 @@
 #include "pism_options.hh"
 #include "flowlaw_factory.hh"
 #include "PIO.hh"
+#include "pism_petsc32_compat.hh"
 
 SSA::SSA(IceGrid &g, IceBasalResistancePlasticLaw &b,
          EnthalpyConverter &e,
@@ -85,8 +86,8 @@ PetscErrorCode SSA::init(PISMVars &vars) {
   // and read the initial guess (unless asked not to).
   bool i_set;
   string filename;
-  ierr = PISMOptionsString("-i", "PISM input file",
-                           filename, i_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-i", "PISM input file",
+                                     filename, i_set); CHKERRQ(ierr);
 
   if (i_set) {
     bool dont_read_initial_guess, u_ssa_found, v_ssa_found;
@@ -130,6 +131,8 @@ PetscErrorCode SSA::init(PISMVars &vars) {
 PetscErrorCode SSA::allocate() {
   PetscErrorCode ierr;
 
+  grid.memory->begin("SSA");
+
   ierr = taud.create(grid, "taud", false); CHKERRQ(ierr);
   ierr = taud.set_attrs("diagnostic",
                         "X-component of the driving shear stress at the base of ice",
@@ -162,6 +165,10 @@ PetscErrorCode SSA::allocate() {
 
   ierr = DMCreateGlobalVector(SSADA, &SSAX); CHKERRQ(ierr);
 
+  PetscInt local_size;
+  ierr = VecGetLocalSize(SSAX, &local_size); CHKERRQ(ierr);
+  grid.memory->allocate("SSA", local_size * sizeof(PetscScalar), MEMORY_LOCAL_2D);
+
   {
     IceFlowLawFactory ice_factory(grid.com, "ssa_", config, &EC);
     ice_factory.removeType(ICE_GOLDSBY_KOHLSTEDT);
@@ -172,6 +179,124 @@ PetscErrorCode SSA::allocate() {
     ierr = ice_factory.create(&flow_law); CHKERRQ(ierr);
   }
 
+  grid.memory->end();
+
+  return 0;
+}
+
+
+//! \brief Set up the geometric multigrid preconditioner for the KSP solving
+//! the SSA (if requested using -ssa_mg_levels).
+/*!
+ * The grid hierarchy is built by coarsening SSADA. Coarse grid operators are
+ * computed algebraically (Galerkin, \f$ R A P \f$), so coefficients
+ * (thickness, basal yield stress, hardness and the mask, including ice-free
+ * areas and calving fronts) do not need to be restricted to coarse grids
+ * separately: the coarse operators are consistent with the fine one by
+ * construction. This works the same way for the SSAFD matrix and for the
+ * SSAFEM Jacobian.
+ *
+ * Each coarsening keeps every other grid point. In periodic directions this
+ * halves the number of points (M has to be even); in non-periodic ones the
+ * boundary points are kept, so M goes to (M-1)/2 + 1 (M has to be odd, as
+ * usual for PISM grids). SSADA is always periodic, so the hierarchy is built
+ * from a copy of it with the actual periodicity of the grid. The number of
+ * levels is reduced if the grid size or the domain decomposition do not
+ * allow the requested number; the number used is reported at the
+ * verbosity level 2.
+ *
+ * Should be called before KSPSetFromOptions(), so that command-line options
+ * (-pc_mg_*, -mg_levels_*) can override these settings.
+ */
+PetscErrorCode SSA::setup_multigrid(KSP ksp) {
+  PetscErrorCode ierr;
+  PC pc;
+
+  const int requested = static_cast<int>(config.get("ssa_multigrid_levels"));
+  if (requested <= 1)
+    return 0;
+
+  // the smallest processor sub-domain size:
+  PetscInt min_x = grid.procs_x[0], min_y = grid.procs_y[0];
+  for (PetscInt k = 0; k < grid.Nx; ++k)
+    min_x = PetscMin(min_x, grid.procs_x[k]);
+  for (PetscInt k = 0; k < grid.Ny; ++k)
+    min_y = PetscMin(min_y, grid.procs_y[k]);
+
+  const bool
+    x_periodic = (grid.periodicity & X_PERIODIC) != 0,
+    y_periodic = (grid.periodicity & Y_PERIODIC) != 0;
+
+  int levels = 1;
+  PetscInt Mx = grid.Mx, My = grid.My;
+  while (levels < requested &&
+         (x_periodic ? Mx % 2 == 0 : (Mx - 1) % 2 == 0) &&
+         (y_periodic ? My % 2 == 0 : (My - 1) % 2 == 0) &&
+         min_x >= 4 && min_y >= 4) { // each sub-domain keeps at least 2 points
+    Mx = x_periodic ? Mx / 2 : (Mx - 1) / 2 + 1;
+    My = y_periodic ? My / 2 : (My - 1) / 2 + 1;
+    min_x /= 2; min_y /= 2;
+    levels++;
+  }
+
+  if (levels < requested) {
+    ierr = verbPrintf(2, grid.com,
+                      "PISM WARNING: the %d x %d grid on %d x %d processors allows only %d SSA multigrid levels (%d requested)\n",
+                      grid.Mx, grid.My, grid.Nx, grid.Ny, levels, requested); CHKERRQ(ierr);
+  }
+
+  if (levels <= 1)
+    return 0;
+
+  // The grid hierarchy is used to build interpolation operators only, so
+  // the DA does not have to be the one the system is solved on, but it has to
+  // have the same layout and the periodicity of the grid (note the
+  // transpose: DA's x is PISM's y).
+  DM mg_da = SSADA;
+  if (grid.periodicity != XY_PERIODIC) {
+    ierr = DMDACreate2d(grid.com,
+                        y_periodic ? DMDA_BOUNDARY_PERIODIC : DMDA_BOUNDARY_NONE,
+                        x_periodic ? DMDA_BOUNDARY_PERIODIC : DMDA_BOUNDARY_NONE,
+                        DMDA_STENCIL_BOX,
+                        grid.My, grid.Mx,
+                        grid.Ny, grid.Nx,
+                        2, 1,
+                        &grid.procs_y[0], &grid.procs_x[0],
+                        &mg_da); CHKERRQ(ierr);
+  }
+
+  ierr = KSPSetDM(ksp, mg_da); CHKERRQ(ierr);
+  ierr = KSPSetDMActive(ksp, PETSC_FALSE); CHKERRQ(ierr);
+
+  if (mg_da != SSADA) {
+    // the KSP keeps a reference
+    ierr = DMDestroy(&mg_da); CHKERRQ(ierr);
+  }
+
+  ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+  ierr = PCSetType(pc, PCMG); CHKERRQ(ierr);
+  ierr = PCMGSetLevels(pc, levels, PETSC_NULL); CHKERRQ(ierr);
+#if PISM_PETSC32_COMPAT==1
+  ierr = PCMGSetGalerkin(pc); CHKERRQ(ierr);
+#else
+  ierr = PCMGSetGalerkin(pc, PETSC_TRUE); CHKERRQ(ierr);
+#endif
+
+  // Richardson/SOR smoothing does not need eigenvalue estimates and does not
+  // require the operator to be symmetric (the SSAFEM Jacobian is not).
+  for (int k = 1; k < levels; ++k) {
+    KSP smoother;
+    PC smoother_pc;
+    ierr = PCMGGetSmoother(pc, k, &smoother); CHKERRQ(ierr);
+    ierr = KSPSetType(smoother, KSPRICHARDSON); CHKERRQ(ierr);
+    ierr = KSPGetPC(smoother, &smoother_pc); CHKERRQ(ierr);
+    ierr = PCSetType(smoother_pc, PCSOR); CHKERRQ(ierr);
+  }
+
+  ierr = verbPrintf(2, grid.com,
+                    "  SSA: using geometric multigrid with %d levels (coarsest grid: %d x %d)\n",
+                    levels, Mx, My); CHKERRQ(ierr);
+
   return 0;
 }
 
@@ -180,6 +305,10 @@ PetscErrorCode SSA::deallocate() {
   PetscErrorCode ierr;
 
   if (SSAX != PETSC_NULL) {
+    PetscInt local_size;
+    ierr = VecGetLocalSize(SSAX, &local_size); CHKERRQ(ierr);
+    grid.memory->deallocate("SSA", local_size * sizeof(PetscScalar), MEMORY_LOCAL_2D);
+
     ierr = VecDestroy(&SSAX); CHKERRQ(ierr);
   }
 
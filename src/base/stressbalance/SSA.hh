@@ -21,6 +21,7 @@
 
 #include "ShallowStressBalance.hh"
 #include "PISMDiagnostic.hh"
+#include <petscksp.h>
 
 //! Gives an extension coefficient to maintain ellipticity of SSA where ice is thin.
 /*!
@@ -182,6 +183,8 @@ protected:
 
   virtual PetscErrorCode compute_maximum_velocity();
 
+  virtual PetscErrorCode setup_multigrid(KSP ksp);
+
   IceModelVec2Int *mask;
   IceModelVec2S *thickness, *tauc, *surface, *bed;
   IceModelVec2S *driving_stress_x;
@@ -43,17 +43,22 @@ where \f$x\f$ (= Vec SSAX).  A PETSc SNES object is never created.
 PetscErrorCode SSAFD::allocate_fd() {
   PetscErrorCode ierr;
 
+  grid.memory->begin("SSA");
+
   // note SSADA and SSAX are allocated in SSA::allocate()
   ierr = VecDuplicate(SSAX, &SSARHS); CHKERRQ(ierr);
 
   ierr = DMCreateMatrix(SSADA, MATAIJ, &SSAStiffnessMatrix); CHKERRQ(ierr);
 
+  ierr = account_fd_memory(true); CHKERRQ(ierr);
+
   ierr = KSPCreate(grid.com, &SSAKSP); CHKERRQ(ierr);
   // the default PC type somehow is ILU, which now fails (?) while block jacobi
   //   seems to work; runtime options can override (see test J in vfnow.py)
   PC pc;
   ierr = KSPGetPC(SSAKSP,&pc); CHKERRQ(ierr);
   ierr = PCSetType(pc,PCBJACOBI); CHKERRQ(ierr);
+  ierr = setup_multigrid(SSAKSP); CHKERRQ(ierr);
   ierr = KSPSetFromOptions(SSAKSP); CHKERRQ(ierr);
 
   const PetscScalar power = 1.0 / flow_law->exponent();
@@ -83,6 +88,28 @@ PetscErrorCode SSAFD::allocate_fd() {
 
   dump_system_matlab = false;
 
+  grid.memory->end();
+
+  return 0;
+}
+
+//! \brief Record (if `allocating` is true) or un-record the memory used by
+//! the stiffness matrix and the right hand side.
+PetscErrorCode SSAFD::account_fd_memory(bool allocating) {
+  PetscErrorCode ierr;
+  MatInfo info;
+  PetscInt local_size;
+
+  ierr = MatGetInfo(SSAStiffnessMatrix, MAT_LOCAL, &info); CHKERRQ(ierr);
+  ierr = VecGetLocalSize(SSARHS, &local_size); CHKERRQ(ierr);
+
+  double bytes = info.memory + local_size * sizeof(PetscScalar);
+
+  if (allocating)
+    grid.memory->allocate("SSA", bytes, MEMORY_LOCAL_2D);
+  else
+    grid.memory->deallocate("SSA", bytes, MEMORY_LOCAL_2D);
+
   return 0;
 }
 
@@ -94,6 +121,10 @@ PetscErrorCode SSAFD::deallocate_fd() {
     ierr = KSPDestroy(&SSAKSP); CHKERRQ(ierr);
   }
 
+  if (SSAStiffnessMatrix != PETSC_NULL && SSARHS != PETSC_NULL) {
+    ierr = account_fd_memory(false); CHKERRQ(ierr);
+  }
+
   if (SSAStiffnessMatrix != PETSC_NULL) {
     ierr = MatDestroy(&SSAStiffnessMatrix); CHKERRQ(ierr);
   }
@@ -122,8 +153,8 @@ An explicit driving stress was specified instead and cannot be used.");
   ierr = PetscOptionsBegin(grid.com, "", "SSAFD options", ""); CHKERRQ(ierr);
   {
     bool flag;
-    ierr = PISMOptionsInt("-ssa_nuh_viewer_size", "nuH viewer size",
-                          nuh_viewer_size, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(grid.com, "-ssa_nuh_viewer_size", "nuH viewer size",
+                                    nuh_viewer_size, flag); CHKERRQ(ierr);
     ierr = PISMOptionsIsSet("-ssa_view_nuh", "Enable the SSAFD nuH runtime viewer",
                             view_nuh); CHKERRQ(ierr);
   }
@@ -191,7 +222,6 @@ PetscErrorCode SSAFD::assemble_rhs(Vec rhs) {
   if (use_cfbc) {
     ierr = thickness->begin_access(); CHKERRQ(ierr);
     ierr = bed->begin_access(); CHKERRQ(ierr);
-    ierr = mask->begin_access(); CHKERRQ(ierr);
   }
 
   for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
@@ -205,11 +235,11 @@ PetscErrorCode SSAFD::assemble_rhs(Vec rhs) {
 
       if (use_cfbc) {
         PetscScalar H_ij = (*thickness)(i,j);
-        PetscInt M_ij = mask->as_int(i,j),
-          M_e = mask->as_int(i + 1,j),
-          M_w = mask->as_int(i - 1,j),
-          M_n = mask->as_int(i,j + 1),
-          M_s = mask->as_int(i,j - 1);
+        PetscInt M_ij = mask_compact.as_int(i,j),
+          M_e = mask_compact.as_int(i + 1,j),
+          M_w = mask_compact.as_int(i - 1,j),
+          M_n = mask_compact.as_int(i,j + 1),
+          M_s = mask_compact.as_int(i,j - 1);
 
         // Note: this sets velocities at both ice-free ocean and ice-free
         // bedrock to zero. This means that we need to set boundary conditions
@@ -307,7 +337,6 @@ PetscErrorCode SSAFD::assemble_rhs(Vec rhs) {
   if (use_cfbc) {
     ierr = thickness->end_access(); CHKERRQ(ierr);
     ierr = bed->end_access(); CHKERRQ(ierr);
-    ierr = mask->end_access(); CHKERRQ(ierr);
   }
 
   if (vel_bc && bc_locations) {
@@ -413,7 +442,6 @@ PetscErrorCode SSAFD::assemble_matrix(bool include_basal_shear, Mat A) {
   ierr = nuH.begin_access(); CHKERRQ(ierr);
   ierr = tauc->begin_access(); CHKERRQ(ierr);
   ierr = vel.begin_access(); CHKERRQ(ierr);
-  ierr = mask->begin_access(); CHKERRQ(ierr);
 
   Mask M;
 
@@ -459,10 +487,10 @@ PetscErrorCode SSAFD::assemble_matrix(bool include_basal_shear, Mat A) {
        // be prescribed and is a temperature-independent free (user determined) parameter
 
 	// direct neighbors
-	PetscInt  M_e = mask->as_int(i + 1,j),
-	          M_w = mask->as_int(i - 1,j),
-	          M_n = mask->as_int(i,j + 1),
-		  M_s = mask->as_int(i,j - 1);
+	PetscInt  M_e = mask_compact.as_int(i + 1,j),
+	          M_w = mask_compact.as_int(i - 1,j),
+	          M_n = mask_compact.as_int(i,j + 1),
+		  M_s = mask_compact.as_int(i,j - 1);
 
         if ((*thickness)(i,j) > HminFrozen) {  
 	  if ((*bed)(i-1,j) > (*surface)(i,j) && M.ice_free_land(M_w)) {
@@ -490,20 +518,20 @@ PetscErrorCode SSAFD::assemble_matrix(bool include_basal_shear, Mat A) {
       PetscInt aMn = 1, aPn = 1, aMM = 1, aPP = 1, aMs = 1, aPs = 1;
       PetscInt bPw = 1, bPP = 1, bPe = 1, bMw = 1, bMM = 1, bMe = 1;
 
-      PetscInt M_ij = mask->as_int(i,j);
+      PetscInt M_ij = mask_compact.as_int(i,j);
 
       if (use_cfbc) {
         int
           // direct neighbors
-          M_e = mask->as_int(i + 1,j),
-          M_w = mask->as_int(i - 1,j),
-          M_n = mask->as_int(i,j + 1),
-          M_s = mask->as_int(i,j - 1),
+          M_e = mask_compact.as_int(i + 1,j),
+          M_w = mask_compact.as_int(i - 1,j),
+          M_n = mask_compact.as_int(i,j + 1),
+          M_s = mask_compact.as_int(i,j - 1),
           // "diagonal" neighbors
-          M_ne = mask->as_int(i + 1,j + 1),
-          M_se = mask->as_int(i + 1,j - 1),
-          M_nw = mask->as_int(i - 1,j + 1),
-          M_sw = mask->as_int(i - 1,j - 1);
+          M_ne = mask_compact.as_int(i + 1,j + 1),
+          M_se = mask_compact.as_int(i + 1,j - 1),
+          M_nw = mask_compact.as_int(i - 1,j + 1),
+          M_sw = mask_compact.as_int(i - 1,j - 1);
 
         // Note: this sets velocities at both ice-free ocean and ice-free
         // bedrock to zero. This means that we need to set boundary conditions
@@ -646,7 +674,6 @@ PetscErrorCode SSAFD::assemble_matrix(bool include_basal_shear, Mat A) {
     ierr = bc_locations->end_access(); CHKERRQ(ierr);
   }
 
-  ierr = mask->end_access(); CHKERRQ(ierr);
   ierr = vel.end_access(); CHKERRQ(ierr);
   ierr = tauc->end_access(); CHKERRQ(ierr);
   ierr = nuH.end_access(); CHKERRQ(ierr);
@@ -737,6 +764,10 @@ PetscErrorCode SSAFD::solve() {
 
   ierr = velocity.copy_to(velocity_old); CHKERRQ(ierr);
 
+  // the mask does not change during the solve; assemble_rhs(),
+  // assemble_matrix() and is_marginal() use the compact copy
+  ierr = mask_compact.update(*mask); CHKERRQ(ierr);
+
   // computation of RHS only needs to be done once; does not depend on
   // solution; but matrix changes under nonlinear iteration (loop over k below)
   ierr = assemble_rhs(SSARHS); CHKERRQ(ierr);
@@ -899,9 +930,9 @@ PetscErrorCode SSAFD::writeSSAsystemMatlab() {
   ierr = component.create(grid, "temp_storage", false); CHKERRQ(ierr);
 
   bool flag;
-  ierr = PISMOptionsString("ssafd_matlab",
-                           "Save the linear system to an ASCII .m file. Sets the file prefix.",
-                           prefix, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "ssafd_matlab",
+                                     "Save the linear system to an ASCII .m file. Sets the file prefix.",
+                                     prefix, flag); CHKERRQ(ierr);
 
   snprintf(yearappend, PETSC_MAX_PATH_LEN, "_y%.0f.m", grid.time->seconds_to_years(grid.time->current()));
   file_name = prefix + string(yearappend);
@@ -1231,7 +1262,7 @@ PetscErrorCode SSAFD::set_diagonal_matrix_entry(Mat A, int i, int j,
 
 //! \brief Checks if a cell is near or at the ice front.
 /*!
- * You need to call mask->begin_access() before and mask->end_access() after using this.
+ * Uses mask_compact, which solve() updates before assembling the system.
  *
  * Note that a cell is a CFBC location of one of four direct neighbors is ice-free.
  *
@@ -1245,17 +1276,17 @@ PetscErrorCode SSAFD::set_diagonal_matrix_entry(Mat A, int i, int j,
  */
 bool SSAFD::is_marginal(int i, int j, bool ssa_dirichlet_bc) {
 	
-  const PetscInt M_ij = mask->as_int(i,j),
+  const PetscInt M_ij = mask_compact.as_int(i,j),
     // direct neighbors
-    M_e = mask->as_int(i + 1,j),
-    M_w = mask->as_int(i - 1,j),
-    M_n = mask->as_int(i,j + 1),
-    M_s = mask->as_int(i,j - 1),
+    M_e = mask_compact.as_int(i + 1,j),
+    M_w = mask_compact.as_int(i - 1,j),
+    M_n = mask_compact.as_int(i,j + 1),
+    M_s = mask_compact.as_int(i,j - 1),
     // "diagonal" neighbors
-    M_ne = mask->as_int(i + 1,j + 1),
-    M_se = mask->as_int(i + 1,j - 1),
-    M_nw = mask->as_int(i - 1,j + 1),
-    M_sw = mask->as_int(i - 1,j - 1);
+    M_ne = mask_compact.as_int(i + 1,j + 1),
+    M_se = mask_compact.as_int(i + 1,j - 1),
+    M_nw = mask_compact.as_int(i - 1,j + 1),
+    M_sw = mask_compact.as_int(i - 1,j - 1);
 
   Mask M;
 
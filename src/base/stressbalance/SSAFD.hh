@@ -56,6 +56,8 @@ protected:
 
   virtual PetscErrorCode deallocate_fd();
 
+  PetscErrorCode account_fd_memory(bool allocating);
+
   virtual PetscErrorCode solve();
 
   virtual PetscErrorCode compute_hardav_staggered(IceModelVec2Stag &result);
@@ -81,6 +83,7 @@ protected:
 
   // objects used internally
   IceModelVec2Stag hardness, nuH, nuH_old;
+  IceModelVec2IntCompact mask_compact; //!< one-byte copy of *mask
   KSP SSAKSP;
   Mat SSAStiffnessMatrix;
   Vec SSARHS;
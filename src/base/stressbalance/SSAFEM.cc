@@ -20,6 +20,7 @@
 #include "FETools.hh"
 #include "Mask.hh"
 #include "basal_resistance.hh"
+#include "pism_threads.hh"
 
 #include "pism_petsc32_compat.hh"
 
@@ -33,6 +34,8 @@ SSA *SSAFEMFactory(IceGrid &g, IceBasalResistancePlasticLaw &b,
 PetscErrorCode SSAFEM::allocate_fem() {
   PetscErrorCode ierr;
 
+  grid.memory->begin("SSA");
+
   dirichletScale = 1.0;
   ocean_rho = config.get("sea_water_density");
   earth_grav = config.get("standard_gravity");
@@ -66,18 +69,122 @@ PetscErrorCode SSAFEM::allocate_fem() {
 
   ierr = SNESSetDM(snes, SSADA); CHKERRQ(ierr);
 
+  // In the matrix-free mode the SNES operator is a MatShell (see
+  // SSAFEM::apply_jacobian) and the assembled matrix (Picard linearization)
+  // is used for preconditioning only.
+  //
+  // By default only the 2x2 diagonal blocks of the Picard linearization are
+  // stored (point-block Jacobi), so no storage proportional to the number of
+  // non-zeros of the Jacobian is needed. The whole Picard linearization is
+  // assembled if requested and when multigrid is used (Galerkin coarse grid
+  // operators need the whole fine grid operator).
+  matrix_free = config.get_flag("ssa_fem_matrix_free");
+  picard_pc = (config.get_flag("ssa_fem_matrix_free_picard_pc") ||
+               config.get("ssa_multigrid_levels") > 1);
+  jacobian_shell = PETSC_NULL;
+  linearization_point = PETSC_NULL;
+  X_local = PETSC_NULL;
+  pc_da = PETSC_NULL;
+  jacobianStore = NULL;
+  if (matrix_free) {
+    PetscInt n;
+    ierr = VecGetLocalSize(SSAX, &n); CHKERRQ(ierr);
+
+    ierr = MatCreateShell(grid.com, n, n, PETSC_DETERMINE, PETSC_DETERMINE,
+                          this, &jacobian_shell); CHKERRQ(ierr);
+    ierr = MatShellSetOperation(jacobian_shell, MATOP_MULT,
+                                (void(*)(void))SSAFEJacobianMult); CHKERRQ(ierr);
+
+    ierr = DMCreateLocalVector(SSADA, &linearization_point); CHKERRQ(ierr);
+    ierr = VecSet(linearization_point, 0.0); CHKERRQ(ierr);
+    ierr = VecDuplicate(linearization_point, &X_local); CHKERRQ(ierr);
+
+    // The preconditioner matrix has the same layout as SSADA; a DA with
+    // stencil width 0 makes DMCreateMatrix() preallocate diagonal blocks
+    // only.
+    DM pc_dm = SSADA;
+    if (picard_pc == false) {
+      ierr = DMDACreate2d(grid.com,
+                          DMDA_BOUNDARY_PERIODIC, DMDA_BOUNDARY_PERIODIC,
+                          DMDA_STENCIL_BOX,
+                          grid.My, grid.Mx,
+                          grid.Ny, grid.Nx,
+                          2, 0,
+                          &grid.procs_y[0], &grid.procs_x[0],
+                          &pc_da); CHKERRQ(ierr);
+      pc_dm = pc_da;
+    }
+
+    Mat J;
+#if PISM_PETSC32_COMPAT==1
+    ierr = DMGetMatrix(pc_dm, "baij",  &J); CHKERRQ(ierr);
+    ierr = SNESSetJacobian(snes, jacobian_shell, J, SNESDAComputeJacobian, &callback_data); CHKERRQ(ierr);
+#else
+    ierr = DMCreateMatrix(pc_dm, "baij", &J); CHKERRQ(ierr);
+    ierr = SNESSetJacobian(snes, jacobian_shell, J, PETSC_NULL, PETSC_NULL); CHKERRQ(ierr);
+#endif
+    // J is destroyed during the SNESDestroy() call below.
+    ierr = MatDestroy(&J); CHKERRQ(ierr);
+
+    if (picard_pc == false) {
+      KSP ksp;
+      PC pc;
+      ierr = SNESGetKSP(snes, &ksp); CHKERRQ(ierr);
+      ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+      ierr = PCSetType(pc, PCPBJACOBI); CHKERRQ(ierr);
+    }
+  }
+
+#if PISM_PETSC32_COMPAT==0
+  if (matrix_free == false) {
+    // Create the Jacobian here (SNES would do it during the first solve) to
+    // be able to record its memory use.
+    Mat J;
+    ierr = DMCreateMatrix(SSADA, "baij", &J); CHKERRQ(ierr);
+    ierr = SNESSetJacobian(snes, J, J, PETSC_NULL, PETSC_NULL); CHKERRQ(ierr);
+    ierr = MatDestroy(&J); CHKERRQ(ierr);
+  }
+#endif
+
+  // Record the memory used by the assembled Jacobian (the preconditioner
+  // matrix in the matrix-free mode).
+  {
+    Mat P;
+    MatInfo info;
+    ierr = SNESGetJacobian(snes, PETSC_NULL, &P, PETSC_NULL, PETSC_NULL); CHKERRQ(ierr);
+    ierr = MatGetInfo(P, MAT_LOCAL, &info); CHKERRQ(ierr);
+    jacobian_bytes = info.memory;
+    grid.memory->allocate("SSA", jacobian_bytes, MEMORY_LOCAL_2D);
+  }
+
   // Default of maximum 200 iterations; possibly overridded by commandline
   PetscInt snes_max_it = 200;
   ierr = SNESSetTolerances(snes,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT,
                            snes_max_it,PETSC_DEFAULT);
   // ierr = SNESSetOptionsPrefix(snes,((PetscObject)this)->prefix);CHKERRQ(ierr);
 
+  {
+    KSP ksp;
+    ierr = SNESGetKSP(snes, &ksp); CHKERRQ(ierr);
+    ierr = setup_multigrid(ksp); CHKERRQ(ierr);
+  }
+
   ierr = SNESSetFromOptions(snes);CHKERRQ(ierr);
 
   // Allocate feStore, which contains coefficient data at the quadrature points of all the elements.
   // There are nElement elements, and FEQuadrature::Nq quadrature points.
   PetscInt nElements = element_index.element_count();
   feStore = new FEStoreNode[FEQuadrature::Nq*nElements];
+  grid.memory->allocate("SSA", (double)sizeof(FEStoreNode) * FEQuadrature::Nq * nElements,
+                        MEMORY_LOCAL_2D);
+
+  // In the matrix-free mode jacobianStore contains coefficients of the
+  // Jacobian at the linearization point; see SSAFEM::apply_jacobian.
+  if (matrix_free) {
+    jacobianStore = new FEJacobianNode[FEQuadrature::Nq*nElements]();
+    grid.memory->allocate("SSA", (double)sizeof(FEJacobianNode) * FEQuadrature::Nq * nElements,
+                          MEMORY_LOCAL_2D);
+  }
 
   // hardav IceModelVec2S is not used (so far).
   const PetscScalar power = 1.0 / flow_law->exponent();
@@ -86,6 +193,8 @@ PetscErrorCode SSAFEM::allocate_fem() {
   ierr = hardav.create(grid, "hardav", true); CHKERRQ(ierr);
   ierr = hardav.set_attrs("internal", "vertically-averaged ice hardness", unitstr, ""); CHKERRQ(ierr);
 
+  grid.memory->end();
+
   return 0;
 }
 
@@ -94,7 +203,30 @@ PetscErrorCode SSAFEM::deallocate_fem() {
   PetscErrorCode ierr;
 
   ierr = SNESDestroy(&snes);CHKERRQ(ierr);
+  grid.memory->deallocate("SSA", jacobian_bytes, MEMORY_LOCAL_2D);
+
+  if (jacobian_shell != PETSC_NULL) {
+    ierr = MatDestroy(&jacobian_shell); CHKERRQ(ierr);
+  }
+  if (linearization_point != PETSC_NULL) {
+    ierr = VecDestroy(&linearization_point); CHKERRQ(ierr);
+  }
+  if (X_local != PETSC_NULL) {
+    ierr = VecDestroy(&X_local); CHKERRQ(ierr);
+  }
+  if (pc_da != PETSC_NULL) {
+    ierr = DMDestroy(&pc_da); CHKERRQ(ierr);
+  }
+
   delete[] feStore;
+  grid.memory->deallocate("SSA", (double)sizeof(FEStoreNode) * FEQuadrature::Nq *
+                          element_index.element_count(), MEMORY_LOCAL_2D);
+
+  if (jacobianStore != NULL) {
+    delete[] jacobianStore;
+    grid.memory->deallocate("SSA", (double)sizeof(FEJacobianNode) * FEQuadrature::Nq *
+                            element_index.element_count(), MEMORY_LOCAL_2D);
+  }
 
   return 0;
 }
@@ -107,6 +239,12 @@ PetscErrorCode SSAFEM::init(PISMVars &vars) {
   ierr = verbPrintf(2,grid.com,
            "  [using the SNES-based finite element method implementation]\n");
            CHKERRQ(ierr);
+  if (matrix_free) {
+    ierr = verbPrintf(2,grid.com,
+                      "  [using the matrix-free Jacobian; the Picard linearization%s is used for preconditioning]\n",
+                      picard_pc ? "" : " (its block diagonal)");
+    CHKERRQ(ierr);
+  }
 
   ierr = setFromOptions(); CHKERRQ(ierr);
 
@@ -208,28 +346,21 @@ PetscErrorCode SSAFEM::solve()
 any geometry or temperature related coefficients have changed. The method
 stores the values of the coefficients at the quadrature points of each
 element so that these interpolated values do not need to be computed
-during each outer iteration of the nonlinear solve.*/
+during each outer iteration of the nonlinear solve. Rows of elements are
+split between threads (see pism_threads.hh).*/
 PetscErrorCode SSAFEM::setup()
 {
   PetscReal      **h,
                  **H,
                  **topg,
                  **tauc_array,
-                  *Enth_e[4],
-                  *Enth_q[4],
                   **ds_x,
                   **ds_y;
-  PetscInt         i,j,k,q,p,
-                   Mz = grid.Mz;
+  const PetscInt Mz = grid.Mz;
   PetscErrorCode   ierr;
 
   PetscReal ice_rho = config.get("ice_density");
 
-  for(q=0;q<FEQuadrature::Nq;q++)
-  {
-    Enth_q[q] = new PetscReal[Mz];
-  }
-
   GeometryCalculator gc(sea_level, config);
 
   ierr = enthalpy->begin_access();CHKERRQ(ierr);
@@ -247,29 +378,52 @@ PetscErrorCode SSAFEM::setup()
   ierr = bed->get_array(topg);CHKERRQ(ierr);
   ierr = tauc->get_array(tauc_array);CHKERRQ(ierr);
 
+  const int n_threads = pism_max_threads();
+  vector<PetscErrorCode> thread_error(n_threads, 0);
+
+  // Every element only writes its own coefficients in feStore, so rows of
+  // elements are split between threads.
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr)
+#endif
+  {
+  const int thread = pism_thread_id();
+  PetscErrorCode &error = thread_error[thread];
+
+  // FEQuadrature and FEDOFMap keep per-element state in members
+  FEQuadrature Q = quadrature;
+  FEDOFMap D;
+
+  PetscReal *Enth_e[FEQuadrature::Nk];
+  vector<PetscReal> Enth_q_storage(FEQuadrature::Nq * Mz);
+  PetscReal *Enth_q[FEQuadrature::Nq];
+  for (PetscInt q=0; q<FEQuadrature::Nq; q++)
+    Enth_q[q] = &Enth_q_storage[q * Mz];
 
   PetscInt xs = element_index.xs, xm = element_index.xm,
            ys = element_index.ys, ym = element_index.ym;
-  for (i=xs; i<xs+xm; i++) {
-    for (j=ys;j<ys+ym; j++) {
+  PetscInt i0, i1;
+  pism_thread_range(xs, xs + xm, i0, i1);
+  for (PetscInt i=i0; i<i1; i++) {
+    for (PetscInt j=ys;j<ys+ym; j++) {
       PetscReal hq[FEQuadrature::Nq],hxq[FEQuadrature::Nq],hyq[FEQuadrature::Nq];
       PetscReal ds_xq[FEQuadrature::Nq], ds_yq[FEQuadrature::Nq];
       if(driving_stress_explicit) {
-        quadrature.computeTrialFunctionValues(i,j,dofmap,ds_x,ds_xq);
-        quadrature.computeTrialFunctionValues(i,j,dofmap,ds_y,ds_yq);
+        Q.computeTrialFunctionValues(i,j,D,ds_x,ds_xq);
+        Q.computeTrialFunctionValues(i,j,D,ds_y,ds_yq);
       } else {
         // Extract coefficient values at the quadrature points.
-        quadrature.computeTrialFunctionValues(i,j,dofmap,h,hq,hxq,hyq);
+        Q.computeTrialFunctionValues(i,j,D,h,hq,hxq,hyq);
       }
 
       PetscReal Hq[FEQuadrature::Nq], bq[FEQuadrature::Nq], taucq[FEQuadrature::Nq];
-      quadrature.computeTrialFunctionValues(i,j,dofmap,H,Hq);
-      quadrature.computeTrialFunctionValues(i,j,dofmap,topg,bq);
-      quadrature.computeTrialFunctionValues(i,j,dofmap,tauc_array,taucq);
+      Q.computeTrialFunctionValues(i,j,D,H,Hq);
+      Q.computeTrialFunctionValues(i,j,D,topg,bq);
+      Q.computeTrialFunctionValues(i,j,D,tauc_array,taucq);
 
       const PetscInt ij = element_index.flatten(i,j);
       FEStoreNode *feS = &feStore[4*ij];
-      for (q=0; q<4; q++) {
+      for (PetscInt q=0; q<4; q++) {
         feS[q].H  = Hq[q];
         feS[q].b  = bq[q];
         feS[q].tauc = taucq[q];
@@ -292,36 +446,57 @@ PetscErrorCode SSAFEM::setup()
       // the column average over each element nodes and then interpolate to the
       // quadrature points. Does this make a difference?
 
+      // IceFlowLaw::averaged_hardness() only uses levels 0,...,kbelowH, so we
+      // only need to interpolate enthalpy up to the highest of these levels
+      // over the quadrature points of this element. (In ice-free areas this is
+      // just the base.)
+      PetscInt ks[FEQuadrature::Nq], ks_max = 0;
+      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
+        ks[q] = grid.kBelowHeight(feS[q].H);
+        ks_max = PetscMax(ks_max, ks[q]);
+      }
+
       // Obtain the values of enthalpy at each vertical level at each of the vertices
       // of the current element.
-      ierr = enthalpy->getInternalColumn(i,j,&Enth_e[0]);
-      ierr = enthalpy->getInternalColumn(i+1,j,&Enth_e[1]);CHKERRQ(ierr);
-      ierr = enthalpy->getInternalColumn(i+1,j+1,&Enth_e[2]);CHKERRQ(ierr);
-      ierr = enthalpy->getInternalColumn(i,j+1,&Enth_e[3]);CHKERRQ(ierr);
+      ierr = enthalpy->getInternalColumn(i,j,&Enth_e[0]); PISM_THREAD_CHKERRQ(ierr, error);
+      ierr = enthalpy->getInternalColumn(i+1,j,&Enth_e[1]); PISM_THREAD_CHKERRQ(ierr, error);
+      ierr = enthalpy->getInternalColumn(i+1,j+1,&Enth_e[2]); PISM_THREAD_CHKERRQ(ierr, error);
+      ierr = enthalpy->getInternalColumn(i,j+1,&Enth_e[3]); PISM_THREAD_CHKERRQ(ierr, error);
 
       // We now want to interpolate to the quadrature points at each of the
       // vertical levels.  It would be nice to use quadrature::computeTestFunctionValues,
       // but the way we have just obtained the values at the element vertices
       // using getInternalColumn doesn't make this straightforward.  So we compute the values
-      // by hand.
-      const FEFunctionGerm (*test)[FEQuadrature::Nk] = quadrature.testFunctionValues();
-      for (k=0; k<Mz; k++) {
-        Enth_q[0][k] = Enth_q[1][k] = Enth_q[2][k] = Enth_q[3][k] = 0;
-        for (q=0; q<FEQuadrature::Nq; q++) {
-          for (p=0; p<FEQuadrature::Nk; p++) {
-            Enth_q[q][k] += test[q][p].val * Enth_e[p][k];
-          }
+      // by hand. The inner loop goes over contiguous column storage, so it
+      // vectorizes.
+      const FEFunctionGerm (*test)[FEQuadrature::Nk] = Q.testFunctionValues();
+      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
+        const PetscReal
+          w0 = test[q][0].val, w1 = test[q][1].val,
+          w2 = test[q][2].val, w3 = test[q][3].val;
+        const PetscReal
+          *E0 = Enth_e[0], *E1 = Enth_e[1], *E2 = Enth_e[2], *E3 = Enth_e[3];
+        PetscReal *result = Enth_q[q];
+
+        for (PetscInt k=0; k<=ks_max; k++) {
+          result[k] = w0*E0[k] + w1*E1[k] + w2*E2[k] + w3*E3[k];
         }
       }
 
       // Now, for each column over a quadrature point, find the averaged_hardness.
-      for (q=0; q<FEQuadrature::Nq; q++) {
+      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
         // Evaluate column integrals in flow law at every quadrature point's column
-        feS[q].B = flow_law->averaged_hardness(feS[q].H, grid.kBelowHeight(feS[q].H),
-                                                  &grid.zlevels[0], Enth_q[q]);
+        feS[q].B = flow_law->averaged_hardness(feS[q].H, ks[q],
+                                               &grid.zlevels[0], Enth_q[q]);
       }
     }
   }
+  } // end of the parallel region
+
+  for (int t = 0; t < n_threads; ++t) {
+    CHKERRQ(thread_error[t]);
+  }
+
   if(surface != NULL) {
     ierr = surface->end_access();CHKERRQ(ierr);
   } else {
@@ -333,11 +508,6 @@ PetscErrorCode SSAFEM::setup()
   ierr = tauc->end_access();CHKERRQ(ierr);
   ierr = enthalpy->end_access();CHKERRQ(ierr);
 
-  for(q=0;q<4;q++)
-  {
-    delete [] Enth_q[q];
-  }
-
   return 0;
 }
 
@@ -410,12 +580,17 @@ void SSAFEM::FixDirichletValues( PetscReal local_bc_mask[],PISMVector2 **BC_vel,
 
 //! Implements the callback for computing the SNES local function.
 /*! Compute the residual \f[r_{ij}= G(x,\psi_{ij}) \f] where \f$G\f$ is the weak form of the SSA, \f$x\f$
-is the current approximate solution, and the \f$\psi_{ij}\f$ are test functions. */
+is the current approximate solution, and the \f$\psi_{ij}\f$ are test functions.
+
+Element rows are processed by threads using two "colors": an element in row
+\a i adds to the residual at nodes in rows \a i and \a i+1, so rows of the
+same parity do not share nodes and can be processed concurrently. Even rows
+go first, then odd ones. */
 PetscErrorCode SSAFEM::compute_local_function(DMDALocalInfo *info, const PISMVector2 **xg, PISMVector2 **yg)
 {
-  PetscInt         i,j,k,q;
-  PetscReal        **bc_mask;
-  PISMVector2        **BC_vel;
+  PetscInt         i,j;
+  PetscReal        **bc_mask = NULL;
+  PISMVector2        **BC_vel = NULL;
   PetscErrorCode   ierr;
 
   (void) info; // Avoid compiler warning.
@@ -428,58 +603,78 @@ PetscErrorCode SSAFEM::compute_local_function(DMDALocalInfo *info, const PISMVec
   }
 
   // Start access of Dirichlet data, if present.
-  if (bc_locations && vel_bc) {
+  const bool dirichlet = (bc_locations && vel_bc);
+  if (dirichlet) {
     ierr = bc_locations->get_array(bc_mask);CHKERRQ(ierr);
     ierr = vel_bc->get_array(BC_vel); CHKERRQ(ierr);
   }
 
+  const int n_threads = pism_max_threads();
+  vector<PetscErrorCode> thread_error(n_threads, 0);
+
+  const PetscInt xs = element_index.xs, xm = element_index.xm,
+    ys = element_index.ys, ym = element_index.ym;
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr)
+#endif
+  {
+  PetscErrorCode &error = thread_error[pism_thread_id()];
+
+  // FEQuadrature and FEDOFMap keep per-element state in members
+  FEQuadrature Q = quadrature;
+  FEDOFMap D;
+
   // Jacobian times weights for quadrature.
   PetscScalar JxW[FEQuadrature::Nq];
-  quadrature.getWeightedJacobian(JxW);
+  Q.getWeightedJacobian(JxW);
 
   // Storage for the current solution at quadrature points.
   PISMVector2 u[FEQuadrature::Nq];
   PetscScalar Du[FEQuadrature::Nq][3];
 
   // An Nq by Nk array of test function values.
-  const FEFunctionGerm (*test)[FEQuadrature::Nk] = quadrature.testFunctionValues();
+  const FEFunctionGerm (*test)[FEQuadrature::Nk] = Q.testFunctionValues();
 
   // Flags for each vertex in an element that determine if explicit Dirichlet data has
   // been set.
   PetscReal local_bc_mask[FEQuadrature::Nk];
 
-  // Iterate over the elements.
-  PetscInt xs = element_index.xs, xm = element_index.xm,
-           ys = element_index.ys, ym = element_index.ym;
-  for (i=xs; i<xs+xm; i++) {
-    for (j=ys; j<ys+ym; j++) {
+  // Iterate over the elements, one color at a time (the implicit barrier at
+  // the end of "omp for" separates colors).
+  for (int color = 0; color < 2; ++color) {
+#if (PISM_USE_OPENMP==1)
+#pragma omp for schedule(static)
+#endif
+  for (PetscInt ei=xs+color; ei<xs+xm; ei+=2) {
+    for (PetscInt ej=ys; ej<ys+ym; ej++) {
       // Storage for element-local solution and residuals.
       PISMVector2     x[4],y[4];
       // Index into coefficient storage in feStore
-      const PetscInt ij = element_index.flatten(i,j);
+      const PetscInt ij = element_index.flatten(ei,ej);
 
       // Initialize the map from global to local degrees of freedom for this element.
-      dofmap.reset(i,j,grid);
+      D.reset(ei,ej,grid);
 
       // Obtain the value of the solution at the nodes adjacent to the element.
-      dofmap.extractLocalDOFs(i,j,xg,x);
+      D.extractLocalDOFs(ei,ej,xg,x);
 
       // These values now need to be adjusted if some nodes in the element have
       // Dirichlet data.
-      if(bc_locations && vel_bc) {
-        dofmap.extractLocalDOFs(i,j,bc_mask,local_bc_mask);
-        FixDirichletValues(local_bc_mask,BC_vel,x,dofmap);
+      if (dirichlet) {
+        D.extractLocalDOFs(ei,ej,bc_mask,local_bc_mask);
+        FixDirichletValues(local_bc_mask,BC_vel,x,D);
       }
 
       // Zero out the element-local residual in prep for updating it.
-      for(k=0;k<FEQuadrature::Nk;k++){
+      for (PetscInt k=0;k<FEQuadrature::Nk;k++){
         y[k].u = 0; y[k].v = 0;
       }
 
       // Compute the solution values and symmetric gradient at the quadrature points.
-      quadrature.computeTrialFunctionValues(x,u,Du);
+      Q.computeTrialFunctionValues(x,u,Du);
 
-      for (q=0; q<FEQuadrature::Nq; q++) {     // loop over quadrature points on this element.
+      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {     // loop over quadrature points on this element.
 
         // Symmetric gradient at the quadrature point.
         PetscScalar *Duq = Du[q];
@@ -488,27 +683,34 @@ PetscErrorCode SSAFEM::compute_local_function(DMDALocalInfo *info, const PISMVec
         const FEStoreNode *feS = &feStore[ij*FEQuadrature::Nq+q];
         const PetscReal    jw  = JxW[q];
         PetscReal nuH, beta;
-        ierr = PointwiseNuHAndBeta(feS,u+q,Duq,&nuH,NULL,&beta,NULL);CHKERRQ(ierr);
+        ierr = PointwiseNuHAndBeta(feS,u+q,Duq,&nuH,NULL,&beta,NULL); PISM_THREAD_CHKERRQ_BREAK(ierr, error);
 
         // The next few lines compute the actual residual for the element.
         PISMVector2 f;
         f.u = beta*u[q].u - feS->driving_stress.u;
         f.v = beta*u[q].v - feS->driving_stress.v;
 
-        for(k=0; k<4;k++) {  // loop over the test functions.
+        for (PetscInt k=0; k<4;k++) {  // loop over the test functions.
           const FEFunctionGerm &testqk = test[q][k];
           y[k].u += jw*(nuH*(testqk.dx*(2*Duq[0]+Duq[1]) + testqk.dy*Duq[2]) + testqk.val*f.u);
           y[k].v += jw*(nuH*(testqk.dy*(2*Duq[1]+Duq[0]) + testqk.dx*Duq[2]) + testqk.val*f.v);
         }
       } // q
+      PISM_THREAD_CHKERRQ(error, error);
 
-      dofmap.addLocalResidualBlock(y,yg);
-    } // j-loop
-  } // i-loop
+      D.addLocalResidualBlock(y,yg);
+    } // ej-loop
+  } // ei-loop
+  } // color
+  } // end of the parallel region
+
+  for (int t = 0; t < n_threads; ++t) {
+    CHKERRQ(thread_error[t]);
+  }
 
   // Until now we have not touched rows in the residual corresponding to Dirichlet data.
   // We fix this now.
-  if (bc_locations && vel_bc) {
+  if (dirichlet) {
     // Enforce Dirichlet conditions strongly
     for (i=grid.xs; i<grid.xs+grid.xm; i++) {
       for (j=grid.ys; j<grid.ys+grid.ym; j++) {
@@ -542,33 +744,33 @@ PetscErrorCode SSAFEM::compute_local_function(DMDALocalInfo *info, const PISMVec
 
 
 
-//! Implements the callback for computing the SNES local Jacobian.
-/*! Compute the Jacobian \f[J_{ij}{kl} \frac{d r_{ij}}{d x_{kl}}= G(x,\psi_{ij}) \f]
-where \f$G\f$ is the weak form of the SSA, \f$x\f$ is the current approximate solution, and
-the \f$\psi_{ij}\f$ are test functions. */
-PetscErrorCode SSAFEM::compute_local_jacobian(DMDALocalInfo *info, const PISMVector2 **xg, Mat Jac )
-{
-
-  PetscReal      **bc_mask;
-  PISMVector2    **BC_vel;
-  PetscInt         i,j;
-  PetscErrorCode   ierr;
+//! \brief Compute the element-local Jacobian \a K of the element (\a i, \a j) at the
+//! element-local solution \a x.
+/*! If \a picard is true, the terms involving the derivatives of the effective viscosity
+and of the basal drag coefficient with respect to the solution are dropped; this gives
+the (symmetric positive definite) Picard linearization, which is cheaper to assemble and
+is used as the preconditioner in the matrix-free mode.
 
-  // Avoid compiler warning.
-  (void) info;
+The element-local Jacobian is a row-major (2*FEQuadrature::Nk)*(2*FEQuadrature::Nk) array.
 
-  // Zero out the Jacobian in preparation for updating it.
-  ierr = MatZeroEntries(Jac);CHKERRQ(ierr);
+\a Q is used to evaluate the solution at quadrature points; each thread has
+to pass its own copy because FEQuadrature keeps scratch space in its members.
+\a nuH_zero_count is incremented for every quadrature point where
+\f$\nu H = 0\f$.
 
-  // Start access to Dirichlet data if present.
-  if (bc_locations && vel_bc) {
-    ierr = bc_locations->get_array(bc_mask);CHKERRQ(ierr);
-    ierr = vel_bc->get_array(BC_vel); CHKERRQ(ierr);
-  }
+In the matrix-free mode the coefficients \f$\nu H\f$, \f$\beta\f$ and their
+derivatives are also saved in jacobianStore (before the Picard
+linearization drops the derivatives) for SSAFEM::apply_jacobian.
+*/
+PetscErrorCode SSAFEM::compute_element_jacobian(FEQuadrature &Q, PetscInt i, PetscInt j,
+                                                const PISMVector2 *x, bool picard, PetscReal *K,
+                                                PetscInt &nuH_zero_count)
+{
+  PetscErrorCode ierr;
 
   // Jacobian times weights for quadrature.
   PetscScalar JxW[FEQuadrature::Nq];
-  quadrature.getWeightedJacobian(JxW);
+  Q.getWeightedJacobian(JxW);
 
   // Storage for the current solution at quadrature points.
   PISMVector2 w[FEQuadrature::Nq];
@@ -576,112 +778,344 @@ PetscErrorCode SSAFEM::compute_local_jacobian(DMDALocalInfo *info, const PISMVec
 
   // Values of the finite element test functions at the quadrature points.
   // This is an Nq by Nk array of function germs (Nq=#of quad pts, Nk=#of test functions).
-  const FEFunctionGerm (*test)[FEQuadrature::Nk] = quadrature.testFunctionValues();
+  const FEFunctionGerm (*test)[FEQuadrature::Nk] = Q.testFunctionValues();
 
-  // Flags for each vertex in an element that determine if explicit Dirichlet data has
-  // been set.
-  PetscReal local_bc_mask[FEQuadrature::Nk];
+  // Index into the coefficient storage array.
+  const PetscInt ij = element_index.flatten(i,j);
 
-  // Loop through all the elements.
-  PetscInt xs = element_index.xs, xm = element_index.xm,
-           ys = element_index.ys, ym = element_index.ym;
-  for (i=xs; i<xs+xm; i++) {
-    for (j=ys; j<ys+ym; j++) {
-      // Values of the solution at the nodes of the current element.
-      PISMVector2    x[FEQuadrature::Nk];
+  // Compute the values of the solution at the quadrature points.
+  Q.computeTrialFunctionValues(x,w,Dw);
 
-      // Element-local Jacobian matrix (there are FEQuadrature::Nk vector valued degrees
-      // of freedom per elment, for a total of (2*FEQuadrature::Nk)*(2*FEQuadrature::Nk) = 16
-      // entries in the local Jacobian.
-      PetscReal      K[(2*FEQuadrature::Nk)*(2*FEQuadrature::Nk)];
+  // Build the element-local Jacobian.
+  ierr = PetscMemzero(K,sizeof(PetscReal)*(2*FEQuadrature::Nk)*(2*FEQuadrature::Nk));CHKERRQ(ierr);
+  for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
 
-      // Index into the coefficient storage array.
-      const PetscInt ij = element_index.flatten(i,j);
+    // Shorthand for values and derivatives of the solution at the single quadrature point.
+    PISMVector2 &wq = w[q];
+    PetscReal *Dwq = Dw[q];
 
-      // Initialize the map from global to local degrees of freedom for this element.
-      dofmap.reset(i,j,grid);
+    // Coefficients evaluated at the single quadrature point.
+    const FEStoreNode *feS = &feStore[ij*4+q];
+    const PetscReal    jw  = JxW[q];
+    PetscReal nuH,dNuH,beta,dbeta;
+    ierr = PointwiseNuHAndBeta(feS,&wq,Dwq,&nuH,&dNuH,&beta,&dbeta);CHKERRQ(ierr);
 
-      // Obtain the value of the solution at the adjacent nodes to the element.
-      dofmap.extractLocalDOFs(i,j,xg,x);
+    if (jacobianStore != NULL) {
+      FEJacobianNode &c = jacobianStore[ij*FEQuadrature::Nq+q];
+      c.nuH = nuH; c.dNuH = dNuH; c.beta = beta; c.dbeta = dbeta;
+    }
 
-      // These values now need to be adjusted if some nodes in the element have
-      // Dirichlet data.
-      if(bc_locations && vel_bc) {
-        dofmap.extractLocalDOFs(i,j,bc_mask,local_bc_mask);
-        FixDirichletValues(local_bc_mask,BC_vel,x,dofmap);
-      }
+    if (picard) {
+      dNuH = 0;
+      dbeta = 0;
+    }
 
-      // Compute the values of the solution at the quadrature points.
-      quadrature.computeTrialFunctionValues(x,w,Dw);
+    if(nuH==0)
+    {
+      nuH_zero_count++;
+    }
 
-      // Build the element-local Jacobian.
-      ierr = PetscMemzero(K,sizeof(K));CHKERRQ(ierr);
-      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
+    for (PetscInt k=0; k<4; k++) {   // Test functions
+      // FIXME (DAM 2/28/11) The following computations could be a little better documented.
+      const FEFunctionGerm &test_qk=test[q][k];
+
+      // Terms that depend on the test function only:
+      const PetscReal ht = test_qk.val,
+        dxt = test_qk.dx, dyt = test_qk.dy,
+        // Cross terms appearing with beta'
+        bvx = ht*wq.u, bvy = ht*wq.v,
+        // Cross terms appearing with nuH'
+        cvx = dxt*(2*Dwq[0]+Dwq[1]) + dyt*Dwq[2],
+        cvy = dyt*(2*Dwq[1]+Dwq[0]) + dxt*Dwq[2];
+
+      for (PetscInt l=0; l<4; l++) { // Trial functions
+        const FEFunctionGerm &test_ql=test[q][l];
+
+        const PetscReal h = test_ql.val,
+              dx = test_ql.dx, dy = test_ql.dy,
+
+        // Cross terms appearing with beta'
+        bux = wq.u*h,buy = wq.v*h,
+        // Cross terms appearing with nuH'
+        cux = (2*Dwq[0]+Dwq[1])*dx + Dwq[2]*dy,
+        cuy = (2*Dwq[1]+Dwq[0])*dy + Dwq[2]*dx;
+
+        // u-u coupling
+        K[k*16+l*2]     += jw*(beta*ht*h + dbeta*bvx*bux + nuH*(2*dxt*dx + dyt*0.5*dy) + dNuH*cvx*cux);
+        // u-v coupling
+        K[k*16+l*2+1]   += jw*(dbeta*bvx*buy + nuH*(0.5*dyt*dx + dxt*dy) + dNuH*cvx*cuy);
+        // v-u coupling
+        K[k*16+8+l*2]   += jw*(dbeta*bvy*bux + nuH*(0.5*dxt*dy + dyt*dx) + dNuH*cvy*cux);
+        // v-v coupling
+        K[k*16+8+l*2+1] += jw*(beta*ht*h + dbeta*bvy*buy + nuH*(2*dyt*dy + dxt*0.5*dx) + dNuH*cvy*cuy);
+      } // l
+    } // k
+  } // q
 
-        // Shorthand for values and derivatives of the solution at the single quadrature point.
-        PISMVector2 &wq = w[q];
-        PetscReal *Dwq = Dw[q];
+  return 0;
+}
 
-        // Coefficients evaluated at the single quadrature point.
-        const FEStoreNode *feS = &feStore[ij*4+q];
-        const PetscReal    jw  = JxW[q];
-        PetscReal nuH,dNuH,beta,dbeta;
-        ierr = PointwiseNuHAndBeta(feS,&wq,Dwq,&nuH,&dNuH,&beta,&dbeta);CHKERRQ(ierr);
-
-        for (PetscInt k=0; k<4; k++) {   // Test functions
-          for (PetscInt l=0; l<4; l++) { // Trial functions
-
-            // FIXME (DAM 2/28/11) The following computations could be a little better documented.
-            const FEFunctionGerm &test_qk=test[q][k];
-            const FEFunctionGerm &test_ql=test[q][l];
-
-            const PetscReal ht = test_qk.val,h = test_ql.val,
-                  dxt = test_qk.dx, dyt = test_qk.dy,
-                  dx = test_ql.dx, dy = test_ql.dy,
-
-            // Cross terms appearing with beta'
-            bvx = ht*wq.u,bvy = ht*wq.v,bux = wq.u*h,buy = wq.v*h,
-            // Cross terms appearing with nuH'
-            cvx = dxt*(2*Dwq[0]+Dwq[1]) + dyt*Dwq[2],
-            cvy = dyt*(2*Dwq[1]+Dwq[0]) + dxt*Dwq[2],
-            cux = (2*Dwq[0]+Dwq[1])*dx + Dwq[2]*dy,
-            cuy = (2*Dwq[1]+Dwq[0])*dy + Dwq[2]*dx;
-
-            if(nuH==0)
-            {
-              verbPrintf(1,grid.com,"nuh=0 i %d j %d q %d k %d\n",i,j,q,k);
-            }
-            // u-u coupling
-            K[k*16+l*2]     += jw*(beta*ht*h + dbeta*bvx*bux + nuH*(2*dxt*dx + dyt*0.5*dy) + dNuH*cvx*cux);
-            // u-v coupling
-            K[k*16+l*2+1]   += jw*(dbeta*bvx*buy + nuH*(0.5*dyt*dx + dxt*dy) + dNuH*cvx*cuy);
-            // v-u coupling
-            K[k*16+8+l*2]   += jw*(dbeta*bvy*bux + nuH*(0.5*dxt*dy + dyt*dx) + dNuH*cvy*cux);
-            // v-v coupling
-            K[k*16+8+l*2+1] += jw*(beta*ht*h + dbeta*bvy*buy + nuH*(2*dyt*dy + dxt*0.5*dx) + dNuH*cvy*cuy);
-          } // l
-        } // k
-      } // q
-      ierr = dofmap.addLocalJacobianBlock(K,Jac);
-    } // j
-  } // i
+//! \brief Compute element-local Jacobians of the row \a i of elements (see
+//! SSAFEM::compute_element_jacobian) and store them in \a K_row.
+/*! \a K_row has room for element_index.ym element Jacobians. \a Q and \a D
+are used as scratch space, so each thread has to pass its own copies.
 
+The Dirichlet data is used to fix element-local values of the solution;
+Dirichlet rows and columns are left out by SSAFEM::insert_jacobian_row.
+*/
+PetscErrorCode SSAFEM::compute_element_row(FEQuadrature &Q, FEDOFMap &D,
+                                           PetscInt i, const PISMVector2 **xg,
+                                           PetscReal **bc_mask, PISMVector2 **BC_vel,
+                                           bool picard, PetscReal *K_row,
+                                           PetscInt &nuH_zero_count)
+{
+  PetscErrorCode ierr;
+  const PetscInt Nk2 = (2*FEQuadrature::Nk)*(2*FEQuadrature::Nk),
+    ys = element_index.ys, ym = element_index.ym;
+  const bool dirichlet = (bc_locations && vel_bc);
+
+  for (PetscInt j=ys; j<ys+ym; j++) {
+    // Values of the solution at the nodes of the current element.
+    PISMVector2 x[FEQuadrature::Nk];
+    PetscReal   local_bc_mask[FEQuadrature::Nk];
+
+    D.reset(i,j,grid);
+    D.extractLocalDOFs(i,j,xg,x);
+
+    // These values now need to be adjusted if some nodes in the element have
+    // Dirichlet data.
+    if (dirichlet) {
+      D.extractLocalDOFs(i,j,bc_mask,local_bc_mask);
+      FixDirichletValues(local_bc_mask,BC_vel,x,D);
+    }
 
-  // Until now, the rows and columns correspoinding to Dirichlet data have not been set.  We now
-  // put an identity block in for these unknowns.  Note that because we have takes steps to not touching these
-  // columns previously, the symmetry of the Jacobian matrix is preserved.
-  if (bc_locations && vel_bc) {
-    for (i=grid.xs; i<grid.xs+grid.xm; i++) {
-      for (j=grid.ys; j<grid.ys+grid.ym; j++) {
-        if (bc_locations->as_int(i,j) == 1) {
-          const PetscReal ident[4] = {dirichletScale,0,0,dirichletScale};
-          MatStencil row;
-          // FIXME: Transpose shows up here!
-          row.j = i; row.i = j;
-          ierr = MatSetValuesBlockedStencil(Jac,1,&row,1,&row,ident,ADD_VALUES);CHKERRQ(ierr);
+    ierr = compute_element_jacobian(Q, i, j, x, picard, &K_row[(j-ys)*Nk2],
+                                    nuH_zero_count); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Sum contributions of element rows \a i-1 and \a i to the Jacobian
+//! rows of nodes (\a i, j) and insert them into \a Jac.
+/*! \a K_prev and \a K_this are element Jacobians computed by
+SSAFEM::compute_element_row; either is NULL if the corresponding row of
+elements does not exist (at the edge of a non-periodic grid).
+
+Rows of Dirichlet nodes get an identity block; columns corresponding to
+Dirichlet nodes are not used. This preserves the symmetry of the Jacobian.
+
+If \a diagonal_only is true, only the 2x2 diagonal blocks are inserted (the
+block-diagonal preconditioner in the matrix-free mode).
+
+This may be called by several threads at once: rows are summed
+concurrently, but PETSc is not thread-safe, so MatSetValuesBlockedStencil()
+calls are serialized.
+*/
+PetscErrorCode SSAFEM::insert_jacobian_row(PetscInt i, const PetscReal *K_prev,
+                                           const PetscReal *K_this,
+                                           PetscReal **bc_mask, bool diagonal_only,
+                                           Mat Jac)
+{
+  PetscErrorCode ierr;
+  const PetscInt Nk2 = (2*FEQuadrature::Nk)*(2*FEQuadrature::Nk),
+    eys = element_index.ys, eym = element_index.ym;
+  const bool dirichlet = (bc_locations && vel_bc);
+
+  // Index of the node (i,j) in the element (i-1+di, j-1+dj), see FEDOFMap.
+  const PetscInt node_index[2][2] = {{2, 1}, {3, 0}};
+
+  for (PetscInt j=grid.ys; j<grid.ys+grid.ym; j++) {
+    MatStencil row, cols[9];
+    // FIXME: Transpose shows up here!
+    row.j = i; row.i = j;
+
+    if (dirichlet && PismIntMask(bc_mask[i][j]) == 1) {
+      const PetscReal ident[4] = {dirichletScale,0,0,dirichletScale};
+#if (PISM_USE_OPENMP==1)
+#pragma omp critical (ssafem_jacobian)
+#endif
+      ierr = MatSetValuesBlockedStencil(Jac,1,&row,1,&row,ident,INSERT_VALUES);
+      CHKERRQ(ierr);
+      continue;
+    }
+
+    // A 2 x 18 block row: 2x2 blocks for the 3x3 neighborhood of (i,j),
+    // indexed by c = (ii-i+1)*3 + (jj-j+1).
+    PetscReal vals[2][18];
+    bool used[9];
+    ierr = PetscMemzero(vals, sizeof(vals)); CHKERRQ(ierr);
+    for (int c = 0; c < 9; ++c)
+      used[c] = false;
+
+    for (PetscInt di=0; di<2; di++) {
+      const PetscReal *K_row = (di == 0) ? K_prev : K_this;
+      if (K_row == NULL)
+        continue;
+
+      for (PetscInt dj=0; dj<2; dj++) {
+        const PetscInt ei = i-1+di, ej = j-1+dj;
+        if (ej < eys || ej >= eys+eym)
+          continue;
+
+        const PetscReal *K = &K_row[(ej-eys)*Nk2];
+        const PetscInt k = node_index[di][dj];
+
+        for (PetscInt l=0; l<FEQuadrature::Nk; l++) {
+          const PetscInt ii = ei + FEDOFMap::kIOffset[l],
+            jj = ej + FEDOFMap::kJOffset[l];
+
+          // Dirichlet columns are not used
+          if (dirichlet && PismIntMask(bc_mask[ii][jj]) == 1)
+            continue;
+
+          const PetscInt c = (ii-i+1)*3 + (jj-j+1);
+          if (diagonal_only && c != 4)
+            continue;
+
+          used[c] = true;
+          vals[0][c*2]   += K[k*16+l*2];
+          vals[0][c*2+1] += K[k*16+l*2+1];
+          vals[1][c*2]   += K[k*16+8+l*2];
+          vals[1][c*2+1] += K[k*16+8+l*2+1];
         }
       }
     }
+
+    // Pack the blocks that were actually used.
+    PetscReal packed[2*18];
+    PetscInt n = 0;
+    for (PetscInt c=0; c<9; c++) {
+      if (used[c] == false)
+        continue;
+      // FIXME: Transpose shows up here!
+      cols[n].j = i + c/3 - 1;
+      cols[n].i = j + c%3 - 1;
+      n++;
+    }
+    for (PetscInt r=0; r<2; r++) {
+      PetscInt m = 0;
+      for (PetscInt c=0; c<9; c++) {
+        if (used[c] == false)
+          continue;
+        packed[r*2*n + 2*m]     = vals[r][c*2];
+        packed[r*2*n + 2*m + 1] = vals[r][c*2+1];
+        m++;
+      }
+    }
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp critical (ssafem_jacobian)
+#endif
+    ierr = MatSetValuesBlockedStencil(Jac,1,&row,n,cols,packed,INSERT_VALUES);
+    CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! Implements the callback for computing the SNES local Jacobian.
+/*! Compute the Jacobian \f[J_{ij}{kl} \frac{d r_{ij}}{d x_{kl}}= G(x,\psi_{ij}) \f]
+where \f$G\f$ is the weak form of the SSA, \f$x\f$ is the current approximate solution, and
+the \f$\psi_{ij}\f$ are test functions.
+
+In the matrix-free mode (see SSAFEM::apply_jacobian) \a Jac is the preconditioner matrix;
+it gets the Picard linearization (or its block diagonal), and the current solution and
+the Jacobian coefficients at quadrature points are saved for the matrix-free Jacobian.
+*/
+PetscErrorCode SSAFEM::compute_local_jacobian(DMDALocalInfo *info, const PISMVector2 **xg, Mat Jac )
+{
+
+  PetscReal      **bc_mask = NULL;
+  PISMVector2    **BC_vel = NULL;
+  PetscInt         i,j;
+  PetscErrorCode   ierr;
+
+  // Zero out the Jacobian in preparation for updating it.
+  ierr = MatZeroEntries(Jac);CHKERRQ(ierr);
+
+  if (matrix_free) {
+    // Save the linearization point (including ghosts). Note that the meaning
+    // of x and y in PETSc is the opposite of PISM's.
+    PISMVector2 **w;
+    ierr = DMDAVecGetArray(SSADA, linearization_point, &w); CHKERRQ(ierr);
+    for (i=info->gys; i<info->gys+info->gym; i++) {
+      for (j=info->gxs; j<info->gxs+info->gxm; j++) {
+        w[i][j] = xg[i][j];
+      }
+    }
+    ierr = DMDAVecRestoreArray(SSADA, linearization_point, &w); CHKERRQ(ierr);
+  }
+
+  // Start access to Dirichlet data if present.
+  if (bc_locations && vel_bc) {
+    ierr = bc_locations->get_array(bc_mask);CHKERRQ(ierr);
+    ierr = vel_bc->get_array(BC_vel); CHKERRQ(ierr);
+  }
+
+  // Owner-computes: each thread gets a block of node rows and computes
+  // element Jacobians one row of elements at a time, keeping two adjacent
+  // rows. Node row i gets contributions from element rows i-1 and i only, so
+  // it is summed locally and inserted with one MatSetValuesBlockedStencil()
+  // call per node. Threads share no node rows (the first element row of each
+  // block is computed by two threads) and all rows are owned by this
+  // processor, so nothing is stashed for other ones.
+  const PetscInt Nk2 = (2*FEQuadrature::Nk)*(2*FEQuadrature::Nk),
+    exs = element_index.xs, exm = element_index.xm;
+  const bool diagonal_only = matrix_free && (picard_pc == false);
+
+  const int n_threads = pism_max_threads();
+  vector<PetscErrorCode> thread_error(n_threads, 0);
+  vector<PetscInt> thread_nuH_zero(n_threads, 0);
+
+#if (PISM_USE_OPENMP==1)
+#pragma omp parallel private(ierr)
+#endif
+  {
+  const int thread = pism_thread_id();
+  PetscErrorCode &error = thread_error[thread];
+
+  // FEQuadrature and FEDOFMap keep per-element state in members
+  FEQuadrature Q = quadrature;
+  FEDOFMap D;
+
+  vector<PetscReal> K_rows[2];
+  K_rows[0].resize(element_index.ym * Nk2);
+  K_rows[1].resize(element_index.ym * Nk2);
+
+  PetscInt i0, i1;
+  pism_thread_range(grid.xs, grid.xs + grid.xm, i0, i1);
+  for (PetscInt i=i0; i<i1; i++) {
+    // element rows i-1 and i (the former is computed in the previous
+    // iteration, except for the first node row of the block)
+    if (i == i0 && i-1 >= exs) {
+      ierr = compute_element_row(Q, D, i-1, xg, bc_mask, BC_vel, matrix_free,
+                                 &K_rows[(i-1) & 1][0], thread_nuH_zero[thread]);
+      PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+    }
+    if (i < exs+exm) {
+      ierr = compute_element_row(Q, D, i, xg, bc_mask, BC_vel, matrix_free,
+                                 &K_rows[i & 1][0], thread_nuH_zero[thread]);
+      PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+    }
+
+    const PetscReal
+      *K_prev = (i-1 >= exs)    ? &K_rows[(i-1) & 1][0] : NULL,
+      *K_this = (i < exs + exm) ? &K_rows[i & 1][0]     : NULL;
+
+    ierr = insert_jacobian_row(i, K_prev, K_this, bc_mask, diagonal_only, Jac);
+    PISM_THREAD_CHKERRQ_BREAK(ierr, error);
+  } // i
+  } // end of the parallel region
+
+  PetscInt nuH_zero_count = 0;
+  for (int t = 0; t < n_threads; ++t) {
+    CHKERRQ(thread_error[t]);
+    nuH_zero_count += thread_nuH_zero[t];
+  }
+
+  if (nuH_zero_count > 0) {
+    ierr = verbPrintf(1, grid.com, "nuh=0 at %d quadrature points\n", nuH_zero_count); CHKERRQ(ierr);
   }
 
   if(bc_locations) {
@@ -722,6 +1156,148 @@ PetscErrorCode SSAFEM::compute_local_jacobian(DMDALocalInfo *info, const PISMVec
   PetscFunctionReturn(0);
 }
 
+//! \brief Compute the action of the SSA Jacobian on \a X without assembling it
+//! (the matrix-free mode).
+/*! The Jacobian is linearized around the solution saved by the last
+SSAFEM::compute_local_jacobian call, which also saved \f$\nu H\f$, \f$\beta\f$
+and their derivatives at all quadrature points in jacobianStore, so the
+flow law is not evaluated here.
+
+The action is computed at quadrature points directly: with the
+linearization point \f$w\f$ and \f$x\f$ at a quadrature point,
+\f[ (J x)_k = \sum_q |J|_q \left[ \psi_k (\beta x + \beta' (w \cdot x) w)
+    + \nu H\, \mathcal{D}(\psi_k) : \mathcal{D}(x)
+    + (\nu H)'\, (\mathcal{D}(\psi_k) : \mathcal{D}(w))\,(\mathcal{D}(w) : \mathcal{D}(x)) \right], \f]
+(schematically; see SSAFEM::compute_element_jacobian for the precise form)
+which costs \f$O(N_k)\f$ instead of \f$O(N_k^2)\f$ operations per quadrature
+point and needs no storage proportional to the number of non-zeros.
+
+Dirichlet rows and columns are treated the same way as in
+SSAFEM::compute_local_jacobian.
+*/
+PetscErrorCode SSAFEM::apply_jacobian(Vec X, Vec Y)
+{
+  PetscErrorCode ierr;
+  PISMVector2 **xg, **wg, **yg, **BC_vel;
+  PetscReal **bc_mask;
+  PetscInt i, j;
+
+  ierr = DMGlobalToLocalBegin(SSADA, X, INSERT_VALUES, X_local); CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(SSADA, X, INSERT_VALUES, X_local); CHKERRQ(ierr);
+
+  ierr = DMDAVecGetArray(SSADA, X_local, &xg); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(SSADA, linearization_point, &wg); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(SSADA, Y, &yg); CHKERRQ(ierr);
+
+  for (i=grid.xs; i<grid.xs+grid.xm; i++) {
+    for (j=grid.ys; j<grid.ys+grid.ym; j++) {
+      yg[i][j].u = yg[i][j].v = 0;
+    }
+  }
+
+  if (bc_locations && vel_bc) {
+    ierr = bc_locations->get_array(bc_mask);CHKERRQ(ierr);
+    ierr = vel_bc->get_array(BC_vel); CHKERRQ(ierr);
+  }
+
+  PetscReal local_bc_mask[FEQuadrature::Nk];
+
+  PetscScalar JxW[FEQuadrature::Nq];
+  quadrature.getWeightedJacobian(JxW);
+
+  const FEFunctionGerm (*test)[FEQuadrature::Nk] = quadrature.testFunctionValues();
+
+  PetscInt xs = element_index.xs, xm = element_index.xm,
+           ys = element_index.ys, ym = element_index.ym;
+  for (i=xs; i<xs+xm; i++) {
+    for (j=ys; j<ys+ym; j++) {
+      PISMVector2 w[FEQuadrature::Nk], x[FEQuadrature::Nk], y[FEQuadrature::Nk];
+      // Values and symmetric gradients at quadrature points
+      PISMVector2 wq[FEQuadrature::Nq], xq[FEQuadrature::Nq];
+      PetscReal   Dw[FEQuadrature::Nq][3], Dx[FEQuadrature::Nq][3];
+
+      dofmap.reset(i,j,grid);
+      dofmap.extractLocalDOFs(i,j,wg,w);
+      dofmap.extractLocalDOFs(i,j,xg,x);
+
+      if(bc_locations && vel_bc) {
+        dofmap.extractLocalDOFs(i,j,bc_mask,local_bc_mask);
+        FixDirichletValues(local_bc_mask,BC_vel,w,dofmap);
+
+        // Dirichlet columns are not used:
+        for (PetscInt k=0; k<FEQuadrature::Nk; k++) {
+          if (PismIntMask(local_bc_mask[k]) == 1)
+            x[k].u = x[k].v = 0;
+        }
+      }
+
+      quadrature.computeTrialFunctionValues(w,wq,Dw);
+      quadrature.computeTrialFunctionValues(x,xq,Dx);
+
+      for (PetscInt k=0; k<FEQuadrature::Nk; k++) {
+        y[k].u = y[k].v = 0;
+      }
+
+      const FEJacobianNode *coefficients = &jacobianStore[element_index.flatten(i,j)*FEQuadrature::Nq];
+
+      for (PetscInt q=0; q<FEQuadrature::Nq; q++) {
+        const FEJacobianNode &c = coefficients[q];
+        const PetscReal jw = JxW[q], *Dwq = Dw[q], *Dxq = Dx[q];
+
+        // Cross terms appearing with nuH' (see SSAFEM::compute_element_jacobian):
+        const PetscReal a = 2*Dwq[0]+Dwq[1], b = 2*Dwq[1]+Dwq[0], d = Dwq[2],
+          // nuH' times the derivative of the strain rate norm in the direction x
+          s = c.dNuH*(a*Dxq[0] + b*Dxq[1] + 2*d*Dxq[2]),
+          // beta' times the derivative of |w|^2/2 in the direction x
+          r = c.dbeta*(wq[q].u*xq[q].u + wq[q].v*xq[q].v),
+          // basal terms
+          fu = c.beta*xq[q].u + r*wq[q].u,
+          fv = c.beta*xq[q].v + r*wq[q].v;
+
+        for (PetscInt k=0; k<FEQuadrature::Nk; k++) {
+          const FEFunctionGerm &t = test[q][k];
+          y[k].u += jw*(t.val*fu + c.nuH*(t.dx*(2*Dxq[0]+Dxq[1]) + t.dy*Dxq[2])
+                        + s*(t.dx*a + t.dy*d));
+          y[k].v += jw*(t.val*fv + c.nuH*(t.dy*(2*Dxq[1]+Dxq[0]) + t.dx*Dxq[2])
+                        + s*(t.dy*b + t.dx*d));
+        }
+      }
+
+      // Rows this processor does not own and Dirichlet rows are skipped.
+      dofmap.addLocalResidualBlock(y,yg);
+    }
+  }
+
+  if (bc_locations && vel_bc) {
+    for (i=grid.xs; i<grid.xs+grid.xm; i++) {
+      for (j=grid.ys; j<grid.ys+grid.ym; j++) {
+        if (bc_locations->as_int(i,j) == 1) {
+          yg[i][j].u = dirichletScale * xg[i][j].u;
+          yg[i][j].v = dirichletScale * xg[i][j].v;
+        }
+      }
+    }
+    ierr = bc_locations->end_access();CHKERRQ(ierr);
+    ierr = vel_bc->end_access(); CHKERRQ(ierr);
+  }
+
+  ierr = DMDAVecRestoreArray(SSADA, Y, &yg); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(SSADA, linearization_point, &wg); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(SSADA, X_local, &xg); CHKERRQ(ierr);
+
+  return 0;
+}
+
+PetscErrorCode SSAFEJacobianMult(Mat J, Vec X, Vec Y)
+{
+  PetscErrorCode ierr;
+  SSAFEM *ssa;
+
+  ierr = MatShellGetContext(J, (void**)&ssa); CHKERRQ(ierr);
+
+  return ssa->apply_jacobian(X, Y);
+}
+
 //!
 PetscErrorCode SSAFEFunction(DMDALocalInfo *info,
                              const PISMVector2 **xg, PISMVector2 **yg,
@@ -31,6 +31,12 @@ struct FEStoreNode {
   PetscInt mask;
 };
 
+//! Coefficients of the SSA Jacobian at a quadrature point, saved at the
+//! linearization point in the matrix-free mode.
+struct FEJacobianNode {
+  PetscReal nuH, dNuH, beta, dbeta;
+};
+
 
 class SSAFEM;
 
@@ -51,6 +57,9 @@ PetscErrorCode SSAFEFunction(DMDALocalInfo *, const PISMVector2 **,
                              PISMVector2 **, SSAFEM_SNESCallbackData *);
 PetscErrorCode SSAFEJacobian(DMDALocalInfo *, const PISMVector2 **, Mat, SSAFEM_SNESCallbackData *);
 
+//! MatShell callback computing the action of the SSA Jacobian (in the matrix-free mode).
+PetscErrorCode SSAFEJacobianMult(Mat, Vec, Vec);
+
 //! Factory function for constructing a new SSAFEM.
 SSA * SSAFEMFactory(IceGrid &, IceBasalResistancePlasticLaw &,
                     EnthalpyConverter &, const NCConfigVariable &);
@@ -64,6 +73,7 @@ class SSAFEM : public SSA
 {
   friend PetscErrorCode SSAFEFunction(DMDALocalInfo *, const PISMVector2 **, PISMVector2 **, SSAFEM_SNESCallbackData *);
   friend PetscErrorCode SSAFEJacobian(DMDALocalInfo *, const PISMVector2 **, Mat, SSAFEM_SNESCallbackData *);
+  friend PetscErrorCode SSAFEJacobianMult(Mat, Vec, Vec);
 public:
   SSAFEM(IceGrid &g, IceBasalResistancePlasticLaw &b,
          EnthalpyConverter &e, const NCConfigVariable &c)
@@ -102,6 +112,23 @@ protected:
 
   virtual PetscErrorCode compute_local_jacobian(DMDALocalInfo *info, const PISMVector2 **xg, Mat J);
 
+  PetscErrorCode compute_element_jacobian(FEQuadrature &Q, PetscInt i, PetscInt j,
+                                          const PISMVector2 *x, bool picard, PetscReal *K,
+                                          PetscInt &nuH_zero_count);
+
+  PetscErrorCode compute_element_row(FEQuadrature &Q, FEDOFMap &D,
+                                     PetscInt i, const PISMVector2 **xg,
+                                     PetscReal **bc_mask, PISMVector2 **BC_vel,
+                                     bool picard, PetscReal *K_row,
+                                     PetscInt &nuH_zero_count);
+
+  PetscErrorCode insert_jacobian_row(PetscInt i, const PetscReal *K_prev,
+                                     const PetscReal *K_this,
+                                     PetscReal **bc_mask, bool diagonal_only,
+                                     Mat Jac);
+
+  virtual PetscErrorCode apply_jacobian(Vec X, Vec Y);
+
   virtual PetscErrorCode solve();
   
   virtual PetscErrorCode setFromOptions();
@@ -119,6 +146,16 @@ protected:
   PetscReal    m_beta_ice_free_bedrock;
   PetscReal    m_epsilon_ssa;
 
+  // matrix-free mode
+  bool matrix_free,
+       picard_pc;               //!< true if the whole Picard linearization is used as the preconditioner
+  Mat  jacobian_shell;          //!< SNES operator in the matrix-free mode
+  DM   pc_da;                   //!< DA without ghosts; gives the block-diagonal preconditioner matrix
+  FEJacobianNode *jacobianStore; //!< Jacobian coefficients at the linearization point
+  double jacobian_bytes;        //!< memory used by the assembled Jacobian or the preconditioner matrix
+  Vec  linearization_point,     //!< local (ghosted) copy of the solution the Jacobian is computed at
+       X_local;                 //!< work space for SSAFEM::apply_jacobian
+
   FEElementMap element_index;
   FEQuadrature quadrature;
   FEDOFMap dofmap;
@@ -127,6 +127,9 @@ PetscErrorCode SSATestCase::init(PetscInt Mx, PetscInt My, SSAFactory ssafactory
   ierr = config.scalar_from_option("ssa_eps",  "epsilon_ssa"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("ssa_maxi", "max_iterations_ssafd"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("ssa_rtol", "ssafd_relative_convergence"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("ssa_fem_matrix_free", "ssa_fem_matrix_free"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("ssa_fem_picard_pc", "ssa_fem_matrix_free_picard_pc"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("ssa_mg_levels", "ssa_multigrid_levels"); CHKERRQ(ierr);
 
   // Subclass builds grid.
   ierr = initializeGrid(Mx,My);
@@ -157,6 +160,13 @@ PetscErrorCode SSATestCase::run()
   bool fast = false;
   ierr = ssa->update(fast); CHKERRQ(ierr);
 
+  bool memory_report;
+  ierr = PISMOptionsIsSet("-memory_report", "Report memory use by PISM components",
+                          memory_report); CHKERRQ(ierr);
+  if (memory_report) {
+    ierr = grid.memory->report(1); CHKERRQ(ierr);
+  }
+
   return 0;
 }
 
@@ -258,8 +268,8 @@ PetscErrorCode SSATestCase::report_netcdf(string testname,
   bool flag, append;
   NCGlobalAttributes global_attributes;
 
-  ierr = PISMOptionsString("-report_file", "NetCDF error report file",
-                           filename, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-report_file", "NetCDF error report file",
+                                     filename, flag); CHKERRQ(ierr);
 
   if (flag == false)
     return 0;
@@ -347,14 +347,14 @@ int main(int argc, char *argv[]) {
     ierr = PetscOptionsBegin(grid.com, "", "SIAFD_TEST options", ""); CHKERRQ(ierr);
     {
       bool flag;
-      ierr = PISMOptionsInt("-Mx", "Number of grid points in the X direction",
-                            grid.Mx, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsInt("-My", "Number of grid points in the X direction",
-                            grid.My, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsInt("-Mz", "Number of vertical grid levels",
-                            grid.Mz, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsString("-o", "Set the output file name",
-                               output_file, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(grid.com, "-Mx", "Number of grid points in the X direction",
+                                      grid.Mx, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(grid.com, "-My", "Number of grid points in the X direction",
+                                      grid.My, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(grid.com, "-Mz", "Number of vertical grid levels",
+                                      grid.Mz, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-o", "Set the output file name",
+                                         output_file, flag); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
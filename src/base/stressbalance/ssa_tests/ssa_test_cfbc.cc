@@ -231,14 +231,14 @@ int main(int argc, char *argv[]) {
     {
       bool flag;
       int my_verbosity_level;
-      ierr = PISMOptionsInt("-Mx", "Number of grid points in the X direction",
-                                                      Mx, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsInt("-My", "Number of grid points in the Y direction",
-                                                      My, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsString("-o", "Set the output file name",
-                                              output_file, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsInt("-verbose", "Verbosity level",
-                            my_verbosity_level, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(com, "-Mx", "Number of grid points in the X direction",
+                                                           Mx, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(com, "-My", "Number of grid points in the Y direction",
+                                                           My, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsString(com, "-o", "Set the output file name",
+                                                   output_file, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsInt(com, "-verbose", "Verbosity level",
+                                 my_verbosity_level, flag); CHKERRQ(ierr);
       if (flag) setVerbosityLevel(my_verbosity_level);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
@@ -22,6 +22,7 @@
 #include "PISMTime.hh"
 #include "PISMGregorianTime.hh"
 #include "PISMProf.hh"
+#include "PISMMemoryUsage.hh"
 #include "NCVariable.hh"
 
 
@@ -84,6 +85,7 @@ IceGrid::IceGrid(MPI_Comm c, PetscMPIInt r, PetscMPIInt s,
   compute_horizontal_spacing();
 
   profiler = new PISMProf(com, rank, size);
+  memory = new PISMMemoryUsage(com, rank, size);
 
   if (config.get_string("calendar") == "gregorian") {
     time = new PISMGregorianTime(com, config);
@@ -102,6 +104,7 @@ IceGrid::~IceGrid() {
 
   delete time;
   delete profiler;
+  delete memory;
 }
 
 //! \brief Set the vertical levels in the ice according to values in Mz, Lz,
@@ -30,6 +30,7 @@ using namespace std;
 
 class PISMTime;
 class PISMProf;
+class PISMMemoryUsage;
 class NCConfigVariable;
 
 typedef enum {UNKNOWN = 0, EQUAL, QUADRATIC} SpacingType;
@@ -188,6 +189,7 @@ public:
                                 //!< the DA in this IceGrid object
 
   PISMProf *profiler;           //!< PISM profiler object; allows tracking how long a computation takes
+  PISMMemoryUsage *memory;      //!< keeps track of memory used by PISM components
   PISMTime *time;               //!< The time management object (hides calendar computations)
 protected:
   PetscScalar lambda;	 //!< quadratic vertical spacing parameter
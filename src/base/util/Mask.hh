@@ -108,10 +108,17 @@ protected:
   bool is_dry_simulation;
 };
 
-class MaskQuery : private Mask
+//! \brief Mask queries using an IceModelVec2Int (class MaskQuery) or its
+//! compact read-only copy IceModelVec2IntCompact (class CompactMaskQuery).
+/*!
+ * fill_where_grounded() and fill_where_floating() are available in MaskQuery
+ * only.
+ */
+template<class M>
+class MaskQueryT : private Mask
 {
 public:
-  MaskQuery(IceModelVec2Int &m) : mask(m) {}
+  MaskQueryT(M &m) : mask(m) {}
   
   inline bool ocean(int i, int j) { return Mask::ocean(mask.as_int(i, j)); }
 
@@ -200,7 +207,10 @@ public:
     return 0;
   }
 protected:
-  IceModelVec2Int &mask;
+  M &mask;
 };
 
+typedef MaskQueryT<IceModelVec2Int> MaskQuery;
+typedef MaskQueryT<const IceModelVec2IntCompact> CompactMaskQuery;
+
 #endif /* _MASK_H_ */
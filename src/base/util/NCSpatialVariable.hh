@@ -42,6 +42,7 @@ public:
 
   PetscErrorCode define(const PIO &nc, PISM_IO_Type nctype,
                         bool write_in_glaciological_units);
+  PetscErrorCode round_for_output(Vec v, PISM_IO_Type nctype);
 
   mutable map<string,string> dimensions,
     x_attrs, y_attrs, z_attrs;
@@ -56,6 +57,9 @@ protected:
   PetscErrorCode change_units(Vec v, utUnit *from, utUnit *to);
   PetscErrorCode check_range(Vec v);
   PetscErrorCode define_dimensions(const PIO &nc);
+  PetscErrorCode define_storage(const PIO &nc, PISM_IO_Type nctype,
+                                const vector<string> &dims);
+  int significant_digits(PISM_IO_Type nctype);
 };
 
 #endif	// __NCSpatialVariable
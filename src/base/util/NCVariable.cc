@@ -19,6 +19,8 @@
 #include <algorithm>
 #include <sstream>
 #include <set>
+#include <cstring>              // memcpy
+#include <stdint.h>             // uint64_t
 
 #include "NCVariable.hh"
 #include "NCSpatialVariable.hh"
@@ -344,6 +346,44 @@ PetscErrorCode NCSpatialVariable::read(string filename, unsigned int time, Vec v
   return 0;
 }
 
+//! \brief Round each element of \c v to \c digits significant decimal digits
+//! by clearing trailing mantissa bits ("bit rounding").
+/*!
+ * This does not reduce the size of a file by itself, but zero bits make
+ * compression (by PISM or later by `nccopy -d`) a lot more effective.
+ */
+static PetscErrorCode round_mantissas(Vec v, int digits) {
+  PetscErrorCode ierr;
+  PetscScalar *a;
+  PetscInt n;
+
+  // bits needed to represent "digits" decimal digits, plus one
+  const int keep = static_cast<int>(ceil(digits * 3.3219280948873622)) + 1,
+    drop = 52 - keep;           // 52 is the number of stored mantissa bits
+  if (drop <= 0)
+    return 0;
+
+  const uint64_t mask = ~((((uint64_t)1) << drop) - 1),
+    half = ((uint64_t)1) << (drop - 1),
+    exponent = ((uint64_t)0x7FF) << 52;
+
+  ierr = VecGetLocalSize(v, &n); CHKERRQ(ierr);
+  ierr = VecGetArray(v, &a); CHKERRQ(ierr);
+  for (PetscInt k = 0; k < n; ++k) {
+    uint64_t bits;
+    memcpy(&bits, &a[k], sizeof(bits));
+
+    if ((bits & exponent) == exponent)
+      continue;                 // leave NaNs and infinities alone
+
+    bits = (bits + half) & mask;
+    memcpy(&a[k], &bits, sizeof(bits));
+  }
+  ierr = VecRestoreArray(v, &a); CHKERRQ(ierr);
+
+  return 0;
+}
+
 //! \brief Write a \b global Vec \c v to a variable.
 /*!
   Defines a variable and converts the units if needed.
@@ -373,7 +413,19 @@ PetscErrorCode NCSpatialVariable::write(string filename, PISM_IO_Type nctype,
   }
 
   // Actually write data:
-  ierr = nc.put_vec(grid, name_found, nlevels, v); CHKERRQ(ierr);
+  if (significant_digits(nctype) > 0) {
+    // round a copy: we should not modify the model state
+    Vec tmp;
+    ierr = VecDuplicate(v, &tmp); CHKERRQ(ierr);
+    ierr = VecCopy(v, tmp); CHKERRQ(ierr);
+    ierr = round_for_output(tmp, nctype); CHKERRQ(ierr);
+
+    ierr = nc.put_vec(grid, name_found, nlevels, tmp); CHKERRQ(ierr);
+
+    ierr = VecDestroy(&tmp); CHKERRQ(ierr);
+  } else {
+    ierr = nc.put_vec(grid, name_found, nlevels, v); CHKERRQ(ierr);
+  }
 
   if (write_in_glaciological_units) {
     ierr = change_units(v, &glaciological_units, &units); CHKERRQ(ierr); // restore the units
@@ -858,11 +910,101 @@ PetscErrorCode NCSpatialVariable::define(const PIO &nc, PISM_IO_Type nctype,
 
   ierr = nc.def_var(short_name, nctype, dims); CHKERRQ(ierr);
 
+  ierr = define_storage(nc, nctype, dims); CHKERRQ(ierr);
+
   ierr = write_attributes(nc, nctype, write_in_glaciological_units); CHKERRQ(ierr);
 
   return 0;
 }
 
+//! \brief Set chunking and compression parameters of a variable (NetCDF-4
+//! only; ignored by other formats).
+/*!
+ * With output_chunking == "processor" each chunk holds one time record of
+ * the largest processor sub-domain (all the vertical levels), so that every
+ * processor writes to (at most) four chunks. Otherwise chunk sizes are
+ * chosen by the NetCDF library.
+ *
+ * Compression is controlled by output_compression_level (0 disables it) and
+ * output_compression_shuffle. If the NetCDF library cannot compress this
+ * variable (for example, if it does not support parallel filters), the
+ * variable is written uncompressed.
+ */
+PetscErrorCode NCSpatialVariable::define_storage(const PIO &nc, PISM_IO_Type nctype,
+                                                 const vector<string> &dims) {
+  PetscErrorCode ierr;
+  const NCConfigVariable &config = grid->config;
+
+  if (config.get_string("output_chunking") == "processor") {
+    vector<size_t> chunk(dims.size());
+    int x_chunk = *max_element(grid->procs_x.begin(), grid->procs_x.end()),
+      y_chunk = *max_element(grid->procs_y.begin(), grid->procs_y.end());
+
+    for (unsigned int k = 0; k < dims.size(); ++k) {
+      if (dims[k] == dimensions["x"])
+        chunk[k] = x_chunk;
+      else if (dims[k] == dimensions["y"])
+        chunk[k] = y_chunk;
+      else if (dims[k] == dimensions["z"])
+        chunk[k] = nlevels;
+      else                      // time
+        chunk[k] = 1;
+    }
+
+    ierr = nc.def_var_chunking(short_name, chunk); CHKERRQ(ierr);
+  }
+
+  int level = static_cast<int>(config.get("output_compression_level"));
+  if (level > 0) {
+    ierr = nc.def_var_deflate(short_name, config.get_flag("output_compression_shuffle"),
+                              PetscMin(level, 9));
+    if (ierr != 0) {
+      ierr = verbPrintf(2, com,
+                        "PISM WARNING: cannot compress '%s' in '%s'; writing it uncompressed.\n",
+                        short_name.c_str(), nc.inq_filename().c_str()); CHKERRQ(ierr);
+    }
+  }
+
+  int digits = significant_digits(nctype);
+  if (digits > 0) {
+    ierr = nc.put_att_double(short_name, "pism_significant_digits", PISM_INT, digits); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Rounds `v` (in place) the way write() does before writing it using
+//! the type \c nctype.
+/*!
+ * Use this when writing data with PIO::put_vec() into a variable created by
+ * define(), which records the number of significant digits kept in the
+ * pism_significant_digits attribute.
+ */
+PetscErrorCode NCSpatialVariable::round_for_output(Vec v, PISM_IO_Type nctype) {
+  PetscErrorCode ierr;
+
+  int digits = significant_digits(nctype);
+  if (digits > 0) {
+    ierr = round_mantissas(v, digits); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Number of significant decimal digits to keep when writing this
+//! variable using the type \c nctype (0 means "keep all").
+/*!
+ * Only single-precision output is rounded (see output_float_significant_digits):
+ * variables written as doubles are assumed to need all the digits.
+ */
+int NCSpatialVariable::significant_digits(PISM_IO_Type nctype) {
+  if (nctype != PISM_FLOAT)
+    return 0;
+
+  return static_cast<int>(grid->config.get("output_float_significant_digits"));
+}
+
+
 //! Reset all the attributes.
 PetscErrorCode NCVariable::reset() {
 
@@ -1167,9 +1309,9 @@ PetscErrorCode NCConfigVariable::scalar_from_option(string name, string paramete
   PetscReal value = get(parameter);
   bool flag;
   
-  ierr = PISMOptionsReal("-" + name,
-			 get_string(parameter + "_doc"),
-			 value, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(com, "-" + name,
+     			 get_string(parameter + "_doc"),
+     			 value, flag); CHKERRQ(ierr);
   if (flag)
     this->set(parameter, value);
   
@@ -1181,9 +1323,9 @@ PetscErrorCode NCConfigVariable::string_from_option(string name, string paramete
   string value = get_string(parameter);
   bool flag;
   
-  ierr = PISMOptionsString("-" + name,
-                           get_string(parameter + "_doc"),
-                           value, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsString(com, "-" + name,
+                                get_string(parameter + "_doc"),
+                                value, flag); CHKERRQ(ierr);
   if (flag)
     this->set_string(parameter, value);
   
@@ -69,6 +69,7 @@ public:
   virtual bool has(string) const;
   virtual bool is_valid(PetscScalar a) const;
   virtual int get_ndims() const;
+  MPI_Comm get_comm() const { return com; }
   string short_name;
 
   // Attributes:
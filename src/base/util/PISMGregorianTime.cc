@@ -33,8 +33,8 @@ PetscErrorCode PISMGregorianTime::init() {
 
   ierr = PISMTime::init(); CHKERRQ(ierr);
 
-  ierr = PISMOptionsString("-time_file", "Reads time information from a file",
-                           time_file, flag); CHKERRQ(ierr);
+  ierr = PISMOptionsString(com, "-time_file", "Reads time information from a file",
+                                time_file, flag); CHKERRQ(ierr);
 
   if (flag == true) {
     ierr = verbPrintf(2, com,
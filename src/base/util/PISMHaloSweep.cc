@@ -0,0 +1,138 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "PISMHaloSweep.hh"
+#include "iceModelVec.hh"
+#include "IceGrid.hh"
+#include "PISMProf.hh"
+
+//! \brief Creates a sweep over the owned part of the sub-domain using a
+//! stencil of width \c width.
+PISMHaloSweep::PISMHaloSweep(IceGrid &g, int width)
+  : grid(g) {
+
+  // If the sub-domain is narrower than 2*width the interior block is empty and
+  // boundary strips cover everything.
+  i0 = grid.xs + PetscMin(width, grid.xm);
+  i1 = PetscMax(i0, grid.xs + grid.xm - width);
+  j0 = grid.ys + PetscMin(width, grid.ym);
+  j1 = PetscMax(j0, grid.ys + grid.ym - width);
+
+  overlap     = grid.config.get_flag("halo_exchange_overlap");
+  in_progress = false;
+
+  event_halo_wait = grid.profiler->create("halo_wait",
+                                          "time spent waiting for ghost (halo) exchanges to complete");
+}
+
+PISMHaloSweep::~PISMHaloSweep() {
+  // Do not leave a scatter in progress (errors cannot be reported here).
+  if (in_progress)
+    end();
+}
+
+//! Adds a field to the list of fields communicated by begin() and end().
+void PISMHaloSweep::add(IceModelVec &field) {
+  fields.push_back(&field);
+}
+
+//! Starts the ghost exchange of all the fields added using add().
+PetscErrorCode PISMHaloSweep::begin() {
+  PetscErrorCode ierr;
+
+  if (in_progress)
+    SETERRQ(grid.com, 1, "PISMHaloSweep::begin(): exchange is in progress already");
+
+  for (unsigned int k = 0; k < fields.size(); ++k) {
+    ierr = fields[k]->beginGhostComm(); CHKERRQ(ierr);
+  }
+  in_progress = true;
+
+  if (!overlap) {
+    ierr = end(); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! Completes the ghost exchange started by begin().
+/*!
+ * Called by block() automatically; does nothing if there is no exchange in
+ * progress.
+ */
+PetscErrorCode PISMHaloSweep::end() {
+  PetscErrorCode ierr;
+
+  if (!in_progress)
+    return 0;
+
+  grid.profiler->begin(event_halo_wait);
+  for (unsigned int k = 0; k < fields.size(); ++k) {
+    ierr = fields[k]->endGhostComm(); CHKERRQ(ierr);
+  }
+  grid.profiler->end(event_halo_wait);
+
+  in_progress = false;
+
+  return 0;
+}
+
+//! \brief Gets the block number \c index (the interior is block 0), as in
+//! IceGrid::xs, IceGrid::xm, etc.
+/*!
+ * Completes the exchange before returning any of the boundary strips.
+ */
+PetscErrorCode PISMHaloSweep::block(int index, PetscInt &xs, PetscInt &xm,
+                                    PetscInt &ys, PetscInt &ym) {
+  PetscErrorCode ierr;
+
+  if (index > 0) {
+    ierr = end(); CHKERRQ(ierr);
+  }
+
+  const PetscInt
+    i_end = grid.xs + grid.xm,
+    j_end = grid.ys + grid.ym;
+
+  switch (index) {
+  case 0:                       // interior
+    xs = i0;      xm = i1 - i0;
+    ys = j0;      ym = j1 - j0;
+    break;
+  case 1:                       // west strip (full height)
+    xs = grid.xs; xm = i0 - grid.xs;
+    ys = grid.ys; ym = grid.ym;
+    break;
+  case 2:                       // east strip (full height)
+    xs = i1;      xm = i_end - i1;
+    ys = grid.ys; ym = grid.ym;
+    break;
+  case 3:                       // south strip (between the west and east strips)
+    xs = i0;      xm = i1 - i0;
+    ys = grid.ys; ym = j0 - grid.ys;
+    break;
+  case 4:                       // north strip
+    xs = i0;      xm = i1 - i0;
+    ys = j1;      ym = j_end - j1;
+    break;
+  default:
+    SETERRQ1(grid.com, 1, "PISMHaloSweep::block(): invalid block index %d", index);
+  }
+
+  return 0;
+}
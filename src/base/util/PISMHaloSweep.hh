@@ -0,0 +1,85 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef __PISMHaloSweep_hh
+#define __PISMHaloSweep_hh
+
+#include <vector>
+#include <petsc.h>
+
+class IceGrid;
+class IceModelVec;
+
+//! \brief Overlaps the ghost (halo) exchange with a stencil sweep.
+/*!
+ * A sweep over owned grid points using a stencil of width \c w needs ghosts
+ * only in the strip of width \c w along the boundary of the processor
+ * sub-domain. This class starts the exchange, hands out the interior block
+ * (which can be computed while messages are in flight), completes the
+ * exchange and then hands out the four boundary strips.
+ *
+ * Usage:
+ * \code
+ * PISMHaloSweep sweep(grid, 1);
+ * sweep.add(foo);
+ * ierr = sweep.begin(); CHKERRQ(ierr);  // starts foo.beginGhostComm()
+ *
+ * ierr = foo.begin_access(); CHKERRQ(ierr);
+ * for (int b = 0; b < PISMHaloSweep::N_BLOCKS; ++b) {
+ *   PetscInt xs, xm, ys, ym;
+ *   ierr = sweep.block(b, xs, xm, ys, ym); CHKERRQ(ierr); // b == 1 waits for ghosts
+ *   for (PetscInt i = xs; i < xs + xm; ++i) {
+ *     for (PetscInt j = ys; j < ys + ym; ++j) {
+ *       // use foo(i+1,j), foo(i-1,j), etc
+ *     }
+ *   }
+ * }
+ * ierr = foo.end_access(); CHKERRQ(ierr);
+ * \endcode
+ *
+ * Blocks cover the owned part of the sub-domain exactly once, so results do
+ * not depend on whether the overlap is used. Kernels using a sweep must not
+ * modify fields that are being communicated.
+ *
+ * Time spent waiting for the exchange to complete is recorded as the
+ * "halo_wait" profiling event (see \c -prof and \c -log_summary). Setting
+ * \c -no_halo_overlap completes the exchange before the interior block,
+ * which gives the baseline to compare to.
+ */
+class PISMHaloSweep {
+public:
+  PISMHaloSweep(IceGrid &grid, int width);
+  ~PISMHaloSweep();
+
+  void add(IceModelVec &field);
+  PetscErrorCode begin();
+  PetscErrorCode end();
+  PetscErrorCode block(int index, PetscInt &xs, PetscInt &xm,
+                       PetscInt &ys, PetscInt &ym);
+
+  //! Number of blocks: the interior and four boundary strips.
+  static const int N_BLOCKS = 5;
+protected:
+  IceGrid &grid;
+  std::vector<IceModelVec*> fields;
+  PetscInt i0, i1, j0, j1;      //!< the interior block is [i0,i1) x [j0,j1)
+  bool overlap, in_progress;
+  int event_halo_wait;
+};
+
+#endif /* __PISMHaloSweep_hh */
@@ -0,0 +1,257 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <cmath>
+#include <cstring>
+#include "PISMMemoryUsage.hh"
+#include "IceGrid.hh"
+#include "pism_const.hh"
+
+static const double MiB = 1048576.0;
+
+PISMMemoryUsage::Usage::Usage() {
+  for (int k = 0; k < MEMORY_N_SCALINGS; ++k)
+    current[k] = peak[k] = 0.0;
+  total_current = total_peak = 0.0;
+}
+
+PISMMemoryUsage::PISMMemoryUsage(MPI_Comm c, PetscMPIInt r, PetscMPIInt s) {
+  com = c;
+  rank = r;
+  size = s;
+  total_current = 0.0;
+  total_peak = 0.0;
+}
+
+//! Make `component` the owner of all the following allocations (until end() is called).
+void PISMMemoryUsage::begin(string component) {
+  owners.push_back(component);
+}
+
+//! Restore the owner that was current before the matching begin() call.
+void PISMMemoryUsage::end() {
+  if (owners.empty() == false)
+    owners.pop_back();
+}
+
+//! Returns the component allocations are currently attributed to.
+string PISMMemoryUsage::current_component() const {
+  if (owners.empty())
+    return "other";
+
+  return owners.back();
+}
+
+//! Record an allocation of `bytes` bytes by `component`.
+void PISMMemoryUsage::allocate(string component, double bytes, PISMMemoryScaling scaling) {
+  Usage &u = components[component];
+
+  u.current[scaling] += bytes;
+  u.peak[scaling] = PetscMax(u.peak[scaling], u.current[scaling]);
+
+  u.total_current += bytes;
+  u.total_peak = PetscMax(u.total_peak, u.total_current);
+
+  total_current += bytes;
+  total_peak = PetscMax(total_peak, total_current);
+}
+
+//! Record that `component` freed `bytes` bytes.
+void PISMMemoryUsage::deallocate(string component, double bytes, PISMMemoryScaling scaling) {
+  Usage &u = components[component];
+
+  u.current[scaling] -= bytes;
+  u.total_current -= bytes;
+  total_current -= bytes;
+}
+
+//! Current memory use of a component on this processor, in bytes.
+double PISMMemoryUsage::current(string component) {
+  map<string, Usage>::iterator j = components.find(component);
+  if (j == components.end())
+    return 0.0;
+
+  return j->second.total_current;
+}
+
+//! Peak memory use of a component on this processor, in bytes.
+double PISMMemoryUsage::peak(string component) {
+  map<string, Usage>::iterator j = components.find(component);
+  if (j == components.end())
+    return 0.0;
+
+  return j->second.total_peak;
+}
+
+//! \brief Get the list of component names known to processor 0 (all
+//! processors get the same list, in the same order).
+/*!
+ * Some components (such as the FFT-based bed deformation model) allocate
+ * memory on processor 0 only, so processor 0 knows about all the components.
+ */
+PetscErrorCode PISMMemoryUsage::get_component_names(vector<string> &result) {
+  PetscErrorCode ierr;
+  int n_components = (int)components.size();
+
+  result.clear();
+
+  ierr = MPI_Bcast(&n_components, 1, MPI_INT, 0, com); CHKERRQ(ierr);
+
+  map<string, Usage>::iterator j = components.begin();
+  for (int k = 0; k < n_components; ++k) {
+    char name[TEMPORARY_STRING_LENGTH];
+    int length = 0;
+
+    // only processor 0 has the name; others get its length and contents below
+    if (rank == 0) {
+      strncpy(name, j->first.c_str(), sizeof(name) - 1);
+      name[sizeof(name) - 1] = '\0';
+      length = (int)strlen(name) + 1;
+      ++j;
+    }
+
+    ierr = MPI_Bcast(&length, 1, MPI_INT, 0, com); CHKERRQ(ierr);
+    ierr = MPI_Bcast(name, length, MPI_CHAR, 0, com); CHKERRQ(ierr);
+
+    result.push_back(name);
+  }
+
+  return 0;
+}
+
+//! \brief Print current and peak memory use by component.
+/*!
+ * Prints maximums over all processors and totals (sums over all processors).
+ * Per-processor totals are printed if the verbosity level is higher than
+ * `threshold`.
+ *
+ * Should be called on all processors.
+ */
+PetscErrorCode PISMMemoryUsage::report(int threshold) {
+  PetscErrorCode ierr;
+  vector<string> names;
+
+  ierr = get_component_names(names); CHKERRQ(ierr);
+
+  ierr = verbPrintf(threshold, com,
+                    "Memory use by component (MiB; max. over processors / sum over processors):\n"
+                    "  %-30s %21s %21s\n", "component", "current", "peak"); CHKERRQ(ierr);
+
+  for (unsigned int k = 0; k < names.size(); ++k) {
+    double my_current = current(names[k]), my_peak = peak(names[k]),
+      current_max, current_sum, peak_max, peak_sum;
+
+    ierr = PISMGlobalMax(&my_current, &current_max, com); CHKERRQ(ierr);
+    ierr = PISMGlobalSum(&my_current, &current_sum, com); CHKERRQ(ierr);
+    ierr = PISMGlobalMax(&my_peak, &peak_max, com); CHKERRQ(ierr);
+    ierr = PISMGlobalSum(&my_peak, &peak_sum, com); CHKERRQ(ierr);
+
+    ierr = verbPrintf(threshold, com, "  %-30s %10.2f /%10.2f %10.2f /%10.2f\n",
+                      names[k].c_str(),
+                      current_max / MiB, current_sum / MiB,
+                      peak_max / MiB, peak_sum / MiB); CHKERRQ(ierr);
+  }
+
+  double current_max, current_sum, peak_max, peak_sum;
+  ierr = PISMGlobalMax(&total_current, &current_max, com); CHKERRQ(ierr);
+  ierr = PISMGlobalSum(&total_current, &current_sum, com); CHKERRQ(ierr);
+  ierr = PISMGlobalMax(&total_peak, &peak_max, com); CHKERRQ(ierr);
+  ierr = PISMGlobalSum(&total_peak, &peak_sum, com); CHKERRQ(ierr);
+
+  ierr = verbPrintf(threshold, com, "  %-30s %10.2f /%10.2f %10.2f /%10.2f\n",
+                    "total",
+                    current_max / MiB, current_sum / MiB,
+                    peak_max / MiB, peak_sum / MiB); CHKERRQ(ierr);
+
+  if (getVerbosityLevel() > threshold) {
+    ierr = PetscSynchronizedPrintf(com, "  processor %4d: current %10.2f MiB, peak %10.2f MiB\n",
+                                   rank, total_current / MiB, total_peak / MiB); CHKERRQ(ierr);
+    ierr = PetscSynchronizedFlush(com); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Estimate per-processor peak memory use on a Mx*My*Mz grid
+//! distributed across `n_procs` processors.
+/*!
+ * Uses peak memory use recorded so far (on the current grid) and the
+ * scaling type of each allocation. Assumes that the same set of objects is
+ * allocated on the target grid.
+ *
+ * Processor sub-domain sizes are computed the same way IceGrid does it (see
+ * IceGrid::compute_nprocs() and IceGrid::compute_ownership_ranges()).
+ */
+PetscErrorCode PISMMemoryUsage::predict(IceGrid &grid, int Mx, int My, int Mz, int n_procs) {
+  PetscErrorCode ierr;
+  vector<string> names;
+
+  if (Mx < 3 || My < 3 || Mz < 2 || n_procs < 1) {
+    SETERRQ4(com, 1, "PISMMemoryUsage::predict(): invalid grid size (%d x %d x %d) or processor count (%d)",
+             Mx, My, Mz, n_procs);
+  }
+
+  // Compute the processor grid; see IceGrid::compute_nprocs().
+  int Nx = (int)(0.5 + sqrt(((double)Mx)*((double)n_procs)/((double)My))), Ny = 1;
+  if (Nx == 0) Nx = 1;
+  while (Nx > 0) {
+    Ny = n_procs / Nx;
+    if (Nx*Ny == n_procs) break;
+    Nx--;
+  }
+  if (Mx > My && Nx < Ny) { int tmp = Nx; Nx = Ny; Ny = tmp; }
+
+  // The largest sub-domain size, including ghosts:
+  const int W = grid.max_stencil_width;
+  double
+    new_patch = (double)(Mx / Nx + (Mx % Nx > 0) + 2*W) * (My / Ny + (My % Ny > 0) + 2*W),
+    old_patch = (double)(grid.xm + 2*W) * (grid.ym + 2*W);
+
+  double ratio[MEMORY_N_SCALINGS];
+  ratio[MEMORY_FIXED]     = 1.0;
+  ratio[MEMORY_LOCAL_2D]  = new_patch / old_patch;
+  ratio[MEMORY_LOCAL_3D]  = (new_patch * Mz) / (old_patch * grid.Mz);
+  ratio[MEMORY_GLOBAL_2D] = ((double)Mx * My) / ((double)grid.Mx * grid.My);
+
+  ierr = get_component_names(names); CHKERRQ(ierr);
+
+  ierr = verbPrintf(1, com,
+                    "Predicted peak memory use on a %d x %d x %d grid and %d processors (%d x %d):\n"
+                    "  %-30s %21s\n", Mx, My, Mz, n_procs, Nx, Ny,
+                    "component", "MiB per processor"); CHKERRQ(ierr);
+
+  double total = 0.0;
+  for (unsigned int k = 0; k < names.size(); ++k) {
+    double my_prediction = 0.0, prediction;
+
+    map<string, Usage>::iterator j = components.find(names[k]);
+    if (j != components.end()) {
+      for (int s = 0; s < MEMORY_N_SCALINGS; ++s)
+        my_prediction += j->second.peak[s] * ratio[s];
+    }
+
+    ierr = PISMGlobalMax(&my_prediction, &prediction, com); CHKERRQ(ierr);
+    total += prediction;
+
+    ierr = verbPrintf(1, com, "  %-30s %21.2f\n", names[k].c_str(), prediction / MiB); CHKERRQ(ierr);
+  }
+
+  ierr = verbPrintf(1, com, "  %-30s %21.2f\n", "total", total / MiB); CHKERRQ(ierr);
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef __PISMMemoryUsage_hh
+#define __PISMMemoryUsage_hh
+
+#include <string>
+#include <vector>
+#include <map>
+#include <petsc.h>
+
+/// @cond NAMESPACE_BROWSER
+using namespace std;
+/// @endcond
+
+class IceGrid;
+
+//! \brief Describes how the size of an allocation depends on the grid size.
+/*!
+ * Used to extrapolate memory use to a different grid and processor count.
+ */
+enum PISMMemoryScaling {
+  MEMORY_FIXED = 0,             //!< does not depend on the grid size
+  MEMORY_LOCAL_2D,              //!< proportional to the size of a processor sub-domain
+  MEMORY_LOCAL_3D,              //!< proportional to the sub-domain size times Mz
+  MEMORY_GLOBAL_2D,             //!< proportional to Mx*My (stored on one processor)
+  MEMORY_N_SCALINGS
+};
+
+//! \brief Tracks current and peak memory use by PISM components.
+/*!
+  Allocations are attributed to the component given as an argument to
+  allocate() and deallocate(). IceModelVecs use the "current" component,
+  which is set using begin() and end() (similar to PISMProf::begin() and
+  PISMProf::end()):
+
+  \code
+  grid.memory->begin("SIAFD");
+  ierr = work_2d[0].create(grid, "work_vector", true); CHKERRQ(ierr);
+  // more allocations...
+  grid.memory->end();
+  \endcode
+
+  Allocations made outside of a begin()/end() pair are attributed to the
+  "other" component.
+
+  Calls of begin() and end() can be nested.
+ */
+class PISMMemoryUsage {
+public:
+  PISMMemoryUsage(MPI_Comm c, PetscMPIInt r, PetscMPIInt s);
+  ~PISMMemoryUsage() {}
+
+  void begin(string component);
+  void end();
+  string current_component() const;
+
+  void allocate(string component, double bytes, PISMMemoryScaling scaling);
+  void deallocate(string component, double bytes, PISMMemoryScaling scaling);
+
+  double current(string component);
+  double peak(string component);
+
+  PetscErrorCode report(int threshold);
+  PetscErrorCode predict(IceGrid &grid, int Mx, int My, int Mz, int n_procs);
+protected:
+  //! Current and peak memory use of one component, split by scaling type.
+  struct Usage {
+    Usage();
+    double current[MEMORY_N_SCALINGS], peak[MEMORY_N_SCALINGS];
+    double total_current, total_peak;
+  };
+
+  map<string, Usage> components;
+  vector<string> owners;
+  double total_current, total_peak;
+  PetscMPIInt rank, size;
+  MPI_Comm com;
+
+  PetscErrorCode get_component_names(vector<string> &result);
+};
+
+#endif /* __PISMMemoryUsage_hh */
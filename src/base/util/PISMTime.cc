@@ -42,9 +42,9 @@ PetscErrorCode PISMTime::init() {
 
   ierr = PetscOptionsBegin(com, "", "PISM model time options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsReal("-ys", "Start year", ys, ys_set); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-ye", "End year", ye, ye_set); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-y", "Run length, in years", y, y_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-ys", "Start year", ys, ys_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-ye", "End year", ye, ye_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-y", "Run length, in years", y, y_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
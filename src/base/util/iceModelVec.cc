@@ -46,6 +46,10 @@ IceModelVec::IceModelVec() {
   shallow_copy = false;
   state_counter = 0;
 
+  memory_owner = "other";
+  memory_size = 0.0;
+  memory_scaling = MEMORY_LOCAL_2D;
+
   v = PETSC_NULL;
 
   zlevels.resize(1);
@@ -83,6 +87,10 @@ IceModelVec::IceModelVec(const IceModelVec &other) {
   shallow_copy = true;
   state_counter = other.state_counter;
 
+  memory_owner = other.memory_owner;
+  memory_size = other.memory_size;
+  memory_scaling = other.memory_scaling;
+
   time_independent = other.time_independent;
 
   v = other.v;
@@ -156,6 +164,7 @@ PetscErrorCode  IceModelVec::destroy() {
   PetscErrorCode ierr;
 
   if (v != PETSC_NULL) {
+    ierr = unregister_memory(); CHKERRQ(ierr);
     ierr = VecDestroy(&v); CHKERRQ(ierr);
     v = PETSC_NULL;
   }
@@ -179,6 +188,38 @@ PetscErrorCode  IceModelVec::destroy() {
   return 0;
 }
 
+//! \brief Attribute the memory used by the internal storage to the current
+//! component (see PISMMemoryUsage).
+/*!
+ * Has to be called right after \c v is allocated.
+ */
+PetscErrorCode IceModelVec::register_memory() {
+  PetscErrorCode ierr;
+  PetscInt local_size;
+
+  ierr = VecGetLocalSize(v, &local_size); CHKERRQ(ierr);
+
+  memory_owner = grid->memory->current_component();
+  memory_size = (double)local_size * sizeof(PetscScalar);
+  memory_scaling = (n_levels > 1 && n_levels == grid->Mz) ? MEMORY_LOCAL_3D : MEMORY_LOCAL_2D;
+
+  grid->memory->allocate(memory_owner, memory_size, memory_scaling);
+
+  return 0;
+}
+
+//! \brief Undo register_memory(). Has to be called right before \c v is
+//! de-allocated.
+PetscErrorCode IceModelVec::unregister_memory() {
+
+  if (grid != NULL && memory_size > 0) {
+    grid->memory->deallocate(memory_owner, memory_size, memory_scaling);
+    memory_size = 0.0;
+  }
+
+  return 0;
+}
+
 //! Result: min <- min(v[j]), max <- max(v[j]).
 /*!
 PETSc manual correctly says "VecMin and VecMax are collective on Vec" but
@@ -357,6 +398,31 @@ PetscErrorCode IceModelVec::copy_from(Vec source) {
   return 0;
 }
 
+//! \brief Allocates a Vec with the same layout as the internal storage
+//! (including ghosts) and copies values into it.
+/*!
+ * The caller is responsible for destroying \c result. Use restore_state() to
+ * put saved values back.
+ */
+PetscErrorCode IceModelVec::save_state(Vec &result) {
+  PetscErrorCode ierr;
+  ierr = checkAllocated(); CHKERRQ(ierr);
+
+  ierr = VecDuplicate(v, &result); CHKERRQ(ierr);
+  ierr = VecCopy(v, result); CHKERRQ(ierr);
+  return 0;
+}
+
+//! \brief Restores values saved using save_state(). Ghost values are restored
+//! too, so no communication is necessary.
+PetscErrorCode IceModelVec::restore_state(Vec saved) {
+  PetscErrorCode ierr;
+  ierr = checkAllocated(); CHKERRQ(ierr);
+
+  ierr = VecCopy(saved, v); CHKERRQ(ierr);
+  return 0;
+}
+
 //! Result: destination <- v.  Leaves metadata alone but copies values in Vec.  Uses VecCopy.
 PetscErrorCode  IceModelVec::copy_to(IceModelVec &destination) {
   PetscErrorCode ierr;
@@ -686,12 +752,17 @@ PetscErrorCode IceModelVec::write(string filename, PISM_IO_Type nctype) {
   vars[0].time_independent = time_independent;
 
   if (localp) {
+    PetscInt local_size;
     ierr = DMCreateGlobalVector(da, &g); CHKERRQ(ierr);
+    ierr = VecGetLocalSize(g, &local_size); CHKERRQ(ierr);
+    grid->memory->allocate("output", local_size * sizeof(PetscScalar), memory_scaling);
+
     ierr = DMLocalToGlobalBegin(da, v, INSERT_VALUES, g); CHKERRQ(ierr);
     ierr = DMLocalToGlobalEnd(da, v, INSERT_VALUES, g); CHKERRQ(ierr);
 
     ierr = vars[0].write(filename, nctype, write_in_glaciological_units, g); CHKERRQ(ierr);
 
+    grid->memory->deallocate("output", local_size * sizeof(PetscScalar), memory_scaling);
     ierr = VecDestroy(&g); CHKERRQ(ierr);
   } else {
     ierr = vars[0].write(filename, nctype, write_in_glaciological_units, v); CHKERRQ(ierr);
@@ -719,6 +790,58 @@ PetscErrorCode IceModelVec::dump(const char filename[]) {
   return 0;
 }
 
+//! \brief Writes the internal storage to a PETSc binary viewer (no metadata,
+//! no unit conversion).
+/*!
+ * Values are written in the natural (processor-independent) ordering, so
+ * read_binary() works with any domain decomposition.
+ */
+PetscErrorCode IceModelVec::write_binary(PetscViewer viewer) {
+  PetscErrorCode ierr;
+  ierr = checkAllocated(); CHKERRQ(ierr);
+
+  if (localp) {
+    Vec g;
+    ierr = DMGetGlobalVector(da, &g); CHKERRQ(ierr);
+    ierr = DMLocalToGlobalBegin(da, v, INSERT_VALUES, g); CHKERRQ(ierr);
+    ierr = DMLocalToGlobalEnd(da, v, INSERT_VALUES, g); CHKERRQ(ierr);
+
+    ierr = VecView(g, viewer); CHKERRQ(ierr);
+
+    ierr = DMRestoreGlobalVector(da, &g); CHKERRQ(ierr);
+  } else {
+    ierr = VecView(v, viewer); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Reads values written by write_binary(). Updates ghost points if
+//! necessary.
+PetscErrorCode IceModelVec::read_binary(PetscViewer viewer) {
+  PetscErrorCode ierr;
+  ierr = checkAllocated(); CHKERRQ(ierr);
+
+  if (getVerbosityLevel() > 3) {
+    ierr = PetscPrintf(grid->com, "  Reading %s (binary)...\n", name.c_str()); CHKERRQ(ierr);
+  }
+
+  if (localp) {
+    Vec g;
+    ierr = DMGetGlobalVector(da, &g); CHKERRQ(ierr);
+
+    ierr = VecLoad(g, viewer); CHKERRQ(ierr);
+
+    ierr = DMGlobalToLocalBegin(da, g, INSERT_VALUES, v); CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da, g, INSERT_VALUES, v); CHKERRQ(ierr);
+    ierr = DMRestoreGlobalVector(da, &g); CHKERRQ(ierr);
+  } else {
+    ierr = VecLoad(v, viewer); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
 //! Checks if an IceModelVec is allocated.  Terminates if not.
 PetscErrorCode  IceModelVec::checkAllocated() {
 #if (PISM_DEBUG==1)
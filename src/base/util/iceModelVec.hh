@@ -21,9 +21,11 @@
 
 #include <cstring>
 #include <cstdlib>
+#include <vector>
 #include <petscdmda.h>
 
 #include "NCSpatialVariable.hh"
+#include "PISMMemoryUsage.hh"
 #include "pism_const.hh"
 
 class PIO;
@@ -182,6 +184,8 @@ public:
   virtual PetscErrorCode  copy_from(Vec source);
   virtual PetscErrorCode  copy_to(IceModelVec &destination);
   virtual PetscErrorCode  copy_from(IceModelVec &source);
+  virtual PetscErrorCode  save_state(Vec &result);
+  virtual PetscErrorCode  restore_state(Vec saved);
   virtual PetscErrorCode  has_nan();
   virtual PetscErrorCode  set_name(string name, int component = 0);
   virtual PetscErrorCode  set_glaciological_units(string units);
@@ -206,6 +210,8 @@ public:
   virtual PetscErrorCode  write(string filename, PISM_IO_Type nctype);
   virtual PetscErrorCode  dump(const char filename[]);
   virtual PetscErrorCode  read(string filename, unsigned int time);
+  virtual PetscErrorCode  write_binary(PetscViewer viewer);
+  virtual PetscErrorCode  read_binary(PetscViewer viewer);
   virtual PetscErrorCode  regrid(string filename, bool critical, int start = 0);
   virtual PetscErrorCode  regrid(string filename, PetscScalar default_value);
 
@@ -256,8 +262,14 @@ protected:
   int access_counter;		// used in begin_access() and end_access()
   int state_counter;            //!< Internal IceModelVec "revision number"
 
+  string memory_owner;          //!< component this IceModelVec's storage is attributed to
+  double memory_size;           //!< size of the internal storage, in bytes
+  PISMMemoryScaling memory_scaling;
+
   virtual PetscErrorCode create_2d_da(DM &result, PetscInt da_dof, PetscInt stencil_width);
   virtual PetscErrorCode destroy();
+  virtual PetscErrorCode register_memory();
+  virtual PetscErrorCode unregister_memory();
   virtual PetscErrorCode checkAllocated();
   virtual PetscErrorCode checkHaveArray();
   virtual PetscErrorCode checkCompatibility(const char*, IceModelVec &other);
@@ -397,7 +409,7 @@ public:
     check_array_indices(i, j);
 #endif
     const PetscScalar **a = (const PetscScalar**) array;
-    return static_cast<int>(floor(a[i][j] + 0.5));
+    return round_to_int(a[i][j]);
   }
 
   inline planeStar<int> int_star(int i, int j) {
@@ -408,16 +420,68 @@ public:
     check_array_indices(i, j+1);
     check_array_indices(i, j-1);
 #endif
+    const PetscScalar **a = (const PetscScalar**) array;
+
+    planeStar<int> result;
+    result.ij = round_to_int(a[i][j]);
+    result.e =  round_to_int(a[i+1][j]);
+    result.w =  round_to_int(a[i-1][j]);
+    result.n =  round_to_int(a[i][j+1]);
+    result.s =  round_to_int(a[i][j-1]);
+
+    return result;
+  }
+protected:
+  //! \brief Round to the nearest integer. Same as floor(x + 0.5), but avoids
+  //! a (possibly non-inlined) call to floor() in mask lookups.
+  static inline int round_to_int(PetscScalar x) {
+    const PetscScalar y = x + 0.5;
+    const int r = static_cast<int>(y); // rounds towards zero
+    return (y < r) ? r - 1 : r;
+  }
+};
+
+//! \brief A read-only copy of an IceModelVec2Int using one byte per grid
+//! point (including ghosts).
+/*!
+ * Masks are stored as PetscScalar (8 bytes per point) so that they can use
+ * the usual DA-based I/O and ghost communication. Loops that perform many
+ * mask lookups (several per grid point, in a region where the mask does not
+ * change) can use this copy instead: it is 8 times smaller and lookups do not
+ * need a float-to-int conversion.
+ *
+ * This is a snapshot: it is \b not updated when the source changes. Call
+ * update() after every change of the source mask and before using the copy.
+ * No begin_access()/end_access() calls are needed.
+ *
+ * Ghost values are copied from the source, so there is no separate one-byte
+ * ghost exchange: loops that change the mask (and exchange ghosts after
+ * every sweep) keep using the IceModelVec2Int.
+ */
+class IceModelVec2IntCompact {
+public:
+  IceModelVec2IntCompact();
+  PetscErrorCode update(IceModelVec2Int &input);
+
+  inline int as_int(int i, int j) const {
+    return m_data[(i - m_xs) * m_stride + (j - m_ys)];
+  }
+
+  inline planeStar<int> int_star(int i, int j) const {
+    const signed char *p = &m_data[(i - m_xs) * m_stride + (j - m_ys)];
 
     planeStar<int> result;
-    result.ij = as_int(i,j);
-    result.e =  as_int(i+1,j);
-    result.w =  as_int(i-1,j);
-    result.n =  as_int(i,j+1);
-    result.s =  as_int(i,j-1);
+    result.ij = p[0];
+    result.e =  p[m_stride];
+    result.w =  p[-m_stride];
+    result.n =  p[1];
+    result.s =  p[-1];
 
     return result;
   }
+protected:
+  vector<signed char> m_data;
+  int m_xs, m_ys, m_stride;     //!< first (ghost) point and row length
 };
 
 //! \brief A class representing a horizontal velocity at a certain grid point.
@@ -657,6 +721,8 @@ public:
                                 planeStar<PetscScalar> *star);
   PetscErrorCode  getPlaneStar_fine(PetscInt i, PetscInt j, PetscInt k,
 				    planeStar<PetscScalar> *star);
+  PetscScalar     getValDeparture_fine(PetscInt i, PetscInt j, PetscInt k,
+                                       PetscScalar di, PetscScalar dj);
   PetscErrorCode  getPlaneStar(PetscInt i, PetscInt j, PetscInt k,
 			       planeStar<PetscScalar> *star);
 
@@ -143,6 +143,45 @@ PetscErrorCode IceModelVec2S::mask_by(IceModelVec2S &M, PetscScalar fill) {
   return 0;
 }
 
+IceModelVec2IntCompact::IceModelVec2IntCompact() {
+  m_xs = 0;
+  m_ys = 0;
+  m_stride = 0;
+}
+
+//! Copies owned and ghost values of `input` (which has to be up to date,
+//! including ghosts).
+PetscErrorCode IceModelVec2IntCompact::update(IceModelVec2Int &input) {
+  PetscErrorCode ierr;
+  IceGrid *grid = input.get_grid();
+  const int width = input.get_stencil_width();
+
+  m_xs     = grid->xs - width;
+  m_ys     = grid->ys - width;
+  m_stride = grid->ym + 2 * width;
+  m_data.resize((grid->xm + 2 * width) * m_stride);
+
+  bool out_of_range = false;
+  ierr = input.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = m_xs; i < grid->xs + grid->xm + width; ++i) {
+    signed char *row = &m_data[(i - m_xs) * m_stride];
+    for (PetscInt j = m_ys; j < grid->ys + grid->ym + width; ++j) {
+      const int value = input.as_int(i, j);
+      if (value < -128 || value > 127)
+        out_of_range = true;
+      row[j - m_ys] = static_cast<signed char>(value);
+    }
+  }
+  ierr = input.end_access(); CHKERRQ(ierr);
+
+  if (out_of_range) {
+    SETERRQ1(grid->com, 1, "PISM ERROR: %s has values that do not fit in a signed char",
+             input.string_attr("short_name").c_str());
+  }
+
+  return 0;
+}
+
 PetscErrorCode IceModelVec2::write(string filename, PISM_IO_Type nctype) {
   PetscErrorCode ierr;
 
@@ -627,6 +666,7 @@ PetscErrorCode  IceModelVec2::create(IceGrid &my_grid, string my_name, bool loca
   } else {
     ierr = DMCreateGlobalVector(da, &v); CHKERRQ(ierr);
   }
+  ierr = register_memory(); CHKERRQ(ierr);
 
   localp = local;
   name = my_name;
@@ -35,6 +35,9 @@ IceModelVec2T::IceModelVec2T() : IceModelVec2S() {
   n_records = 50;		// just a default
   report_range = false;
   lic = NULL;
+  buffer_size = 0.0;
+  single_precision = false;
+  records32 = NULL;
 }
 
 IceModelVec2T::IceModelVec2T(const IceModelVec2T &other) : IceModelVec2S(other) {
@@ -51,11 +54,15 @@ IceModelVec2T::IceModelVec2T(const IceModelVec2T &other) : IceModelVec2S(other)
   time = other.time;
   time_bounds = other.time_bounds;
   v3 = other.v3;
+  buffer_size = other.buffer_size;
+  single_precision = other.single_precision;
+  records32 = other.records32;
 }
 
 IceModelVec2T::~IceModelVec2T() {
   if (!shallow_copy) {
     delete lic;
+    delete[] records32;
     // call destroy(), maybe???
   }
 }
@@ -80,11 +87,29 @@ PetscErrorCode IceModelVec2T::create(IceGrid &my_grid, string my_short_name,
 
   ierr = IceModelVec2S::create(my_grid, my_short_name, false, width); CHKERRQ(ierr);
 
-  // create the DA:
-  ierr = create_2d_da(da3, n_records, 1); CHKERRQ(ierr);
+  single_precision = grid->config.get_flag("climate_forcing_single_precision");
 
-  // allocate the 3D Vec:
-  ierr = DMCreateGlobalVector(da3, &v3); CHKERRQ(ierr);
+  const double local_size = (double)grid->xm * grid->ym * n_records;
+
+  if (single_precision) {
+    records32 = new float[grid->xm * grid->ym * n_records];
+    buffer_size = local_size * sizeof(float);
+
+    ierr = verbPrintf(3, grid->com,
+                      "  - storing %d records of '%s' in single precision: %.1f Mb instead of %.1f Mb per processor\n",
+                      n_records, name.c_str(), buffer_size / 1048576.0,
+                      local_size * sizeof(PetscScalar) / 1048576.0); CHKERRQ(ierr);
+  } else {
+    // create the DA:
+    ierr = create_2d_da(da3, n_records, 1); CHKERRQ(ierr);
+
+    // allocate the 3D Vec:
+    ierr = DMCreateGlobalVector(da3, &v3); CHKERRQ(ierr);
+
+    buffer_size = local_size * sizeof(PetscScalar);
+  }
+
+  grid->memory->allocate(memory_owner + " (forcing)", buffer_size, MEMORY_LOCAL_2D);
 
   return 0;
 }
@@ -94,10 +119,15 @@ PetscErrorCode IceModelVec2T::destroy() {
 
   ierr = IceModelVec2S::destroy(); CHKERRQ(ierr);
 
+  if (v3 != PETSC_NULL || records32 != NULL) {
+    grid->memory->deallocate(memory_owner + " (forcing)", buffer_size, MEMORY_LOCAL_2D);
+  }
   if (v3 != PETSC_NULL) {
     ierr = VecDestroy(&v3); CHKERRQ(ierr);
     v3 = PETSC_NULL;
   }
+  delete[] records32;
+  records32 = NULL;
   if (da3 != PETSC_NULL) {
     ierr = DMDestroy(&da3); CHKERRQ(ierr);
     da3 = PETSC_NULL;
@@ -108,6 +138,10 @@ PetscErrorCode IceModelVec2T::destroy() {
 
 PetscErrorCode IceModelVec2T::get_array3(PetscScalar*** &a3) {
   PetscErrorCode ierr;
+
+  if (single_precision)
+    SETERRQ(grid->com, 1, "IceModelVec2T::get_array3(): records are stored in single precision");
+
   ierr = begin_access(); CHKERRQ(ierr);
   a3 = (PetscScalar***) array3;
   return 0;
@@ -115,7 +149,7 @@ PetscErrorCode IceModelVec2T::get_array3(PetscScalar*** &a3) {
 
 PetscErrorCode IceModelVec2T::begin_access() {
   PetscErrorCode ierr;
-  if (access_counter == 0) {
+  if (access_counter == 0 && single_precision == false) {
     ierr = DMDAVecGetArrayDOF(da3, v3, &array3); CHKERRQ(ierr);
   }
 
@@ -129,7 +163,7 @@ PetscErrorCode IceModelVec2T::end_access() {
   // this call will decrement the access_counter
   PetscErrorCode ierr = IceModelVec2S::end_access(); CHKERRQ(ierr);
 
-  if (access_counter == 0) {
+  if (access_counter == 0 && single_precision == false) {
     ierr = DMDAVecRestoreArrayDOF(da3, v3, &array3); CHKERRQ(ierr);
     array3 = PETSC_NULL;
   }
@@ -355,19 +389,17 @@ PetscErrorCode IceModelVec2T::update(int start) {
 //! Discard the first N records, shifting the rest of them towards the "beginning".
 PetscErrorCode IceModelVec2T::discard(int number) {
   PetscErrorCode ierr;
-  PetscScalar **a2, ***a3;
 
   if (number == 0)
     return 0;
 
   N -= number;
 
-  ierr = get_array(a2); CHKERRQ(ierr);
-  ierr = get_array3(a3); CHKERRQ(ierr);
+  ierr = begin_access(); CHKERRQ(ierr);
   for (PetscInt i=grid->xs; i<grid->xs+grid->xm; ++i)
     for (PetscInt j=grid->ys; j<grid->ys+grid->ym; ++j)
       for (PetscInt k = 0; k < N; ++k)
-	a3[i][j][k] = a3[i][j][k + number];
+	set_record_value(i, j, k, record(i, j, k + number));
   ierr = end_access(); CHKERRQ(ierr);
   
   return 0;
@@ -376,13 +408,12 @@ PetscErrorCode IceModelVec2T::discard(int number) {
 //! Sets the record number n to the contents of the (internal) Vec v.
 PetscErrorCode IceModelVec2T::set_record(int n) {
   PetscErrorCode ierr;
-  PetscScalar **a2, ***a3;
+  PetscScalar **a2;
 
   ierr = get_array(a2); CHKERRQ(ierr);
-  ierr = get_array3(a3); CHKERRQ(ierr);
   for (PetscInt i=grid->xs; i<grid->xs+grid->xm; ++i)
     for (PetscInt j=grid->ys; j<grid->ys+grid->ym; ++j)
-      a3[i][j][n] = a2[i][j];
+      set_record_value(i, j, n, a2[i][j]);
   ierr = end_access(); CHKERRQ(ierr);
 
   return 0;
@@ -391,13 +422,12 @@ PetscErrorCode IceModelVec2T::set_record(int n) {
 //! Sets the (internal) Vec v to the contents of the nth record.
 PetscErrorCode IceModelVec2T::get_record(int n) {
   PetscErrorCode ierr;
-  PetscScalar **a2, ***a3;
+  PetscScalar **a2;
 
   ierr = get_array(a2); CHKERRQ(ierr);
-  ierr = get_array3(a3); CHKERRQ(ierr);
   for (PetscInt i=grid->xs; i<grid->xs+grid->xm; ++i)
     for (PetscInt j=grid->ys; j<grid->ys+grid->ym; ++j)
-      a2[i][j] = a3[i][j][n];
+      a2[i][j] = record(i, j, n);
   ierr = end_access(); CHKERRQ(ierr);
 
   return 0;
@@ -511,13 +541,12 @@ PetscErrorCode IceModelVec2T::interp(double my_t) {
   int m = first + k;
   double lambda = (my_t - time[m]) / (time[m + 1] - time[m]);
 
-  PetscScalar **a2, ***a3;
+  PetscScalar **a2;
 
   ierr = get_array(a2); CHKERRQ(ierr);
-  ierr = get_array3(a3); CHKERRQ(ierr);
   for (PetscInt i=grid->xs; i<grid->xs+grid->xm; ++i)
     for (PetscInt j=grid->ys; j<grid->ys+grid->ym; ++j)
-      a2[i][j] = a3[i][j][k] * (1 - lambda) + a3[i][j][k + 1] * lambda;
+      a2[i][j] = record(i, j, k) * (1 - lambda) + record(i, j, k + 1) * lambda;
   ierr = end_access(); CHKERRQ(ierr);
 
   return 0;
@@ -530,7 +559,6 @@ PetscErrorCode IceModelVec2T::interp(double my_t) {
 PetscErrorCode IceModelVec2T::interp(int i, int j, int number,
 				    PetscScalar *ts, PetscScalar *values) {
   int mcurr = first;
-  PetscScalar ***a3 = (PetscScalar***) array3;
   int last = first + (N - 1);
 
   for (int k = 0; k < number; ++k) {
@@ -540,12 +568,12 @@ PetscErrorCode IceModelVec2T::interp(int i, int j, int number,
 
     // extrapolate on the left:
     if (ts[k] <= time[first]) {
-      values[k] = a3[i][j][0];
+      values[k] = record(i, j, 0);
       continue;
     }
     // extrapolate on the right:
     if (ts[k] >= time[last]) {
-      values[k] = a3[i][j][N-1];
+      values[k] = record(i, j, N-1);
       continue;
     }
 
@@ -554,17 +582,102 @@ PetscErrorCode IceModelVec2T::interp(int i, int j, int number,
     }
 
     const PetscScalar incr = (ts[k] - time[mcurr]) / (time[mcurr+1] - time[mcurr]);
-    const PetscScalar valm = a3[i][j][mcurr - first];
-    values[k] = valm + incr * (a3[i][j][mcurr - first + 1] - valm);
+    const PetscScalar valm = record(i, j, mcurr - first);
+    values[k] = valm + incr * (record(i, j, mcurr - first + 1) - valm);
+  }
+
+  return 0;
+}
+
+//! Values of the column of records at a grid point, weighted using
+//! precomputed indices and weights. (T is float or PetscScalar.)
+template <typename T>
+static inline void apply_weights(const T *column, int N,
+                                 const int *left, const int *right, const double *weight,
+                                 PetscScalar *result) {
+  for (int k = 0; k < N; ++k) {
+    const PetscScalar a = column[left[k]];
+    result[k] = a + weight[k] * (column[right[k]] - a);
+  }
+}
+
+//! Linear combination of records (in memory) at a grid point.
+template <typename T>
+static inline PetscScalar combine(const T *column, int N, const double *coefficient) {
+  PetscScalar result = 0.0;
+  for (int k = 0; k < N; ++k)
+    result += coefficient[k] * column[k];
+  return result;
+}
+
+//! \brief Compute indices of records and weights used to interpolate to
+//! times in \c ts.
+/*!
+ * Weights depend on times only, so they are computed once for all the grid
+ * points (see interp(int, int, PetscScalar*)). Uses records in memory, so
+ * this has to be called after update().
+ *
+ * Extrapolates by a constant outside the available range, just like
+ * interp(int, int, int, PetscScalar*, PetscScalar*).
+ */
+PetscErrorCode IceModelVec2T::init_interpolation(const PetscScalar *ts, unsigned int ts_length) {
+  int last = first + (N - 1);
+
+  interp_left.resize(ts_length);
+  interp_right.resize(ts_length);
+  interp_weight.resize(ts_length);
+
+  for (unsigned int k = 0; k < ts_length; ++k) {
+
+    if (ts[k] <= time[first]) {
+      // extrapolate on the left:
+      interp_left[k] = interp_right[k] = 0;
+      interp_weight[k] = 0.0;
+    } else if (ts[k] >= time[last]) {
+      // extrapolate on the right:
+      interp_left[k] = interp_right[k] = N - 1;
+      interp_weight[k] = 0.0;
+    } else {
+      // time[m] < ts[k] <= time[m + 1]
+      int m = (int)(lower_bound(time.begin() + first, time.begin() + last + 1, ts[k])
+                    - time.begin()) - 1;
+
+      interp_left[k]   = m - first;
+      interp_right[k]  = m - first + 1;
+      interp_weight[k] = (ts[k] - time[m]) / (time[m + 1] - time[m]);
+    }
   }
 
   return 0;
 }
 
+//! \brief Get an interpolated time-series at i,j using weights computed by
+//! init_interpolation(). Has to be surrounded with begin_access() and
+//! end_access().
+/*!
+  Note: this method does not check ownership and does not check if an update() call is necessary!
+ */
+PetscErrorCode IceModelVec2T::interp(int i, int j, PetscScalar *results) {
+  const int n = (int)interp_weight.size();
+
+  if (n == 0)
+    return 0;
+
+  if (single_precision)
+    apply_weights(records32 + offset32(i, j), n,
+                  &interp_left[0], &interp_right[0], &interp_weight[0], results);
+  else
+    apply_weights(((PetscScalar***) array3)[i][j], n,
+                  &interp_left[0], &interp_right[0], &interp_weight[0], results);
+
+  return 0;
+}
+
 //! \brief Finds the average value at i,j over the interval (my_t, my_t +
 //! my_dt) using trapezoidal rule.
 /*!
-  Can (and should) be optimized. Later, though.
+  Re-computes the time-dependent weights at every call; average(double,
+  double) is a lot faster if the average is needed at all grid points.
  */
 PetscErrorCode IceModelVec2T::average(int i, int j, double my_t, double my_dt,
 				      double &result) {
@@ -593,15 +706,59 @@ PetscErrorCode IceModelVec2T::average(int i, int j, double my_t, double my_dt,
   return 0;
 }
 
+//! \brief Computes the average over the interval (my_t, my_t + my_dt) at all
+//! grid points, using the trapezoidal rule (same as average(int, int,
+//! double, double, double&)).
+/*!
+ * The average of linearly-interpolated values is a linear combination of
+ * the records in memory with coefficients that depend on times only. These
+ * coefficients are computed once, so at each grid point this is a dot
+ * product of a contiguous column of records and a vector of coefficients.
+ */
 PetscErrorCode IceModelVec2T::average(double my_t, double my_dt) {
   PetscErrorCode ierr;
   PetscScalar **a2;
 
+  PetscReal dt_years = grid->time->seconds_to_years(my_dt); // *not* time->year(my_dt)
+
+  // Determine the number of small time-steps to use for averaging:
+  int M = (int) ceil(52 * (dt_years) + 1); // (52 weeks in a year)
+  if (M < 2) M = 2;
+
+  vector<double> ts(M);
+  double dt = my_dt / (M - 1);
+  for (int k = 0; k < M; k++)
+    ts[k] = my_t + k * dt;
+
+  ierr = init_interpolation(&ts[0], M); CHKERRQ(ierr);
+
+  // trapezoidal rule weights of values at ts[k] are 1/(2(M-1)) at the end
+  // points and 1/(M-1) in the interior:
+  vector<double> coefficient(N, 0.0);
+  for (int k = 0; k < M; ++k) {
+    double w = (k == 0 || k == M - 1) ? 0.5 / (M - 1) : 1.0 / (M - 1);
+
+    coefficient[interp_left[k]]  += w * (1.0 - interp_weight[k]);
+    coefficient[interp_right[k]] += w * interp_weight[k];
+  }
+
+  // only use the range of records with non-zero coefficients:
+  int n0 = 0, n1 = N - 1;
+  while (n0 < n1 && coefficient[n0] == 0.0)
+    n0++;
+  while (n1 > n0 && coefficient[n1] == 0.0)
+    n1--;
+  const int n = n1 - n0 + 1;
+  const double *c = &coefficient[n0];
+
   ierr = begin_access(); CHKERRQ(ierr);
   ierr = get_array(a2);
   for (PetscInt   i = grid->xs; i < grid->xs+grid->xm; ++i) {
     for (PetscInt j = grid->ys; j < grid->ys+grid->ym; ++j) {
-      ierr = average(i, j, my_t, my_dt, a2[i][j]); CHKERRQ(ierr);
+      if (single_precision)
+        a2[i][j] = combine(records32 + offset32(i, j) + n0, n, c);
+      else
+        a2[i][j] = combine(((PetscScalar***) array3)[i][j] + n0, n, c);
     }
   }
 
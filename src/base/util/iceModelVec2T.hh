@@ -20,6 +20,7 @@
 #define __IceModelVec2T_hh
 
 #include "iceModelVec.hh"
+#include "IceGrid.hh"
 
 //! A class for storing and accessing 2D time-series (for climate forcing)
 /*! This class was created to read time-dependent and spatially-varying climate
@@ -37,6 +38,11 @@
 
   IceModelVec2T is always global (%i.e. has no ghosts).
 
+  If the configuration flag `climate_forcing_single_precision` is set, records
+  are stored as \c float (halving memory use and the amount of data
+  interp() and average() have to read) and converted to double on access.
+  The internal Vec (the "current" field) is always double precision.
+
   Both versions of interp() use linear interpolation and extrapolate (by a
   constant) outside the available range.
 
@@ -76,10 +82,13 @@
   // is is OK to call update() again, it will not re-read data if at all possible
   ierr = v.update(t, max_dt); CHKERRQ(ierr);
 
+  // compute interpolation weights (these depend on ts only):
+  ierr = v.init_interpolation(&ts[0], N); CHKERRQ(ierr);
+
   ierr = v.begin_access(); CHKERRQ(ierr);
   for (PetscInt i=grid->xs; i<grid->xs+grid->xm; ++i)
     for (PetscInt j=grid->ys; j<grid->ys+grid->ym; ++j) {
-      ierr = v.interp(i, j, N, &ts[0], &values[0]); CHKERRQ(ierr);
+      ierr = v.interp(i, j, &values[0]); CHKERRQ(ierr);
       // do more
     }
   ierr = v.end_access(); CHKERRQ(ierr);
@@ -115,6 +124,8 @@ public:
   virtual PetscErrorCode interp(double my_t);
   virtual PetscErrorCode interp(int i, int j, int N,
 				PetscScalar *times, PetscScalar *results);
+  virtual PetscErrorCode init_interpolation(const PetscScalar *times, unsigned int N);
+  virtual PetscErrorCode interp(int i, int j, PetscScalar *results);
   virtual PetscErrorCode average(double my_t, double my_dt);
   virtual PetscErrorCode average(int i, int j, double my_t, double my_dt,
 				 double &result);
@@ -122,6 +133,28 @@ public:
   virtual PetscErrorCode end_access();
 
 protected:
+  //! \brief Value of the record k (counting from the first record in
+  //! memory) at the grid point i,j. Has to be surrounded by begin_access()
+  //! and end_access().
+  inline double record(int i, int j, int k) const {
+    if (single_precision)
+      return records32[offset32(i, j) + k];
+    return ((PetscScalar***) array3)[i][j][k];
+  }
+
+  //! \brief Set the value of the record k at i,j.
+  inline void set_record_value(int i, int j, int k, double value) {
+    if (single_precision)
+      records32[offset32(i, j) + k] = static_cast<float>(value);
+    else
+      ((PetscScalar***) array3)[i][j][k] = value;
+  }
+
+  //! \brief Offset of the first record at i,j in records32.
+  inline int offset32(int i, int j) const {
+    return ((i - grid->xs) * grid->ym + (j - grid->ys)) * n_records;
+  }
+
   vector<double> time,		//!< all the times available in filename
     time_bounds;		//!< time bounds
   string filename;		//!< file to read (regrid) from
@@ -133,6 +166,15 @@ protected:
     N;                   //!< number of records kept in memory
   LocalInterpCtx *lic;
 
+  //! records (in memory) and weights used by interp(i, j, results): the
+  //! value at times[k] is record(left[k]) + weight[k] * (record(right[k]) - record(left[k]))
+  vector<int> interp_left, interp_right;
+  vector<double> interp_weight;
+
+  double buffer_size;           //!< size of the records buffer (v3 or records32), in bytes
+  bool single_precision;        //!< true if records are stored in records32 instead of v3
+  float *records32;             //!< single precision records (n_records per grid point)
+
   virtual PetscErrorCode destroy();
   virtual PetscErrorCode get_array3(PetscScalar*** &a3);
   virtual PetscErrorCode update(int start);
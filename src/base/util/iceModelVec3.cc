@@ -73,6 +73,7 @@ PetscErrorCode  IceModelVec3D::allocate(IceGrid &my_grid, string my_name,
   } else {
     ierr = DMCreateGlobalVector(da, &v); CHKERRQ(ierr);
   }
+  ierr = register_memory(); CHKERRQ(ierr);
 
   localp = local;
   name = my_name;
@@ -360,6 +361,59 @@ PetscErrorCode IceModelVec3::getPlaneStar_fine(PetscInt i, PetscInt j, PetscInt
   return 0;
 }
 
+//! \brief Returns the value at the fine level \c k and the "departure point"
+//! \f$(i - d_i, j - d_j)\f$ (in grid units), using bilinear interpolation.
+/*!
+ * Used by the semi-Lagrangian horizontal advection scheme: \f$d_i = u \Delta
+ * t / \Delta x\f$ and \f$d_j = v \Delta t / \Delta y\f$.
+ *
+ * Displacements are clipped so that the departure point stays within the
+ * ghosted sub-domain, i.e. \f$|d_i|, |d_j| \le\f$ the stencil width. The
+ * halo has to be wide enough to make this unnecessary; IceModel sizes it
+ * using semi_lagrangian_cfl_factor and counts clipped points (see
+ * IceModel::countCFLViolations()).
+ */
+PetscScalar IceModelVec3::getValDeparture_fine(PetscInt i, PetscInt j, PetscInt k,
+                                               PetscScalar di, PetscScalar dj) {
+  const PetscInt W = da_stencil_width;
+  PetscScalar ***arr = (PetscScalar***) array;
+
+  di = PetscMax(PetscMin(di, (PetscScalar)W), -(PetscScalar)W);
+  dj = PetscMax(PetscMin(dj, (PetscScalar)W), -(PetscScalar)W);
+
+  const PetscScalar x = i - di, y = j - dj;
+  PetscInt I = static_cast<PetscInt>(floor(x)), J = static_cast<PetscInt>(floor(y));
+  PetscScalar a = x - I, b = y - J;
+
+  // at the edge of the ghosted sub-domain use the cell on the inside
+  if (I == i + W) { I -= 1; a = 1.0; }
+  if (J == j + W) { J -= 1; b = 1.0; }
+
+#if (PISM_DEBUG == 1)
+  check_array_indices(I, J);
+  check_array_indices(I + 1, J + 1);
+#endif
+
+  // vertical interpolation, as in getPlaneStar_fine():
+  const PetscInt kbz = grid->ice_storage2fine[k];
+  PetscScalar incr = 0.0;
+  PetscInt kbz1 = kbz;
+  if (kbz < n_levels - 1) {
+    incr = (grid->zlevels_fine[k] - zlevels[kbz]) / (zlevels[kbz+1] - zlevels[kbz]);
+    kbz1 = kbz + 1;
+  }
+
+#define VAL(ii, jj) (arr[ii][jj][kbz] + incr * (arr[ii][jj][kbz1] - arr[ii][jj][kbz]))
+  const PetscScalar result =
+    (1.0 - a) * (1.0 - b) * VAL(I,     J) +
+    a         * (1.0 - b) * VAL(I + 1, J) +
+    (1.0 - a) * b         * VAL(I,     J + 1) +
+    a         * b         * VAL(I + 1, J + 1);
+#undef VAL
+
+  return result;
+}
+
 //! Return values of ice scalar quantity at given levels (m) above base of ice, using piecewise linear interpolation.
 /*!
 Input array \c levelsIN must be an allocated array of \c nlevels scalars 
@@ -688,9 +742,13 @@ PetscErrorCode IceModelVec3::extend_vertically_private(int old_Mz) {
   ierr = DMDAVecRestoreArrayDOF(da, v, &a_old); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArrayDOF(da_new, v_new, &a_new); CHKERRQ(ierr);
 
-  // Deallocate old DA and Vec:
+  // Deallocate old DA and Vec (keeping the owner of this storage):
+  grid->memory->begin(memory_owner);
+  ierr = unregister_memory(); CHKERRQ(ierr);
   ierr = VecDestroy(&v); CHKERRQ(ierr);
   v = v_new;
+  ierr = register_memory(); CHKERRQ(ierr);
+  grid->memory->end();
 
   ierr = DMDestroy(&da); CHKERRQ(ierr);
   da = da_new;
@@ -604,6 +604,27 @@ PetscErrorCode PIO::def_var(string name, PISM_IO_Type nctype, vector<string> dim
 
   return 0;
 }
+
+//! \brief Set chunk sizes of a variable (one per dimension, in the order used
+//! in def_var()). Ignored by NetCDF-3 formats.
+PetscErrorCode PIO::def_var_chunking(string name, vector<size_t> &dimensions) const {
+  PetscErrorCode ierr;
+
+  ierr = nc->def_var_chunking(name, dimensions); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Enable deflate compression (and optionally the shuffle filter) for
+//! a variable. Ignored by NetCDF-3 formats.
+/*!
+ * Parallel NetCDF-4 writes to compressed variables require a NetCDF library
+ * built with support for parallel filters; the error code is returned to the
+ * caller so that it can decide what to do.
+ */
+PetscErrorCode PIO::def_var_deflate(string name, bool shuffle, int deflate_level) const {
+  return nc->def_var_deflate(name, shuffle ? 1 : 0, deflate_level);
+}
 PetscErrorCode PIO::get_1d_var(string name, unsigned int s, unsigned int c,
                                vector<double> &result) const {
   PetscErrorCode ierr;
@@ -90,6 +90,10 @@ public:
 
   virtual PetscErrorCode def_var(string name, PISM_IO_Type nctype, vector<string> dims) const;
 
+  virtual PetscErrorCode def_var_chunking(string name, vector<size_t> &dimensions) const;
+
+  virtual PetscErrorCode def_var_deflate(string name, bool shuffle, int deflate_level) const;
+
   virtual PetscErrorCode get_dim(string name, vector<double> &result) const;
 
   virtual PetscErrorCode get_1d_var(string name, unsigned int start, unsigned int count,
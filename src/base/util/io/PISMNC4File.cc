@@ -186,6 +186,62 @@ int PISMNC4File::def_var(string name, PISM_IO_Type nctype, vector<string> dims)
   return stat;
 }
 
+int PISMNC4File::def_var_chunking(string name, vector<size_t> &dimensions) const {
+  int stat, varid;
+
+  stat = nc_inq_varid(ncid, name.c_str(), &varid); check(stat);
+
+  stat = nc_def_var_chunking(ncid, varid, NC_CHUNKED, &dimensions[0]); check(stat);
+
+  return stat;
+}
+
+int PISMNC4File::def_var_deflate(string name, int shuffle, int deflate_level) const {
+  int stat, varid;
+
+  stat = nc_inq_varid(ncid, name.c_str(), &varid); check(stat);
+
+  stat = nc_def_var_deflate(ncid, varid, shuffle, deflate_level > 0 ? 1 : 0,
+                            deflate_level); check(stat);
+
+  return stat;
+}
+
+//! \brief Computes offsets, in the "mapped" layout described by `imap`, of
+//! the elements of a block of size `count`, listed in the file order.
+/*!
+ * Used to replace nc_{get,put}_varm_double(), which are slow and which HDF5
+ * can't do collectively, with a transpose in memory and one collective
+ * nc_{get,put}_vara_double() call.
+ */
+static void mapped_offsets(const vector<size_t> &count, const vector<ptrdiff_t> &imap,
+                           vector<ptrdiff_t> &result) {
+  const int ndims = static_cast<int>(count.size());
+  size_t N = 1;
+  for (int j = 0; j < ndims; ++j)
+    N *= count[j];
+
+  result.resize(N);
+
+  // index (within the block) of the current element and its offset in the
+  // mapped layout; the last index changes fastest
+  vector<size_t> index(ndims, 0);
+  ptrdiff_t offset = 0;
+
+  for (size_t n = 0; n < N; ++n) {
+    result[n] = offset;
+
+    for (int j = ndims - 1; j >= 0; --j) {
+      index[j] += 1;
+      offset += imap[j];
+      if (index[j] < count[j])
+        break;
+      offset -= imap[j] * static_cast<ptrdiff_t>(count[j]);
+      index[j] = 0;
+    }
+  }
+}
+
 int PISMNC4File::get_varm_double(string variable_name,
                                  vector<unsigned int> start,
                                  vector<unsigned int> count,
@@ -229,7 +285,7 @@ int PISMNC4File::get_var_double(string variable_name,
     imap.resize(ndims);
 
   vector<size_t> nc_start(ndims), nc_count(ndims);
-  vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
+  vector<ptrdiff_t> nc_imap(ndims);
 
   stat = nc_inq_varid(ncid, variable_name.c_str(), &varid); check(stat);
 
@@ -237,26 +293,26 @@ int PISMNC4File::get_var_double(string variable_name,
     nc_start[j] = start[j];
     nc_count[j] = count[j];
     nc_imap[j]  = imap[j];
-    nc_stride[j] = 1;
   }
 
+  // Use collective parallel access mode because it is faster (and because
+  // HDF5 can only write compressed variables collectively).
+  stat = nc_var_par_access(ncid, varid, NC_COLLECTIVE); check(stat);
 
   if (mapped) {
-    // Use independent parallel access mode because it works. It would be
-    // better to use collective mode, but I/O performance is ruined by
-    // "mapping" anyway.
+    // read into a buffer in the file order, then transpose
+    vector<ptrdiff_t> offsets;
+    mapped_offsets(nc_count, nc_imap, offsets);
+    const size_t N = offsets.size();
+    vector<double> buffer(N);
 
-    stat = nc_var_par_access(ncid, varid, NC_INDEPENDENT); check(stat);
+    stat = nc_get_vara_double(ncid, varid,
+                              &nc_start[0], &nc_count[0],
+                              N > 0 ? &buffer[0] : NULL); check(stat);
 
-    stat = nc_get_varm_double(ncid, varid,
-                              &nc_start[0], &nc_count[0], &nc_stride[0], &nc_imap[0],
-                              ip); check(stat);
+    for (size_t n = 0; n < N; ++n)
+      ip[offsets[n]] = buffer[n];
   } else {
-    // Use collective parallel access mode because it is faster (and because it
-    // works in this case).
-
-    stat = nc_var_par_access(ncid, varid, NC_COLLECTIVE); check(stat);
-
     stat = nc_get_vara_double(ncid, varid,
                               &nc_start[0], &nc_count[0],
                               ip); check(stat);
@@ -308,7 +364,7 @@ int PISMNC4File::put_var_double(string variable_name,
     imap.resize(ndims);
 
   vector<size_t> nc_start(ndims), nc_count(ndims);
-  vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
+  vector<ptrdiff_t> nc_imap(ndims);
 
   stat = nc_inq_varid(ncid, variable_name.c_str(), &varid); check(stat);
 
@@ -316,25 +372,26 @@ int PISMNC4File::put_var_double(string variable_name,
     nc_start[j] = start[j];
     nc_count[j] = count[j];
     nc_imap[j]  = imap[j];
-    nc_stride[j] = 1;
   }
 
+  // Use collective parallel access mode because it is faster (and because
+  // HDF5 can only write compressed variables collectively).
+  stat = nc_var_par_access(ncid, varid, NC_COLLECTIVE); check(stat);
+
   if (mapped) {
-    // Use independent parallel access mode because it works. It would be
-    // better to use collective mode, but I/O performance is ruined by
-    // "mapping" anyway.
+    // transpose into a buffer in the file order, then write
+    vector<ptrdiff_t> offsets;
+    mapped_offsets(nc_count, nc_imap, offsets);
+    const size_t N = offsets.size();
+    vector<double> buffer(N);
 
-    stat = nc_var_par_access(ncid, varid, NC_INDEPENDENT); check(stat);
+    for (size_t n = 0; n < N; ++n)
+      buffer[n] = op[offsets[n]];
 
-    stat = nc_put_varm_double(ncid, varid,
-                              &nc_start[0], &nc_count[0], &nc_stride[0], &nc_imap[0],
-                              op); check(stat);
+    stat = nc_put_vara_double(ncid, varid,
+                              &nc_start[0], &nc_count[0],
+                              N > 0 ? &buffer[0] : NULL); check(stat);
   } else {
-    // Use collective parallel access mode because it is faster (and because it
-    // works in this case).
-
-    stat = nc_var_par_access(ncid, varid, NC_COLLECTIVE); check(stat);
-
     stat = nc_put_vara_double(ncid, varid,
                               &nc_start[0], &nc_count[0],
                               op); check(stat);
@@ -51,6 +51,10 @@ public:
   // var
   int def_var(string name, PISM_IO_Type nctype, vector<string> dims) const;
 
+  int def_var_chunking(string name, vector<size_t> &dimensions) const;
+
+  int def_var_deflate(string name, int shuffle, int deflate_level) const;
+
   int get_vara_double(string variable_name,
                       vector<unsigned int> start,
                       vector<unsigned int> count,
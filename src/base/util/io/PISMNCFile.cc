@@ -47,6 +47,18 @@ int PISMNCFile::put_att_double(string variable_name, string att_name, PISM_IO_Ty
   return put_att_double(variable_name, att_name, nctype, tmp);
 }
 
+//! \brief Set chunk sizes of a variable. Does nothing (NetCDF-3 files are not
+//! chunked); overridden by PISMNC4File.
+int PISMNCFile::def_var_chunking(string, vector<size_t> &) const {
+  return 0;
+}
+
+//! \brief Set compression parameters of a variable. Does nothing (NetCDF-3
+//! files cannot be compressed); overridden by PISMNC4File.
+int PISMNCFile::def_var_deflate(string, int, int) const {
+  return 0;
+}
+
 //! \brief Prints an error message; for debugging.
 void PISMNCFile::check(int return_code) const {
   if (return_code != NC_NOERR) {
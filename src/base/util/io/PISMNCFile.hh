@@ -107,6 +107,10 @@ public:
   // var
   virtual int def_var(string name, PISM_IO_Type nctype, vector<string> dims) const = 0;
 
+  virtual int def_var_chunking(string name, vector<size_t> &dimensions) const;
+
+  virtual int def_var_deflate(string name, int shuffle, int deflate_level) const;
+
   virtual int get_vara_double(string variable_name,
                               vector<unsigned int> start,
                               vector<unsigned int> count,
@@ -261,7 +261,7 @@ PetscErrorCode PISMOptionsList(MPI_Comm com, string opt, string description, set
 }
 
 //! \brief Process a command-line option taking a string as an argument.
-PetscErrorCode PISMOptionsString(string option, string text,
+PetscErrorCode PISMOptionsString(MPI_Comm com, string option, string text,
 				 string &result, bool &is_set, bool allow_empty_arg) {
   PetscErrorCode ierr;
   char tmp[TEMPORARY_STRING_LENGTH];
@@ -278,7 +278,7 @@ PetscErrorCode PISMOptionsString(string option, string text,
       if (allow_empty_arg)
         result.clear();
       else {
-        ierr = PetscPrintf(PETSC_COMM_WORLD,
+        ierr = PetscPrintf(com,
                            "ERROR: command line option '%s' requires an argument.\n",
                            option.c_str()); CHKERRQ(ierr);
         PISMEnd();
@@ -291,7 +291,7 @@ PetscErrorCode PISMOptionsString(string option, string text,
 }
 
 //! PISM wrapper replacing PetscOptionsStringArray.
-PetscErrorCode PISMOptionsStringArray(string opt, string text, string default_value,
+PetscErrorCode PISMOptionsStringArray(MPI_Comm com, string opt, string text, string default_value,
 				      vector<string>& result, bool &flag) {
   PetscErrorCode ierr;
   char tmp[TEMPORARY_STRING_LENGTH];
@@ -309,7 +309,7 @@ PetscErrorCode PISMOptionsStringArray(string opt, string text, string default_va
       result.push_back(word);
 
     if (result.empty()) {
-      ierr = PetscPrintf(PETSC_COMM_WORLD,
+      ierr = PetscPrintf(com,
                          "ERROR: command line option '%s' requires an argument.\n",
                          opt.c_str()); CHKERRQ(ierr);
       PISMEnd();
@@ -328,7 +328,7 @@ PetscErrorCode PISMOptionsStringArray(string opt, string text, string default_va
 }
 
 //! \brief Process a command-line option taking an integer as an argument.
-PetscErrorCode PISMOptionsInt(string option, string text,
+PetscErrorCode PISMOptionsInt(MPI_Comm com, string option, string text,
 			      PetscInt &result, bool &is_set) {
   PetscErrorCode ierr;
   char str[TEMPORARY_STRING_LENGTH];
@@ -344,7 +344,7 @@ PetscErrorCode PISMOptionsInt(string option, string text,
     return 0;
 
   if (strlen(str) == 0) {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,
+    ierr = PetscPrintf(com,
                        "ERROR: command line option '%s' requires an argument.\n",
                        option.c_str()); CHKERRQ(ierr);
     PISMEnd();
@@ -352,7 +352,7 @@ PetscErrorCode PISMOptionsInt(string option, string text,
 
   result = (int) strtol(str, &endptr, 10);
   if (*endptr != '\0') {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,
+    ierr = PetscPrintf(com,
                        "PISM ERROR: Can't parse \"%s %s\": (%s is not a number).\n",
                        option.c_str(), str, str); CHKERRQ(ierr);
     PISMEnd();
@@ -362,7 +362,7 @@ PetscErrorCode PISMOptionsInt(string option, string text,
 }
 
 //! \brief Process a command-line option taking a real number as an argument.
-PetscErrorCode PISMOptionsReal(string option, string text,
+PetscErrorCode PISMOptionsReal(MPI_Comm com, string option, string text,
 			       PetscReal &result, bool &is_set) {
   PetscErrorCode ierr;
   char str[TEMPORARY_STRING_LENGTH];
@@ -381,7 +381,7 @@ PetscErrorCode PISMOptionsReal(string option, string text,
     return 0;
 
   if (strlen(str) == 0) {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,
+    ierr = PetscPrintf(com,
                        "ERROR: command line option '%s' requires an argument.\n",
                        option.c_str()); CHKERRQ(ierr);
     PISMEnd();
@@ -389,7 +389,7 @@ PetscErrorCode PISMOptionsReal(string option, string text,
 
   result = strtod(str, &endptr);
   if (*endptr != '\0') {
-    ierr = PetscPrintf(PETSC_COMM_WORLD,
+    ierr = PetscPrintf(com,
                        "PISM ERROR: Can't parse \"%s %s\": (%s is not a number).\n",
                        option.c_str(), str, str); CHKERRQ(ierr);
     PISMEnd();
@@ -399,7 +399,7 @@ PetscErrorCode PISMOptionsReal(string option, string text,
 }
 //! \brief Process a command-line option taking a comma-separated list of reals
 //! as an argument.
-PetscErrorCode PISMOptionsRealArray(string option, string text,
+PetscErrorCode PISMOptionsRealArray(MPI_Comm com, string option, string text,
 				    vector<PetscReal> &result, bool &is_set) {
   PetscErrorCode ierr;
   char str[TEMPORARY_STRING_LENGTH];
@@ -422,7 +422,7 @@ PetscErrorCode PISMOptionsRealArray(string option, string text,
 
       d = strtod(tmp.c_str(), &endptr);
       if (*endptr != '\0') {
-	ierr = PetscPrintf(PETSC_COMM_WORLD,
+	ierr = PetscPrintf(com,
 			   "PISM ERROR: Can't parse %s (%s is not a number).\n",
 			   tmp.c_str(), tmp.c_str()); CHKERRQ(ierr);
 	PISMEnd();
@@ -437,12 +437,12 @@ PetscErrorCode PISMOptionsRealArray(string option, string text,
 
 //! \brief Process a command-line option taking a comma-separated list of
 //! integers as an argument.
-PetscErrorCode PISMOptionsIntArray(string option, string text,
+PetscErrorCode PISMOptionsIntArray(MPI_Comm com, string option, string text,
 				    vector<PetscInt> &result, bool &is_set) {
   PetscErrorCode ierr;
   vector<PetscReal> tmp;
 
-  ierr = PISMOptionsRealArray(option, text, tmp, is_set); CHKERRQ(ierr);
+  ierr = PISMOptionsRealArray(com, option, text, tmp, is_set); CHKERRQ(ierr);
 
   result.clear();
   for (unsigned int j = 0; j < tmp.size(); ++j)
@@ -509,9 +509,9 @@ PetscErrorCode init_config(MPI_Comm com, PetscMPIInt rank,
   
   ierr = PetscOptionsBegin(com, "", "PISM config file options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-config", "Specifies the name of an alternative config file",
+    ierr = PISMOptionsString(com, "-config", "Specifies the name of an alternative config file",
 			     alt_config, use_alt_config); CHKERRQ(ierr);
-    ierr = PISMOptionsString("-config_override", "Specifies a config override file name",
+    ierr = PISMOptionsString(com, "-config_override", "Specifies a config override file name",
 			     override_config, use_override_config); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
@@ -541,6 +541,8 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
   // Energy modeling
   ierr = config.flag_from_option("varc", "use_linear_in_temperature_heat_capacity");  CHKERRQ(ierr);
   ierr = config.flag_from_option("vark", "use_temperature_dependent_thermal_conductivity");  CHKERRQ(ierr);
+  ierr = config.flag_from_option("varc_tabulated", "enthalpy_converter_tabulated");  CHKERRQ(ierr);
+  ierr = config.scalar_from_option("varc_table_tolerance", "enthalpy_converter_table_tolerance");  CHKERRQ(ierr);
 
   // see getBasalWaterPressure()
   ierr = config.flag_from_option("bmr_enhance",
@@ -559,6 +561,10 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
   ierr = config.scalar_from_option("low_temp", "global_min_allowed_temp"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("max_low_temps", "max_low_temp_count"); CHKERRQ(ierr);
 
+  ierr = config.scalar_from_option("threads", "threads_per_process"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("halo_overlap", "halo_exchange_overlap"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("halo_width", "iterative_halo_width"); CHKERRQ(ierr);
+
   // Sub-models
   ierr = config.flag_from_option("blatter", "do_blatter"); CHKERRQ(ierr);
   ierr = config.flag_from_option("age", "do_age"); CHKERRQ(ierr);
@@ -575,12 +581,25 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
   ierr = config.scalar_from_option("adapt_ratio",
 				   "adaptive_timestepping_ratio"); CHKERRQ(ierr);
 
+  ierr = config.flag_from_option("implicit_mass", "mass_continuity_implicit"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("implicit_mass_dt_factor",
+                                   "mass_continuity_implicit_dt_factor"); CHKERRQ(ierr);
+
+  ierr = config.flag_from_option("semi_lagrangian", "semi_lagrangian_advection"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("semi_lagrangian_cfl", "semi_lagrangian_cfl_factor"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("fuse_energy_age", "fuse_energy_age_steps"); CHKERRQ(ierr);
   ierr = config.flag_from_option("count_steps", "count_time_steps"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("prelim_restore_from_memory",
+                                 "preliminary_step_restore_from_memory"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("max_dt", "maximum_time_step_years"); CHKERRQ(ierr);
 
 	// evaluates the adaptive timestep based on a CFL criterion with respect to the eigenCalving rate
   ierr = config.flag_from_option("cfl_eigencalving", "cfl_eigencalving"); CHKERRQ(ierr);
 
+  // Lingle-Clark bed deformation model
+  ierr = config.flag_from_option("lc_elastic", "bed_def_lc_elastic_model"); CHKERRQ(ierr);
+  ierr = config.string_from_option("lc_elastic_cache", "bed_def_lc_elastic_cache_dir"); CHKERRQ(ierr);
+
 
   // SIA
   ierr = config.scalar_from_option("bed_smoother_range", "bed_smoother_range"); CHKERRQ(ierr);
@@ -601,6 +620,9 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
   // SSA
   // Decide on the algorithm for solving the SSA
   ierr = config.keyword_from_option("ssa_method", "ssa_method", "fd,fem"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("ssa_fem_matrix_free", "ssa_fem_matrix_free"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("ssa_fem_picard_pc", "ssa_fem_matrix_free_picard_pc"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("ssa_mg_levels", "ssa_multigrid_levels"); CHKERRQ(ierr);
 
   ierr = config.scalar_from_option("ssa_eps",  "epsilon_ssa"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("ssa_maxi", "max_iterations_ssafd"); CHKERRQ(ierr);
@@ -686,6 +708,16 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
 
   ierr = config.keyword_from_option("o_format", "output_format",
                                     "netcdf3,netcdf4_parallel,pnetcdf"); CHKERRQ(ierr);
+  ierr = config.keyword_from_option("o_chunking", "output_chunking",
+                                    "processor,netcdf"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("o_compression", "output_compression_level"); CHKERRQ(ierr);
+  ierr = config.flag_from_option("o_shuffle", "output_compression_shuffle"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("o_float_digits", "output_float_significant_digits"); CHKERRQ(ierr);
+
+  // Climate forcing
+  ierr = config.flag_from_option("forcing_float", "climate_forcing_single_precision"); CHKERRQ(ierr);
+  ierr = config.keyword_from_option("backup_format", "backup_format",
+                                    "netcdf,binary"); CHKERRQ(ierr);
 
   ierr = config.scalar_from_option("summary_volarea_scale_factor_log10",
                                    "summary_volarea_scale_factor_log10"); CHKERRQ(ierr);
@@ -699,6 +731,9 @@ PetscErrorCode set_config_from_options(MPI_Comm /*com*/, NCConfigVariable &confi
   // Skipping
   ierr = config.flag_from_option("skip", "do_skip"); CHKERRQ(ierr);
   ierr = config.scalar_from_option("skip_max", "skip_max"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("yield_stress_interval", "yield_stress_update_interval_years"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("coupler_interval", "coupler_update_interval_years"); CHKERRQ(ierr);
+  ierr = config.scalar_from_option("iceberg_removal_interval", "iceberg_removal_interval_years"); CHKERRQ(ierr);
 
   // Shortcuts
 
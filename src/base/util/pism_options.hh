@@ -34,19 +34,19 @@ PetscErrorCode verbosityLevelFromOptions();
 PetscErrorCode PISMOptionsList(MPI_Comm com, string opt, string text, set<string> choices,
 			       string default_value, string &result, bool &flag);
 
-PetscErrorCode PISMOptionsString(string option, string text,
+PetscErrorCode PISMOptionsString(MPI_Comm com, string option, string text,
 				 string &result, bool &flag, bool allow_empty_arg = false);
-PetscErrorCode PISMOptionsStringArray(string opt, string text, string default_value,
+PetscErrorCode PISMOptionsStringArray(MPI_Comm com, string opt, string text, string default_value,
 				      vector<string>& result, bool &flag);
 
-PetscErrorCode PISMOptionsInt(string option, string text,
+PetscErrorCode PISMOptionsInt(MPI_Comm com, string option, string text,
 			      PetscInt &result, bool &is_set);
-PetscErrorCode PISMOptionsIntArray(string option, string text,
+PetscErrorCode PISMOptionsIntArray(MPI_Comm com, string option, string text,
 				   vector<PetscInt> &result, bool &is_set);
 
-PetscErrorCode PISMOptionsReal(string option, string text,
+PetscErrorCode PISMOptionsReal(MPI_Comm com, string option, string text,
 			       PetscReal &result, bool &is_set);
-PetscErrorCode PISMOptionsRealArray(string option, string text,
+PetscErrorCode PISMOptionsRealArray(MPI_Comm com, string option, string text,
 				    vector<PetscReal> &result, bool &is_set);
 
 PetscErrorCode PISMOptionsIsSet(string option, bool &result);
@@ -0,0 +1,48 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "pism_threads.hh"
+#include "pism_const.hh"
+
+//! \brief Set the number of threads (per MPI process) used by thread-parallel
+//! loops.
+/*!
+ * If \c N is zero the OpenMP default (usually set using the OMP_NUM_THREADS
+ * environment variable) is used.
+ */
+PetscErrorCode pism_set_threads(MPI_Comm com, int N) {
+  PetscErrorCode ierr;
+
+#if (PISM_USE_OPENMP==1)
+  if (N > 0)
+    omp_set_num_threads(N);
+
+  if (pism_max_threads() > 1) {
+    ierr = verbPrintf(2, com, "* Using %d threads per process in column physics loops.\n",
+                      pism_max_threads()); CHKERRQ(ierr);
+  }
+#else
+  if (N > 1) {
+    ierr = verbPrintf(2, com,
+                      "PISM WARNING: PISM was built without OpenMP; ignoring -threads %d.\n",
+                      N); CHKERRQ(ierr);
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef __pism_threads_hh
+#define __pism_threads_hh
+
+#include <petsc.h>
+
+#if (PISM_USE_OPENMP==1)
+#include <omp.h>
+#endif
+
+//! \file pism_threads.hh Helpers for thread-parallel (OpenMP) column loops.
+/*!
+ * Column physics loops (energy, age, bedrock temperature, SIA flux) are
+ * thread-parallel if PISM is built with Pism_USE_OPENMP. Each thread uses
+ * its own column system and work space, and every grid point is updated by
+ * exactly one thread, so results do not depend on the number of threads.
+ *
+ * All the MPI communication happens outside of parallel regions.
+ */
+
+//! \brief Maximum number of threads a parallel region can use (1 if PISM
+//! was built without OpenMP).
+inline int pism_max_threads() {
+#if (PISM_USE_OPENMP==1)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+//! \brief Number of threads in the current parallel region.
+inline int pism_num_threads() {
+#if (PISM_USE_OPENMP==1)
+  return omp_get_num_threads();
+#else
+  return 1;
+#endif
+}
+
+//! \brief Index of the current thread (0 outside of parallel regions).
+inline int pism_thread_id() {
+#if (PISM_USE_OPENMP==1)
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//! \brief Splits the range [begin, end) into contiguous blocks (one per
+//! thread); sets [a, b) to the block of the current thread.
+inline void pism_thread_range(int begin, int end, int &a, int &b) {
+  const int n = pism_num_threads(), t = pism_thread_id(), length = end - begin;
+  a = begin + (length * t) / n;
+  b = begin + (length * (t + 1)) / n;
+}
+
+//! \brief Replaces CHKERRQ() in the body of a thread-parallel loop.
+/*!
+ * One cannot return from a parallel region, so the error code is stored in
+ * \c result (use one per thread) and the rest of the current iteration of
+ * the *innermost* enclosing loop is skipped. Stored codes have to be checked
+ * after the parallel region.
+ *
+ * Use this in the body of a loop over grid points (columns) only. Inside a
+ * loop nested in it (over levels, directions, etc) use
+ * PISM_THREAD_CHKERRQ_BREAK() instead.
+ */
+#define PISM_THREAD_CHKERRQ(ierr, result)                      \
+  if ((ierr) != 0) { (result) = (ierr); continue; } else (void)0
+
+//! \brief Replaces CHKERRQ() in a loop nested in the body of a
+//! thread-parallel loop.
+/*!
+ * Stores the error code in \c result and leaves the innermost enclosing
+ * loop. Follow that loop with PISM_THREAD_CHKERRQ(result, result) to skip
+ * the rest of the current grid point, too.
+ */
+#define PISM_THREAD_CHKERRQ_BREAK(ierr, result)                \
+  if ((ierr) != 0) { (result) = (ierr); break; } else (void)0
+
+PetscErrorCode pism_set_threads(MPI_Comm com, int N);
+
+#endif /* __pism_threads_hh */
@@ -19,9 +19,62 @@
 
 #include "pism_const.hh"
 #include "varcEnthalpyConverter.hh"
+#include "NCVariable.hh"
 
 #include "pism_petsc32_compat.hh"
 
+varcEnthalpyConverter::varcEnthalpyConverter(const NCConfigVariable &config)
+  : EnthalpyConverter(config),
+    T_r(256.81786846822),
+    c_gradient(7.253)
+{
+  inline_pointwise = false;
+
+  tabulated   = false;
+  table_dE    = 0.0;
+  table_E_max = 0.0;
+
+  if (config.get_flag("enthalpy_converter_tabulated"))
+    build_table(config.get("enthalpy_converter_table_tolerance"));
+}
+
+
+//! Tabulate the temperature of cold ice as a function of enthalpy.
+/*!
+Linear interpolation of \f$T(E)\f$ (see TfromE()) with spacing \f$h\f$ has
+the error of at most
+  \f[ \frac{h^2}{8}\max|T''(E)| = \frac{h^2}{8} \frac{7.253}{C(T_0)^3}, \f]
+because \f$T'(E) = 1/C(T)\f$, \f$T''(E) = -7.253 / C(T)^3\f$ and \f$C(T)\f$
+is smallest at \f$T_0\f$ (the lowest temperature corresponding to a
+non-negative enthalpy).  We choose \f$h\f$ so that this error does not exceed
+\c tolerance (in Kelvin).
+
+The table covers cold ice at all pressures, i.e. enthalpies from zero to
+\f$E(T_{melting})\f$.
+ */
+void varcEnthalpyConverter::build_table(double tolerance) {
+  const double C_min = c_i + c_gradient * (T_0 - T_r);
+
+  if (tolerance <= 0.0 || C_min <= 0.0) {
+    tabulated = false;
+    return;
+  }
+
+  table_dE    = sqrt(8.0 * tolerance * C_min * C_min * C_min / c_gradient);
+  table_E_max = EfromT(T_melting);
+
+  // the table has to include the point E = table_E_max:
+  const int N = (int)ceil(table_E_max / table_dE) + 2;
+
+  tabulated = false;            // use the exact formula to fill the table
+  T_table.resize(N);
+  for (int k = 0; k < N; ++k)
+    T_table[k] = TfromE(k * table_dE);
+
+  tabulated = true;
+}
+
+
 /*!
 A calculation only used in the cold case.
 
@@ -64,9 +117,17 @@ Of course, \f$T=T_0 + \Delta T\f$.
  */
 double varcEnthalpyConverter::TfromE(double E) const {
   if (E < 0.0) {
-    PetscPrintf(PETSC_COMM_WORLD,"\n\nE < 0 in varcEnthalpyConverter is not allowed.  FIXME.\n\n");
+    // TfromE() is called point-wise by one process, so report on that one
+    PetscPrintf(PETSC_COMM_SELF,"\n\nE < 0 in varcEnthalpyConverter is not allowed.  FIXME.\n\n");
     PISMEnd();
   }
+
+  if (tabulated && E < table_E_max) {
+    const double x = E / table_dE;
+    const int k = (int)x;
+    return T_table[k] + (x - k) * (T_table[k+1] - T_table[k]);
+  }
+
   const double
     ALPHA = 2.0 / c_gradient,
     BETA  = ALPHA * c_i + 2.0 * (T_0 - T_r),
@@ -81,7 +142,7 @@ PetscErrorCode varcEnthalpyConverter::viewConstants(PetscViewer viewer) const {
 
   PetscBool iascii;
   if (!viewer) {
-    ierr = PetscViewerASCIIGetStdout(PETSC_COMM_WORLD,&viewer); CHKERRQ(ierr);
+    ierr = PetscViewerASCIIGetStdout(com,&viewer); CHKERRQ(ierr);
   }
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii); CHKERRQ(ierr);
   if (!iascii) { SETERRQ(PETSC_COMM_SELF, 1,"Only ASCII viewer for EnthalpyConverter\n"); }
@@ -92,7 +153,14 @@ PetscErrorCode varcEnthalpyConverter::viewConstants(PetscViewer viewer) const {
   ierr = PetscViewerASCIIPrintf(viewer,
       "   T_r   = %12.5f (K)\n",         T_r); CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,
-      "   c_gradient = %12.8f  >\n",    c_gradient); CHKERRQ(ierr);
+      "   c_gradient = %12.8f\n",    c_gradient); CHKERRQ(ierr);
+  if (tabulated) {
+    ierr = PetscViewerASCIIPrintf(viewer,
+      "   T(E) is tabulated: %d entries, dE = %8.3f (J kg-1)\n",
+      (int)T_table.size(), table_dE); CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,
+      ">\n"); CHKERRQ(ierr);
 
   ierr = EnthalpyConverter::viewConstants(viewer); CHKERRQ(ierr);
   return 0;
@@ -154,3 +222,90 @@ PetscErrorCode varcEnthalpyConverter::getEnth(
   return 0;
 }
 
+
+//! Redefined from EnthalpyConverter version, for use when specific heat capacity depends on temperature.
+/*!
+Calls EfromT() and TfromE(); see EnthalpyConverter::getAbsTempColumn().
+ */
+PetscErrorCode varcEnthalpyConverter::getAbsTempColumn(const double *E, double thickness,
+                                                       const double *z, int n, double *T) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      T_m = T_melting - beta * p,
+      E_s = EfromT(T_m);
+
+    if (E[k] < E_s) {
+      T[k] = TfromE(E[k]);
+    } else {
+      T[k] = T_m;
+      if (E[k] >= E_s + L)
+        result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Redefined from EnthalpyConverter version, for use when specific heat capacity depends on temperature.
+/*!
+Calls EfromT() and TfromE(); see EnthalpyConverter::getPATempColumn().
+ */
+PetscErrorCode varcEnthalpyConverter::getPATempColumn(const double *E, double thickness,
+                                                      const double *z, int n, double *T_pa) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      T_m = T_melting - beta * p,
+      E_s = EfromT(T_m);
+
+    if (E[k] < E_s) {
+      T_pa[k] = TfromE(E[k]) - T_m + T_melting;
+    } else {
+      T_pa[k] = T_melting;
+      if (E[k] >= E_s + L)
+        result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Redefined from EnthalpyConverter version, for use when specific heat capacity depends on temperature.
+/*!
+Calls EfromT(); see EnthalpyConverter::getWaterFractionColumn().
+ */
+PetscErrorCode varcEnthalpyConverter::getWaterFractionColumn(const double *E, double thickness,
+                                                             const double *z, int n, double *omega) const {
+  PetscErrorCode result = 0;
+  for (int k = 0; k < n; ++k) {
+    const double
+      p   = getPressureFromDepth(thickness - z[k]), // FIXME issue #15
+      E_s = EfromT(T_melting - beta * p);
+
+    if (E[k] <= E_s) {
+      omega[k] = 0.0;
+    } else if (E[k] < E_s + L) {
+      omega[k] = (E[k] - E_s) / L;
+    } else {
+      omega[k] = 1.0;
+      result = 1;
+    }
+  }
+  return result;
+}
+
+
+//! Redefined from EnthalpyConverter version, for use when specific heat capacity depends on temperature.
+/*!
+Calls EfromT().
+ */
+void varcEnthalpyConverter::getEnthalpyCTSColumn(double thickness, const double *z, int n,
+                                                 double *E_s) const {
+  for (int k = 0; k < n; ++k) {
+    const double p = getPressureFromDepth(thickness - z[k]); // FIXME issue #15
+    E_s[k] = EfromT(T_melting - beta * p);
+  }
+}
@@ -19,6 +19,7 @@
 #ifndef __varcEnthalpyConverter_hh
 #define __varcEnthalpyConverter_hh
 
+#include <vector>
 #include "enthalpyConverter.hh"
 
 //! Enthalpy converter based on specific heat which is linear in temperature.
@@ -29,15 +30,14 @@ Equation (4.39) in [\ref GreveBlatter2009],
         \f[ C(T) = 146.3 + 7.253 T = c_i + 7.253 (T - T_r) \f]
 where \f$T\f$ is in Kelvin, \f$c_i = 2009\,\, \text{J}\,\text{kg}^{-1}\,\text{K}^{-1}\f$,
 and the reference temperature is \f$T_r = 256.81786846822\f$ K.
+
+If the configuration flag \c enthalpy_converter_tabulated is set, the
+temperature of cold ice is computed by linear interpolation from a table
+instead of solving a quadratic equation; see build_table().
  */
 class varcEnthalpyConverter : public EnthalpyConverter {
 public:
-  varcEnthalpyConverter(const NCConfigVariable &config)
-    : EnthalpyConverter(config),
-      T_r(256.81786846822),
-      c_gradient(7.253)
-  {
-  }
+  varcEnthalpyConverter(const NCConfigVariable &config);
   virtual ~varcEnthalpyConverter() {}
 
   virtual PetscErrorCode viewConstants(PetscViewer viewer) const;
@@ -48,6 +48,15 @@ public:
 
   virtual PetscErrorCode getEnth(double T, double omega, double p, double &E) const;
 
+  virtual PetscErrorCode getAbsTempColumn(const double *E, double thickness,
+                                          const double *z, int n, double *T) const;
+  virtual PetscErrorCode getPATempColumn(const double *E, double thickness,
+                                         const double *z, int n, double *T_pa) const;
+  virtual PetscErrorCode getWaterFractionColumn(const double *E, double thickness,
+                                                const double *z, int n, double *omega) const;
+  virtual void           getEnthalpyCTSColumn(double thickness, const double *z, int n,
+                                              double *E_s) const;
+
   /*!
     Equation (4.39) in [\ref GreveBlatter2009] is
     \f$C(T) = c_i + 7.253 (T - T_r)\f$, with a reference temperature
@@ -69,6 +78,13 @@ protected:
                      //!< the parameterization of C(T)
   double EfromT(double T) const;
   double TfromE(double E) const;
+
+  void build_table(double tolerance);
+
+  bool tabulated;               //!< true if TfromE() uses the table below
+  std::vector<double> T_table;  //!< temperatures at E = k * table_dE
+  double table_dE,              //!< enthalpy spacing of T_table
+    table_E_max;                //!< the table is used if 0 <= E < table_E_max
 };
 
 #endif // __varcEnthalpyConverter_hh
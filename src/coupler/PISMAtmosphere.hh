@@ -22,6 +22,7 @@
 
 #include "PISMComponent.hh"
 class IceModelVec2S;
+class PCellOperations;
 
 ///// PISMAtmosphereModel: models which provide precipitation and temperature
 /////                      to the PISMSurfaceModel below
@@ -41,15 +42,40 @@ public:
   virtual PetscErrorCode begin_pointwise_access() = 0;
   virtual PetscErrorCode end_pointwise_access() = 0;
 
+  //! \brief Prepares to compute time-series of near-surface air temperature
+  //! at N times ts (in seconds). Has to be called after update() and before
+  //! temp_time_series().
+  /*!
+   * Models should do all the work that depends on times only (but not on
+   * the grid point) here.
+   */
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N)
+  {
+    ts_times.assign(ts, ts + N);
+    return 0;
+  }
+
   //! \brief Sets a pre-allocated N-element array "values" to the time-series
   //! of near-surface air temperature (degrees Kelvin) at the point i,j on the
-  //! grid. Times (in years) are specified in ts. NB! Has to be surrounded by
-  //! begin_pointwise_access() and end_pointwise_access()
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values) = 0;
+  //! grid. Times are specified using init_timeseries(). NB! Has to be
+  //! surrounded by begin_pointwise_access() and end_pointwise_access()
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values) = 0;
   //! \brief Sets result to a snapshot of temperature for the current time.
   //! (For diagnostic purposes.)
   virtual PetscErrorCode temp_snapshot(IceModelVec2S &result) = 0;
+
+  //! \brief Versions of mean_precipitation(), mean_annual_temp() and
+  //! temp_snapshot() that may leave some per-cell operations in ops for the
+  //! caller to apply (see PCellOperations). Models compute the whole field;
+  //! modifiers re-implement these to fuse their corrections.
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &)
+  { return mean_precipitation(result); }
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &)
+  { return mean_annual_temp(result); }
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &)
+  { return temp_snapshot(result); }
+protected:
+  vector<PetscReal> ts_times;   //!< times used by temp_time_series(), in seconds
 };
 
 #endif	// __PISMAtmosphere_hh
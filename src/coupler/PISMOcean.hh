@@ -22,6 +22,7 @@
 
 #include "PISMComponent.hh"
 class IceModelVec2S;
+class PCellOperations;
 
 //! A very rudimentary PISM ocean model.
 class PISMOceanModel : public PISMComponent_TS {
@@ -33,6 +34,14 @@ public:
   virtual PetscErrorCode sea_level_elevation(PetscReal &result) = 0;
   virtual PetscErrorCode shelf_base_temperature(IceModelVec2S &result) = 0;
   virtual PetscErrorCode shelf_base_mass_flux(IceModelVec2S &result) = 0;
+
+  //! \brief Versions of shelf_base_temperature() and shelf_base_mass_flux()
+  //! that may leave some per-cell operations in ops for the caller to apply
+  //! (see PCellOperations).
+  virtual PetscErrorCode shelf_base_temperature_deferred(IceModelVec2S &result, PCellOperations &)
+  { return shelf_base_temperature(result); }
+  virtual PetscErrorCode shelf_base_mass_flux_deferred(IceModelVec2S &result, PCellOperations &)
+  { return shelf_base_mass_flux(result); }
 protected:
   PetscReal sea_level;
 };
@@ -29,6 +29,7 @@
 
 class PISMAtmosphereModel;
 class IceModelVec2S;
+class PCellOperations;
 
 //! \brief The interface of PISM's surface models.
 class PISMSurfaceModel : public PISMComponent_TS {
@@ -44,6 +45,11 @@ public:
   virtual PetscErrorCode mass_held_in_surface_layer(IceModelVec2S &result);
   virtual PetscErrorCode surface_layer_thickness(IceModelVec2S &result);
 
+  // versions of the above that may leave some per-cell operations in ops
+  // for the caller to apply (see PCellOperations):
+  virtual PetscErrorCode ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops);
+  virtual PetscErrorCode ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops);
+
   // provide default re-implementations of these parent's methods:
   virtual PetscErrorCode init(PISMVars &vars);
   virtual void get_diagnostics(map<string, PISMDiagnostic*> &dict);
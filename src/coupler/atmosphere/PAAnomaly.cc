@@ -76,22 +76,22 @@ PetscErrorCode PAAnomaly::update(PetscReal my_t, PetscReal my_dt) {
 }
 
 
-PetscErrorCode PAAnomaly::mean_precipitation(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->mean_precipitation(result); CHKERRQ(ierr);
-
-  return result.add(1.0, mass_flux);
+PetscErrorCode PAAnomaly::mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_precipitation_deferred(result, ops); CHKERRQ(ierr);
+  ops.add(mass_flux);
+  return 0;
 }
 
-PetscErrorCode PAAnomaly::mean_annual_temp(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->mean_annual_temp(result); CHKERRQ(ierr);
-
-  return result.add(1.0, temp);
+PetscErrorCode PAAnomaly::mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_annual_temp_deferred(result, ops); CHKERRQ(ierr);
+  ops.add(temp);
+  return 0;
 }
 
-PetscErrorCode PAAnomaly::temp_snapshot(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->temp_snapshot(result); CHKERRQ(ierr);
-
-  return result.add(1.0, temp);
+PetscErrorCode PAAnomaly::temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->temp_snapshot_deferred(result, ops); CHKERRQ(ierr);
+  ops.add(temp);
+  return 0;
 }
 
 
@@ -105,22 +105,17 @@ PetscErrorCode PAAnomaly::end_pointwise_access() {
   return temp.end_access();
 }
 
-PetscErrorCode PAAnomaly::temp_time_series(int i, int j, int N,
-                                           PetscReal *ts, PetscReal *values) {
+PetscErrorCode PAAnomaly::init_timeseries(PetscReal *ts, unsigned int N) {
   PetscErrorCode ierr;
+  PetscReal *ptr;
 
   // NB! the input_model uses un-periodized times.
-  ierr = input_model->temp_time_series(i, j, N, ts, values); CHKERRQ(ierr);
-
-  PetscReal *ptr;
+  ierr = PAModifier::init_timeseries(ts, N); CHKERRQ(ierr);
 
   if (bc_period > 0.01) {
-    // Recall that this method is called for each map-plane point during a
-    // time-step. This if-condition is here to avoid calling
-    // grid.time->mod() if the user didn't ask for periodized climate.
-    ts_mod.reserve(N);
+    ts_mod.resize(N);
 
-    for (int k = 0; k < N; ++k)
+    for (unsigned int k = 0; k < N; ++k)
       ts_mod[k] = grid.time->mod(ts[k] - bc_reference_time, bc_period);
 
     ptr = &ts_mod[0];
@@ -128,10 +123,21 @@ PetscErrorCode PAAnomaly::temp_time_series(int i, int j, int N,
     ptr = ts;
   }
 
-  ts_values.reserve(N);
-  ierr = temp.interp(i, j, N, ptr, &ts_values[0]); CHKERRQ(ierr);
+  ierr = temp.init_interpolation(ptr, N); CHKERRQ(ierr);
+
+  ts_values.resize(N);
+
+  return 0;
+}
+
+PetscErrorCode PAAnomaly::temp_time_series(int i, int j, PetscReal *values) {
+  PetscErrorCode ierr;
+
+  ierr = input_model->temp_time_series(i, j, values); CHKERRQ(ierr);
+
+  ierr = temp.interp(i, j, &ts_values[0]); CHKERRQ(ierr);
 
-  for (int k = 0; k < N; ++k)
+  for (unsigned int k = 0; k < ts_values.size(); ++k)
     values[k] += ts_values[k];
 
   return 0;
@@ -37,14 +37,14 @@ public:
   PetscErrorCode init(PISMVars &vars);
   PetscErrorCode update(PetscReal my_t, PetscReal my_dt);
 
-  virtual PetscErrorCode mean_precipitation(IceModelVec2S &result);
-  virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result); 
-  virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops);
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops);
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops);
 
   virtual PetscErrorCode begin_pointwise_access();
   virtual PetscErrorCode end_pointwise_access();
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values);
 
   virtual void add_vars_to_output(string keyword,
                                   map<string,NCSpatialVariable> &result);
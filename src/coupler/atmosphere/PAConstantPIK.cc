@@ -44,9 +44,8 @@ PetscErrorCode PAConstantPIK::end_pointwise_access() {
   return 0;
 }
 
-PetscErrorCode PAConstantPIK::temp_time_series(int i, int j, int N,
-                                               PetscReal */*ts*/, PetscReal *values) {
-  for (PetscInt k = 0; k < N; k++)
+PetscErrorCode PAConstantPIK::temp_time_series(int i, int j, PetscReal *values) {
+  for (unsigned int k = 0; k < ts_times.size(); k++)
     values[k] = air_temp(i,j);
   return 0;
 }
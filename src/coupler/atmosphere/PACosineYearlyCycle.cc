@@ -68,12 +68,12 @@ PetscErrorCode PACosineYearlyCycle::init(PISMVars &vars) {
   ierr = PetscOptionsBegin(grid.com, "", "Options controlling '-atmosphere yearly_cycle'",
                            ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsString("-atmosphere_yearly_cycle_file",
-                             "PACosineYearlyCycle input file name",
-                             input_file, input_file_flag); CHKERRQ(ierr);
-    ierr = PISMOptionsString("-atmosphere_yearly_cycle_scaling_file",
-                             "PACosineYearlyCycle amplitude scaling input file name",
-                             scaling_file, scaling_flag); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-atmosphere_yearly_cycle_file",
+                                       "PACosineYearlyCycle input file name",
+                                       input_file, input_file_flag); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-atmosphere_yearly_cycle_scaling_file",
+                                       "PACosineYearlyCycle amplitude scaling input file name",
+                                       scaling_file, scaling_flag); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -157,23 +157,14 @@ PetscErrorCode PACosineYearlyCycle::temp_snapshot(IceModelVec2S &result) {
   return 0;
 }
 
-PetscErrorCode PACosineYearlyCycle::temp_time_series(int i, int j, int N,
-                                                     PetscReal *ts, PetscReal *values) {
-  // constants related to the standard yearly cycle
-  const PetscReal
-    sperd = 8.64e4, // exact number of seconds per day
-    julyday_fraction = (sperd / secpera) * snow_temp_july_day;
-
-  for (PetscInt k = 0; k < N; ++k) {
-    double tk = grid.time->year_fraction(ts[k]) - julyday_fraction,
-      scaling = 1;
+//! \brief Scales the yearly cycle computed by PAYearlyCycle using the
+//! amplitude time-series (if set).
+PetscErrorCode PACosineYearlyCycle::init_timeseries(PetscReal *ts, unsigned int N) {
+  PetscErrorCode ierr = PAYearlyCycle::init_timeseries(ts, N); CHKERRQ(ierr);
 
-    if (A != NULL) {
-      scaling = (*A)(ts[k]);
-    }
-
-    values[k] = air_temp_mean_annual(i,j) +
-      scaling * (air_temp_mean_july(i,j) - air_temp_mean_annual(i,j)) * cos(2.0 * pi * tk);
+  if (A != NULL) {
+    for (unsigned int k = 0; k < N; ++k)
+      cosine_cycle[k] *= (*A)(ts[k]);
   }
 
   return 0;
@@ -31,8 +31,7 @@ public:
 
   virtual PetscErrorCode init(PISMVars &vars);
   virtual PetscErrorCode update(PetscReal my_t, PetscReal my_dt);
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
   virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
 protected:
   Timeseries *A;                 // amplitude scaling
@@ -90,18 +90,16 @@ PetscErrorCode PAGivenClimate::end_pointwise_access() {
   return 0;
 }
 
-PetscErrorCode PAGivenClimate::temp_time_series(int i, int j, int N,
-                                                 PetscReal *ts, PetscReal *values) {
-
+PetscErrorCode PAGivenClimate::init_timeseries(PetscReal *ts, unsigned int N) {
+  PetscErrorCode ierr;
   PetscReal *ptr;
 
+  ierr = PAModifier::init_timeseries(ts, N); CHKERRQ(ierr);
+
   if (bc_period > 0.01) {
-    // Recall that this method is called for each map-plane point during a
-    // time-step. This if-condition is here to avoid calling
-    // grid.time->mod() if the user didn't ask for periodized climate.
-    ts_mod.reserve(N);
+    ts_mod.resize(N);
 
-    for (int k = 0; k < N; ++k)
+    for (unsigned int k = 0; k < N; ++k)
       ts_mod[k] = grid.time->mod(ts[k] - bc_reference_time, bc_period);
 
     ptr = &ts_mod[0];
@@ -109,7 +107,12 @@ PetscErrorCode PAGivenClimate::temp_time_series(int i, int j, int N,
     ptr = ts;
   }
 
-  PetscErrorCode ierr = temp.interp(i, j, N, ptr, values); CHKERRQ(ierr);
+  ierr = temp.init_interpolation(ptr, N); CHKERRQ(ierr);
+
+  return 0;
+}
 
+PetscErrorCode PAGivenClimate::temp_time_series(int i, int j, PetscReal *values) {
+  PetscErrorCode ierr = temp.interp(i, j, values); CHKERRQ(ierr);
   return 0;
 }
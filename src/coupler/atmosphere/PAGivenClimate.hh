@@ -42,10 +42,18 @@ public:
   virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result); 
   virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
 
+  // this is a model, not a modifier: compute whole fields
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMAtmosphereModel::mean_precipitation_deferred(result, ops); }
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMAtmosphereModel::mean_annual_temp_deferred(result, ops); }
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMAtmosphereModel::temp_snapshot_deferred(result, ops); }
+
   virtual PetscErrorCode begin_pointwise_access();
   virtual PetscErrorCode end_pointwise_access();
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values);
 protected:
   vector<PetscReal> ts_mod;
 };
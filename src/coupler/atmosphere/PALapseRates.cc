@@ -31,9 +31,9 @@ PetscErrorCode PALapseRates::init(PISMVars &vars) {
 
   ierr = PetscOptionsBegin(grid.com, "", "Lapse rate options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsReal("-precip_lapse_rate",
-                           "Elevation lapse rate for the surface mass balance, in m/year per km",
-                           precip_lapse_rate, precip_lapse_rate_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-precip_lapse_rate",
+                                     "Elevation lapse rate for the surface mass balance, in m/year per km",
+                                     precip_lapse_rate, precip_lapse_rate_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -63,17 +63,15 @@ PetscErrorCode PALapseRates::init(PISMVars &vars) {
 }
 
 
-PetscErrorCode PALapseRates::mean_precipitation(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-  ierr = input_model->mean_precipitation(result); CHKERRQ(ierr);
-  ierr = lapse_rate_correction(result, precip_lapse_rate); CHKERRQ(ierr);
+PetscErrorCode PALapseRates::mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_precipitation_deferred(result, ops); CHKERRQ(ierr);
+  lapse_rate_correction(ops, precip_lapse_rate);
   return 0;
 }
 
-PetscErrorCode PALapseRates::mean_annual_temp(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-  ierr = input_model->mean_annual_temp(result); CHKERRQ(ierr);
-  ierr = lapse_rate_correction(result, temp_lapse_rate); CHKERRQ(ierr);
+PetscErrorCode PALapseRates::mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_annual_temp_deferred(result, ops); CHKERRQ(ierr);
+  lapse_rate_correction(ops, temp_lapse_rate);
   return 0;
 }
 
@@ -95,26 +93,35 @@ PetscErrorCode PALapseRates::end_pointwise_access() {
 }
 
 
-PetscErrorCode PALapseRates::temp_time_series(int i, int j, int N,
-                                              PetscReal *ts, PetscReal *values) {
+PetscErrorCode PALapseRates::init_timeseries(PetscReal *ts, unsigned int N) {
   PetscErrorCode ierr;
-  vector<PetscScalar> usurf(N);
 
-  ierr = input_model->temp_time_series(i, j, N, ts, values); CHKERRQ(ierr);
+  ierr = PAModifier::init_timeseries(ts, N); CHKERRQ(ierr);
 
-  ierr = reference_surface.interp(i, j, N, ts, &usurf[0]); CHKERRQ(ierr);
+  ierr = reference_surface.init_interpolation(ts, N); CHKERRQ(ierr);
 
-  for (int m = 0; m < N; ++m) {
-    values[m] -= temp_lapse_rate * ((*surface)(i, j) - usurf[m]);
-  }
+  ts_usurf.resize(N);
 
   return 0;
 }
 
-PetscErrorCode PALapseRates::temp_snapshot(IceModelVec2S &result) {
+PetscErrorCode PALapseRates::temp_time_series(int i, int j, PetscReal *values) {
   PetscErrorCode ierr;
-  ierr = input_model->temp_snapshot(result); CHKERRQ(ierr);
-  ierr = lapse_rate_correction(result, temp_lapse_rate); CHKERRQ(ierr);
+
+  ierr = input_model->temp_time_series(i, j, values); CHKERRQ(ierr);
+
+  ierr = reference_surface.interp(i, j, &ts_usurf[0]); CHKERRQ(ierr);
+
+  for (unsigned int m = 0; m < ts_usurf.size(); ++m) {
+    values[m] -= temp_lapse_rate * ((*surface)(i, j) - ts_usurf[m]);
+  }
+
+  return 0;
+}
+
+PetscErrorCode PALapseRates::temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->temp_snapshot_deferred(result, ops); CHKERRQ(ierr);
+  lapse_rate_correction(ops, temp_lapse_rate);
   return 0;
 }
 
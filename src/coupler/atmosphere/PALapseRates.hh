@@ -36,15 +36,15 @@ public:
 
   virtual PetscErrorCode init(PISMVars &vars);
 
-  virtual PetscErrorCode mean_precipitation(IceModelVec2S &result);
-  virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result);
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops);
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops);
 
   virtual PetscErrorCode begin_pointwise_access();
   virtual PetscErrorCode end_pointwise_access();
 
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-                                          PetscReal *ts, PetscReal *values);
-  virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values);
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops);
 
 
   virtual PetscErrorCode define_variables(set<string> vars, const PIO &nc, PISM_IO_Type nctype);
@@ -53,6 +53,8 @@ public:
 protected:
   PetscReal precip_lapse_rate;
   NCSpatialVariable precipitation, air_temp;
+  vector<PetscReal> ts_usurf;   //!< reference surface elevation time-series
+
 };
 
 #endif /* _PALAPSERATES_H_ */
@@ -20,7 +20,17 @@
 #define _PAMODIFIER_H_
 
 #include "PISMAtmosphere.hh"
+#include "PCellOperations.hh"
 
+//! \brief The base class of atmosphere model modifiers.
+/*!
+ * mean_precipitation(), mean_annual_temp() and temp_snapshot() collect the
+ * per-cell operations of the whole stack of modifiers (see the "_deferred"
+ * methods and PCellOperations) and apply them in one sweep. By default the
+ * "_deferred" methods pass the request to the input model; a modifier
+ * re-implementing one of the three methods above in some other way has to
+ * re-implement the corresponding "_deferred" method, too.
+ */
 class PAModifier : public Modifier<PISMAtmosphereModel>
 {
 public:
@@ -29,17 +39,33 @@ public:
   virtual ~PAModifier() {}
 
   virtual PetscErrorCode mean_precipitation(IceModelVec2S &result)
+  {
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = mean_precipitation_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->mean_precipitation(result); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->mean_precipitation_deferred(result, ops); CHKERRQ(ierr);
     }
     return 0;
   }
 
   virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result)
+  {
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = mean_annual_temp_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->mean_annual_temp(result); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->mean_annual_temp_deferred(result, ops); CHKERRQ(ierr);
     }
     return 0;
   }
@@ -60,19 +86,35 @@ public:
     return 0;
   }
 
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values)
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N)
+  {
+    PetscErrorCode ierr = PISMAtmosphereModel::init_timeseries(ts, N); CHKERRQ(ierr);
+    if (input_model != NULL) {
+      ierr = input_model->init_timeseries(ts, N); CHKERRQ(ierr);
+    }
+    return 0;
+  }
+
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->temp_time_series(i, j, N, ts, values); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->temp_time_series(i, j, values); CHKERRQ(ierr);
     }
     return 0;
   }
 
   virtual PetscErrorCode temp_snapshot(IceModelVec2S &result)
+  {
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = temp_snapshot_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->temp_snapshot(result); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->temp_snapshot_deferred(result, ops); CHKERRQ(ierr);
     }
     return 0;
   }
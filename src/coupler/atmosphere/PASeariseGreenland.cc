@@ -60,9 +60,9 @@ PetscErrorCode PA_SeaRISE_Greenland::init(PISMVars &vars) {
     bool delta_T_set;
     string delta_T_file;
 
-    ierr = PISMOptionsString("-paleo_precip",
-                             "Specifies the air temperature offsets file to use with -paleo_precip",
-                             delta_T_file, delta_T_set); CHKERRQ(ierr);
+    ierr = PISMOptionsString(grid.com, "-paleo_precip",
+                                       "Specifies the air temperature offsets file to use with -paleo_precip",
+                                       delta_T_file, delta_T_set); CHKERRQ(ierr);
 
     ierr = verbPrintf(2, grid.com, 
                       "  reading delta_T data from forcing file %s for -paleo_precip actions ...\n",
@@ -156,22 +156,37 @@ PetscErrorCode PAYearlyCycle::mean_annual_temp(IceModelVec2S &result) {
   return 0;
 }
 
-PetscErrorCode PAYearlyCycle::temp_time_series(int i, int j, int N,
-                                               PetscReal *ts, PetscReal *values) {
+//! \brief Evaluates the yearly cycle (which does not depend on the grid
+//! point) at times ts.
+PetscErrorCode PAYearlyCycle::init_timeseries(PetscReal *ts, unsigned int N) {
+  PetscErrorCode ierr;
   // constants related to the standard yearly cycle
   const PetscReal
     sperd = 8.64e4, // exact number of seconds per day
     julyday_fraction = (sperd / secpera) * snow_temp_july_day;
 
-  for (PetscInt k = 0; k < N; ++k) {
+  ierr = PISMAtmosphereModel::init_timeseries(ts, N); CHKERRQ(ierr);
+
+  cosine_cycle.resize(N);
+  for (unsigned int k = 0; k < N; ++k) {
     double tk = grid.time->year_fraction(ts[k]) - julyday_fraction;
-    values[k] = air_temp_mean_annual(i,j) +
-      (air_temp_mean_july(i,j) - air_temp_mean_annual(i,j)) * cos(2.0 * pi * tk);
+    cosine_cycle[k] = cos(2.0 * pi * tk);
   }
 
   return 0;
 }
 
+PetscErrorCode PAYearlyCycle::temp_time_series(int i, int j, PetscReal *values) {
+  const PetscReal
+    mean  = air_temp_mean_annual(i,j),
+    delta = air_temp_mean_july(i,j) - mean;
+
+  for (unsigned int k = 0; k < cosine_cycle.size(); ++k)
+    values[k] = mean + delta * cosine_cycle[k];
+
+  return 0;
+}
+
 PetscErrorCode PAYearlyCycle::temp_snapshot(IceModelVec2S &result) {
   PetscErrorCode ierr;
   const PetscReal
@@ -40,8 +40,8 @@ public:
   virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result);
   virtual PetscErrorCode begin_pointwise_access();
   virtual PetscErrorCode end_pointwise_access();
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-					  PetscReal *ts, PetscReal *values);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values);
   virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
 protected:
   PISMVars *variables;
@@ -49,6 +49,7 @@ protected:
   string reference, precip_filename;
   IceModelVec2S air_temp_mean_annual, air_temp_mean_july, precipitation;
   NCSpatialVariable air_temp_snapshot;
+  vector<PetscReal> cosine_cycle; //!< yearly cycle at times used by temp_time_series()
 };
 
 #endif /* _PAYEARLYCYCLE_H_ */
@@ -54,9 +54,9 @@ PetscErrorCode PA_delta_P::init(PISMVars &vars) {
 }
 
 
-PetscErrorCode PA_delta_P::mean_precipitation(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->mean_precipitation(result);
-  ierr = offset_data(result); CHKERRQ(ierr);
+PetscErrorCode PA_delta_P::mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_precipitation_deferred(result, ops); CHKERRQ(ierr);
+  offset_data(ops);
   return 0;
 }
 
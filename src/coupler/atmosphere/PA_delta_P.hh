@@ -30,7 +30,7 @@ public:
 
   virtual PetscErrorCode init(PISMVars &vars);
 
-  virtual PetscErrorCode mean_precipitation(IceModelVec2S &result);
+  virtual PetscErrorCode mean_precipitation_deferred(IceModelVec2S &result, PCellOperations &ops);
 
   virtual void add_vars_to_output(string keyword,
                                   map<string,NCSpatialVariable> &result);
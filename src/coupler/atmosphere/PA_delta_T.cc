@@ -55,27 +55,35 @@ PetscErrorCode PA_delta_T::init(PISMVars &vars) {
   return 0;
 }
 
-PetscErrorCode PA_delta_T::mean_annual_temp(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->mean_annual_temp(result); CHKERRQ(ierr);
-  ierr = offset_data(result); CHKERRQ(ierr);
+PetscErrorCode PA_delta_T::mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->mean_annual_temp_deferred(result, ops); CHKERRQ(ierr);
+  offset_data(ops);
   return 0;
 }
 
-PetscErrorCode PA_delta_T::temp_time_series(int i, int j, int N,
-                                             PetscReal *ts, PetscReal *values) {
-  PetscErrorCode ierr = input_model->temp_time_series(i, j, N, ts, values); CHKERRQ(ierr);
-  
-  if (offset) {
-    for (int k = 0; k < N; ++k)
-      values[k] += (*offset)(ts[k]);
-  }
+PetscErrorCode PA_delta_T::init_timeseries(PetscReal *ts, unsigned int N) {
+  PetscErrorCode ierr = PAModifier::init_timeseries(ts, N); CHKERRQ(ierr);
+
+  // Evaluate offsets once per call instead of once per grid point:
+  ts_offset.resize(N);
+  for (unsigned int k = 0; k < N; ++k)
+    ts_offset[k] = offset ? (*offset)(ts[k]) : 0.0;
+
+  return 0;
+}
+
+PetscErrorCode PA_delta_T::temp_time_series(int i, int j, PetscReal *values) {
+  PetscErrorCode ierr = input_model->temp_time_series(i, j, values); CHKERRQ(ierr);
+
+  for (unsigned int k = 0; k < ts_offset.size(); ++k)
+    values[k] += ts_offset[k];
 
   return 0;
 }
 
-PetscErrorCode PA_delta_T::temp_snapshot(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->temp_snapshot(result); CHKERRQ(ierr);
-  ierr = offset_data(result); CHKERRQ(ierr);
+PetscErrorCode PA_delta_T::temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->temp_snapshot_deferred(result, ops); CHKERRQ(ierr);
+  offset_data(ops);
   return 0;
 }
 
@@ -30,11 +30,11 @@ public:
 
   virtual PetscErrorCode init(PISMVars &vars);
 
-  virtual PetscErrorCode mean_annual_temp(IceModelVec2S &result);
+  virtual PetscErrorCode mean_annual_temp_deferred(IceModelVec2S &result, PCellOperations &ops);
 
-  virtual PetscErrorCode temp_time_series(int i, int j, int N,
-                                          PetscReal *ts, PetscReal *values);
-  virtual PetscErrorCode temp_snapshot(IceModelVec2S &result);
+  virtual PetscErrorCode init_timeseries(PetscReal *ts, unsigned int N);
+  virtual PetscErrorCode temp_time_series(int i, int j, PetscReal *values);
+  virtual PetscErrorCode temp_snapshot_deferred(IceModelVec2S &result, PCellOperations &ops);
 
   virtual void add_vars_to_output(string keyword,
                                   map<string,NCSpatialVariable> &result);
@@ -46,6 +46,7 @@ public:
 
 protected:
   NCSpatialVariable air_temp, precipitation;
+  vector<PetscReal> ts_offset;  //!< temperature offsets at times used by temp_time_series()
 };
 
 
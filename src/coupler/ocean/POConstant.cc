@@ -50,9 +50,9 @@ PetscErrorCode POConstant::init(PISMVars &vars) {
 
   ierr = PetscOptionsBegin(grid.com, "", "Ocean model", ""); CHKERRQ(ierr);
 
-  ierr = PISMOptionsReal("-shelf_base_melt_rate",
-                          "Specifies a sub shelf ice-equivalent melt rate in meters/year",
-			  mymeltrate, meltrate_set); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-shelf_base_melt_rate",
+                                    "Specifies a sub shelf ice-equivalent melt rate in meters/year",
+          			  mymeltrate, meltrate_set); CHKERRQ(ierr);
 
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
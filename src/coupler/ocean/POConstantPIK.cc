@@ -107,9 +107,9 @@ PetscErrorCode POConstantPIK::shelf_base_mass_flux(IceModelVec2S &result) {
   PetscReal meltfactor = 5e-3;
   bool meltfactorSet;
   double meltfactor_pik;
-  ierr = PISMOptionsReal("-meltfactor_pik",
-                         "Uses as a meltfactor as in sub-shelf-melting parameterization of martin_winkelmann11",
-                         meltfactor_pik, meltfactorSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-meltfactor_pik",
+                                   "Uses as a meltfactor as in sub-shelf-melting parameterization of martin_winkelmann11",
+                                   meltfactor_pik, meltfactorSet); CHKERRQ(ierr);
 
   if (meltfactorSet) {
     meltfactor = meltfactor_pik; // default is 5e-3 as in martin_winkelmann11
@@ -46,6 +46,12 @@ public:
   virtual PetscErrorCode shelf_base_temperature(IceModelVec2S &result);
 
   virtual PetscErrorCode shelf_base_mass_flux(IceModelVec2S &result);
+
+  // this is a model, not a modifier: compute whole fields
+  virtual PetscErrorCode shelf_base_temperature_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMOceanModel::shelf_base_temperature_deferred(result, ops); }
+  virtual PetscErrorCode shelf_base_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMOceanModel::shelf_base_mass_flux_deferred(result, ops); }
 };
 
 
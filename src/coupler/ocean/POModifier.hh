@@ -20,7 +20,15 @@
 #define _POMODIFIER_H_
 
 #include "PISMOcean.hh"
+#include "PCellOperations.hh"
 
+//! \brief The base class of ocean model modifiers.
+/*!
+ * shelf_base_temperature() and shelf_base_mass_flux() apply the per-cell
+ * operations collected by the "_deferred" methods of the stack of modifiers
+ * (see PCellOperations) in one sweep. By default the "_deferred" methods
+ * pass the request to the input model.
+ */
 class POModifier : public Modifier<PISMOceanModel>
 {
 public:
@@ -36,13 +44,29 @@ public:
 
   virtual PetscErrorCode shelf_base_temperature(IceModelVec2S &result)
   {
-    PetscErrorCode ierr = input_model->shelf_base_temperature(result); CHKERRQ(ierr);
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = shelf_base_temperature_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode shelf_base_temperature_deferred(IceModelVec2S &result, PCellOperations &ops)
+  {
+    PetscErrorCode ierr = input_model->shelf_base_temperature_deferred(result, ops); CHKERRQ(ierr);
     return 0;
   }
 
   virtual PetscErrorCode shelf_base_mass_flux(IceModelVec2S &result)
   {
-    PetscErrorCode ierr = input_model->shelf_base_mass_flux(result); CHKERRQ(ierr);
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = shelf_base_mass_flux_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode shelf_base_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops)
+  {
+    PetscErrorCode ierr = input_model->shelf_base_mass_flux_deferred(result, ops); CHKERRQ(ierr);
     return 0;
   }
 };
@@ -55,9 +55,9 @@ PetscErrorCode PO_delta_T::init(PISMVars &vars) {
   return 0;
 }
 
-PetscErrorCode PO_delta_T::shelf_base_temperature(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->shelf_base_temperature(result); CHKERRQ(ierr);
-  ierr = offset_data(result); CHKERRQ(ierr);
+PetscErrorCode PO_delta_T::shelf_base_temperature_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->shelf_base_temperature_deferred(result, ops); CHKERRQ(ierr);
+  offset_data(ops);
   return 0;
 }
 
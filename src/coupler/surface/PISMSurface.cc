@@ -99,6 +99,28 @@ PetscErrorCode PISMSurfaceModel::ice_surface_liquid_water_fraction(IceModelVec2S
   return 0;
 }
 
+//! \brief Computes the climatic mass balance, possibly leaving some per-cell
+//! operations in `ops` for the caller to apply.
+/*!
+ * Surface models compute the whole field. Modifiers (PS_delta_T,
+ * PSAnomaly, PSLapseRates) re-implement this to add their per-cell
+ * corrections to `ops`, so that a stack of modifiers makes one sweep over the
+ * grid instead of one per modifier.
+ */
+PetscErrorCode PISMSurfaceModel::ice_surface_mass_flux_deferred(IceModelVec2S &result,
+                                                                PCellOperations &) {
+  PetscErrorCode ierr = ice_surface_mass_flux(result); CHKERRQ(ierr);
+  return 0;
+}
+
+//! \brief Computes the ice surface temperature, possibly leaving some
+//! per-cell operations in `ops` for the caller to apply.
+PetscErrorCode PISMSurfaceModel::ice_surface_temperature_deferred(IceModelVec2S &result,
+                                                                  PCellOperations &) {
+  PetscErrorCode ierr = ice_surface_temperature(result); CHKERRQ(ierr);
+  return 0;
+}
+
 PetscErrorCode PISMSurfaceModel::define_variables(set<string> vars, const PIO &nc, PISM_IO_Type nctype) {
   PetscErrorCode ierr;
 
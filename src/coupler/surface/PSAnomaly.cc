@@ -79,21 +79,15 @@ PetscErrorCode PSAnomaly::update(PetscReal my_t, PetscReal my_dt) {
   return 0;
 }
 
-PetscErrorCode PSAnomaly::ice_surface_mass_flux(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-
-  ierr = input_model->ice_surface_mass_flux(result); CHKERRQ(ierr);
-  ierr = result.add(1.0, mass_flux); CHKERRQ(ierr);
-
+PetscErrorCode PSAnomaly::ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->ice_surface_mass_flux_deferred(result, ops); CHKERRQ(ierr);
+  ops.add(mass_flux);
   return 0;
 }
 
-PetscErrorCode PSAnomaly::ice_surface_temperature(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-
-  ierr = input_model->ice_surface_temperature(result); CHKERRQ(ierr);
-  ierr = result.add(1.0, temp); CHKERRQ(ierr);
-
+PetscErrorCode PSAnomaly::ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->ice_surface_temperature_deferred(result, ops); CHKERRQ(ierr);
+  ops.add(temp);
   return 0;
 }
 
@@ -290,11 +290,6 @@ PetscErrorCode PSForceThickness::ice_surface_mass_flux(IceModelVec2S &result) {
   return 0;
 }
 
-//! Does not modify ice surface temperature.
-PetscErrorCode PSForceThickness::ice_surface_temperature(IceModelVec2S &result) {
-  return input_model->ice_surface_temperature(result);
-}
-
 /*!
 The timestep restriction is, by direct analogy, the same as for
    \f[\frac{dy}{dt} = - \alpha y\f]
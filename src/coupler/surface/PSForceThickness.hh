@@ -38,7 +38,9 @@ public:
   PetscErrorCode init(PISMVars &vars);
   virtual void attach_atmosphere_model(PISMAtmosphereModel *input);
   virtual PetscErrorCode ice_surface_mass_flux(IceModelVec2S &result);
-  virtual PetscErrorCode ice_surface_temperature(IceModelVec2S &result);
+  // the forcing depends on the ice thickness: compute the whole field
+  virtual PetscErrorCode ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMSurfaceModel::ice_surface_mass_flux_deferred(result, ops); }
   virtual PetscErrorCode max_timestep(PetscReal my_t, PetscReal &my_dt, bool &restrict);
   virtual void add_vars_to_output(string keyword, map<string,NCSpatialVariable> &result);
   virtual PetscErrorCode define_variables(set<string> vars, const PIO &nc, PISM_IO_Type nctype);
@@ -44,6 +44,12 @@ public:
 
   virtual PetscErrorCode ice_surface_mass_flux(IceModelVec2S &result);
   virtual PetscErrorCode ice_surface_temperature(IceModelVec2S &result);
+
+  // this is a model, not a modifier: compute whole fields
+  virtual PetscErrorCode ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMSurfaceModel::ice_surface_mass_flux_deferred(result, ops); }
+  virtual PetscErrorCode ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops)
+  { return PISMSurfaceModel::ice_surface_temperature_deferred(result, ops); }
 };
 
 #endif /* _PSGIVEN_H_ */
@@ -31,9 +31,9 @@ PetscErrorCode PSLapseRates::init(PISMVars &vars) {
 
   ierr = PetscOptionsBegin(grid.com, "", "Lapse rate options", ""); CHKERRQ(ierr);
   {
-    ierr = PISMOptionsReal("-smb_lapse_rate",
-                           "Elevation lapse rate for the surface mass balance, in m/year per km",
-                           smb_lapse_rate, smb_lapse_rate_set); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-smb_lapse_rate",
+                                     "Elevation lapse rate for the surface mass balance, in m/year per km",
+                                     smb_lapse_rate, smb_lapse_rate_set); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -64,17 +64,15 @@ PetscErrorCode PSLapseRates::init(PISMVars &vars) {
   return 0;
 }
 
-PetscErrorCode PSLapseRates::ice_surface_mass_flux(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-  ierr = input_model->ice_surface_mass_flux(result); CHKERRQ(ierr);
-  ierr = lapse_rate_correction(result, smb_lapse_rate); CHKERRQ(ierr);
+PetscErrorCode PSLapseRates::ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->ice_surface_mass_flux_deferred(result, ops); CHKERRQ(ierr);
+  lapse_rate_correction(ops, smb_lapse_rate);
   return 0;
 }
 
-PetscErrorCode PSLapseRates::ice_surface_temperature(IceModelVec2S &result) {
-  PetscErrorCode ierr;
-  ierr = input_model->ice_surface_temperature(result); CHKERRQ(ierr);
-  ierr = lapse_rate_correction(result, temp_lapse_rate); CHKERRQ(ierr);
+PetscErrorCode PSLapseRates::ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->ice_surface_temperature_deferred(result, ops); CHKERRQ(ierr);
+  lapse_rate_correction(ops, temp_lapse_rate);
   return 0;
 }
 
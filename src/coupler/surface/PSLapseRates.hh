@@ -36,8 +36,8 @@ public:
   virtual ~PSLapseRates() {}
 
   virtual PetscErrorCode init(PISMVars &vars);
-  virtual PetscErrorCode ice_surface_mass_flux(IceModelVec2S &result);
-  virtual PetscErrorCode ice_surface_temperature(IceModelVec2S &result);
+  virtual PetscErrorCode ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops);
+  virtual PetscErrorCode ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops);
 
   virtual PetscErrorCode define_variables(set<string> vars, const PIO &nc, PISM_IO_Type nctype);
   virtual PetscErrorCode write_variables(set<string> vars, string filename);
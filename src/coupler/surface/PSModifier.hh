@@ -20,6 +20,7 @@
 #define _PSMODIFIER_H_
 
 #include "PISMSurface.hh"
+#include "PCellOperations.hh"
 
 //! \brief A base class for mechanisms which modify the results of a surface
 //! processes model (an instance of PISMSurfaceModel) before they reach the ice.
@@ -31,6 +32,15 @@ are already dealt-with, and a basic surface processes model is in use which
 generates surface mass balance and ice upper surface temperature, then instances
 of this PSModifier class can be used to modify the surface mass balance and ice
 upper surface temperature "just before" it gets to the ice itself.
+
+Modifiers that change the climatic mass balance or the ice surface temperature
+one grid cell at a time re-implement the "_deferred" methods, adding their
+corrections to a PCellOperations list; ice_surface_mass_flux() and
+ice_surface_temperature() below then apply the whole list in one sweep. By
+default the "_deferred" methods pass the request to the input model, so a
+modifier re-implementing ice_surface_mass_flux() or ice_surface_temperature()
+in some other way has to re-implement the corresponding "_deferred" method,
+too (see PSForceThickness).
 */
 class PSModifier : public Modifier<PISMSurfaceModel>
 {
@@ -46,17 +56,33 @@ public:
   }
 
   virtual PetscErrorCode ice_surface_mass_flux(IceModelVec2S &result)
+  {
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = ice_surface_mass_flux_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode ice_surface_temperature(IceModelVec2S &result)
+  {
+    PCellOperations ops(grid);
+    PetscErrorCode ierr = ice_surface_temperature_deferred(result, ops); CHKERRQ(ierr);
+    ierr = ops.apply(result); CHKERRQ(ierr);
+    return 0;
+  }
+
+  virtual PetscErrorCode ice_surface_mass_flux_deferred(IceModelVec2S &result, PCellOperations &ops)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->ice_surface_mass_flux(result); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->ice_surface_mass_flux_deferred(result, ops); CHKERRQ(ierr);
     }
     return 0;
   }
 
-  virtual PetscErrorCode ice_surface_temperature(IceModelVec2S &result)
+  virtual PetscErrorCode ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops)
   {
     if (input_model != NULL) {
-      PetscErrorCode ierr = input_model->ice_surface_temperature(result); CHKERRQ(ierr);
+      PetscErrorCode ierr = input_model->ice_surface_temperature_deferred(result, ops); CHKERRQ(ierr);
     }
     return 0;
   }
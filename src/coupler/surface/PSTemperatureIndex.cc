@@ -67,18 +67,18 @@ PetscErrorCode PSTemperatureIndex::init(PISMVars &vars) {
                             "Compute annual mass balance, removing yearly variations",
                             pdd_annualize); CHKERRQ(ierr);
 
-    ierr = PISMOptionsReal("-pdd_factor_snow", "PDD snow factor",
-                           base_ddf.snow, pSet); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-pdd_factor_ice", "PDD ice factor",
-                           base_ddf.ice, pSet); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-pdd_refreeze", "PDD refreeze fraction",
-                           base_ddf.refreezeFrac, pSet); CHKERRQ(ierr);
-
-    ierr = PISMOptionsReal("-pdd_std_dev", "PDD standard deviation",
-                           base_pddStdDev, pSet); CHKERRQ(ierr);
-    ierr = PISMOptionsReal("-pdd_positive_threshold_temp",
-                           "PDD uses this temp in K to determine 'positive' temperatures",
-                           base_pddThresholdTemp, pSet); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-pdd_factor_snow", "PDD snow factor",
+                                     base_ddf.snow, pSet); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-pdd_factor_ice", "PDD ice factor",
+                                     base_ddf.ice, pSet); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-pdd_refreeze", "PDD refreeze fraction",
+                                     base_ddf.refreezeFrac, pSet); CHKERRQ(ierr);
+
+    ierr = PISMOptionsReal(grid.com, "-pdd_std_dev", "PDD standard deviation",
+                                     base_pddStdDev, pSet); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(grid.com, "-pdd_positive_threshold_temp",
+                                     "PDD uses this temp in K to determine 'positive' temperatures",
+                                     base_pddThresholdTemp, pSet); CHKERRQ(ierr);
   }
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -300,6 +300,8 @@ PetscErrorCode PSTemperatureIndex::update_internal(PetscReal my_t, PetscReal my_
 
   DegreeDayFactors  ddf = base_ddf;
 
+  ierr = atmosphere->init_timeseries(&ts[0], Nseries); CHKERRQ(ierr);
+
   ierr = atmosphere->begin_pointwise_access(); CHKERRQ(ierr);
   ierr = climatic_mass_balance.begin_access(); CHKERRQ(ierr);
 
@@ -311,7 +313,7 @@ PetscErrorCode PSTemperatureIndex::update_internal(PetscReal my_t, PetscReal my_
     for (PetscInt j = grid.ys; j<grid.ys+grid.ym; ++j) {
 
       // the temperature time series from the PISMAtmosphereModel and its modifiers
-      ierr = atmosphere->temp_time_series(i, j, Nseries, &ts[0], &T[0]); CHKERRQ(ierr);
+      ierr = atmosphere->temp_time_series(i, j, &T[0]); CHKERRQ(ierr);
 
       if (faustogreve != NULL) {
 	// we have been asked to set mass balance parameters according to
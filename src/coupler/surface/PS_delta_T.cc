@@ -60,9 +60,9 @@ PetscErrorCode PS_delta_T::init(PISMVars &vars) {
   return 0;
 }
 
-PetscErrorCode PS_delta_T::ice_surface_temperature(IceModelVec2S &result) {
-  PetscErrorCode ierr = input_model->ice_surface_temperature(result); CHKERRQ(ierr);
-  ierr = offset_data(result); CHKERRQ(ierr);
+PetscErrorCode PS_delta_T::ice_surface_temperature_deferred(IceModelVec2S &result, PCellOperations &ops) {
+  PetscErrorCode ierr = input_model->ice_surface_temperature_deferred(result, ops); CHKERRQ(ierr);
+  offset_data(ops);
   return 0;
 }
 
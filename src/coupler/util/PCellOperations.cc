@@ -0,0 +1,144 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "PCellOperations.hh"
+#include "IceGrid.hh"
+#include "iceModelVec.hh"
+
+PCellOperations::PCellOperations(IceGrid &g)
+  : grid(g) {
+}
+
+void PCellOperations::shift(PetscReal c) {
+  // merge consecutive shifts
+  if (ops.empty() == false && ops.back().type == SHIFT) {
+    ops.back().c += c;
+    return;
+  }
+
+  Op op;
+  op.type = SHIFT;
+  op.c = c;
+  op.field = op.surface = op.reference = NULL;
+  ops.push_back(op);
+}
+
+void PCellOperations::add(IceModelVec2S &field) {
+  Op op;
+  op.type = ADD;
+  op.c = 1.0;
+  op.field = &field;
+  op.surface = op.reference = NULL;
+  ops.push_back(op);
+}
+
+void PCellOperations::lapse_rate_correction(IceModelVec2S &thk, IceModelVec2S &surface,
+                                            IceModelVec2S &reference, PetscReal lapse_rate) {
+  if (PetscAbs(lapse_rate) < 1e-12)
+    return;
+
+  Op op;
+  op.type = LAPSE_RATE;
+  op.c = lapse_rate;
+  op.field = &thk;
+  op.surface = &surface;
+  op.reference = &reference;
+  ops.push_back(op);
+}
+
+PetscErrorCode PCellOperations::begin_access() {
+  PetscErrorCode ierr;
+
+  for (unsigned int k = 0; k < ops.size(); ++k) {
+    if (ops[k].field != NULL) {
+      ierr = ops[k].field->begin_access(); CHKERRQ(ierr);
+    }
+    if (ops[k].type == LAPSE_RATE) {
+      ierr = ops[k].surface->begin_access(); CHKERRQ(ierr);
+      ierr = ops[k].reference->begin_access(); CHKERRQ(ierr);
+    }
+  }
+  return 0;
+}
+
+PetscErrorCode PCellOperations::end_access() {
+  PetscErrorCode ierr;
+
+  for (unsigned int k = 0; k < ops.size(); ++k) {
+    if (ops[k].field != NULL) {
+      ierr = ops[k].field->end_access(); CHKERRQ(ierr);
+    }
+    if (ops[k].type == LAPSE_RATE) {
+      ierr = ops[k].surface->end_access(); CHKERRQ(ierr);
+      ierr = ops[k].reference->end_access(); CHKERRQ(ierr);
+    }
+  }
+  return 0;
+}
+
+//! \brief Apply all the operations to `result`, then clear the list.
+/*!
+ * A single shift is applied using IceModelVec::shift() (this does not need a
+ * loop over grid points).
+ */
+PetscErrorCode PCellOperations::apply(IceModelVec2S &result) {
+  PetscErrorCode ierr;
+
+  if (ops.empty())
+    return 0;
+
+  if (ops.size() == 1 && ops[0].type == SHIFT) {
+    ierr = result.shift(ops[0].c); CHKERRQ(ierr);
+    ops.clear();
+    return 0;
+  }
+
+  const unsigned int N = ops.size();
+
+  ierr = begin_access(); CHKERRQ(ierr);
+  ierr = result.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      PetscReal value = result(i, j);
+
+      for (unsigned int k = 0; k < N; ++k) {
+        const Op &op = ops[k];
+        switch (op.type) {
+        case SHIFT:
+          value += op.c;
+          break;
+        case ADD:
+          value += (*op.field)(i, j);
+          break;
+        case LAPSE_RATE:
+          if ((*op.field)(i, j) > 0)
+            value -= op.c * ((*op.surface)(i, j) - (*op.reference)(i, j));
+          break;
+        }
+      }
+
+      result(i, j) = value;
+    }
+  }
+  ierr = result.end_access(); CHKERRQ(ierr);
+  ierr = end_access(); CHKERRQ(ierr);
+
+  ops.clear();
+
+  return 0;
+}
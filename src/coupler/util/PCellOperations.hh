@@ -0,0 +1,71 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _PCELLOPERATIONS_H_
+#define _PCELLOPERATIONS_H_
+
+#include <vector>
+#include <petsc.h>
+
+class IceGrid;
+class IceModelVec2S;
+
+//! \brief A list of per-cell operations applied to a 2D field in one sweep.
+/*!
+ * Modifiers such as PS_delta_T, PSAnomaly and PSLapseRates change the field
+ * computed by the model below them one grid cell at a time. Instead of
+ * making a pass over the whole field each, they append their operations to a
+ * PCellOperations list (see the "_deferred" methods of PISMSurfaceModel,
+ * PISMAtmosphereModel and PISMOceanModel); the top-most modifier of the
+ * stack then applies the whole list in one sweep over the subdomain.
+ *
+ * Operations are applied in the order they were added, i.e. in the order the
+ * modifiers would have applied them.
+ */
+class PCellOperations {
+public:
+  PCellOperations(IceGrid &g);
+
+  //! Add a constant to the field.
+  void shift(PetscReal c);
+  //! Add a 2D field (an anomaly) to the field.
+  void add(IceModelVec2S &field);
+  //! Subtract lapse_rate * (surface - reference) wherever thk > 0.
+  void lapse_rate_correction(IceModelVec2S &thk, IceModelVec2S &surface,
+                             IceModelVec2S &reference, PetscReal lapse_rate);
+
+  bool empty() const { return ops.empty(); }
+  void clear() { ops.clear(); }
+
+  PetscErrorCode apply(IceModelVec2S &result);
+protected:
+  enum OpType {SHIFT, ADD, LAPSE_RATE};
+  struct Op {
+    OpType type;
+    PetscReal c;
+    IceModelVec2S *field, *surface, *reference;
+  };
+
+  PetscErrorCode begin_access();
+  PetscErrorCode end_access();
+
+  IceGrid &grid;
+  std::vector<Op> ops;
+};
+
+#endif /* _PCELLOPERATIONS_H_ */
@@ -156,15 +156,15 @@ protected:
 
     ierr = PetscOptionsBegin(Model::grid.com, "", "Climate forcing options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString(option_prefix + "_file",
-                               "Specifies a file with boundary conditions",
-                               filename, bc_file_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_period",
-                             "Specifies the length of the climate data period (in years)",
-                             bc_period_years, bc_period_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_reference_year",
-                             "Boundary condition reference year",
-                             bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(Model::grid.com, option_prefix + "_file",
+                                                "Specifies a file with boundary conditions",
+                                                filename, bc_file_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(Model::grid.com, option_prefix + "_period",
+                                              "Specifies the length of the climate data period (in years)",
+                                              bc_period_years, bc_period_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(Model::grid.com, option_prefix + "_reference_year",
+                                              "Boundary condition reference year",
+                                              bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -25,6 +25,7 @@
 #include "PIO.hh"
 #include "PISMVars.hh"
 #include "PISMTime.hh"
+#include "PCellOperations.hh"
 
 template <class Model, class Mod>
 class PLapseRates : public Mod
@@ -118,18 +119,18 @@ protected:
 
     ierr = PetscOptionsBegin(g.com, "", "Lapse rate options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString(option_prefix + "_file",
-                               "Specifies a file with top-surface boundary conditions",
-                               filename, bc_file_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_period",
-                             "Specifies the length of the climate data period",
-                             bc_period_years, bc_period_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_reference_year",
-                             "Boundary condition reference year",
-                             bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal("-temp_lapse_rate",
-                             "Elevation lapse rate for the temperature, in K per km",
-                             temp_lapse_rate, temp_lapse_rate_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(g.com, option_prefix + "_file",
+                                      "Specifies a file with top-surface boundary conditions",
+                                      filename, bc_file_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(g.com, option_prefix + "_period",
+                                    "Specifies the length of the climate data period",
+                                    bc_period_years, bc_period_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(g.com, option_prefix + "_reference_year",
+                                    "Boundary condition reference year",
+                                    bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(g.com, "-temp_lapse_rate",
+                                    "Elevation lapse rate for the temperature, in K per km",
+                                    temp_lapse_rate, temp_lapse_rate_set); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -186,33 +187,10 @@ protected:
     return 0;
   }
 
-  PetscErrorCode lapse_rate_correction(IceModelVec2S &result, PetscReal lapse_rate)
+  //! Adds the lapse rate correction to the list of per-cell operations.
+  void lapse_rate_correction(PCellOperations &ops, PetscReal lapse_rate)
   {
-    PetscErrorCode ierr;
-
-    if (PetscAbs(lapse_rate) < 1e-12)
-      return 0;
-
-    ierr = thk->begin_access(); CHKERRQ(ierr);
-    ierr = surface->begin_access(); CHKERRQ(ierr);
-    ierr = reference_surface.begin_access(); CHKERRQ(ierr);
-    ierr = result.begin_access(); CHKERRQ(ierr);
-
-    IceGrid &g = Mod::grid;
-
-    for (PetscInt   i = g.xs; i < g.xs + g.xm; ++i) {
-      for (PetscInt j = g.ys; j < g.ys + g.ym; ++j) {
-        if ((*thk)(i,j) > 0)
-          result(i,j) -= lapse_rate * ((*surface)(i,j) - reference_surface(i,j));
-      }
-    }
-
-    ierr = result.end_access(); CHKERRQ(ierr);
-    ierr = reference_surface.end_access(); CHKERRQ(ierr);
-    ierr = surface->end_access(); CHKERRQ(ierr);
-    ierr = thk->end_access(); CHKERRQ(ierr);
-
-    return 0;
+    ops.lapse_rate_correction(*thk, *surface, reference_surface, lapse_rate);
   }
 };
 
@@ -24,6 +24,7 @@
 #include "Timeseries.hh"
 #include "pism_options.hh"
 #include "PISMTime.hh"
+#include "PCellOperations.hh"
 
 template<class Model, class Mod>
 class PScalarForcing : public Mod
@@ -59,12 +60,12 @@ protected:
 
     ierr = PetscOptionsBegin(g.com, "", "Scalar forcing options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString(option_prefix + "_file", "Specifies a file with scalar offsets",
-                               filename, file_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_period", "Specifies the length of the climate data period",
-                             bc_period_years, bc_period_set); CHKERRQ(ierr);
-      ierr = PISMOptionsReal(option_prefix + "_reference_year", "Boundary condition reference year",
-                             bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(g.com, option_prefix + "_file", "Specifies a file with scalar offsets",
+                                      filename, file_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(g.com, option_prefix + "_period", "Specifies the length of the climate data period",
+                                    bc_period_years, bc_period_set); CHKERRQ(ierr);
+      ierr = PISMOptionsReal(g.com, option_prefix + "_reference_year", "Boundary condition reference year",
+                                    bc_reference_year, bc_ref_year_set); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -99,11 +100,10 @@ protected:
     return 0;
   }
 
-  PetscErrorCode offset_data(IceModelVec2S &result) {
-    if (offset) {
-      PetscErrorCode ierr = result.shift((*offset)(Mod::t + 0.5*Mod::dt)); CHKERRQ(ierr);
-    }
-    return 0;
+  //! Adds the offset to the list of per-cell operations.
+  void offset_data(PCellOperations &ops) {
+    if (offset)
+      ops.shift((*offset)(Mod::t + 0.5*Mod::dt));
   }
 
   Model *input;
@@ -92,6 +92,8 @@ PetscErrorCode PBLingleClark::transfer_from_proc0(Vec source, IceModelVec2S *res
 PetscErrorCode PBLingleClark::allocate() {
   PetscErrorCode ierr;
 
+  grid.memory->begin("bed deformation");
+
   ierr = DMCreateGlobalVector(grid.da2, &g2); CHKERRQ(ierr);
 
   // note we want a global Vec but reordered in the natural ordering so when it is
@@ -105,21 +107,59 @@ PetscErrorCode PBLingleClark::allocate() {
   ierr = VecDuplicate(Hp0,&bedstartp0); CHKERRQ(ierr);
   ierr = VecDuplicate(Hp0,&upliftp0); CHKERRQ(ierr);
 
+  // The elastic load response matrix is computed by all processors (or read
+  // from the cache).
+  bool include_elastic = config.get_flag("bed_def_lc_elastic_model");
+  vector<double> load_response;
+  if (include_elastic) {
+    ierr = BedDeformLC::load_response_matrix(grid.com, grid.Mx, grid.My, grid.dx, grid.dy,
+                                             config.get_string("bed_def_lc_elastic_cache_dir"),
+                                             load_response); CHKERRQ(ierr);
+  }
+
   if (grid.rank == 0) {
-    ierr = bdLC.settings(config, PETSC_FALSE, // turn off elastic model for now
+    ierr = bdLC.settings(config, include_elastic ? PETSC_TRUE : PETSC_FALSE,
 			 grid.Mx, grid.My, grid.dx, grid.dy,
 			 4,     // use Z = 4 for now; to reduce global drift?
 			 &Hstartp0, &bedstartp0, &upliftp0, &Hp0, &bedp0);
     CHKERRQ(ierr);
 
-    ierr = bdLC.alloc(); CHKERRQ(ierr);
+    ierr = bdLC.alloc(load_response); CHKERRQ(ierr);
+  }
+
+  // g2 and g2natural are distributed; Hp0 and friends (and everything
+  // BedDeformLC allocates) live on processor 0 only
+  PetscInt local_size;
+  ierr = VecGetLocalSize(g2, &local_size); CHKERRQ(ierr);
+  grid.memory->allocate("bed deformation", 2.0 * local_size * sizeof(PetscScalar),
+                        MEMORY_LOCAL_2D);
+
+  if (grid.rank == 0) {
+    ierr = VecGetLocalSize(Hp0, &local_size); CHKERRQ(ierr);
+    grid.memory->allocate("bed deformation",
+                          5.0 * local_size * sizeof(PetscScalar) + bdLC.memory_usage(),
+                          MEMORY_GLOBAL_2D);
   }
 
+  grid.memory->end();
+
   return 0;
 }
 
 PetscErrorCode PBLingleClark::deallocate() {
   PetscErrorCode ierr;
+  PetscInt local_size;
+
+  ierr = VecGetLocalSize(g2, &local_size); CHKERRQ(ierr);
+  grid.memory->deallocate("bed deformation", 2.0 * local_size * sizeof(PetscScalar),
+                          MEMORY_LOCAL_2D);
+
+  if (grid.rank == 0) {
+    ierr = VecGetLocalSize(Hp0, &local_size); CHKERRQ(ierr);
+    grid.memory->deallocate("bed deformation",
+                            5.0 * local_size * sizeof(PetscScalar) + bdLC.memory_usage(),
+                            MEMORY_GLOBAL_2D);
+  }
 
   ierr = VecDestroy(&g2); CHKERRQ(ierr);
   ierr = VecDestroy(&g2natural); CHKERRQ(ierr);
@@ -172,11 +212,11 @@ PetscErrorCode PBLingleClark::correct_topg() {
   // Stop if topg correction was not requiested.
   if (!use_special_regrid_semantics) return 0;
 
-  ierr = PISMOptionsString("-regrid_file", "Specifies the name of a file to regrid from",
-                           regrid_filename, regrid_file_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-regrid_file", "Specifies the name of a file to regrid from",
+                                     regrid_filename, regrid_file_set); CHKERRQ(ierr);
 
-  ierr = PISMOptionsString("-boot_file", "Specifies the name of the file to bootstrap from",
-                           boot_filename, boot_file_set); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-boot_file", "Specifies the name of the file to bootstrap from",
+                                     boot_filename, boot_file_set); CHKERRQ(ierr);
 
   // Stop if it was requested, but we're not bootstrapping *and* regridding.
   if (! (regrid_file_set && boot_file_set) ) return 0;
@@ -194,8 +234,8 @@ PetscErrorCode PBLingleClark::correct_topg() {
 
   // Stop if the user asked to regrid topg (in this case no correction is necessary).
   vector<string> regrid_vars;
-  ierr = PISMOptionsStringArray("-regrid_vars", "Specifies regridding variables", "",
-                                regrid_vars, regrid_vars_set); CHKERRQ(ierr);
+  ierr = PISMOptionsStringArray(grid.com, "-regrid_vars", "Specifies regridding variables", "",
+                                          regrid_vars, regrid_vars_set); CHKERRQ(ierr);
 
   if (regrid_vars_set) {
     for (unsigned int i = 0; i < regrid_vars.size(); ++i) {
@@ -17,6 +17,9 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
 #include <petscvec.h>
 #include <fftw3.h>
 #include "pism_const.hh"
@@ -27,6 +30,7 @@
 BedDeformLC::BedDeformLC() {
   settingsDone = PETSC_FALSE;
   allocDone = PETSC_FALSE;
+  lrmE_hat = NULL;
 }
 
 BedDeformLC::~BedDeformLC() {
@@ -37,6 +41,8 @@ BedDeformLC::~BedDeformLC() {
     fftw_free(fftw_input);
     fftw_free(fftw_output);
     fftw_free(loadhat);
+    if (lrmE_hat != NULL)
+      fftw_free(lrmE_hat);
 
     VecDestroy(&Hdiff);
     VecDestroy(&dbedElastic);
@@ -71,6 +77,7 @@ PetscErrorCode BedDeformLC::settings(const NCConfigVariable &config,
   D = config.get("lithosphere_flexural_rigidity");
 
   standard_gravity = config.get("standard_gravity");
+  elastic_cache_dir = config.get_string("bed_def_lc_elastic_cache_dir");
 
   // derive more parameters
   Lx = ((Mx - 1) / 2) * dx;
@@ -96,7 +103,25 @@ PetscErrorCode BedDeformLC::settings(const NCConfigVariable &config,
 }
 
 
+//! \brief Allocate and compute (on this processor only) the load response
+//! matrix, if needed.
 PetscErrorCode BedDeformLC::alloc() {
+  PetscErrorCode ierr;
+  vector<double> load_response;
+
+  if (settingsDone == PETSC_TRUE && include_elastic == PETSC_TRUE) {
+    ierr = load_response_matrix(PETSC_COMM_SELF, Mx, My, dx, dy,
+                                elastic_cache_dir, load_response); CHKERRQ(ierr);
+  }
+
+  ierr = alloc(load_response); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Allocate, using the load response matrix computed by
+//! load_response_matrix() (ignored unless include_elastic is set).
+PetscErrorCode BedDeformLC::alloc(const vector<double> &load_response) {
   PetscErrorCode  ierr;
   if (settingsDone == PETSC_FALSE) {
     SETERRQ(PETSC_COMM_SELF, 1, "BedDeformLC must be set with settings() before alloc()\n");
@@ -114,7 +139,8 @@ PetscErrorCode BedDeformLC::alloc() {
   // FFT - side coefficient fields (i.e. multiplication form of operators)
   ierr = VecDuplicate(U, &vleft); CHKERRQ(ierr);
   ierr = VecDuplicate(U, &vright); CHKERRQ(ierr);
-  ierr = VecCreateSeq(PETSC_COMM_SELF, Nxge * Nyge, &lrmE); CHKERRQ(ierr);
+  // conv2_same() uses lrmE(p,q) with p < Mx and q < My only
+  ierr = VecCreateSeq(PETSC_COMM_SELF, Mx * My, &lrmE); CHKERRQ(ierr);
 
   // setup fftw stuff: FFTW builds "plans" based on observed performance
 
@@ -152,27 +178,35 @@ PetscErrorCode BedDeformLC::alloc() {
   for (PetscInt j = Ny / 2 + 1; j < Ny; j++)
     cy[j] = (pi / Ly_fat) * (Ny - j);
 
-  // compare geforconv.m
   if (include_elastic == PETSC_TRUE) {
-    ierr = PetscPrintf(PETSC_COMM_SELF,
-           "     computing spherical elastic load response matrix ..."); CHKERRQ(ierr);
-    PetscVecAccessor2D II(lrmE, Nxge, Nyge);
-    ge_params ge_data;
-    ge_data.dx = dx;
-    ge_data.dy = dy;
-    //const PetscInt imid_ge = Nx/2, jmid_ge = Ny/2;
-    for (PetscInt i = 0; i < Nxge; i++) {
-      for (PetscInt j = 0; j < Nyge; j++) {
-        ge_data.p = i;
-        ge_data.q = j;
-        //ge_data.p = i - imid_ge;
-        //ge_data.q = j - jmid_ge;
-        II(i, j) = dblquad_cubature(ge_integrand, -dx/2, dx/2, -dy/2, dy/2,
-                                    1.0e-8, &ge_data);
+    if ((int)load_response.size() != Mx * My) {
+      SETERRQ(PETSC_COMM_SELF, 3, "BedDeformLC: the load response matrix has the wrong size\n");
+    }
+
+    PetscVecAccessor2D II(lrmE, Mx, My);
+    for (PetscInt i = 0; i < Mx; i++) {
+      for (PetscInt j = 0; j < My; j++) {
+        II(i, j) = load_response[i * My + j];
       }
     }
 
-    ierr = PetscPrintf(PETSC_COMM_SELF, " done\n"); CHKERRQ(ierr);
+    // Precompute fft2(lrmE) for elastic_response(). The response at (i,j)
+    // computed by conv2_same() uses lrmE(p,q) with 1 <= p <= i and
+    // 1 <= q <= j only, so the first row and column are left out and
+    // lrmE(1:Mx-1,1:My-1) is enough.
+    lrmE_hat = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * Nx * Ny);
+
+    clear_fftw_input();
+    {
+      VecAccessor2D<fftw_complex> input(fftw_input, Nx, Ny);
+      for (PetscInt i = 1; i < Mx; i++) {
+        for (PetscInt j = 1; j < My; j++) {
+          input(i, j)[0] = II(i, j);
+        }
+      }
+    }
+    fftw_execute(dft_forward);
+    copy_fftw_output(lrmE_hat);
   }
 
   allocDone = PETSC_TRUE;
@@ -180,6 +214,186 @@ PetscErrorCode BedDeformLC::alloc() {
 }
 
 
+//! Returns the number of bytes allocated by alloc() (0 if not allocated yet).
+double BedDeformLC::memory_usage() {
+  if (allocDone == PETSC_FALSE)
+    return 0.0;
+
+  double
+    thin = (double)Mx * My,     // Hdiff, dbedElastic, lrmE
+    fat = (double)Nx * Ny;      // U, U_start, vleft, vright
+
+  return sizeof(PetscScalar) * (3*thin + 4*fat + Nx + Ny) +
+    sizeof(fftw_complex) * (include_elastic == PETSC_TRUE ? 4 : 3) * fat;
+}
+
+//! \brief Name of the file caching the load response matrix for a given grid.
+static string load_response_cache_file(string dir, PetscInt Mx, PetscInt My,
+                                       PetscScalar dx, PetscScalar dy) {
+  char filename[TEMPORARY_STRING_LENGTH];
+  snprintf(filename, TEMPORARY_STRING_LENGTH, "%s/lc_elastic_%dx%d_%.3fx%.3f.bin",
+           dir.c_str(), (int)Mx, (int)My, dx, dy);
+  return filename;
+}
+
+// Cache files start with this string, followed by Mx, My (int), dx, dy
+// (double) and Mx*My values (double) in the native byte order.
+static const char load_response_magic[] = "PISM lrmE 1";
+
+//! \brief Read the load response matrix from a cache file. Returns true on
+//! success, false if the file is missing or does not match the grid.
+static bool read_load_response(string filename, PetscInt Mx, PetscInt My,
+                               PetscScalar dx, PetscScalar dy,
+                               vector<double> &result) {
+  FILE *f = fopen(filename.c_str(), "rb");
+  if (f == NULL)
+    return false;
+
+  char magic[sizeof(load_response_magic)];
+  int M = 0, N = 0;
+  double x = 0.0, y = 0.0;
+  bool success =
+    fread(magic, sizeof(magic), 1, f) == 1 &&
+    strncmp(magic, load_response_magic, sizeof(magic)) == 0 &&
+    fread(&M, sizeof(M), 1, f) == 1 && fread(&N, sizeof(N), 1, f) == 1 &&
+    fread(&x, sizeof(x), 1, f) == 1 && fread(&y, sizeof(y), 1, f) == 1 &&
+    M == Mx && N == My && x == dx && y == dy;
+
+  if (success) {
+    result.resize(Mx * My);
+    success = fread(&result[0], sizeof(double), Mx * My, f) == (size_t)(Mx * My);
+  }
+
+  fclose(f);
+  return success;
+}
+
+//! \brief Save the load response matrix to a cache file. Writes to a
+//! temporary file first, so that concurrent runs never see a partial table.
+static bool write_load_response(string filename, PetscInt Mx, PetscInt My,
+                                PetscScalar dx, PetscScalar dy,
+                                const vector<double> &table) {
+  char tmp_name[TEMPORARY_STRING_LENGTH];
+  snprintf(tmp_name, TEMPORARY_STRING_LENGTH, "%s.tmp%d", filename.c_str(), (int)getpid());
+
+  FILE *f = fopen(tmp_name, "wb");
+  if (f == NULL)
+    return false;
+
+  int M = Mx, N = My;
+  double x = dx, y = dy;
+  bool success =
+    fwrite(load_response_magic, sizeof(load_response_magic), 1, f) == 1 &&
+    fwrite(&M, sizeof(M), 1, f) == 1 && fwrite(&N, sizeof(N), 1, f) == 1 &&
+    fwrite(&x, sizeof(x), 1, f) == 1 && fwrite(&y, sizeof(y), 1, f) == 1 &&
+    fwrite(&table[0], sizeof(double), Mx * My, f) == (size_t)(Mx * My);
+
+  success = (fclose(f) == 0) && success;
+
+  if (success)
+    success = rename(tmp_name, filename.c_str()) == 0;
+  else
+    remove(tmp_name);
+
+  return success;
+}
+
+//! \brief Compute the elastic load response matrix (compare geforconv.m).
+/*!
+ * Collective on \c com; \c result (Mx*My values, lrmE(i,j) is
+ * result[i*My + j]) is the same on all processors.
+ *
+ * Each entry requires an adaptive cubature of ge_integrand(), so entries are
+ * distributed (round-robin) among processors in \c com. If dx == dy then
+ * lrmE(p,q) == lrmE(q,p) and only entries with p <= q (and the ones with no
+ * transposed counterpart) are computed.
+ *
+ * If \c cache_dir is not empty, processor 0 tries to read the matrix from a
+ * file in this directory (one file per grid size and spacing) and saves it
+ * there after computing it, so that restarts and other runs on the same grid
+ * can skip this computation.
+ */
+PetscErrorCode BedDeformLC::load_response_matrix(MPI_Comm com, PetscInt Mx, PetscInt My,
+                                                 PetscScalar dx, PetscScalar dy,
+                                                 string cache_dir, vector<double> &result) {
+  PetscErrorCode ierr;
+  PetscMPIInt rank, size;
+  int found = 0;
+  string filename;
+
+  ierr = MPI_Comm_rank(com, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(com, &size); CHKERRQ(ierr);
+
+  result.resize(Mx * My);
+
+  if (cache_dir.empty() == false) {
+    filename = load_response_cache_file(cache_dir, Mx, My, dx, dy);
+
+    if (rank == 0)
+      found = read_load_response(filename, Mx, My, dx, dy, result);
+
+    ierr = MPI_Bcast(&found, 1, MPI_INT, 0, com); CHKERRQ(ierr);
+
+    if (found) {
+      ierr = PetscPrintf(com, "     read the elastic load response matrix from '%s'\n",
+                         filename.c_str()); CHKERRQ(ierr);
+      ierr = MPI_Bcast(&result[0], Mx * My, MPI_DOUBLE, 0, com); CHKERRQ(ierr);
+      return 0;
+    }
+  }
+
+  ierr = PetscPrintf(com,
+                     "     computing spherical elastic load response matrix ..."); CHKERRQ(ierr);
+
+  const bool symmetric = (dx == dy);
+  ge_params ge_data;
+  ge_data.dx = dx;
+  ge_data.dy = dy;
+
+  int counter = 0;
+  for (PetscInt i = 0; i < Mx; i++) {
+    for (PetscInt j = 0; j < My; j++) {
+      result[i * My + j] = 0.0;
+
+      if (symmetric && j < i && i < My)
+        continue;               // copied from lrmE(j,i) below
+
+      if (counter++ % size != rank)
+        continue;
+
+      ge_data.p = i;
+      ge_data.q = j;
+      result[i * My + j] = dblquad_cubature(ge_integrand, -dx/2, dx/2, -dy/2, dy/2,
+                                            1.0e-8, &ge_data);
+    }
+  }
+
+  if (size > 1) {
+    vector<double> tmp(result);
+    ierr = MPI_Allreduce(&tmp[0], &result[0], Mx * My, MPI_DOUBLE, MPI_SUM, com); CHKERRQ(ierr);
+  }
+
+  if (symmetric) {
+    for (PetscInt i = 0; i < Mx; i++) {
+      for (PetscInt j = 0; j < i && i < My; j++) {
+        result[i * My + j] = result[j * My + i];
+      }
+    }
+  }
+
+  ierr = PetscPrintf(com, " done\n"); CHKERRQ(ierr);
+
+  if (filename.empty() == false && rank == 0) {
+    if (write_load_response(filename, Mx, My, dx, dy, result) == false) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,
+                         "PISM WARNING: could not save the elastic load response matrix to '%s'\n",
+                         filename.c_str()); CHKERRQ(ierr);
+    }
+  }
+
+  return 0;
+}
+
 PetscErrorCode BedDeformLC::uplift_init() {
   // to initialize we solve:
   //   rho_r g U + D grad^4 U = 0 - 2 eta |grad| uplift
@@ -313,8 +527,7 @@ PetscErrorCode BedDeformLC::step(const PetscScalar dt_seconds, const PetscScalar
   // now compute elastic response if desired; bed = ue at end of this block
   if (include_elastic == PETSC_TRUE) {
     // Matlab:     ue=rhoi*conv2(H-H_start, II, 'same')
-    ierr = conv2_same(Hdiff, Mx, My, lrmE, Nxge, Nyge, dbedElastic);  CHKERRQ(ierr);
-    ierr = VecScale(dbedElastic, icerho);  CHKERRQ(ierr);
+    ierr = elastic_response(Hdiff, dbedElastic); CHKERRQ(ierr);
   } else {
     ierr = VecSet(dbedElastic, 0.0); CHKERRQ(ierr);
   }
@@ -336,6 +549,66 @@ PetscErrorCode BedDeformLC::step(const PetscScalar dt_seconds, const PetscScalar
   return 0;
 }
 
+//! \brief Compute the elastic bed displacement due to the ice thickness
+//! change \c dH, using FFTs.
+/*!
+ * Computes the same thing as elastic_response_direct(), but as a product of
+ * fft2(dH) and the precomputed fft2(lrmE) on the fat domain. This is a
+ * circular convolution; since \c dH is zero-padded to the Nx by Ny fat
+ * domain and only lrmE(1:Mx-1,1:My-1) contributes, it matches the linear
+ * convolution everywhere except in the first row and column of the result if
+ * Z == 2. conv2_same() gives zero there, so we do the same.
+ *
+ * Requires Z >= 2 (as does the rest of the class).
+ */
+PetscErrorCode BedDeformLC::elastic_response(Vec dH, Vec result) {
+  if (lrmE_hat == NULL) {
+    SETERRQ(PETSC_COMM_SELF, 3, "BedDeformLC: elastic load response matrix was not computed\n");
+  }
+
+  clear_fftw_input();
+  set_fftw_input(dH, 1.0, Mx, My, 0, 0);
+  fftw_execute(dft_forward);
+
+  {
+    VecAccessor2D<fftw_complex> input(fftw_input, Nx, Ny),
+      dH_hat(fftw_output, Nx, Ny), G_hat(lrmE_hat, Nx, Ny);
+    for (PetscInt i = 0; i < Nx; i++) {
+      for (PetscInt j = 0; j < Ny; j++) {
+        input(i, j)[0] = dH_hat(i, j)[0] * G_hat(i, j)[0] - dH_hat(i, j)[1] * G_hat(i, j)[1];
+        input(i, j)[1] = dH_hat(i, j)[0] * G_hat(i, j)[1] + dH_hat(i, j)[1] * G_hat(i, j)[0];
+      }
+    }
+  }
+
+  fftw_execute(dft_inverse);
+  get_fftw_output(result, icerho / (Nx * Ny), Mx, My, 0, 0);
+
+  {
+    PetscVecAccessor2D r(result, Mx, My);
+    for (PetscInt i = 0; i < Mx; i++)
+      r(i, 0) = 0.0;
+    for (PetscInt j = 0; j < My; j++)
+      r(0, j) = 0.0;
+  }
+
+  return 0;
+}
+
+//! \brief Compute the elastic bed displacement due to the ice thickness
+//! change \c dH by direct summation (conv2_same()).
+/*!
+ * This is O(Mx^2 My^2); it is kept to test elastic_response().
+ */
+PetscErrorCode BedDeformLC::elastic_response_direct(Vec dH, Vec result) {
+  PetscErrorCode ierr;
+
+  ierr = conv2_same(dH, Mx, My, lrmE, Mx, My, result);  CHKERRQ(ierr);
+  ierr = VecScale(result, icerho);  CHKERRQ(ierr);
+
+  return 0;
+}
+
 void BedDeformLC::tweak(PetscReal seconds_from_start) {
   PetscVecAccessor2D u(U, Nx, Ny);
 
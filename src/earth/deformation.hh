@@ -59,8 +59,17 @@ public:
                                         // before each call to step
                           Vec* mybed);  // mybed gets modified by step()
   PetscErrorCode alloc();
+  PetscErrorCode alloc(const vector<double> &load_response);
   PetscErrorCode uplift_init();
   PetscErrorCode step(const PetscScalar dtyear, const PetscScalar yearFromStart);
+  double memory_usage();
+
+  PetscErrorCode elastic_response(Vec dH, Vec result);
+  PetscErrorCode elastic_response_direct(Vec dH, Vec result);
+
+  static PetscErrorCode load_response_matrix(MPI_Comm com, PetscInt Mx, PetscInt My,
+                                             PetscScalar dx, PetscScalar dy,
+                                             string cache_dir, vector<double> &result);
 
 protected:
   PetscBool     include_elastic;
@@ -75,6 +84,7 @@ protected:
 
 private:
   PetscScalar   standard_gravity;
+  string        elastic_cache_dir;
   PetscBool    settingsDone, allocDone;
   PetscInt      Nx, Ny,      // fat sizes
                 Nxge, Nyge;  // fat with boundary sizes
@@ -86,8 +96,9 @@ private:
   Vec           Hdiff, dbedElastic,    // sequential; working space
                 U, U_start, // sequential and fat
                 vleft, vright,  // coefficients; sequential and fat
-                lrmE;           // load response matrix (elastic); sequential and fat *with* boundary
+                lrmE;           // load response matrix (elastic); sequential, Mx by My
   fftw_complex  *fftw_input, *fftw_output, *loadhat;  // 2D sequential
+  fftw_complex  *lrmE_hat;  // fft2(lrmE) on the fat grid; allocated if include_elastic
   fftw_plan     dft_forward, dft_inverse;
 
   void tweak(PetscReal seconds_from_start);
@@ -34,8 +34,8 @@ infinite case .  (The infinite case is where A(i,j) and B(i,j) are defined for
 -inf < i,j < inf but A(i,j)=0 if i<0 or i>mA-1 or j<0 or j>nA-1
 and B(i,j)=0 if i<0 or i>mB-1 or j<0 or j>nB-1.)
 
-This operation is O(mA^2 nA^2), but an alternate FFT implementation would
-be O(mA nA log(mA nA)), presumably.
+This operation is O(mA^2 nA^2); BedDeformLC::elastic_response() computes the
+same convolution using FFTs.
  */
 PetscErrorCode conv2_same(Vec vA, int mA, int nA,  Vec vB, int mB, int nB,
                           Vec &vresult);
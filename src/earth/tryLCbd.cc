@@ -34,7 +34,12 @@ static char help[] =
   "               include_elastic = FALSE, do_uplift = TRUE, H0 = 0.0\n"
   "     (4) dump ice disc on initially level, uplifting land, use both viscous \n"
   "         half-space model and elastic model:\n"
-  "               include_elastic = TRUE, do_uplift = TRUE, H0 = 1000.0\n\n";
+  "               include_elastic = TRUE, do_uplift = TRUE, H0 = 1000.0\n"
+  "  Option -check_elastic compares the FFT-based elastic response to the\n"
+  "  direct (conv2_same) one for the scenario 2 load and exits (with status 1\n"
+  "  if they differ).\n"
+  "  Option -lc_elastic_cache DIR saves the elastic load response matrix in DIR\n"
+  "  and re-uses it in later runs.\n\n";
 
 
 #include <cmath>
@@ -51,6 +56,7 @@ int main(int argc, char *argv[]) {
 
   MPI_Comm    com;  // won't be used except for rank,size
   PetscMPIInt rank, size;
+  int         status = 0;
 
   ierr = PetscInitialize(&argc, &argv, PETSC_NULL, help); CHKERRQ(ierr);
 
@@ -71,6 +77,7 @@ int main(int argc, char *argv[]) {
     PetscBool  include_elastic = PETSC_FALSE,
                 do_uplift = PETSC_FALSE;
     PetscScalar H0 = 1000.0;            // ice disc load thickness
+    bool        check_elastic;
 
     if (argc >= 2) {
       // FIXME:  should use PETSC-style options
@@ -91,6 +98,11 @@ int main(int argc, char *argv[]) {
           break; // accept default which is scenario 1
       }
     }
+
+    ierr = PISMOptionsIsSet("-check_elastic", check_elastic); CHKERRQ(ierr);
+    if (check_elastic) {
+      include_elastic = PETSC_TRUE;  do_uplift = PETSC_FALSE;  H0 = 1000.0;
+    }
     const PetscScalar R0 = 1000.0e3;          // ice disc load radius
     const PetscScalar tfinalyears = 150.0e3;  // total run time
 
@@ -102,7 +114,18 @@ int main(int argc, char *argv[]) {
                       Ly = 2000.0e3;
     const PetscInt    Z = 2;
     const PetscScalar dtyears = 100.0;
-    
+    const PetscScalar dx = (2.0*Lx)/((PetscScalar) Mx - 1),
+                      dy = (2.0*Ly)/((PetscScalar) My - 1);
+
+    // the elastic load response matrix is computed by all processors
+    vector<double> load_response;
+    if (include_elastic == PETSC_TRUE) {
+      ierr = config.string_from_option("lc_elastic_cache", "bed_def_lc_elastic_cache_dir"); CHKERRQ(ierr);
+      ierr = BedDeformLC::load_response_matrix(com, Mx, My, dx, dy,
+                                               config.get_string("bed_def_lc_elastic_cache_dir"),
+                                               load_response); CHKERRQ(ierr);
+    }
+
     if (rank == 0) { // only runs on proc 0; all sequential
       // allocate the variables needed before BedDeformLC can work:
       ierr = VecCreateSeq(PETSC_COMM_SELF, Mx*My, &H); CHKERRQ(ierr);
@@ -120,24 +143,9 @@ int main(int argc, char *argv[]) {
                                        PETSC_NULL, PETSC_NULL); CHKERRQ(ierr);
       ierr = DMCreateGlobalVector(da2, &bed); CHKERRQ(ierr);
 
-      // create a bed viewer
-      PetscViewer viewer;
-      PetscDraw   draw;
-      const PetscInt  windowx = 500,
-                      windowy = (PetscInt) (((float) windowx) * Ly / Lx);
-      ierr = PetscViewerDrawOpen(PETSC_COMM_SELF, PETSC_NULL, "bed elev (m)",
-           PETSC_DECIDE, PETSC_DECIDE, windowy, windowx, &viewer);  CHKERRQ(ierr);
-      // following should be redundant, but may put up a title even under 2.3.3-p1:3 where
-      // there is a no-titles bug
-      ierr = PetscViewerDrawGetDraw(viewer,0,&draw); CHKERRQ(ierr);
-      ierr = PetscDrawSetDoubleBuffer(draw); CHKERRQ(ierr);  // remove flicker while we are at it
-      ierr = PetscDrawSetTitle(draw,"bed elev (m)"); CHKERRQ(ierr);
-
       // make disc load
       ierr = PetscPrintf(PETSC_COMM_SELF,"creating disc load\n"); CHKERRQ(ierr);
       // see "Results: Earth deformation only" section of Bueler et al "Fast computation ..."
-      const PetscScalar dx = (2.0*Lx)/((PetscScalar) Mx - 1), 
-                        dy = (2.0*Ly)/((PetscScalar) My - 1);
       const PetscInt    imid = (Mx-1)/2, jmid = (My-1)/2;
       PetscScalar **HH;
       ierr = VecGetArray2d(H, Mx, My, 0, 0, &HH); CHKERRQ(ierr);
@@ -182,47 +190,90 @@ int main(int argc, char *argv[]) {
                &Hstart, &bedstart, &uplift, &H, &bed); CHKERRQ(ierr);
 
       ierr = PetscPrintf(PETSC_COMM_SELF,"allocating BedDeformLC\n"); CHKERRQ(ierr);
-      ierr = bdlc.alloc(); CHKERRQ(ierr);
-      
-      ierr = PetscPrintf(PETSC_COMM_SELF,"initializing BedDeformLC from uplift map\n"); CHKERRQ(ierr);
-      ierr = bdlc.uplift_init(); CHKERRQ(ierr);
-      
-      ierr = PetscPrintf(PETSC_COMM_SELF,"stepping BedDeformLC\n"); CHKERRQ(ierr);
-      const PetscInt     KK = (PetscInt) (tfinalyears / dtyears);
-      PetscScalar **b;
-      ierr = VecGetArray2d(bedstart, Mx, My, 0, 0, &b); CHKERRQ(ierr);
-      PetscScalar b0old = b[imid][jmid];
-      ierr = VecRestoreArray2d(bedstart, Mx, My, 0, 0, &b); CHKERRQ(ierr);
-      for (PetscInt k=0; k<KK; k++) {
-        const PetscScalar tyears = k*dtyears;
-        ierr = bdlc.step(dtyears, tyears); CHKERRQ(ierr);
-        ierr = VecView(bed,viewer); CHKERRQ(ierr);
-        ierr = VecGetArray2d(bed, Mx, My, 0, 0, &b); CHKERRQ(ierr);
-        const PetscScalar b0new = b[imid][jmid];
-        ierr = VecRestoreArray2d(bed, Mx, My, 0, 0, &b); CHKERRQ(ierr);
-        const PetscScalar dbdt0 = (b0new - b0old) / (dtyears);
+      ierr = bdlc.alloc(load_response); CHKERRQ(ierr);
+
+      if (check_elastic) {
+        Vec dH, ue_fft, ue_direct;
+        PetscReal max_diff, max_ue;
+
+        ierr = VecDuplicate(H, &dH); CHKERRQ(ierr);
+        ierr = VecDuplicate(H, &ue_fft); CHKERRQ(ierr);
+        ierr = VecDuplicate(H, &ue_direct); CHKERRQ(ierr);
+
+        ierr = VecWAXPY(dH, -1, Hstart, H); CHKERRQ(ierr);
+        ierr = bdlc.elastic_response(dH, ue_fft); CHKERRQ(ierr);
+        ierr = bdlc.elastic_response_direct(dH, ue_direct); CHKERRQ(ierr);
+
+        ierr = VecNorm(ue_direct, NORM_INFINITY, &max_ue); CHKERRQ(ierr);
+        ierr = VecAXPY(ue_fft, -1, ue_direct); CHKERRQ(ierr);
+        ierr = VecNorm(ue_fft, NORM_INFINITY, &max_diff); CHKERRQ(ierr);
 
         ierr = PetscPrintf(PETSC_COMM_SELF,
-                  "   t=%8.0f (a)   b(0,0)=%11.5f (m)  dbdt(0,0)=%11.7f (m/a)\n",
-                  tyears, b0new, dbdt0); CHKERRQ(ierr);
+                           "elastic response: max |ue| = %12.5e (m), max |ue_fft - ue_direct| = %12.5e (m)\n",
+                           max_ue, max_diff); CHKERRQ(ierr);
+
+        if (max_diff > 1e-10 * max_ue) {
+          ierr = PetscPrintf(PETSC_COMM_SELF, "FAILED\n"); CHKERRQ(ierr);
+          status = 1;
+        }
+
+        ierr = VecDestroy(&dH); CHKERRQ(ierr);
+        ierr = VecDestroy(&ue_fft); CHKERRQ(ierr);
+        ierr = VecDestroy(&ue_direct); CHKERRQ(ierr);
+      } else {
+        // create a bed viewer
+        PetscViewer viewer;
+        PetscDraw   draw;
+        const PetscInt  windowx = 500,
+                        windowy = (PetscInt) (((float) windowx) * Ly / Lx);
+        ierr = PetscViewerDrawOpen(PETSC_COMM_SELF, PETSC_NULL, "bed elev (m)",
+             PETSC_DECIDE, PETSC_DECIDE, windowy, windowx, &viewer);  CHKERRQ(ierr);
+        // following should be redundant, but may put up a title even under 2.3.3-p1:3 where
+        // there is a no-titles bug
+        ierr = PetscViewerDrawGetDraw(viewer,0,&draw); CHKERRQ(ierr);
+        ierr = PetscDrawSetDoubleBuffer(draw); CHKERRQ(ierr);  // remove flicker while we are at it
+        ierr = PetscDrawSetTitle(draw,"bed elev (m)"); CHKERRQ(ierr);
+
+        ierr = PetscPrintf(PETSC_COMM_SELF,"initializing BedDeformLC from uplift map\n"); CHKERRQ(ierr);
+        ierr = bdlc.uplift_init(); CHKERRQ(ierr);
+
+        ierr = PetscPrintf(PETSC_COMM_SELF,"stepping BedDeformLC\n"); CHKERRQ(ierr);
+        const PetscInt     KK = (PetscInt) (tfinalyears / dtyears);
+        PetscScalar **b;
+        ierr = VecGetArray2d(bedstart, Mx, My, 0, 0, &b); CHKERRQ(ierr);
+        PetscScalar b0old = b[imid][jmid];
+        ierr = VecRestoreArray2d(bedstart, Mx, My, 0, 0, &b); CHKERRQ(ierr);
+        for (PetscInt k=0; k<KK; k++) {
+          const PetscScalar tyears = k*dtyears;
+          ierr = bdlc.step(dtyears, tyears); CHKERRQ(ierr);
+          ierr = VecView(bed,viewer); CHKERRQ(ierr);
+          ierr = VecGetArray2d(bed, Mx, My, 0, 0, &b); CHKERRQ(ierr);
+          const PetscScalar b0new = b[imid][jmid];
+          ierr = VecRestoreArray2d(bed, Mx, My, 0, 0, &b); CHKERRQ(ierr);
+          const PetscScalar dbdt0 = (b0new - b0old) / (dtyears);
 
-        char title[100];
-        snprintf(title,100, "bed elev (m)  [t = %9.1f]", tyears);
-        ierr = PetscDrawSetTitle(draw,title); CHKERRQ(ierr);
-        b0old = b0new;
+          ierr = PetscPrintf(PETSC_COMM_SELF,
+                    "   t=%8.0f (a)   b(0,0)=%11.5f (m)  dbdt(0,0)=%11.7f (m/a)\n",
+                    tyears, b0new, dbdt0); CHKERRQ(ierr);
+
+          char title[100];
+          snprintf(title,100, "bed elev (m)  [t = %9.1f]", tyears);
+          ierr = PetscDrawSetTitle(draw,title); CHKERRQ(ierr);
+          b0old = b0new;
+        }
+        ierr = PetscPrintf(PETSC_COMM_SELF,"\ndone\n"); CHKERRQ(ierr);
+        ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
       }
-      ierr = PetscPrintf(PETSC_COMM_SELF,"\ndone\n"); CHKERRQ(ierr);
 
       ierr = VecDestroy(&H); CHKERRQ(ierr);
       ierr = VecDestroy(&bed); CHKERRQ(ierr);
       ierr = VecDestroy(&Hstart); CHKERRQ(ierr);
       ierr = VecDestroy(&bedstart); CHKERRQ(ierr);
       ierr = VecDestroy(&uplift); CHKERRQ(ierr);
-      ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
       ierr = DMDestroy(&da2); CHKERRQ(ierr);
     }
   }
 
   ierr = PetscFinalize(); CHKERRQ(ierr);
-  return 0;
+  return status;
 }
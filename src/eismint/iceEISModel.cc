@@ -72,8 +72,8 @@ PetscErrorCode IceEISModel::set_expername_from_options() {
   string eisIIexpername = "A";
   char temp = expername;
   bool EISIIchosen;
-  ierr = PISMOptionsString("-eisII", "EISMINT II experiment name",
-			   eisIIexpername, EISIIchosen);
+  ierr = PISMOptionsString(grid.com, "-eisII", "EISMINT II experiment name",
+          			   eisIIexpername, EISIIchosen);
             CHKERRQ(ierr);
   if (EISIIchosen == PETSC_TRUE) {
     temp = (char)toupper(eisIIexpername.c_str()[0]);
@@ -140,29 +140,29 @@ PetscErrorCode IceEISModel::setFromOptions() {
 
   // if user specifies Tmin, Tmax, Mmax, Sb, ST, Rel, then use that (override above)
   bool paramSet;
-  ierr = PISMOptionsReal("-Tmin", "T min, Kelvin",
-			 T_min, paramSet); CHKERRQ(ierr);
-  ierr = PISMOptionsReal("-Tmax", "T max, Kelvin",
-			 T_max, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Tmin", "T min, Kelvin",
+          			 T_min, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Tmax", "T max, Kelvin",
+          			 T_max, paramSet); CHKERRQ(ierr);
 
   PetscReal myMmax = convert(M_max, "m/s", "m/year"),
     mySb = S_b * secpera / 1e3,
     myST = S_T / 1e3,
     myRel = R_el / 1e3;
-  ierr = PISMOptionsReal("-Mmax", "Maximum accumulation, m/year",
-			 myMmax, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Mmax", "Maximum accumulation, m/year",
+          			 myMmax, paramSet); CHKERRQ(ierr);
   if (paramSet)     M_max = myMmax / secpera;
 
-  ierr = PISMOptionsReal("-Sb", "radial gradient of accumulation rate, (m/a)/km",
-			 mySb, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Sb", "radial gradient of accumulation rate, (m/a)/km",
+          			 mySb, paramSet); CHKERRQ(ierr);
   if (paramSet)     S_b = mySb * 1e-3 / secpera;
 
-  ierr = PISMOptionsReal("-ST", "radial gradient of surface temperature, K/km",
-			 myST, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-ST", "radial gradient of surface temperature, K/km",
+          			 myST, paramSet); CHKERRQ(ierr);
   if (paramSet)     S_T = myST * 1e-3;
 
-  ierr = PISMOptionsReal("-Rel", "radial distance to equilibrium line, km",
-			 myRel, paramSet); CHKERRQ(ierr);
+  ierr = PISMOptionsReal(grid.com, "-Rel", "radial distance to equilibrium line, km",
+          			 myRel, paramSet); CHKERRQ(ierr);
   if (paramSet)     R_el = myRel * 1e3;
 
   ierr = PetscOptionsEnd(); CHKERRQ(ierr);
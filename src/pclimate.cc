@@ -183,6 +183,72 @@ static PetscErrorCode doneWithIceInfo(PISMVars &variables) {
 }
 
 
+//! \brief Wall-clock times spent evaluating boundary models and writing
+//! their outputs.
+struct PCCTimings {
+  PCCTimings() : surface(0.0), ocean(0.0), output(0.0), records(0) {}
+  PetscLogDouble surface, ocean, output;
+  unsigned int records;
+};
+
+//! \brief Report evaluation throughput (grid cells per second) of each
+//! coupler; uses the maximum time over all processors.
+static PetscErrorCode reportThroughput(IceGrid &grid, PCCTimings &timings) {
+  PetscErrorCode ierr;
+  double local[3] = {timings.surface, timings.ocean, timings.output},
+    times[3];
+
+  ierr = MPI_Allreduce(local, times, 3, MPI_DOUBLE, MPI_MAX, grid.com); CHKERRQ(ierr);
+
+  const double cells = (double)grid.Mx * grid.My * timings.records;
+  const char *names[3] = {"surface", "ocean", "output"};
+
+  ierr = verbPrintf(2, grid.com,
+                    "Throughput (%d records, %d x %d grid):\n"
+                    "  %-10s %12s %14s\n", timings.records, grid.Mx, grid.My,
+                    "", "time, s", "cells/s"); CHKERRQ(ierr);
+  for (int k = 0; k < 3; ++k) {
+    ierr = verbPrintf(2, grid.com, "  %-10s %12.3f %14.4e\n",
+                      names[k], times[k],
+                      times[k] > 0.0 ? cells / times[k] : 0.0); CHKERRQ(ierr);
+  }
+
+  return 0;
+}
+
+//! \brief Update surface and ocean models and compute the fields they
+//! provide to IceModel; accumulates evaluation times.
+static PetscErrorCode evaluateCouplers(PISMSurfaceModel *surface, PISMOceanModel *ocean,
+                                       double t, double dt,
+                                       IceModelVec2S &climatic_mass_balance,
+                                       IceModelVec2S &ice_surface_temp,
+                                       IceModelVec2S &shelfbasetemp,
+                                       IceModelVec2S &shelfbasemassflux,
+                                       PetscReal &sea_level,
+                                       PCCTimings &timings) {
+  PetscErrorCode ierr;
+  PetscLogDouble start, end;
+
+  ierr = PetscGetTime(&start); CHKERRQ(ierr);
+  ierr = surface->update(t, dt); CHKERRQ(ierr);
+  ierr = surface->ice_surface_mass_flux(climatic_mass_balance); CHKERRQ(ierr);
+  ierr = surface->ice_surface_temperature(ice_surface_temp); CHKERRQ(ierr);
+  ierr = PetscGetTime(&end); CHKERRQ(ierr);
+  timings.surface += end - start;
+
+  start = end;
+  ierr = ocean->update(t, dt); CHKERRQ(ierr);
+  ierr = ocean->sea_level_elevation(sea_level); CHKERRQ(ierr);
+  ierr = ocean->shelf_base_temperature(shelfbasetemp); CHKERRQ(ierr);
+  ierr = ocean->shelf_base_mass_flux(shelfbasemassflux); CHKERRQ(ierr);
+  ierr = PetscGetTime(&end); CHKERRQ(ierr);
+  timings.ocean += end - start;
+
+  timings.records += 1;
+
+  return 0;
+}
+
 static PetscErrorCode writePCCStateAtTimes(PISMVars &variables,
 					   PISMSurfaceModel *surface,
 					   PISMOceanModel* ocean,
@@ -257,6 +323,7 @@ static PetscErrorCode writePCCStateAtTimes(PISMVars &variables,
 
   // write the states
   unsigned int record_index = 0;
+  PCCTimings timings;
 
   while (record_index < times.size() && times[record_index] <= grid.time->current())
     record_index++;
@@ -289,17 +356,11 @@ static PetscErrorCode writePCCStateAtTimes(PISMVars &variables,
     ierr = usurf->write(filename, PISM_FLOAT); CHKERRQ(ierr);
 
     // update surface and ocean models' outputs:
-    ierr = surface->update(current_time, dt); CHKERRQ(ierr);
-    ierr = ocean->update(current_time, dt); CHKERRQ(ierr);
-
-    ierr = surface->ice_surface_mass_flux(*climatic_mass_balance); CHKERRQ(ierr);
-    ierr = surface->ice_surface_temperature(*ice_surface_temp); CHKERRQ(ierr);
-
     PetscReal current_sea_level;
-    ierr = ocean->sea_level_elevation(current_sea_level); CHKERRQ(ierr);
-
-    ierr = ocean->shelf_base_temperature(*shelfbasetemp); CHKERRQ(ierr);
-    ierr = ocean->shelf_base_mass_flux(*shelfbasemassflux); CHKERRQ(ierr);
+    ierr = evaluateCouplers(surface, ocean, current_time, dt,
+                            *climatic_mass_balance, *ice_surface_temp,
+                            *shelfbasetemp, *shelfbasemassflux,
+                            current_sea_level, timings); CHKERRQ(ierr);
 
     sea_level.append(current_sea_level, current_time, next_time);
     sea_level.interp(current_time, next_time);
@@ -324,6 +385,136 @@ static PetscErrorCode writePCCStateAtTimes(PISMVars &variables,
   }
   ierr = verbPrintf(2,com,"\n"); CHKERRQ(ierr);
 
+  ierr = reportThroughput(grid, timings); CHKERRQ(ierr);
+
+  return 0;
+}
+
+
+//! \brief Evaluate surface and ocean models over the time axis and save
+//! their outputs in a file that can be replayed using "-surface given" and
+//! "-ocean given".
+/*!
+ * Unlike writePCCStateAtTimes(), this writes only the four fields IceModel
+ * gets from couplers (climatic_mass_balance, ice_surface_temp, shelfbtemp,
+ * shelfbmassflux), in single precision and SI units, plus time bounds. The
+ * file is opened and all the variables are defined once, so each record
+ * costs one put_vec() call per field. There is no limit on the number of
+ * records.
+ *
+ * The value in record k is the average over [times[k], times[k+1]], which
+ * is what PSGivenClimate and POGivenClimate expect to find in a file with
+ * time bounds.
+ */
+static PetscErrorCode writeCouplerCache(PISMVars &variables,
+                                        PISMSurfaceModel *surface,
+                                        PISMOceanModel* ocean,
+                                        string filename, IceGrid& grid,
+                                        vector<double> times,
+                                        NCConfigVariable &mapping) {
+  PetscErrorCode ierr;
+  MPI_Comm com = grid.com;
+  PIO nc(grid.com, grid.rank, grid.config.get_string("output_format"));
+  NCGlobalAttributes global_attrs;
+  NCTimeBounds time_bounds;
+  string time_name = grid.config.get_string("time_dimension_name");
+  PCCTimings timings;
+  PetscLogDouble start, end;
+
+  const char *names[4] = {"climatic_mass_balance", "ice_surface_temp",
+                          "shelfbtemp", "shelfbmassflux"};
+  IceModelVec2S *fields[4];
+  for (int k = 0; k < 4; ++k) {
+    fields[k] = dynamic_cast<IceModelVec2S*>(variables.get(names[k]));
+    if (fields[k] == NULL) SETERRQ1(com, 1, "%s is not available", names[k]);
+  }
+
+  if (times.size() < 2) {
+    ierr = PetscPrintf(com,
+                       "PCLIMATE ERROR: -coupler_cache needs at least two times (one interval).\n");
+    CHKERRQ(ierr);
+    PISMEnd();
+  }
+
+  global_attrs.init("global_attributes", com, grid.rank);
+  global_attrs.set_string("Conventions", "CF-1.5");
+  global_attrs.set_string("source", string("pclimate ") + PISM_Revision);
+  global_attrs.prepend_history(pism_username_prefix() + pism_args_string());
+
+  // create the file (moving an existing one aside) and write metadata:
+  ierr = nc.open(filename, PISM_WRITE); CHKERRQ(ierr);
+  ierr = nc.def_time(time_name, grid.config.get_string("calendar"),
+                     grid.time->units()); CHKERRQ(ierr);
+  ierr = nc.put_att_text(time_name, "bounds", "time_bounds"); CHKERRQ(ierr);
+  ierr = nc.close(); CHKERRQ(ierr);
+
+  ierr = mapping.write(filename); CHKERRQ(ierr);
+  ierr = global_attrs.write(filename); CHKERRQ(ierr);
+
+  // define all the variables before writing any data:
+  ierr = nc.open(filename, PISM_WRITE, true); CHKERRQ(ierr);
+
+  time_bounds.init("time_bounds", time_name, com, grid.rank);
+  ierr = time_bounds.define(nc, PISM_DOUBLE, true); CHKERRQ(ierr);
+
+  vector<NCSpatialVariable> metadata;
+  for (int k = 0; k < 4; ++k) {
+    NCSpatialVariable var = fields[k]->get_metadata();
+    var.time_independent = false;
+    ierr = var.define(nc, PISM_FLOAT, false); CHKERRQ(ierr);
+    metadata.push_back(var);
+  }
+
+  Vec g;
+  ierr = DMCreateGlobalVector(grid.da2, &g); CHKERRQ(ierr);
+
+  ierr = verbPrintf(2, com,
+                    "  caching boundary model outputs for %d intervals...\n",
+                    (int)times.size() - 1); CHKERRQ(ierr);
+
+  for (unsigned int j = 0; j + 1 < times.size(); ++j) {
+    double t = times[j], dt = times[j + 1] - times[j];
+    PetscReal sea_level;
+
+    grid.time->set(t);
+
+    ierr = evaluateCouplers(surface, ocean, t, dt,
+                            *fields[0], *fields[1], *fields[2], *fields[3],
+                            sea_level, timings); CHKERRQ(ierr);
+
+    ierr = PetscGetTime(&start); CHKERRQ(ierr);
+
+    ierr = nc.append_time(time_name, t); CHKERRQ(ierr);
+
+    vector<unsigned int> bounds_start(2), bounds_count(2);
+    bounds_start[0] = j; bounds_start[1] = 0;
+    bounds_count[0] = 1; bounds_count[1] = 2;
+    double bounds[2] = {t, t + dt};
+    ierr = nc.put_vara_double("time_bounds", bounds_start, bounds_count, bounds); CHKERRQ(ierr);
+
+    for (int k = 0; k < 4; ++k) {
+      ierr = fields[k]->copy_to(g); CHKERRQ(ierr);
+      // round as promised by the pism_significant_digits attribute
+      ierr = metadata[k].round_for_output(g, PISM_FLOAT); CHKERRQ(ierr);
+      ierr = nc.put_vec(&grid, names[k], 1, g); CHKERRQ(ierr);
+    }
+
+    ierr = PetscGetTime(&end); CHKERRQ(ierr);
+    timings.output += end - start;
+
+    ierr = verbPrintf(2, com, "."); CHKERRQ(ierr);
+  }
+  ierr = verbPrintf(2, com, "\n"); CHKERRQ(ierr);
+
+  ierr = VecDestroy(&g); CHKERRQ(ierr);
+  ierr = nc.close(); CHKERRQ(ierr);
+
+  ierr = reportThroughput(grid, timings); CHKERRQ(ierr);
+
+  ierr = verbPrintf(2, com,
+                    "  replay using '-surface given -surface_given_file %s -ocean given -ocean_given_file %s'\n",
+                    filename.c_str(), filename.c_str()); CHKERRQ(ierr);
+
   return 0;
 }
 
@@ -366,6 +557,10 @@ int main(int argc, char *argv[]) {
       "  -atmosphere    Chooses an atmosphere model; see User's Manual\n"
       "  -surface       Chooses a surface model; see User's Manual\n"
       "  -ocean         Chooses an ocean model; see User's Manual\n"
+      "and, optionally:\n"
+      "  -coupler_cache save only climatic_mass_balance, ice_surface_temp, shelfbtemp and\n"
+      "                 shelfbmassflux (interval averages) to OUT.nc, to be used with\n"
+      "                 -surface given and -ocean given; reports throughput\n"
       ); CHKERRQ(ierr);
 
     // read the config option database:
@@ -380,15 +575,18 @@ int main(int argc, char *argv[]) {
 
     IceGrid grid(com, rank, size, config);
 
-    bool flag, times_set;
+    bool flag, times_set, coupler_cache;
     string tmp;
     vector<double> times;
     ierr = PetscOptionsBegin(grid.com, "", "PCLIMATE options", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString("-i", "Input file name",  inname, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsString("-o", "Output file name", outname, flag); CHKERRQ(ierr);
-      ierr = PISMOptionsString("-times", "Specifies times to save at",
-                               tmp, times_set); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-i", "Input file name",  inname, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-o", "Output file name", outname, flag); CHKERRQ(ierr);
+      ierr = PISMOptionsString(grid.com, "-times", "Specifies times to save at",
+                                         tmp, times_set); CHKERRQ(ierr);
+      ierr = PISMOptionsIsSet("-coupler_cache",
+                              "Save interval averages of coupler outputs only",
+                              coupler_cache); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -462,8 +660,13 @@ int main(int argc, char *argv[]) {
         "writing boundary model states to NetCDF file '%s' ...\n",
         outname.c_str()); CHKERRQ(ierr);
 
-    ierr = writePCCStateAtTimes(variables, surface, ocean,
-                                outname, grid, times, mapping); CHKERRQ(ierr);
+    if (coupler_cache) {
+      ierr = writeCouplerCache(variables, surface, ocean,
+                               outname, grid, times, mapping); CHKERRQ(ierr);
+    } else {
+      ierr = writePCCStateAtTimes(variables, surface, ocean,
+                                  outname, grid, times, mapping); CHKERRQ(ierr);
+    }
 
     if (override_used) {
       ierr = verbPrintf(3, com,
@@ -0,0 +1,458 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+static char help[] =
+  "Ensemble driver for PISM: runs several pismr-like members, which differ only\n"
+  "in a few options, in one MPI job.\n";
+
+#include <petsc.h>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include "IceGrid.hh"
+#include "iceModel.hh"
+
+#include "pism_options.hh"
+#include "PAFactory.hh"
+#include "POFactory.hh"
+#include "PSFactory.hh"
+
+//! \brief Reads the list of ensemble members (one line of options per member)
+//! on processor 0 and broadcasts it.
+/*!
+ * Empty lines and lines starting with '#' are ignored.
+ */
+static PetscErrorCode read_members(MPI_Comm com, PetscMPIInt rank,
+                                   string filename, vector<string> &result) {
+  PetscErrorCode ierr;
+  int n_members = 0;
+
+  result.clear();
+
+  if (rank == 0) {
+    ifstream f(filename.c_str());
+    string line;
+
+    while (getline(f, line)) {
+      string::size_type j = line.find_first_not_of(" \t");
+      if (j == string::npos || line[j] == '#')
+        continue;
+      result.push_back(line);
+    }
+    n_members = (int)result.size();
+  }
+
+  ierr = MPI_Bcast(&n_members, 1, MPI_INT, 0, com); CHKERRQ(ierr);
+
+  for (int k = 0; k < n_members; ++k) {
+    int length = 0;
+    if (rank == 0)
+      length = (int)result[k].size() + 1;
+
+    ierr = MPI_Bcast(&length, 1, MPI_INT, 0, com); CHKERRQ(ierr);
+
+    vector<char> buffer(length);
+    if (rank == 0)
+      strncpy(&buffer[0], result[k].c_str(), length);
+
+    ierr = MPI_Bcast(&buffer[0], length, MPI_CHAR, 0, com); CHKERRQ(ierr);
+
+    if (rank != 0)
+      result.push_back(&buffer[0]);
+  }
+
+  return 0;
+}
+
+//! \brief Adds "_member<N>" to the file name given using \c option (if set),
+//! so that members do not overwrite each other's output.
+static PetscErrorCode add_member_suffix(MPI_Comm com, string option, int member) {
+  PetscErrorCode ierr;
+  string filename;
+  bool flag;
+  char suffix[TEMPORARY_STRING_LENGTH];
+
+  ierr = PISMOptionsString(com, option, "", filename, flag); CHKERRQ(ierr);
+  if (flag == false)
+    return 0;
+
+  snprintf(suffix, TEMPORARY_STRING_LENGTH, "%d", member);
+  filename = pism_filename_add_suffix(filename, "_member", suffix);
+
+  ierr = PetscOptionsSetValue(option.c_str(), filename.c_str()); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Returns true if `option` names an input file shared by all members.
+/*!
+ * All options ending in "_file" (-boot_file, -regrid_file, the -atmosphere_*,
+ * -surface_* and -ocean_* forcing files, ...) except the ones naming output
+ * files are treated as inputs.
+ */
+static bool is_shared_input(string option) {
+  const char *outputs[] = {"-ts_file", "-extra_file", "-save_file", "-report_file",
+                           "-ensemble_file", NULL};
+
+  if (option == "-i")
+    return true;
+
+  const string suffix = "_file";
+  if (option.size() <= suffix.size() ||
+      option.compare(option.size() - suffix.size(), suffix.size(), suffix) != 0)
+    return false;
+
+  for (int k = 0; outputs[k] != NULL; ++k) {
+    if (option == outputs[k])
+      return false;
+  }
+
+  return true;
+}
+
+//! \brief Creates a communicator containing processes running on the same
+//! node as the current one.
+/*!
+ * Nodes are identified by MPI_Get_processor_name(). The process with the
+ * lowest rank in `world` gets the rank 0 in the resulting communicator.
+ */
+static PetscErrorCode split_by_node(MPI_Comm world, MPI_Comm &node) {
+  PetscErrorCode ierr;
+  PetscMPIInt rank, size;
+  char name[MPI_MAX_PROCESSOR_NAME];
+  int length;
+
+  ierr = MPI_Comm_rank(world, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(world, &size); CHKERRQ(ierr);
+
+  memset(name, 0, MPI_MAX_PROCESSOR_NAME);
+  ierr = MPI_Get_processor_name(name, &length); CHKERRQ(ierr);
+
+  vector<char> names(size * MPI_MAX_PROCESSOR_NAME);
+  ierr = MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                       &names[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR, world); CHKERRQ(ierr);
+
+  // the color is the lowest rank on this node
+  int color = rank;
+  for (int r = 0; r < size; ++r) {
+    if (strncmp(name, &names[r * MPI_MAX_PROCESSOR_NAME], MPI_MAX_PROCESSOR_NAME) == 0) {
+      color = r;
+      break;
+    }
+  }
+
+  ierr = MPI_Comm_split(world, color, rank, &node); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! \brief Copies shared input files to node-local storage, reading each of
+//! them once per job.
+/*!
+ * Processor 0 reads each input file given on the command line (see
+ * is_shared_input()) in chunks and broadcasts it to one process per node,
+ * which writes it to `stage_dir` (a RAM disk such as /dev/shm, or a
+ * node-local scratch directory). Options are then changed to point to these
+ * copies, so members read bootstrapping and forcing data from node-local
+ * storage instead of hammering the shared file system N times.
+ *
+ * Names of the copies are added to `staged`; they are removed by
+ * remove_staged_inputs().
+ */
+static PetscErrorCode stage_shared_inputs(MPI_Comm world, int argc, char *argv[],
+                                          string stage_dir, vector<string> &staged) {
+  PetscErrorCode ierr;
+  PetscMPIInt rank, node_rank;
+  MPI_Comm node, leaders;
+  const long int chunk_size = 64 * 1024 * 1024;
+
+  ierr = MPI_Comm_rank(world, &rank); CHKERRQ(ierr);
+
+  ierr = split_by_node(world, node); CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(node, &node_rank); CHKERRQ(ierr);
+
+  // processes writing copies; processor 0 of world is one of them
+  ierr = MPI_Comm_split(world, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders); CHKERRQ(ierr);
+
+  // make names of copies unique to this job
+  int tag = (int)getpid();
+  ierr = MPI_Bcast(&tag, 1, MPI_INT, 0, world); CHKERRQ(ierr);
+
+  vector<char> buffer;
+  int n_staged = 0;
+  for (int k = 1; k < argc - 1; ++k) {
+    string option = argv[k], filename = argv[k + 1];
+
+    if (option.size() < 2 || option[0] != '-' || is_shared_input(option) == false)
+      continue;
+
+    string basename = filename.substr(filename.find_last_of('/') + 1);
+    char copy[PETSC_MAX_PATH_LEN];
+    snprintf(copy, PETSC_MAX_PATH_LEN, "%s/pism_ensemble_%d_%d_%s",
+             stage_dir.c_str(), tag, n_staged, basename.c_str());
+
+    int failed = 0;
+    if (node_rank == 0) {
+      FILE *input = NULL, *output = NULL;
+      long int size = 0;
+
+      if (rank == 0) {
+        input = fopen(filename.c_str(), "rb");
+        if (input != NULL) {
+          fseek(input, 0, SEEK_END);
+          size = ftell(input);
+          fseek(input, 0, SEEK_SET);
+        } else {
+          size = -1;
+        }
+      }
+
+      ierr = MPI_Bcast(&size, 1, MPI_LONG, 0, leaders); CHKERRQ(ierr);
+
+      if (size >= 0) {
+        output = fopen(copy, "wb");
+        if (output == NULL)
+          failed = 1;
+
+        buffer.resize(PetscMin(size, chunk_size) + 1);
+        for (long int offset = 0; offset < size; offset += chunk_size) {
+          const long int length = PetscMin(chunk_size, size - offset);
+
+          if (rank == 0 && fread(&buffer[0], 1, length, input) != (size_t)length)
+            failed = 1;
+
+          ierr = MPI_Bcast(&buffer[0], (int)length, MPI_BYTE, 0, leaders); CHKERRQ(ierr);
+
+          if (output != NULL && fwrite(&buffer[0], 1, length, output) != (size_t)length)
+            failed = 1;
+        }
+      } else {
+        // processor 0 cannot read this file; leave the option alone so that
+        // the member reports the error
+        failed = -1;
+      }
+
+      if (input != NULL)
+        fclose(input);
+      if (output != NULL)
+        fclose(output);
+    }
+
+    // -1 (cannot read) wins over 1 (cannot write a copy)
+    int result = 0;
+    ierr = MPI_Allreduce(&failed, &result, 1, MPI_INT, MPI_MIN, world); CHKERRQ(ierr);
+    if (result == 0) {
+      ierr = MPI_Allreduce(&failed, &result, 1, MPI_INT, MPI_MAX, world); CHKERRQ(ierr);
+    }
+
+    if (result == 1) {
+      ierr = PetscPrintf(world,
+                         "PISM ERROR: cannot copy '%s' to '%s' (see -ensemble_stage_dir).\n",
+                         filename.c_str(), copy); CHKERRQ(ierr);
+      PISMEnd();
+    }
+
+    if (result == 0) {
+      ierr = PetscOptionsSetValue(option.c_str(), copy); CHKERRQ(ierr);
+      ierr = verbPrintf(2, world, "  %s %s: using the node-local copy %s\n",
+                        option.c_str(), filename.c_str(), copy); CHKERRQ(ierr);
+      if (node_rank == 0)
+        staged.push_back(copy);
+      n_staged++;
+    }
+  }
+
+  if (leaders != MPI_COMM_NULL) {
+    ierr = MPI_Comm_free(&leaders); CHKERRQ(ierr);
+  }
+  ierr = MPI_Comm_free(&node); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! Removes copies made by stage_shared_inputs() (once all members are done).
+static PetscErrorCode remove_staged_inputs(MPI_Comm world, vector<string> &staged) {
+  PetscErrorCode ierr;
+
+  ierr = MPI_Barrier(world); CHKERRQ(ierr);
+
+  for (unsigned int k = 0; k < staged.size(); ++k)
+    remove(staged[k].c_str());
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  PetscErrorCode  ierr;
+
+  MPI_Comm    world, com;
+  PetscMPIInt world_rank, world_size, rank, size;
+
+  ierr = PetscInitialize(&argc, &argv, PETSC_NULL, help); CHKERRQ(ierr);
+
+  world = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_rank(world, &world_rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(world, &world_size); CHKERRQ(ierr);
+
+  /* This explicit scoping forces destructors to be called before PetscFinalize() */
+  {
+    ierr = verbosityLevelFromOptions(); CHKERRQ(ierr);
+
+    ierr = verbPrintf(2, world, "PISMR_ENSEMBLE %s (ensemble run mode)\n",
+		      PISM_Revision); CHKERRQ(ierr);
+    ierr = stop_on_version_option(); CHKERRQ(ierr);
+
+    bool ensemble_file_set;
+    string ensemble_file;
+    ierr = PISMOptionsString(world, "-ensemble_file", "Specifies the file listing ensemble members",
+                                    ensemble_file, ensemble_file_set); CHKERRQ(ierr);
+
+    string usage =
+      "  pismr_ensemble -ensemble_file MEMBERS.txt {-i IN.nc|-boot_file IN.nc} [OTHER PISM & PETSc OPTIONS]\n"
+      "where:\n"
+      "  -ensemble_file  MEMBERS.txt lists ensemble members, one line of options per member,\n"
+      "                  for example '-sia_e 3.0 -pdd_factor_ice 0.008'\n"
+      "notes:\n"
+      "  * the number of processes has to be divisible by the number of members\n"
+      "  * options in MEMBERS.txt override options given on the command line\n"
+      "  * output file names (-o, -ts_file, -extra_file, -save_file) get the suffix '_memberN'\n"
+      "  * input files given on the command line (-i, -boot_file and other *_file options)\n"
+      "    are read once and copied to -ensemble_stage_dir (default: /dev/shm) on each node;\n"
+      "    use -ensemble_no_staging to disable this\n"
+      "  * -ensemble_write_groups N: members write their final output in N turns\n";
+
+    bool iset, bfset;
+    ierr = PISMOptionsIsSet("-i", iset); CHKERRQ(ierr);
+    ierr = PISMOptionsIsSet("-boot_file", bfset); CHKERRQ(ierr);
+    if (ensemble_file_set == false || ((iset == PETSC_FALSE) && (bfset == PETSC_FALSE))) {
+      ierr = PetscPrintf(world,
+         "\nPISM ERROR: options -ensemble_file and one of -i,-boot_file are required\n\n"); CHKERRQ(ierr);
+      ierr = show_usage_and_quit(world, "pismr_ensemble", usage.c_str()); CHKERRQ(ierr);
+    }
+
+    vector<string> members;
+    ierr = read_members(world, world_rank, ensemble_file, members); CHKERRQ(ierr);
+
+    int n_members = (int)members.size();
+    if (n_members == 0 || world_size % n_members != 0) {
+      ierr = PetscPrintf(world,
+                         "PISM ERROR: %d processes cannot be split evenly between %d ensemble members (listed in '%s').\n",
+                         world_size, n_members, ensemble_file.c_str()); CHKERRQ(ierr);
+      PISMEnd();
+    }
+
+    // Each member gets a contiguous block of processes:
+    int member = world_rank / (world_size / n_members);
+    ierr = MPI_Comm_split(world, member, world_rank, &com); CHKERRQ(ierr);
+    ierr = MPI_Comm_rank(com, &rank); CHKERRQ(ierr);
+    ierr = MPI_Comm_size(com, &size); CHKERRQ(ierr);
+
+    ierr = verbPrintf(2, world, "  running %d members using %d processes each\n",
+                      n_members, size); CHKERRQ(ierr);
+
+    // Read shared inputs once and put copies on each node (before inserting
+    // member options, which may replace some of them).
+    vector<string> staged;
+    bool no_staging;
+    ierr = PISMOptionsIsSet("-ensemble_no_staging", no_staging); CHKERRQ(ierr);
+    if (no_staging == false) {
+      string stage_dir = "/dev/shm";
+      bool flag;
+      ierr = PISMOptionsString(world, "-ensemble_stage_dir",
+                               "Node-local directory for copies of shared input files",
+                               stage_dir, flag); CHKERRQ(ierr);
+      ierr = stage_shared_inputs(world, argc, argv, stage_dir, staged); CHKERRQ(ierr);
+    }
+
+    // Members writing at the same time compete for the file system, so
+    // final outputs can be written in turns.
+    PetscInt write_groups = 1;
+    {
+      bool flag;
+      ierr = PISMOptionsInt(world, "-ensemble_write_groups",
+                            "Number of turns members take to write their final output",
+                            write_groups, flag); CHKERRQ(ierr);
+      write_groups = PetscMax(1, PetscMin(write_groups, n_members));
+    }
+
+    // The options database is per-process, so each member can have its own
+    // options:
+    ierr = PetscOptionsInsertString(members[member].c_str()); CHKERRQ(ierr);
+    ierr = add_member_suffix(com, "-o", member); CHKERRQ(ierr);
+    ierr = add_member_suffix(com, "-ts_file", member); CHKERRQ(ierr);
+    ierr = add_member_suffix(com, "-extra_file", member); CHKERRQ(ierr);
+    ierr = add_member_suffix(com, "-save_file", member); CHKERRQ(ierr);
+
+    ierr = verbPrintf(3, com, "  member %d: '%s'\n", member, members[member].c_str()); CHKERRQ(ierr);
+
+    {
+      NCConfigVariable config, overrides;
+      ierr = init_config(com, rank, config, overrides, true); CHKERRQ(ierr);
+
+      IceGrid g(com, rank, size, config);
+      IceModel m(g, config, overrides);
+
+      // Initialize boundary models:
+      PAFactory pa(g, config);
+      PISMAtmosphereModel *atmosphere;
+
+      PSFactory ps(g, config);
+      PISMSurfaceModel *surface;
+
+      POFactory po(g, config);
+      PISMOceanModel *ocean;
+
+      ierr = PetscOptionsBegin(com, "", "Options choosing PISM boundary models", ""); CHKERRQ(ierr);
+      pa.create(atmosphere);
+      ps.create(surface);
+      po.create(ocean);
+      ierr = PetscOptionsEnd(); CHKERRQ(ierr);
+
+      surface->attach_atmosphere_model(atmosphere);
+
+      m.attach_ocean_model(ocean);
+      m.attach_surface_model(surface);
+      ierr = m.setExecName("pismr"); CHKERRQ(ierr);
+
+      ierr = m.init(); CHKERRQ(ierr);
+
+      ierr = m.run(); CHKERRQ(ierr);
+
+      ierr = verbPrintf(2, com, "... done with run (member %d)\n", member); CHKERRQ(ierr);
+
+      char default_output[TEMPORARY_STRING_LENGTH];
+      snprintf(default_output, TEMPORARY_STRING_LENGTH, "unnamed_member%d.nc", member);
+      for (int turn = 0; turn < write_groups; ++turn) {
+        if (member % write_groups == turn) {
+          ierr = m.writeFiles(default_output); CHKERRQ(ierr);
+        }
+        if (write_groups > 1) {
+          ierr = MPI_Barrier(world); CHKERRQ(ierr);
+        }
+      }
+    }
+
+    ierr = remove_staged_inputs(world, staged); CHKERRQ(ierr);
+
+    ierr = MPI_Comm_free(&com); CHKERRQ(ierr);
+  }
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  return 0;
+}
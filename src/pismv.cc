@@ -85,8 +85,8 @@ int main(int argc, char *argv[]) {
     bool   test_chosen;
     ierr = PetscOptionsBegin(g.com, "", "Options specific to PISMV", ""); CHKERRQ(ierr);
     {
-      ierr = PISMOptionsString("-test", "Specifies PISM verification test",
-			       testname, test_chosen); CHKERRQ(ierr);
+      ierr = PISMOptionsString(g.com, "-test", "Specifies PISM verification test",
+       			       testname, test_chosen); CHKERRQ(ierr);
     }
     ierr = PetscOptionsEnd(); CHKERRQ(ierr);
 
@@ -201,9 +201,9 @@ PetscErrorCode IceRegionalModel::model_state_setup() {
 
   bool nmstripSet;
   PetscReal stripkm = 0.0;
-  ierr = PISMOptionsReal("-no_model_strip", 
-                         "width in km of strip near boundary in which modeling is turned off",
-			 stripkm, nmstripSet);
+  ierr = PISMOptionsReal(grid.com, "-no_model_strip", 
+                                   "width in km of strip near boundary in which modeling is turned off",
+          			 stripkm, nmstripSet);
 
   if (nmstripSet) {
     ierr = verbPrintf(2, grid.com,
@@ -0,0 +1,173 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <petsc.h>
+#include <vector>
+#include "pism_const.hh"
+#include "NCVariable.hh"
+#include "enthalpyConverter.hh"
+#include "varcEnthalpyConverter.hh"
+#include "pism_options.hh"
+
+static char help[] =
+  "Times EnthalpyConverter methods: point-wise (one virtual call per level),\n"
+  "inline value-returning and column-wise (one virtual call per column)\n"
+  "conversions from enthalpy to temperature and liquid water fraction, using\n"
+  "EnthalpyConverter and varcEnthalpyConverter (exact and tabulated).  Checks\n"
+  "that all versions agree and prints the maximum error of the tabulated\n"
+  "temperature.\n"
+  "Exits with status 1 if any of these checks fails.\n";
+
+//! Converts N columns of Mz levels point-wise, using inline methods and
+//! column-wise; prints timing and returns the maximum difference between the
+//! point-wise results and the other two.
+static PetscErrorCode time_converter(const char *name, EnthalpyConverter &EC,
+                                     int N, int Mz, double H,
+                                     vector<double> &z, vector<double> &E,
+                                     vector<double> &T_column, double &max_diff) {
+  PetscErrorCode ierr;
+  PetscLogDouble start, point_time, inline_time, column_time;
+  vector<double> T(Mz), omega(Mz), T_inline(Mz), omega_inline(Mz), omega_column(Mz);
+
+  max_diff = 0.0;
+
+  ierr = PetscGetTime(&start); CHKERRQ(ierr);
+  for (int n = 0; n < N; ++n) {
+    for (int k = 0; k < Mz; ++k) {
+      const double p = EC.getPressureFromDepth(H - z[k]);
+      EC.getPATemp(E[k], p, T[k]);
+      EC.getWaterFraction(E[k], p, omega[k]);
+    }
+  }
+  ierr = PetscGetTime(&point_time); CHKERRQ(ierr);
+  point_time -= start;
+
+  ierr = PetscGetTime(&start); CHKERRQ(ierr);
+  for (int n = 0; n < N; ++n) {
+    for (int k = 0; k < Mz; ++k) {
+      const double p = EC.getPressureFromDepth(H - z[k]);
+      T_inline[k]     = EC.pa_temperature(E[k], p);
+      omega_inline[k] = EC.water_fraction(E[k], p);
+    }
+  }
+  ierr = PetscGetTime(&inline_time); CHKERRQ(ierr);
+  inline_time -= start;
+
+  ierr = PetscGetTime(&start); CHKERRQ(ierr);
+  for (int n = 0; n < N; ++n) {
+    EC.getPATempColumn(&E[0], H, &z[0], Mz, &T_column[0]);
+    EC.getWaterFractionColumn(&E[0], H, &z[0], Mz, &omega_column[0]);
+  }
+  ierr = PetscGetTime(&column_time); CHKERRQ(ierr);
+  column_time -= start;
+
+  for (int k = 0; k < Mz; ++k) {
+    max_diff = PetscMax(max_diff, PetscAbs(T[k] - T_column[k]));
+    max_diff = PetscMax(max_diff, PetscAbs(omega[k] - omega_column[k]));
+    max_diff = PetscMax(max_diff, PetscAbs(T[k] - T_inline[k]));
+    max_diff = PetscMax(max_diff, PetscAbs(omega[k] - omega_inline[k]));
+  }
+
+  const double levels = (double)N * Mz;
+  printf("%-26s point-wise: %8.3f s (%9.3e levels/s), inline: %8.3f s (%9.3e levels/s), column-wise: %8.3f s (%9.3e levels/s)\n",
+         name, point_time, levels / point_time, inline_time, levels / inline_time,
+         column_time, levels / column_time);
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  PetscErrorCode  ierr;
+
+  MPI_Comm    com;
+  PetscMPIInt rank, size;
+  int         status = 0;
+
+  ierr = PetscInitialize(&argc, &argv, PETSC_NULL, help); CHKERRQ(ierr);
+
+  com = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_rank(com, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(com, &size); CHKERRQ(ierr);
+
+  /* This explicit scoping forces destructors to be called before PetscFinalize() */
+  {
+    NCConfigVariable config, overrides;
+    ierr = init_config(com, rank, config, overrides); CHKERRQ(ierr);
+
+    PetscInt N = 10000, Mz = 201;
+    bool flag;
+    ierr = PISMOptionsInt(com, "-N", "Number of columns", N, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(com, "-Mz", "Number of levels in a column", Mz, flag); CHKERRQ(ierr);
+
+    // A 3000 m thick column with temperate ice near the base and cold ice
+    // above; the top 10% of the levels are above the surface.
+    const double H = 3000.0, Lz = 1.1 * H;
+    vector<double> z(Mz), E(Mz), T_exact(Mz), T_tabulated(Mz);
+
+    EnthalpyConverter EC(config);
+    for (int k = 0; k < Mz; ++k) {
+      z[k] = Lz * k / (Mz - 1);
+      const double p = EC.getPressureFromDepth(H - z[k]),
+        T_m = EC.getMeltingTemp(p),
+        T = T_m - 40.0 * z[k] / Lz;      // from T_m at the base to T_m - 40 K at the top
+      if (k < Mz / 20) {
+        ierr = EC.getEnthAtWaterFraction(0.01, p, E[k]); CHKERRQ(ierr);
+      } else {
+        ierr = EC.getEnth(T, 0.0, p, E[k]); CHKERRQ(ierr);
+      }
+    }
+
+    double max_diff;
+    printf("converting %d columns, %d levels each:\n", N, Mz);
+
+    ierr = time_converter("EnthalpyConverter", EC, N, Mz, H, z, E, T_exact, max_diff); CHKERRQ(ierr);
+    printf("  max. difference between point-wise and inline/column-wise: %9.3e\n", max_diff);
+    if (max_diff > 1e-9)
+      status = 1;
+
+    config.set_flag("enthalpy_converter_tabulated", false);
+    varcEnthalpyConverter varc(config);
+    ierr = time_converter("varcEnthalpyConverter", varc, N, Mz, H, z, E, T_exact, max_diff); CHKERRQ(ierr);
+    printf("  max. difference between point-wise and inline/column-wise: %9.3e\n", max_diff);
+    if (max_diff > 1e-9)
+      status = 1;
+
+    config.set_flag("enthalpy_converter_tabulated", true);
+    varcEnthalpyConverter varc_tabulated(config);
+    ierr = time_converter("varcEnthalpyConverter (tab)", varc_tabulated, N, Mz, H, z, E, T_tabulated, max_diff); CHKERRQ(ierr);
+    printf("  max. difference between point-wise and inline/column-wise: %9.3e\n", max_diff);
+    if (max_diff > 1e-9)
+      status = 1;
+
+    double table_error = 0.0;
+    for (int k = 0; k < Mz; ++k)
+      table_error = PetscMax(table_error, PetscAbs(T_exact[k] - T_tabulated[k]));
+
+    printf("max. error of the tabulated temperature: %9.3e K (tolerance: %9.3e K)\n",
+           table_error, config.get("enthalpy_converter_table_tolerance"));
+
+    if (table_error > config.get("enthalpy_converter_table_tolerance"))
+      status = 1;
+
+    if (status != 0)
+      printf("FAILED\n");
+  } // end explicit scope
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  return status;
+}
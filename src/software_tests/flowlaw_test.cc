@@ -61,8 +61,8 @@ int main(int argc, char *argv[]) {
     ice_factory.create(&flow_law);
 
     bool dummy;
-    ierr = PISMOptionsString("-flow_law", "Selects the flow law",
-                             flow_law_name, dummy); CHKERRQ(ierr);
+    ierr = PISMOptionsString(com, "-flow_law", "Selects the flow law",
+                                  flow_law_name, dummy); CHKERRQ(ierr);
 
     double     TpaC[]  = {-30.0, -5.0, 0.0, 0.0},  // pressure-adjusted, deg C
                depth   = 2000.0,
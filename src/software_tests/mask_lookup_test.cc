@@ -0,0 +1,158 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <petsc.h>
+#include "pism_const.hh"
+#include "pism_options.hh"
+#include "IceGrid.hh"
+#include "iceModelVec.hh"
+#include "NCVariable.hh"
+#include "Mask.hh"
+
+static char help[] =
+  "Times five-point mask lookups (MaskQuery::ice_margin()) using an\n"
+  "IceModelVec2Int (PetscScalar storage) and using IceModelVec2IntCompact\n"
+  "(one byte per grid point, including ghosts).  The time needed to update\n"
+  "the compact copy is reported separately; it is paid once per mask change.\n"
+  "Exits with status 1 if the two versions disagree.\n";
+
+//! Fills the mask with a pattern containing all four mask values and many
+//! ice margins: an ice sheet with an ice shelf and ice-free patches.
+static PetscErrorCode fill_mask(IceGrid &grid, IceModelVec2Int &mask) {
+  PetscErrorCode ierr;
+
+  ierr = mask.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      const bool ocean = i > grid.Mx / 2,
+        ice_free = ((i / 7) * 13 + (j / 5) * 7) % 11 == 0;
+      if (ocean)
+        mask(i, j) = ice_free ? MASK_ICE_FREE_OCEAN : MASK_FLOATING;
+      else
+        mask(i, j) = ice_free ? MASK_ICE_FREE_BEDROCK : MASK_GROUNDED;
+    }
+  }
+  ierr = mask.end_access(); CHKERRQ(ierr);
+
+  ierr = mask.beginGhostComm(); CHKERRQ(ierr);
+  ierr = mask.endGhostComm(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  PetscErrorCode  ierr;
+
+  MPI_Comm    com;
+  PetscMPIInt rank, size;
+  int         status = 0;
+
+  ierr = PetscInitialize(&argc, &argv, PETSC_NULL, help); CHKERRQ(ierr);
+
+  com = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_rank(com, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(com, &size); CHKERRQ(ierr);
+
+  /* This explicit scoping forces destructors to be called before PetscFinalize() */
+  {
+    NCConfigVariable config, overrides;
+    ierr = init_config(com, rank, config, overrides); CHKERRQ(ierr);
+
+    PetscInt Mxy = 1001, N = 20;
+    bool flag;
+    ierr = PISMOptionsInt(com, "-M", "Number of grid points in each direction", Mxy, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(com, "-N", "Number of sweeps over the grid", N, flag); CHKERRQ(ierr);
+
+    IceGrid grid(com, rank, size, config);
+    grid.Mx = Mxy;
+    grid.My = Mxy;
+    grid.Lx = 1000e3;
+    grid.Ly = grid.Lx;
+    grid.compute_nprocs();
+    grid.compute_ownership_ranges();
+    ierr = grid.compute_horizontal_spacing(); CHKERRQ(ierr);
+    ierr = grid.createDA(); CHKERRQ(ierr);
+
+    IceModelVec2Int mask;
+    ierr = mask.create(grid, "mask", true, 1); CHKERRQ(ierr);
+    ierr = fill_mask(grid, mask); CHKERRQ(ierr);
+
+    const PetscInt xs = grid.xs, ys = grid.ys, xm = grid.xm, ym = grid.ym;
+    PetscLogDouble start, scalar_time, pack_time, compact_time;
+    long scalar_count = 0, compact_count = 0;
+
+    // Count ice margin cells using the PetscScalar storage.
+    MaskQuery M(mask);
+    ierr = mask.begin_access(); CHKERRQ(ierr);
+    ierr = PetscGetTime(&start); CHKERRQ(ierr);
+    for (int n = 0; n < N; ++n) {
+      for (PetscInt i = xs; i < xs + xm; ++i) {
+        for (PetscInt j = ys; j < ys + ym; ++j) {
+          if (M.ice_margin(i, j))
+            scalar_count++;
+        }
+      }
+    }
+    ierr = PetscGetTime(&scalar_time); CHKERRQ(ierr);
+    scalar_time -= start;
+    ierr = mask.end_access(); CHKERRQ(ierr);
+
+    IceModelVec2IntCompact compact;
+    ierr = PetscGetTime(&start); CHKERRQ(ierr);
+    ierr = compact.update(mask); CHKERRQ(ierr);
+    ierr = PetscGetTime(&pack_time); CHKERRQ(ierr);
+    pack_time -= start;
+
+    // The same using the compact copy.
+    CompactMaskQuery C(compact);
+    ierr = PetscGetTime(&start); CHKERRQ(ierr);
+    for (int n = 0; n < N; ++n) {
+      for (PetscInt i = xs; i < xs + xm; ++i) {
+        for (PetscInt j = ys; j < ys + ym; ++j) {
+          if (C.ice_margin(i, j))
+            compact_count++;
+        }
+      }
+    }
+    ierr = PetscGetTime(&compact_time); CHKERRQ(ierr);
+    compact_time -= start;
+
+    const double lookups = (double)N * xm * ym;
+    ierr = PetscSynchronizedPrintf(com,
+                                   "[%d] %d x %d points, %d sweeps:\n"
+                                   "  PetscScalar storage: %8.3f s (%9.3e lookups/s)\n"
+                                   "  compact copy:        %8.3f s (%9.3e lookups/s), speedup %5.2f\n"
+                                   "  updating the copy:   %8.3f s (%5.1f%% of one PetscScalar sweep)\n"
+                                   "  bytes per point:     %d vs. %d\n",
+                                   rank, xm, ym, N,
+                                   scalar_time, lookups / scalar_time,
+                                   compact_time, lookups / compact_time, scalar_time / compact_time,
+                                   pack_time, 100.0 * pack_time / (scalar_time / N),
+                                   (int)sizeof(PetscScalar), (int)sizeof(signed char)); CHKERRQ(ierr);
+    ierr = PetscSynchronizedFlush(com); CHKERRQ(ierr);
+
+    if (scalar_count != compact_count) {
+      printf("[%d] FAILED: %ld margin cells using PetscScalar storage, %ld using the compact copy\n",
+             rank, scalar_count, compact_count);
+      status = 1;
+    }
+  } // end explicit scope
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  return status;
+}
@@ -58,15 +58,15 @@ int main(int argc, char**argv) {
     // the size of the local block of data:
     int Mx = 801, My = 801, Mz = 201, n_vars = 4;
 
-    ierr = PISMOptionsInt("-Mx", "Number of grid points in the x-direction (for each block)",
-                          Mx, flag); CHKERRQ(ierr);
-    ierr = PISMOptionsInt("-My", "Number of grid points in the y-direction (for each block)",
-                          My, flag); CHKERRQ(ierr);
-    ierr = PISMOptionsInt("-Mz", "Number of grid points in the z-direction",
-                          Mz, flag); CHKERRQ(ierr);
-
-    ierr = PISMOptionsInt("-n_vars", "Number of variables to write",
-                          n_vars, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(mpi_comm, "-Mx", "Number of grid points in the x-direction (for each block)",
+                                    Mx, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(mpi_comm, "-My", "Number of grid points in the y-direction (for each block)",
+                                    My, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(mpi_comm, "-Mz", "Number of grid points in the z-direction",
+                                    Mz, flag); CHKERRQ(ierr);
+
+    ierr = PISMOptionsInt(mpi_comm, "-n_vars", "Number of variables to write",
+                                    n_vars, flag); CHKERRQ(ierr);
 
     ierr = PISMOptionsIsSet("-close", "Close and re-open the file",
                             close_and_reopen); CHKERRQ(ierr);
@@ -0,0 +1,207 @@
+// Copyright (C) 2012 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <petsc.h>
+#include <cmath>
+#include "pism_const.hh"
+#include "pism_options.hh"
+#include "IceGrid.hh"
+#include "iceModelVec.hh"
+#include "NCVariable.hh"
+
+static char help[] =
+  "Translates a Gaussian enthalpy blob across the (periodic) domain using the\n"
+  "semi-Lagrangian scheme (IceModelVec3::getValDeparture_fine()) with the\n"
+  "Courant number -cfl and a halo of width ceil(cfl), and using first-order\n"
+  "upwinding with Courant numbers at most 1.  Both are compared to the exact\n"
+  "solution.  Exits with status 1 if the semi-Lagrangian error exceeds the\n"
+  "upwind error or -max_error.\n";
+
+//! Periodic distance between grid indices a and b, in grid cells.
+static double periodic_distance(double a, double b, int N) {
+  double d = fabs(a - b);
+  d = fmod(d, (double)N);
+  return PetscMin(d, N - d);
+}
+
+//! Sets `result` to the blob of radius `sigma` centered at (x0, y0) (in grid
+//! units).
+static PetscErrorCode set_blob(IceGrid &grid, double x0, double y0, double sigma,
+                               IceModelVec3 &result) {
+  PetscErrorCode ierr;
+
+  ierr = result.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      const double
+        x = periodic_distance(i, x0, grid.Mx),
+        y = periodic_distance(j, y0, grid.My);
+      ierr = result.setColumn(i, j, exp(-(x*x + y*y) / (2.0 * sigma*sigma))); CHKERRQ(ierr);
+    }
+  }
+  ierr = result.end_access(); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! Takes one step moving `E` by (cx, cy) grid cells, putting new values in `work`
+//! and communicating them back to `E`.
+static PetscErrorCode advect(IceGrid &grid, bool semi_lagrangian, double cx, double cy,
+                             IceModelVec3 &E, IceModelVec3 &work) {
+  PetscErrorCode ierr;
+  planeStar<PetscScalar> ss;
+
+  ierr = E.begin_access(); CHKERRQ(ierr);
+  ierr = work.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      PetscScalar value;
+      if (semi_lagrangian) {
+        value = E.getValDeparture_fine(i, j, 0, cx, cy);
+      } else {
+        // cx and cy are positive
+        ierr = E.getPlaneStar_fine(i, j, 0, &ss); CHKERRQ(ierr);
+        value = ss.ij - cx * (ss.ij - ss.w) - cy * (ss.ij - ss.s);
+      }
+      ierr = work.setColumn(i, j, value); CHKERRQ(ierr);
+    }
+  }
+  ierr = work.end_access(); CHKERRQ(ierr);
+  ierr = E.end_access(); CHKERRQ(ierr);
+
+  ierr = E.beginGhostCommTransfer(work); CHKERRQ(ierr);
+  ierr = E.endGhostCommTransfer(work); CHKERRQ(ierr);
+
+  return 0;
+}
+
+//! Returns the maximum (over the whole grid) difference between `E` and `exact`.
+static PetscErrorCode max_error(IceGrid &grid, IceModelVec3 &E, IceModelVec3 &exact,
+                                double &result) {
+  PetscErrorCode ierr;
+  PetscScalar *a, *b;
+  double my_error = 0.0;
+
+  ierr = E.begin_access(); CHKERRQ(ierr);
+  ierr = exact.begin_access(); CHKERRQ(ierr);
+  for (PetscInt i = grid.xs; i < grid.xs + grid.xm; ++i) {
+    for (PetscInt j = grid.ys; j < grid.ys + grid.ym; ++j) {
+      ierr = E.getInternalColumn(i, j, &a); CHKERRQ(ierr);
+      ierr = exact.getInternalColumn(i, j, &b); CHKERRQ(ierr);
+      my_error = PetscMax(my_error, PetscAbs(a[0] - b[0]));
+    }
+  }
+  ierr = exact.end_access(); CHKERRQ(ierr);
+  ierr = E.end_access(); CHKERRQ(ierr);
+
+  ierr = PISMGlobalMax(&my_error, &result, grid.com); CHKERRQ(ierr);
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  PetscErrorCode  ierr;
+
+  MPI_Comm    com;
+  PetscMPIInt rank, size;
+  int         status = 0;
+
+  ierr = PetscInitialize(&argc, &argv, PETSC_NULL, help); CHKERRQ(ierr);
+
+  com = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_rank(com, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(com, &size); CHKERRQ(ierr);
+
+  /* This explicit scoping forces destructors to be called before PetscFinalize() */
+  {
+    NCConfigVariable config, overrides;
+    ierr = init_config(com, rank, config, overrides); CHKERRQ(ierr);
+
+    PetscInt Mxy = 101;
+    PetscReal cfl = 3.5, sigma = 4.0, tolerance = 0.5;
+    bool flag;
+    ierr = PISMOptionsInt(com, "-M", "Number of grid points in each direction", Mxy, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-cfl", "Courant number of semi-Lagrangian steps", cfl, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-sigma", "Radius of the blob, in grid cells", sigma, flag); CHKERRQ(ierr);
+    ierr = PISMOptionsReal(com, "-max_error", "Largest acceptable semi-Lagrangian error", tolerance, flag); CHKERRQ(ierr);
+
+    if (cfl <= 0.0) {
+      PetscPrintf(com, "PISM ERROR: -cfl has to be positive.\n");
+      PISMEnd();
+    }
+
+    IceGrid grid(com, rank, size, config);
+    grid.Mx = Mxy;
+    grid.My = Mxy;
+    grid.Lx = 1000e3;
+    grid.Ly = grid.Lx;
+    grid.compute_nprocs();
+    grid.compute_ownership_ranges();
+    ierr = grid.compute_horizontal_spacing(); CHKERRQ(ierr);
+    ierr = grid.createDA(); CHKERRQ(ierr);
+
+    const int W = static_cast<int>(ceil(cfl)), substeps = W;
+    // Courant numbers in the x and y directions; the blob moves about half
+    // way across the domain.
+    const double cx = cfl, cy = 0.6 * cfl;
+    const int steps = static_cast<int>(ceil(0.5 * Mxy / cfl));
+
+    IceModelVec3 E_sl, E_upwind, work, exact;
+    ierr = E_sl.create(grid, "enthalpy_sl", true, W); CHKERRQ(ierr);
+    ierr = E_upwind.create(grid, "enthalpy_upwind", true, 1); CHKERRQ(ierr);
+    ierr = work.create(grid, "work", false); CHKERRQ(ierr);
+    ierr = exact.create(grid, "exact", false); CHKERRQ(ierr);
+
+    const double x0 = 0.25 * Mxy, y0 = 0.25 * Mxy;
+    ierr = set_blob(grid, x0, y0, sigma, work); CHKERRQ(ierr);
+    ierr = E_sl.beginGhostCommTransfer(work); CHKERRQ(ierr);
+    ierr = E_sl.endGhostCommTransfer(work); CHKERRQ(ierr);
+    ierr = E_upwind.beginGhostCommTransfer(work); CHKERRQ(ierr);
+    ierr = E_upwind.endGhostCommTransfer(work); CHKERRQ(ierr);
+
+    for (int n = 0; n < steps; ++n) {
+      ierr = advect(grid, true, cx, cy, E_sl, work); CHKERRQ(ierr);
+
+      for (int m = 0; m < substeps; ++m) {
+        ierr = advect(grid, false, cx / substeps, cy / substeps, E_upwind, work); CHKERRQ(ierr);
+      }
+    }
+
+    ierr = set_blob(grid, x0 + steps * cx, y0 + steps * cy, sigma, exact); CHKERRQ(ierr);
+
+    double sl_error, upwind_error;
+    ierr = max_error(grid, E_sl, exact, sl_error); CHKERRQ(ierr);
+    ierr = max_error(grid, E_upwind, exact, upwind_error); CHKERRQ(ierr);
+
+    ierr = PetscPrintf(com,
+                       "%d x %d grid, blob radius %.1f cells, moved by (%.1f, %.1f) cells:\n"
+                       "  semi-Lagrangian: %4d steps, Courant number %.2f, halo %d, max. error %.4f\n"
+                       "  upwind:          %4d steps, Courant number %.2f, halo 1, max. error %.4f\n",
+                       Mxy, Mxy, sigma, steps * cx, steps * cy,
+                       steps, cfl, W, sl_error,
+                       steps * substeps, cfl / substeps, upwind_error); CHKERRQ(ierr);
+
+    if (sl_error > upwind_error || sl_error > tolerance) {
+      ierr = PetscPrintf(com, "FAILED: the semi-Lagrangian error is too large\n"); CHKERRQ(ierr);
+      status = 1;
+    }
+  } // end explicit scope
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  return status;
+}
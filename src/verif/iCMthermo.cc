@@ -714,8 +714,8 @@ PetscErrorCode IceCompModel::initTestsKO() {
   if (testname == 'K') {
     bool Mbz_set;
     int Mbz;
-    ierr = PISMOptionsInt("-Mbz", "Number of levels in the bedrock thermal model",
-                          Mbz, Mbz_set); CHKERRQ(ierr);
+    ierr = PISMOptionsInt(grid.com, "-Mbz", "Number of levels in the bedrock thermal model",
+                                    Mbz, Mbz_set); CHKERRQ(ierr);
     if (Mbz_set && Mbz < 2) {
       PetscPrintf(grid.com, "PISM ERROR: pismv test K requires a bedrock thermal layer 1000m deep.\n");
       PISMEnd();
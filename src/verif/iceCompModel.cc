@@ -1046,8 +1046,8 @@ PetscErrorCode IceCompModel::reportErrors() {
   string filename;
   bool netcdf_report, append;
   NCTimeseries err;
-  ierr = PISMOptionsString("-report_file", "NetCDF error report file",
-                           filename, netcdf_report); CHKERRQ(ierr);
+  ierr = PISMOptionsString(grid.com, "-report_file", "NetCDF error report file",
+                                     filename, netcdf_report); CHKERRQ(ierr);
   ierr = PISMOptionsIsSet("-append", "Append the NetCDF error report",
                           append); CHKERRQ(ierr);
   if (netcdf_report) {
@@ -0,0 +1,348 @@
+#!/usr/bin/env python
+
+## @package pism_benchmark
+## \brief Runs a fixed set of PISM verification drivers to track performance.
+## \details Runs \c pismv, \c pisms, \c siafd_test, the SSA test executables,
+## \c btutest and \c flowlaw_test on a fixed set of grid sizes and processor
+## counts, collects wall-clock times, PISMProf timings (if PISM was built with
+## \c Pism_PROFILE), per-kernel throughput (grid cells per second), output
+## file sizes and KSP iteration counts (runs using \c -ksp_converged_reason), saves results in a JSON file and (optionally) compares them to a
+## baseline.
+##
+## Examples:
+##    - \verbatim pism_benchmark.py --prefix=build/ -o results.json \endverbatim
+##      runs all the benchmarks using 1 and 2 processes,
+##    - \verbatim pism_benchmark.py --prefix=build/ -n 1,2,4 -l 3 -b baseline.json -t 0.15 \endverbatim
+##      uses 1, 2 and 4 processes and three grid sizes, then compares to
+##      \c baseline.json allowing a 15% slowdown,
+##    - \verbatim pism_benchmark.py --list \endverbatim lists benchmarks.
+##
+## The exit status is 1 if any of the benchmarks failed to run or was slower
+## than the baseline by more than the tolerance.
+##
+## Copyright (C) 2012 PISM Authors
+
+from __future__ import print_function
+import sys, os, getopt, time, json, socket, subprocess, re
+
+try:
+    from netCDF4 import Dataset as NC
+except:
+    try:
+        from netCDF3 import Dataset as NC
+    except:
+        NC = None
+
+## PISMProf events and the number of "cells" each one processes per time
+## step: "2d" (Mx*My) or "3d" (Mx*My*Mz).
+kernels = {"velocity" : "3d",
+           "energy"   : "3d",
+           "age"      : "3d",
+           "masscont" : "2d",
+           "output"   : "3d"}
+
+## A benchmark: an executable, fixed options and a list of grid sizes.
+class Benchmark:
+    def __init__(self, name, executable, opts, grids, uses_prof = True, optional = False):
+        ## benchmark name
+        self.name = name
+        ## executable name (the prefix is added later)
+        self.executable = executable
+        ## options used in all runs
+        self.opts = opts
+        ## list of (Mx, My, Mz) tuples; Mz = 1 means "2D" and the -Mz option is not used
+        self.grids = grids
+        ## True if the executable is an IceModel-based one (supports -prof and -count_steps)
+        self.uses_prof = uses_prof
+        ## True if the benchmark needs optional PISM features (failures are reported but ignored)
+        self.optional = optional
+
+    def command(self, prefix, mpido, n, grid, output):
+        Mx, My, Mz = grid
+        cmd = "%s %d %s%s %s" % (mpido, n, prefix, self.executable, self.opts)
+        if Mx > 0:
+            cmd += " -Mx %d -My %d" % (Mx, My)
+        if Mz > 1:
+            cmd += " -Mz %d" % Mz
+        if self.uses_prof:
+            cmd += " -prof -count_steps -o %s" % output
+        return cmd
+
+benchmarks = [
+    # SIA only (isothermal), mass continuity:
+    Benchmark("pismv_B", "pismv", "-test B -Mbz 1 -y 1000 -o_size small -verbose 2",
+              [(61, 61, 31), (121, 121, 31), (241, 241, 31)]),
+    # thermomechanically coupled SIA: energy and age
+    Benchmark("pismv_G", "pismv", "-test G -Mbz 1 -y 100 -o_size small -verbose 2",
+              [(61, 61, 31), (121, 121, 61), (241, 241, 61)]),
+    # EISMINT II, experiment A
+    Benchmark("pisms_A", "pisms", "-eisII A -y 500 -o_size big -verbose 2",
+              [(61, 61, 31), (121, 121, 61), (241, 241, 61)]),
+    # one SIAFD velocity computation
+    Benchmark("siafd_test", "siafd_test", "-verbose 2",
+              [(61, 61, 61), (121, 121, 61), (241, 241, 61)], uses_prof = False),
+    # SSA solvers
+    Benchmark("ssa_testi_fd", "ssa_testi", "-ssa_method fd -memory_report -verbose 2",
+              [(5, 241, 1), (5, 481, 1), (5, 961, 1)], uses_prof = False),
+    Benchmark("ssa_testi_fem", "ssa_testi", "-ssa_method fem -memory_report -verbose 2",
+              [(5, 241, 1), (5, 481, 1), (5, 961, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fd", "ssa_testj", "-ssa_method fd -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fem", "ssa_testj", "-ssa_method fem -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_test_plug_fem", "ssa_test_plug", "-ssa_method fem -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    # matrix-free SSAFEM Jacobian (block-diagonal and Picard preconditioners);
+    # compare wall_time and memory_peak_mib to ssa_*_fem above
+    Benchmark("ssa_testi_fem_mf", "ssa_testi", "-ssa_method fem -ssa_fem_matrix_free -memory_report -verbose 2",
+              [(5, 241, 1), (5, 481, 1), (5, 961, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fem_mf", "ssa_testj", "-ssa_method fem -ssa_fem_matrix_free -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fem_mf_picard", "ssa_testj",
+              "-ssa_method fem -ssa_fem_matrix_free -ssa_fem_picard_pc -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_test_plug_fem_mf", "ssa_test_plug", "-ssa_method fem -ssa_fem_matrix_free -memory_report -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    # SSAFD with and without geometric multigrid; compare wall_time and
+    # ksp_iterations (non-periodic grids coarsen 241 -> 121 -> 61, periodic
+    # ones 256 -> 128 -> 64)
+    Benchmark("ssa_test_plug_fd_default", "ssa_test_plug", "-ssa_method fd -ksp_converged_reason -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_test_plug_fd_mg", "ssa_test_plug", "-ssa_method fd -ssa_mg_levels 3 -ksp_converged_reason -verbose 2",
+              [(61, 61, 1), (121, 121, 1), (241, 241, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fd_default", "ssa_testj", "-ssa_method fd -ksp_converged_reason -verbose 2",
+              [(64, 64, 1), (128, 128, 1), (256, 256, 1)], uses_prof = False),
+    Benchmark("ssa_testj_fd_mg", "ssa_testj", "-ssa_method fd -ssa_mg_levels 3 -ksp_converged_reason -verbose 2",
+              [(64, 64, 1), (128, 128, 1), (256, 256, 1)], uses_prof = False),
+    # bedrock thermal unit and flow laws (serial, no grid refinement)
+    Benchmark("btutest", "btutest", "-Mbz 1001 -Lbz 1000 -ys 0.0 -ye 1000.0 -dt 0.1 -verbose 2",
+              [(0, 0, 1)], uses_prof = False),
+    Benchmark("flowlaw_test", "flowlaw_test", "-flow_law gpbld",
+              [(0, 0, 1)], uses_prof = False),
+    # output: NetCDF-3, NetCDF-4 (chunked) and compressed NetCDF-4 with rounding
+    # of single-precision fields; compare "output" throughput and output_bytes
+    Benchmark("output_nc3", "pismv", "-test G -Mbz 1 -y 1 -o_size big -o_format netcdf3 -verbose 2",
+              [(121, 121, 61), (241, 241, 61)]),
+    Benchmark("output_nc4", "pismv", "-test G -Mbz 1 -y 1 -o_size big -o_format netcdf4_parallel -verbose 2",
+              [(121, 121, 61), (241, 241, 61)], optional = True),
+    Benchmark("output_nc4_deflate", "pismv",
+              "-test G -Mbz 1 -y 1 -o_size big -o_format netcdf4_parallel -o_compression 1 -o_float_digits 4 -verbose 2",
+              [(121, 121, 61), (241, 241, 61)], optional = True),
+    # enthalpy converters: point-wise vs. column-wise calls, tabulated varc
+    Benchmark("enthalpy_converter_test", "enthalpy_converter_test", "-N 20000 -Mz 201",
+              [(0, 0, 1)], uses_prof = False),
+    # mask lookups: IceModelVec2Int vs. IceModelVec2IntCompact
+    Benchmark("mask_lookup_test", "mask_lookup_test", "-M 2001 -N 20",
+              [(0, 0, 1)], uses_prof = False),
+    ]
+
+def read_prof(filename):
+    """Returns a dictionary {event: time}, using the maximum over processors."""
+    result = {}
+    if NC is None or not os.path.exists(filename):
+        return result
+
+    nc = NC(filename, 'r')
+    for name, var in nc.variables.items():
+        if getattr(var, "units", "") == "seconds":
+            result[name] = float(var[:].max())
+    nc.close()
+    return result
+
+def run(benchmark, prefix, mpido, n, grid):
+    """Runs one benchmark and returns a dictionary with results (or None on failure)."""
+    output = "%s-benchmark.nc" % benchmark.name
+    prof_file = "%s-benchmark-prof.nc" % benchmark.name
+    command = benchmark.command(prefix, mpido, n, grid, output)
+
+    print(" running '%s'" % command)
+    sys.stdout.flush()
+
+    start = time.time()
+    p = subprocess.Popen(command, shell = True, stdout = subprocess.PIPE, stderr = subprocess.STDOUT)
+    stdout = p.communicate()[0]
+    wall_time = time.time() - start
+
+    if p.returncode != 0:
+        print("  FAILED (exit status %d); output:\n%s" % (p.returncode, stdout))
+        return None
+
+    Mx, My, Mz = grid
+    result = {"wall_time" : wall_time}
+
+    # peak memory use (max. over processors) reported by -memory_report
+    match = re.search(r"^\s*total\s+[\d.]+\s*/\s*[\d.]+\s+([\d.]+)\s*/", str(stdout), re.MULTILINE)
+    if match:
+        result["memory_peak_mib"] = float(match.group(1))
+
+    # total number of KSP iterations reported by -ksp_converged_reason
+    iterations = re.findall(r"Linear solve converged due to \w+ iterations (\d+)", str(stdout))
+    if iterations:
+        result["ksp_iterations"] = sum(int(x) for x in iterations)
+
+    if not benchmark.uses_prof:
+        if Mx > 0:
+            result["cells_per_second"] = Mx * My * max(Mz, 1) / wall_time
+        return result
+
+    match = re.search(r"run\(\) took (\d+) steps", str(stdout))
+    steps = int(match.group(1)) if match else 0
+    result["steps"] = steps
+
+    events = read_prof(prof_file)
+    result["events"] = events
+
+    if os.path.exists(output):
+        result["output_bytes"] = os.path.getsize(output)
+
+    cells = {"2d" : Mx * My, "3d" : Mx * My * Mz}
+    for kernel, dim in kernels.items():
+        t = events.get(kernel, 0.0)
+        if kernel == "output":
+            # output is done once per run
+            count = 1
+        else:
+            count = steps
+        if t > 0.0 and count > 0:
+            result["%s_cells_per_second" % kernel] = count * cells[dim] / t
+
+    for f in (output, prof_file):
+        if os.path.exists(f):
+            os.remove(f)
+
+    return result
+
+def compare(results, baseline, tolerance):
+    """Compares results to a baseline. Returns the number of regressions."""
+    regressions = 0
+    print("Comparing to the baseline (tolerance: %3.0f%%):" % (tolerance * 100))
+    for key in sorted(results.keys()):
+        if key not in baseline:
+            print("  %-45s not in the baseline" % key)
+            continue
+
+        current, base = results[key], baseline[key]
+        for quantity in sorted(current.keys()):
+            if quantity not in base or quantity in ("events", "steps"):
+                continue
+            a, b = current[quantity], base[quantity]
+            if b <= 0.0:
+                continue
+
+            # wall times, file sizes, memory use and iteration counts should
+            # not go up, throughputs should not go down
+            if quantity in ("wall_time", "output_bytes", "memory_peak_mib", "ksp_iterations"):
+                change = a / b - 1.0
+            else:
+                change = b / a - 1.0 if a > 0.0 else 1.0
+
+            status = "ok"
+            if change > tolerance:
+                status = "REGRESSION"
+                regressions += 1
+            print("  %-45s %-28s %12.4g %12.4g %+7.1f%% %s" % (key, quantity, b, a, 100 * change, status))
+
+    return regressions
+
+def usage():
+    print("""Usage: pism_benchmark.py [options]
+  -n, --procs=1,2       comma-separated list of processor counts
+  -l, --levels=2        number of grid sizes to use (1 to 3)
+  -r, --run=NAMES       comma-separated list of benchmarks to run (default: all)
+  -o, --output=FILE     save results to FILE (JSON)
+  -b, --baseline=FILE   compare to results saved in FILE
+  -t, --tolerance=0.1   allowed relative slowdown
+  --prefix=DIR/         location of PISM executables
+  --mpido=CMD           command used to start MPI jobs (default: 'mpiexec -n')
+  --list                list available benchmarks
+  -h, --help            print this message""")
+
+def main():
+    procs = [1, 2]
+    levels = 2
+    names = [b.name for b in benchmarks]
+    output = None
+    baseline = None
+    tolerance = 0.1
+    prefix = ""
+    mpido = "mpiexec -n"
+
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "n:l:r:o:b:t:h",
+                                   ["procs=", "levels=", "run=", "output=", "baseline=",
+                                    "tolerance=", "prefix=", "mpido=", "list", "help"])
+    except getopt.GetoptError as e:
+        print(e)
+        usage()
+        sys.exit(1)
+
+    for opt, arg in opts:
+        if opt in ("-n", "--procs"):
+            procs = [int(x) for x in arg.split(",")]
+        elif opt in ("-l", "--levels"):
+            levels = int(arg)
+        elif opt in ("-r", "--run"):
+            names = arg.split(",")
+        elif opt in ("-o", "--output"):
+            output = arg
+        elif opt in ("-b", "--baseline"):
+            baseline = arg
+        elif opt in ("-t", "--tolerance"):
+            tolerance = float(arg)
+        elif opt == "--prefix":
+            prefix = arg
+        elif opt == "--mpido":
+            mpido = arg
+        elif opt == "--list":
+            for b in benchmarks:
+                print("%-20s %s %s" % (b.name, b.executable, b.opts))
+            sys.exit(0)
+        elif opt in ("-h", "--help"):
+            usage()
+            sys.exit(0)
+
+    results = {}
+    failures = 0
+    for b in benchmarks:
+        if b.name not in names:
+            continue
+        for grid in b.grids[:levels]:
+            for n in procs:
+                if b.executable in ("btutest", "flowlaw_test", "enthalpy_converter_test") and n > 1:
+                    continue        # serial codes
+
+                key = "%s/%dx%dx%d/n%d" % ((b.name,) + grid + (n,))
+                r = run(b, prefix, mpido, n, grid)
+                if r is None:
+                    if b.optional:
+                        print("  %s: skipped (optional benchmark failed)" % key)
+                    else:
+                        failures += 1
+                    continue
+                results[key] = r
+                if "ksp_iterations" in r:
+                    print("  %s: %.2f s, %d KSP iterations" % (key, r["wall_time"], r["ksp_iterations"]))
+                else:
+                    print("  %s: %.2f s" % (key, r["wall_time"]))
+
+    if output is not None:
+        f = open(output, "w")
+        json.dump({"host" : socket.gethostname(),
+                   "date" : time.strftime("%Y-%m-%d %H:%M:%S"),
+                   "procs" : procs,
+                   "results" : results}, f, indent = 2, sort_keys = True)
+        f.close()
+        print("Results saved to '%s'." % output)
+
+    regressions = 0
+    if baseline is not None:
+        f = open(baseline, "r")
+        regressions = compare(results, json.load(f)["results"], tolerance)
+        f.close()
+
+    if failures > 0 or regressions > 0:
+        print("%d benchmark(s) failed, %d regression(s)." % (failures, regressions))
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# SSAFEM verification test I regression test (matrix-free Jacobian)
+#
+# Compares solutions computed using the assembled Jacobian, the matrix-free
+# Jacobian with the default (block-diagonal) preconditioner and the
+# matrix-free Jacobian preconditioned by the whole Picard linearization.
+
+PISM_PATH=$1
+NCCMP=$1/nccmp.py
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+PISM_SOURCE_DIR=$3
+EXT=""
+if [ $# -ge 4 ] && [ "$4" == "-python" ]
+then
+  PYTHONEXEC=$5
+  MPIEXEC_COMMAND="$MPIEXEC_COMMAND $PYTHONEXEC"
+  PYTHONPATH=${PISM_PATH}
+  PISM_PATH=${PISM_SOURCE_DIR}/examples/python/ssa_tests
+  EXT=".py"
+fi
+
+# List of files to remove when done:
+files="fem-I.nc fem-I.nc~ mf-I.nc mf-I.nc~ mf-picard-I.nc mf-picard-I.nc~ test-I-out.txt"
+
+rm -f $files
+
+set -e
+
+# Solve accurately, so that results differ by round-off and solver
+# tolerances only.
+OPTS="-verbose 1 -ssa_method fem -Mx 5 -snes_rtol 1e-10 -ksp_rtol 1e-10 -ksp_max_it 2000 -ksp_gmres_restart 200"
+
+for My in 61 121;
+do
+    $MPIEXEC_COMMAND $PISM_PATH/ssa_testi${EXT} -My $My $OPTS -o fem-I.nc > test-I-out.txt
+    $MPIEXEC_COMMAND $PISM_PATH/ssa_testi${EXT} -My $My $OPTS -ssa_fem_matrix_free -o mf-I.nc >> test-I-out.txt
+    $MPIEXEC_COMMAND $PISM_PATH/ssa_testi${EXT} -My $My $OPTS -ssa_fem_matrix_free -ssa_fem_picard_pc -o mf-picard-I.nc >> test-I-out.txt
+
+    set +e
+
+    # Check results:
+    $NCCMP -r -t 1e-6 -v u_ssa,v_ssa fem-I.nc mf-I.nc
+    if [ $? != 0 ];
+    then
+        cat test-I-out.txt
+        exit 1
+    fi
+
+    $NCCMP -r -t 1e-6 -v u_ssa,v_ssa fem-I.nc mf-picard-I.nc
+    if [ $? != 0 ];
+    then
+        cat test-I-out.txt
+        exit 1
+    fi
+
+    set -e
+done
+
+rm -f $files; exit 0
@@ -0,0 +1,23 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #29: column-wise and tabulated EnthalpyConverter methods."
+# The list of files to delete when done.
+files="enthalpy_converter.txt"
+
+rm -f $files
+
+# enthalpy_converter_test exits with status 1 if column-wise and point-wise
+# conversions disagree or if the tabulated temperature is not accurate enough
+$PISM_PATH/enthalpy_converter_test -N 10 -Mz 101 > enthalpy_converter.txt
+
+if [ $? != 0 ];
+then
+    cat enthalpy_converter.txt
+    exit 1
+fi
+
+rm -f $files; exit 0
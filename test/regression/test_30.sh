@@ -0,0 +1,31 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #30: FFT-based elastic bed deformation response vs. conv2_same."
+# The list of files to delete when done.
+files="tryLCbd_elastic.txt lc_elastic_193x129_*.bin"
+
+rm -f $files
+
+# tryLCbd exits with status 1 if BedDeformLC::elastic_response() and
+# BedDeformLC::elastic_response_direct() disagree. The first run computes the
+# load response matrix (using 2 processes) and saves it in the current
+# directory, the second one reads it.
+for run in 1 2;
+do
+    $MPIEXEC -n 2 $PISM_PATH/tryLCbd -check_elastic -lc_elastic_cache . > tryLCbd_elastic.txt
+
+    if [ $? != 0 ];
+    then
+        cat tryLCbd_elastic.txt
+        exit 1
+    fi
+done
+
+# the second run should have used the cached matrix
+grep -q "read the elastic load response matrix" tryLCbd_elastic.txt || exit 1
+
+rm -f $files; exit 0
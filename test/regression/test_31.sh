@@ -0,0 +1,54 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #31: SSA geometric multigrid on odd (non-periodic) and even (periodic) grids."
+# The list of files to delete when done.
+files="mg-default.nc mg-default.nc~ mg-3.nc mg-3.nc~ mg-default.txt mg-3.txt"
+
+rm -f $files
+
+# Prints the total number of KSP iterations reported by -ksp_converged_reason.
+total_iterations() {
+    grep -o "iterations [0-9]*" $1 | awk '{s += $2} END {print s + 0}'
+}
+
+# ssa_test_plug uses a non-periodic grid (Mx = My = 61 allow 3 levels:
+# 61 -> 31 -> 16), ssa_testj a doubly periodic one (64 -> 32 -> 16).
+for test in "ssa_test_plug -Mx 61 -My 61" "ssa_testj -Mx 64 -My 64";
+do
+    opts="-ssa_method fd -ssa_rtol 1e-8 -ksp_rtol 1e-10 -ksp_converged_reason -verbose 2"
+
+    set -e
+    $MPIEXEC -n 2 $PISM_PATH/$test $opts -o mg-default.nc > mg-default.txt
+    $MPIEXEC -n 2 $PISM_PATH/$test $opts -ssa_mg_levels 3 -o mg-3.nc > mg-3.txt
+    set +e
+
+    # all three levels should be used
+    grep -q "using geometric multigrid with 3 levels" mg-3.txt
+    if [ $? != 0 ];
+    then
+        cat mg-3.txt
+        exit 1
+    fi
+
+    default=`total_iterations mg-default.txt`
+    mg=`total_iterations mg-3.txt`
+    echo "$test: $default KSP iterations without multigrid, $mg with 3 levels"
+
+    if [ $mg -eq 0 ] || [ $mg -gt $default ];
+    then
+        exit 1
+    fi
+
+    # the solution should not depend on the preconditioner
+    $PISM_PATH/nccmp.py -r -t 1e-6 -v u_ssa,v_ssa mg-default.nc mg-3.nc
+    if [ $? != 0 ];
+    then
+        exit 1
+    fi
+done
+
+rm -f $files; exit 0
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #32: binary checkpoints survive backup rotation."
+# The list of files to delete when done.
+files="foo.nc foo.nc~ foo_backup.nc foo_backup.nc~ foo_backup.nc.bin foo_backup.nc~.bin foo_backup.nc.bin.tmp bar.nc bar.nc~ baz.nc baz.nc~"
+
+rm -f $files
+
+set -e -x
+
+# A run that saves a binary checkpoint after every time step (so that the
+# second and later backups rotate the first one):
+$MPIEXEC -n 2 $PISM_PATH/pisms -eisII A -Mx 31 -My 31 -Mz 21 -y 1000 \
+    -backup_interval 0 -backup_format binary -o foo.nc
+
+set +x
+
+# The newest checkpoint and the rotated one are complete; no temporary file
+# is left behind.
+for f in foo_backup.nc foo_backup.nc.bin foo_backup.nc~ foo_backup.nc~.bin;
+do
+    if [ ! -f $f ]; then echo "$f is missing"; exit 1; fi
+done
+if [ -f foo_backup.nc.bin.tmp ]; then echo "foo_backup.nc.bin.tmp was not removed"; exit 1; fi
+
+set -x
+
+# Restart from both checkpoints (using a different number of processes):
+$MPIEXEC -n 3 $PISM_PATH/pisms -eisII A -i foo_backup.nc -y 0 -o bar.nc
+$MPIEXEC -n 1 $PISM_PATH/pisms -eisII A -i foo_backup.nc~ -y 0 -o baz.nc
+
+set +e
+set +x
+
+# The last backup is saved after the last time step, so it has to match the
+# output file:
+$PISM_PATH/nccmp.py -v thk,enthalpy foo.nc bar.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
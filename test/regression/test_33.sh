@@ -0,0 +1,85 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #33: multirate coupler updates vs. updates at every step (linear forcing)."
+# The list of files to delete when done.
+files="eisII.nc eisII.nc~ forcing.nc every_step.nc every_step.nc~ multirate.nc multirate.nc~"
+
+rm -f $files
+
+set -e -x
+
+# Create the initial state:
+$MPIEXEC -n 2 $PISM_PATH/pisms -eisII A -Mx 21 -My 21 -Mz 11 -y 1 -o eisII.nc
+
+set +x
+
+# Create forcing with precipitation growing linearly in time (from 0 to 2
+# m/year over 200 years):
+/usr/bin/env python <<END_OF_PYTHON
+from numpy import zeros, array
+try:
+    from netCDF4 import Dataset as NC
+except:
+    from netCDF3 import Dataset as NC
+
+input = NC("eisII.nc", "r")
+nc = NC("forcing.nc", "w")
+
+nc.createDimension("x", len(input.dimensions["x"]))
+nc.createDimension("y", len(input.dimensions["y"]))
+nc.createDimension("time", None)
+nc.createDimension("nv", 2)
+
+for name in ["x", "y"]:
+    var = nc.createVariable(name, 'f8', (name,))
+    var.units = "m"
+    var[:] = input.variables[name][:]
+
+time = nc.createVariable("time", 'f8', ("time",))
+time.units = "years"
+time.axis = "T"
+time.bounds = "time_bounds"
+time_bounds = nc.createVariable("time_bounds", 'f8', ("time", "nv"))
+
+temp = nc.createVariable("air_temp", 'f8', ("time", "y", "x"))
+temp.units = "Kelvin"
+precip = nc.createVariable("precipitation", 'f8', ("time", "y", "x"))
+precip.units = "m year-1"
+
+shape = (len(input.dimensions["y"]), len(input.dimensions["x"]))
+for k, t in enumerate([0.0, 100.0, 200.0]):
+    time[k] = t
+    time_bounds[k,:] = array([t - 100.0, t])
+    temp[k,:,:] = zeros(shape) + 250.0
+    precip[k,:,:] = zeros(shape) + 0.01 * t
+
+nc.close()
+input.close()
+END_OF_PYTHON
+
+set -x
+
+# Without ice flow the thickness change is the time integral of the
+# precipitation. With -coupler_interval 20 and -max_dt 1 nineteen out of
+# twenty coupler updates are skipped; each update has to average the forcing
+# over the twenty years it is used for.
+OPTS="-i eisII.nc -no_sia -atmosphere given -atmosphere_given_file forcing.nc -surface simple -ys 0 -ye 200 -max_dt 1"
+
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -o every_step.nc
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -coupler_interval 20 -o multirate.nc
+
+set +e
+set +x
+
+# Averaging over the current time step only would be off by about 19 m.
+$PISM_PATH/nccmp.py -t 1e-3 -v thk every_step.nc multirate.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
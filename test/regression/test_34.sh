@@ -0,0 +1,63 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #34: semi-Lagrangian vs. upwind horizontal advection (translating blob)."
+# The list of files to delete when done.
+files="semi_lagrangian.txt upwind.txt sl_input.nc sl_input.nc~ upwind.nc upwind.nc~ sl.nc sl.nc~"
+
+rm -f $files
+
+# semi_lagrangian_test exits with status 1 if the semi-Lagrangian scheme is
+# less accurate than upwinding; try Courant numbers that do and do not need a
+# halo wider than 2 grid cells.
+for cfl in 1.5 3.5;
+do
+    $MPIEXEC -n 2 $PISM_PATH/semi_lagrangian_test -cfl $cfl > semi_lagrangian.txt
+
+    if [ $? != 0 ];
+    then
+        cat semi_lagrangian.txt
+        exit 1
+    fi
+done
+
+# Polythermal runs with the age (cold-ice methods do not use the
+# semi-Lagrangian scheme). Mass continuity is off, so time steps are limited
+# by the 3D CFL condition, which the semi-Lagrangian scheme relaxes.
+set -e
+$MPIEXEC -n 2 $PISM_PATH/pisms -eisII A -Mx 31 -My 31 -Mz 21 -y 3000 -no_cold -age \
+    -o sl_input.nc > semi_lagrangian.txt
+set +e
+
+OPTS="-i sl_input.nc -no_mass -no_cold -age -y 500 -count_steps"
+
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -o upwind.nc > upwind.txt
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -semi_lagrangian -semi_lagrangian_cfl 3 -o sl.nc > semi_lagrangian.txt
+
+if [ $? != 0 ];
+then
+    cat semi_lagrangian.txt
+    exit 1
+fi
+
+# The relaxed time step has to be actually taken:
+steps_upwind=`grep -o "run() took [0-9]*" upwind.txt | awk '{print $3}'`
+steps_sl=`grep -o "run() took [0-9]*" semi_lagrangian.txt | awk '{print $3}'`
+echo "time steps: $steps_upwind (upwind), $steps_sl (semi-Lagrangian, CFL factor 3)"
+if [ -z "$steps_sl" ] || [ -z "$steps_upwind" ] || [ $steps_sl -ge $steps_upwind ];
+then
+    exit 1
+fi
+
+# The model sizes the halo of enthalpy and age to fit departure points, so
+# none of them are clipped:
+if grep -q "departure points" semi_lagrangian.txt;
+then
+    cat semi_lagrangian.txt
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #35: compressed parallel NetCDF-4 output using a non-xyz variable order."
+# The list of files to delete when done.
+files="foo.nc foo.nc~ bar.nc bar.nc~"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-eisII A -Mx 31 -My 41 -Mz 21 -y 1000 -o_order zyx"
+
+# Variables stored in the "zyx" order are transposed in memory and written
+# collectively, which is required for compressed variables.
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -o_format netcdf3 -o foo.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -o_format netcdf4_parallel -o_compression 1 -o_shuffle -o bar.nc
+
+set +e
+set +x
+
+$PISM_PATH/nccmp.py -v thk,enthalpy foo.nc bar.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #36: results do not depend on the number of threads."
+# The list of files to delete when done.
+files="threads-1.nc threads-1.nc~ threads-4.nc threads-4.nc~"
+
+rm -f $files
+
+# Polythermal (enthalpy) and cold (temperature) runs; both use the SIA and
+# compute the age. (pisms uses cold-ice methods unless -no_cold is given.)
+for METHOD in "-no_cold" "-cold";
+do
+    OPTS="-eisII A -Mx 31 -My 31 -Mz 21 -y 3000 -age $METHOD"
+    if [ "$METHOD" == "-cold" ];
+    then
+        VARS="thk,temp,age"
+    else
+        VARS="thk,enthalpy,liqfrac,age"
+    fi
+
+    set -e -x
+    $MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -threads 1 -o threads-1.nc
+    $MPIEXEC -n 2 $PISM_PATH/pisms $OPTS -threads 4 -o threads-4.nc
+    set +e +x
+
+    # Every grid point is updated by exactly one thread, so results have to be
+    # identical:
+    $PISM_PATH/nccmp.py -v $VARS threads-1.nc threads-4.nc
+    if [ $? != 0 ];
+    then
+        exit 1
+    fi
+done
+
+rm -f $files; exit 0
@@ -0,0 +1,60 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #37: semi-implicit vs. explicit SIA mass continuity (verification test B)."
+# The list of files to delete when done.
+files="explicit.txt implicit-1.txt implicit-10.txt explicit.nc implicit-1.nc implicit-10.nc"
+
+rm -f $files
+
+OPTS="-test B -Mx 31 -My 31 -Mz 31 -ys 1000 -y 5000 -count_steps -o_size small"
+
+set -e
+
+# explicit; semi-implicit with the explicit time step; semi-implicit with
+# time steps up to 10 times longer
+$MPIEXEC -n 2 $PISM_PATH/pismv $OPTS -o explicit.nc > explicit.txt
+$MPIEXEC -n 2 $PISM_PATH/pismv $OPTS -implicit_mass -implicit_mass_dt_factor 1 -o implicit-1.nc > implicit-1.txt
+$MPIEXEC -n 2 $PISM_PATH/pismv $OPTS -implicit_mass -implicit_mass_dt_factor 10 -o implicit-10.nc > implicit-10.txt
+
+set +e
+
+# Prints the maximum and average thickness errors (in this order).
+thickness_errors() {
+    awk '/^geometry/ {getline; print $2, $3}' $1
+}
+
+steps() {
+    grep -o "run() took [0-9]*" $1 | awk '{print $3}'
+}
+
+read max_explicit av_explicit <<< `thickness_errors explicit.txt`
+steps_explicit=`steps explicit.txt`
+
+for run in implicit-1 implicit-10;
+do
+    read max_implicit av_implicit <<< `thickness_errors $run.txt`
+    echo "$run: max/av. thickness errors $max_implicit/$av_implicit m, explicit: $max_explicit/$av_explicit m"
+
+    # The semi-implicit scheme should be about as accurate as the explicit
+    # one: allow twice the explicit error plus 1 meter.
+    python -c "import sys; sys.exit(not ($max_implicit <= 2 * $max_explicit + 1 and $av_implicit <= 2 * $av_explicit + 1))"
+    if [ $? != 0 ];
+    then
+        cat $run.txt
+        exit 1
+    fi
+done
+
+# The relaxed time step has to be actually taken:
+steps_relaxed=`steps implicit-10.txt`
+echo "time steps: $steps_explicit (explicit), $steps_relaxed (semi-implicit, dt factor 10)"
+if [ -z "$steps_relaxed" ] || [ -z "$steps_explicit" ] || [ $steps_relaxed -ge $steps_explicit ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
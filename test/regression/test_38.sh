@@ -0,0 +1,98 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+# Test name:
+echo "Test #38: surface modifiers applied in one sweep vs. one at a time."
+# The list of files to delete when done.
+files="eisII.nc forcing.nc delta_T.nc lapse_rate.nc sequential.nc fused.nc lapse_rate.nc~ sequential.nc~ fused.nc~"
+
+rm -f $files
+
+set -e -x
+
+# Create the initial state:
+$MPIEXEC -n 2 $PISM_PATH/pisms -eisII A -Mx 21 -My 21 -Mz 11 -y 1 -o eisII.nc
+
+set +x
+
+# Create surface forcing (with the reference surface 100 m below the actual
+# one, so that lapse rate corrections are not zero) and temperature offsets:
+/usr/bin/env python <<END_OF_PYTHON
+from numpy import zeros, array
+try:
+    from netCDF4 import Dataset as NC
+except:
+    from netCDF3 import Dataset as NC
+
+input = NC("eisII.nc", "r")
+nc = NC("forcing.nc", "w")
+
+nc.createDimension("x", len(input.dimensions["x"]))
+nc.createDimension("y", len(input.dimensions["y"]))
+nc.createDimension("time", None)
+
+for name in ["x", "y"]:
+    var = nc.createVariable(name, 'f8', (name,))
+    var.units = "m"
+    var[:] = input.variables[name][:]
+
+time = nc.createVariable("time", 'f8', ("time",))
+time.units = "years"
+time[0] = 0.0
+
+shape = (len(input.dimensions["y"]), len(input.dimensions["x"]))
+
+temp = nc.createVariable("ice_surface_temp", 'f8', ("time", "y", "x"))
+temp.units = "Kelvin"
+temp[0,:,:] = zeros(shape) + 250.0
+
+smb = nc.createVariable("climatic_mass_balance", 'f8', ("time", "y", "x"))
+smb.units = "m year-1"
+smb[0,:,:] = zeros(shape) + 0.3
+
+usurf = nc.createVariable("usurf", 'f8', ("time", "y", "x"))
+usurf.units = "m"
+usurf.standard_name = "surface_altitude"
+usurf[0,:,:] = input.variables["usurf"][0,:,:] - 100.0
+
+nc.close()
+
+nc = NC("delta_T.nc", "w")
+nc.createDimension("time", None)
+time = nc.createVariable("time", 'f8', ("time",))
+time.units = "years"
+delta_T = nc.createVariable("delta_T", 'f8', ("time",))
+delta_T.units = "Kelvin"
+for k, t in enumerate([0.0, 10.0]):
+    time[k] = t
+    delta_T[k] = -5.0 - 0.1 * t
+nc.close()
+
+input.close()
+END_OF_PYTHON
+
+set -x
+
+OPTS="-i eisII.nc -no_mass -ys 0 -y 1 -max_dt 0.5 -o_size big -temp_lapse_rate 6 -smb_lapse_rate 0.5 -surface_lapse_rate_file forcing.nc -surface_delta_T_file delta_T.nc"
+
+# Apply the lapse rate correction, save the result and use it as the input of
+# the temperature offset modifier:
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -surface given,lapse_rate -surface_given_file forcing.nc -o lapse_rate.nc
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -surface given,delta_T -surface_given_file lapse_rate.nc -o sequential.nc
+
+# Apply both in one sweep:
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -surface given,lapse_rate,delta_T -surface_given_file forcing.nc -o fused.nc
+
+set +e
+set +x
+
+# The only difference should be the round-off of saving lapse_rate.nc.
+$PISM_PATH/nccmp.py -t 1e-3 -v ice_surface_temp,climatic_mass_balance sequential.nc fused.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0